@@ -0,0 +1,227 @@
+/*******************************************************************************
+ * palloc.h                                                                    *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PALLOC_H
+#define PALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+
+/*
+aligned storage for the vector and matrix types
+-----------------------------------------------
+the vector types are declared with PVECF_ALIGN(16/32) and loada()/storea()
+rely on that, but before C++17 std::vector<vec8f_t> or new mat4f_t[n] only
+guarantee the alignment of max_align_t (8 or 16 bytes); the types here
+allocate on cache line boundaries (64 bytes) instead, so aligned loads can be
+used for every element and no vector load is split across two cache lines:
+
+  aligned_allocator_t<T, A>  std allocator with A byte alignment (A >= alignof(T))
+  aligned_vector_t<T>        std::vector with aligned_allocator_t<T>
+  arena_t                    bump allocator for per-frame temporaries, reset()
+                             releases everything at once and keeps the blocks
+
+padding:
+  every allocation is rounded up to a multiple of its alignment, the padding
+  bytes are zeroed, so a full vector load (up to 64 bytes) at any aligned
+  position inside the buffer stays inside the allocation; this allows the
+  tail of an array to be processed with full vector loads (the padding
+  elements' results have to be discarded, of course)
+
+  padded_size<T>(n) is the number of elements actually covered by the
+  allocation of n elements
+
+the arena does not call destructors, only trivially destructible types can be
+allocated as arrays from it
+*/
+
+
+namespace math {
+
+static const size_t cache_line_size = 64;
+
+namespace ipriv {
+
+    inline size_t round_up(size_t size, size_t align)
+    { return (size + align - 1) & ~(align - 1); }
+
+    // align: power of 2, >= sizeof(void *)
+    inline void * aligned_malloc(size_t size, size_t align)
+    {
+#if defined(_MSC_VER)
+        return _aligned_malloc(size, align);
+#else
+        void * p = nullptr;
+        return posix_memalign(&p, align, size) == 0 ? p : nullptr;
+#endif
+    }
+    inline void aligned_free(void * p)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+} // namespace ipriv
+
+inline bool is_aligned(const void * p, size_t align)
+{ return (reinterpret_cast<uintptr_t>(p) & (align - 1)) == 0; }
+
+// number of elements covered by an allocation of n elements of T
+template<typename T, size_t A = cache_line_size> inline size_t padded_size(size_t n)
+{ return ipriv::round_up(n * sizeof(T), A) / sizeof(T); }
+
+
+template<typename T, size_t A = cache_line_size>
+class aligned_allocator_t
+{
+    static_assert((A & (A - 1)) == 0, "alignment must be a power of 2");
+    static_assert(A >= alignof(T), "alignment below the alignment of the type");
+    static_assert(A >= sizeof(void *), "alignment below the size of a pointer");
+
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template<typename U> struct rebind { typedef aligned_allocator_t<U, A> other; };
+
+    static const size_t alignment = A;
+
+    aligned_allocator_t() {}
+    template<typename U> aligned_allocator_t(const aligned_allocator_t<U, A> &) {}
+
+    T * allocate(size_t n)
+    {
+        size_t bytes = ipriv::round_up(n * sizeof(T), A);
+        if(bytes == 0) bytes = A;
+        void * p = ipriv::aligned_malloc(bytes, A);
+        if(!p) throw std::bad_alloc();
+        memset(static_cast<char *>(p) + n * sizeof(T), 0, bytes - n * sizeof(T));
+        return static_cast<T *>(p);
+    }
+    void deallocate(T * p, size_t)
+    { ipriv::aligned_free(p); }
+
+    size_t max_size() const
+    { return (size_t(-1) - A) / sizeof(T); }
+
+    template<typename U, typename... Args> void construct(U * p, Args &&... args)
+    { ::new(static_cast<void *>(p)) U(std::forward<Args>(args)...); }
+    template<typename U> void destroy(U * p)
+    { p->~U(); }
+};
+
+template<typename T, typename U, size_t A>
+inline bool operator==(const aligned_allocator_t<T, A> &, const aligned_allocator_t<U, A> &)
+{ return true; }
+template<typename T, typename U, size_t A>
+inline bool operator!=(const aligned_allocator_t<T, A> &, const aligned_allocator_t<U, A> &)
+{ return false; }
+
+template<typename T, size_t A = cache_line_size>
+using aligned_vector_t = std::vector<T, aligned_allocator_t<T, A> >;
+
+
+class arena_t
+{
+public:
+    explicit arena_t(size_t block_size = 64 * 1024)
+        : block_size_(ipriv::round_up(block_size, cache_line_size)), cur_(0), offset_(0) {}
+    ~arena_t()
+    {
+        for(size_t i = 0; i < blocks_.size(); ++i)
+            ipriv::aligned_free(blocks_[i].p);
+    }
+    arena_t(const arena_t &) = delete;
+    arena_t & operator=(const arena_t &) = delete;
+
+    // size rounded up to a multiple of align, the padding is zeroed
+    void * allocate(size_t size, size_t align = cache_line_size)
+    {
+        if(align < cache_line_size) align = cache_line_size;
+        size_t bytes = ipriv::round_up(size ? size : 1, align);
+        for(; cur_ < blocks_.size(); ++cur_, offset_ = 0) {
+            uintptr_t base = reinterpret_cast<uintptr_t>(blocks_[cur_].p);
+            size_t begin = size_t(ipriv::round_up(size_t(base) + offset_, align) - base);
+            if(begin + bytes <= blocks_[cur_].size) {
+                char * p = blocks_[cur_].p + begin;
+                memset(p + size, 0, bytes - size);
+                offset_ = begin + bytes;
+                return p;
+            }
+        }
+        // new block, large requests get a block of their own
+        // (blocks are cache line aligned, larger alignments need slack)
+        size_t block = bytes + (align - cache_line_size);
+        block = block > block_size_ ? block : block_size_;
+        blocks_.reserve(blocks_.size() + 1);
+        block_t b = { static_cast<char *>(ipriv::aligned_malloc(block, cache_line_size)), block };
+        if(!b.p) throw std::bad_alloc();
+        blocks_.push_back(b);
+        cur_ = blocks_.size() - 1;
+        offset_ = 0;
+        return allocate(size, align);
+    }
+
+    template<typename T> T * allocate_array(size_t n)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "the arena does not call destructors");
+        T * p = static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+        for(size_t i = 0; i < n; ++i)
+            ::new(static_cast<void *>(p + i)) T();
+        return p;
+    }
+
+    // releases all allocations, the blocks are kept for reuse
+    void reset() { cur_ = 0; offset_ = 0; }
+
+    // bytes handed out since the last reset() (including padding) and
+    // bytes held in blocks
+    size_t used() const
+    {
+        size_t n = offset_;
+        for(size_t i = 0; i < cur_ && i < blocks_.size(); ++i) n += blocks_[i].size;
+        return n;
+    }
+    size_t capacity() const
+    {
+        size_t n = 0;
+        for(size_t i = 0; i < blocks_.size(); ++i) n += blocks_[i].size;
+        return n;
+    }
+
+private:
+    struct block_t { char * p; size_t size; };
+
+    std::vector<block_t> blocks_;
+    size_t block_size_;
+    size_t cur_;       // block allocated from
+    size_t offset_;    // first free byte in blocks_[cur_]
+};
+
+} // namespace math
+
+#endif // PALLOC_H
@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * pbvh.h                                                                      *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PBVH_H
+#define PBVH_H
+
+#include <pgeom.h>
+#include <palloc.h>
+#include <pparallel.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+/*
+bounding volume hierarchy
+-------------------------
+a BVH with W = V::N children per node (BVH4 with vec4f_t, BVH8 with vec8f_t),
+the child boxes of a node are stored as a box_packet_t<V> (SoA slabs), so one
+ray_box() of pgeom.h tests all children of a node at once:
+
+  bvh_t<V> bvh;
+  bvh.build(bmin, bmax, n);         // the bounding boxes of the primitives
+  bvh.intersect(origin, dir, tmin, tmax, [&](uint32_t prim, float & t) {
+      // intersect primitive prim, if hit at a distance < t: t = distance,
+      // return true
+  });
+  bvh.occluded(origin, dir, tmin, tmax, f)   // stops at the first hit (line
+                                             // of sight, shadow rays)
+  bvh.overlap(qmin, qmax, [&](uint32_t prim) { .. })   // primitives whose
+                                             // boxes may overlap the query box
+  bvh.refit(bmin, bmax);            // new boxes for the same primitives
+                                    // (animation), keeps the topology
+
+build:
+  binned SAH (16 bins per axis, all three axes), the children of a node are
+  found by splitting the child with the largest surface area until there are
+  W of them; leaves hold up to leaf_size primitives (more only for primitives
+  with identical centroids beyond the maximum depth); the subtrees below the
+  top levels are built as independent tasks on a thread_pool_t of pparallel.h
+  (the global pool by default), the result doesn't depend on the number of
+  threads
+
+traversal:
+  intersect() visits the children in front to back order of their entry
+  distances and skips the ones behind the closest hit found so far (t of the
+  callback); the callbacks get the primitive indices (the order of the boxes
+  passed to build())
+
+the points are vec4f_t {x,y,z,w}, the w lanes are ignored; dir doesn't need to
+be normalized (the distances are in units of |dir|)
+*/
+
+// TODO:
+// - packet traversal (ray_packet_t against the child boxes)
+// - compressed (quantized) child boxes
+// - spatial splits for long diagonal triangles
+
+
+namespace math {
+
+namespace ipriv {
+
+    // box of the build, AoS in the xyz lanes
+    struct bvh_box_t
+    {
+        vec4f_t lo, hi;
+
+        static bvh_box_t empty()
+        {
+            const float inf = std::numeric_limits<float>::infinity();
+            bvh_box_t b = { vec4f_t(inf, inf, inf, inf), vec4f_t(-inf, -inf, -inf, -inf) };
+            return b;
+        }
+        inline void grow(const vec4f_t & l, const vec4f_t & h) { lo = vec4f_t::min_(lo, l); hi = vec4f_t::max_(hi, h); }
+        inline void grow(const bvh_box_t & b) { grow(b.lo, b.hi); }
+        inline float half_area() const
+        {
+            vec4f_t d(hi - lo);
+            return d[0] < 0.0f ? 0.0f : d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+        }
+    };
+
+    static const unsigned bvh_bins = 16;
+    static const unsigned bvh_max_depth = 48;
+
+} // namespace ipriv
+
+
+template<typename V = vec4f_t>
+class bvh_t
+{
+public:
+    static const unsigned W = V::N;
+
+    struct node_t
+    {
+        box_packet_t<V> box;  // child boxes, empty slots: min = max = +inf (never hit)
+        int32_t child[W];     // >= 0: inner node, < 0: leaf with the primitives
+                              // ~child .. ~child + count - 1 of prims()
+        uint32_t count[W];    // number of primitives of a leaf, 0 for inner nodes
+                              // and empty slots
+    };
+
+    bvh_t() {}
+
+    // builds the hierarchy for the boxes bmin[i], bmax[i], i < n
+    void build(thread_pool_t & pool, const vec4f_t * bmin, const vec4f_t * bmax, size_t n, unsigned leaf_size = 4)
+    {
+        nodes_.clear();
+        prims_.resize(n);
+        if(n == 0) { bounds_ = ipriv::bvh_box_t::empty(); return; }
+
+        builder_t b(bmin, bmax, std::max(1u, leaf_size));
+        b.centroids.resize(n);
+        bounds_ = ipriv::bvh_box_t::empty();
+        for(size_t i = 0; i < n; ++i) {
+            prims_[i] = uint32_t(i);
+            b.centroids[i] = (bmin[i] + bmax[i]) * 0.5f;
+            bounds_.grow(bmin[i], bmax[i]);
+        }
+        b.prims = &prims_[0];
+        // subtrees with at most task_size primitives are built as tasks
+        b.task_size = n >= 8192 ? n / 32 : n;
+        b.build(nodes_, 0, n, bounds_, 0, true);
+
+        // the subtrees into separate node arrays, appended in task order
+        std::vector<aligned_vector_t<node_t> > sub(b.tasks.size());
+        pool.run(b.tasks.size(), [&](size_t k) {
+            const task_t & t = b.tasks[k];
+            b.build(sub[k], t.begin, t.end, t.box, t.depth, false);
+        });
+        for(size_t k = 0; k < sub.size(); ++k) {
+            int32_t offset = int32_t(nodes_.size());
+            nodes_[b.tasks[k].node].child[b.tasks[k].slot] = offset;
+            for(size_t i = 0; i < sub[k].size(); ++i) {
+                node_t nd = sub[k][i];
+                for(unsigned c = 0; c < W; ++c)
+                    if(nd.child[c] >= 0 && nd.count[c] == 0) nd.child[c] += offset;
+                nodes_.push_back(nd);
+            }
+        }
+    }
+    void build(const vec4f_t * bmin, const vec4f_t * bmax, size_t n, unsigned leaf_size = 4)
+    { build(thread_pool_t::global(), bmin, bmax, n, leaf_size); }
+
+    // recomputes the boxes for moved primitives (same number and order as in
+    // build()), the parents precede their children in nodes()
+    void refit(const vec4f_t * bmin, const vec4f_t * bmax)
+    {
+        bounds_ = ipriv::bvh_box_t::empty();
+        if(nodes_.empty()) return;
+        std::vector<ipriv::bvh_box_t> node_box(nodes_.size());
+        for(size_t i = nodes_.size(); i-- > 0; ) {
+            node_t & nd = nodes_[i];
+            ipriv::bvh_box_t all = ipriv::bvh_box_t::empty();
+            for(unsigned c = 0; c < W; ++c) {
+                if(nd.child[c] < 0 && nd.count[c] == 0) continue;
+                ipriv::bvh_box_t cb = ipriv::bvh_box_t::empty();
+                if(nd.count[c]) {
+                    uint32_t first = uint32_t(~nd.child[c]);
+                    for(uint32_t j = first; j < first + nd.count[c]; ++j)
+                        cb.grow(bmin[prims_[j]], bmax[prims_[j]]);
+                } else {
+                    cb = node_box[size_t(nd.child[c])];
+                }
+                set_slot(nd, c, cb);
+                all.grow(cb);
+            }
+            node_box[i] = all;
+        }
+        bounds_ = node_box[0];
+    }
+
+    // closest hit: f(prim, t) intersects the primitive and returns true (with
+    // t reduced to the distance) if it's hit closer than t; returns true if
+    // any primitive was hit, tmax is the distance of the closest hit then
+    template<typename F>
+    bool intersect(const vec4f_t & origin, const vec4f_t & dir, float tmin, float & tmax, F f) const
+    { return traverse(origin, dir, tmin, tmax, f, false); }
+
+    // any hit: true as soon as one callback returns true
+    template<typename F>
+    bool occluded(const vec4f_t & origin, const vec4f_t & dir, float tmin, float tmax, F f) const
+    { return traverse(origin, dir, tmin, tmax, f, true); }
+
+    // f(prim) for the primitives of the leaves overlapping the box [qmin,qmax]
+    template<typename F>
+    void overlap(const vec4f_t & qmin, const vec4f_t & qmax, F f) const
+    {
+        if(nodes_.empty()) return;
+        using ipriv::geom_splat;
+        const V lx(geom_splat<V>(qmin[0])), ly(geom_splat<V>(qmin[1])), lz(geom_splat<V>(qmin[2]));
+        const V hx(geom_splat<V>(qmax[0])), hy(geom_splat<V>(qmax[1])), hz(geom_splat<V>(qmax[2]));
+        uint32_t stack[ipriv::bvh_max_depth * W + 1];
+        unsigned sp = 0;
+        stack[sp++] = 0;
+        while(sp) {
+            const node_t & nd = nodes_[stack[--sp]];
+            const box_packet_t<V> & b = nd.box;
+            unsigned bits =
+                mask_bits(
+                    ipriv::geom_lte(b.minx, hx) & ipriv::geom_lte(b.miny, hy) & ipriv::geom_lte(b.minz, hz) &
+                    ipriv::geom_gte(b.maxx, lx) & ipriv::geom_gte(b.maxy, ly) & ipriv::geom_gte(b.maxz, lz)
+                );
+            for(unsigned c = 0; bits; ++c, bits >>= 1) {
+                if(!(bits & 1)) continue;
+                if(nd.count[c]) {
+                    uint32_t first = uint32_t(~nd.child[c]);
+                    for(uint32_t j = first; j < first + nd.count[c]; ++j) f(prims_[j]);
+                } else if(nd.child[c] >= 0) {
+                    stack[sp++] = uint32_t(nd.child[c]);
+                }
+            }
+        }
+    }
+
+    const aligned_vector_t<node_t> & nodes() const { return nodes_; }
+    // primitive indices in leaf order
+    const std::vector<uint32_t> & prims() const { return prims_; }
+    bool empty() const { return nodes_.empty(); }
+    // bounds of all primitives
+    vec4f_t bounds_min() const { return bounds_.lo; }
+    vec4f_t bounds_max() const { return bounds_.hi; }
+
+private:
+    struct task_t
+    {
+        size_t node;
+        unsigned slot;
+        size_t begin, end;
+        ipriv::bvh_box_t box;
+        unsigned depth;
+    };
+
+    struct range_t
+    {
+        size_t begin, end;
+        ipriv::bvh_box_t box;
+    };
+
+    static void set_slot(node_t & nd, unsigned c, const ipriv::bvh_box_t & b)
+    {
+        nd.box.minx[c] = b.lo[0]; nd.box.miny[c] = b.lo[1]; nd.box.minz[c] = b.lo[2];
+        nd.box.maxx[c] = b.hi[0]; nd.box.maxy[c] = b.hi[1]; nd.box.maxz[c] = b.hi[2];
+    }
+    static void clear_slot(node_t & nd, unsigned c)
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        nd.box.minx[c] = nd.box.miny[c] = nd.box.minz[c] = inf;
+        nd.box.maxx[c] = nd.box.maxy[c] = nd.box.maxz[c] = inf;
+        nd.child[c] = -1;
+        nd.count[c] = 0;
+    }
+
+    struct builder_t
+    {
+        builder_t(const vec4f_t * lo, const vec4f_t * hi, unsigned leaf)
+            : bmin(lo), bmax(hi), prims(nullptr), leaf_size(leaf), task_size(0) {}
+
+        const vec4f_t * bmin;
+        const vec4f_t * bmax;
+        std::vector<vec4f_t> centroids;
+        uint32_t * prims;
+        unsigned leaf_size;
+        size_t task_size;
+        std::vector<task_t> tasks;
+
+        ipriv::bvh_box_t box_of(size_t begin, size_t end) const
+        {
+            ipriv::bvh_box_t b = ipriv::bvh_box_t::empty();
+            for(size_t i = begin; i < end; ++i) b.grow(bmin[prims[i]], bmax[prims[i]]);
+            return b;
+        }
+
+        // binned SAH split of [begin,end), returns the first index of the
+        // right part (begin or end if it can't be split)
+        size_t split(size_t begin, size_t end) const
+        {
+            using ipriv::bvh_bins;
+            ipriv::bvh_box_t cb = ipriv::bvh_box_t::empty();
+            for(size_t i = begin; i < end; ++i) cb.grow(centroids[prims[i]], centroids[prims[i]]);
+
+            float best_cost = std::numeric_limits<float>::infinity();
+            int best_axis = -1;
+            unsigned best_bin = 0;
+            for(int axis = 0; axis < 3; ++axis) {
+                float lo = cb.lo[axis], ext = cb.hi[axis] - lo;
+                if(!(ext > 0.0f)) continue;
+                float scale = float(bvh_bins) / ext;
+                ipriv::bvh_box_t bins[bvh_bins];
+                size_t count[bvh_bins] = { 0 };
+                for(unsigned k = 0; k < bvh_bins; ++k) bins[k] = ipriv::bvh_box_t::empty();
+                for(size_t i = begin; i < end; ++i) {
+                    uint32_t p = prims[i];
+                    unsigned k = std::min(bvh_bins - 1, unsigned((centroids[p][axis] - lo) * scale));
+                    bins[k].grow(bmin[p], bmax[p]);
+                    ++count[k];
+                }
+                // cost of the planes between bin k-1 and k: A(left) N(left) + A(right) N(right)
+                float right_cost[bvh_bins];
+                ipriv::bvh_box_t acc = ipriv::bvh_box_t::empty();
+                size_t n = 0;
+                for(unsigned k = bvh_bins; k-- > 1; ) {
+                    acc.grow(bins[k]);
+                    n += count[k];
+                    right_cost[k] = n ? acc.half_area() * float(n) : -1.0f;
+                }
+                acc = ipriv::bvh_box_t::empty();
+                n = 0;
+                for(unsigned k = 1; k < bvh_bins; ++k) {
+                    acc.grow(bins[k - 1]);
+                    n += count[k - 1];
+                    if(n == 0 || right_cost[k] < 0.0f) continue;
+                    float cost = acc.half_area() * float(n) + right_cost[k];
+                    if(cost < best_cost) { best_cost = cost; best_axis = axis; best_bin = k; }
+                }
+            }
+
+            if(best_axis < 0) {
+                // identical centroids: split in the middle
+                return begin + (end - begin) / 2;
+            }
+            float lo = cb.lo[best_axis], scale = float(bvh_bins) / (cb.hi[best_axis] - lo);
+            const std::vector<vec4f_t> & c = centroids;
+            uint32_t * mid =
+                std::partition(prims + begin, prims + end, [&](uint32_t p) {
+                    return std::min(bvh_bins - 1, unsigned((c[p][best_axis] - lo) * scale)) < best_bin;
+                });
+            return size_t(mid - prims);
+        }
+
+        // builds the node for [begin,end) with the bounds box, returns its
+        // index; top: defer the subtrees of at most task_size primitives
+        int32_t build(aligned_vector_t<node_t> & nodes, size_t begin, size_t end,
+                      const ipriv::bvh_box_t & box, unsigned depth, bool top)
+        {
+            // children: split the largest splittable one until there are W
+            range_t ch[W];
+            unsigned n = 1;
+            ch[0].begin = begin; ch[0].end = end; ch[0].box = box;
+            while(n < W) {
+                int pick = -1;
+                float area = -1.0f;
+                for(unsigned k = 0; k < n; ++k)
+                    if(ch[k].end - ch[k].begin > leaf_size && ch[k].box.half_area() > area) {
+                        area = ch[k].box.half_area();
+                        pick = int(k);
+                    }
+                if(pick < 0) break;
+                range_t r = ch[pick];
+                size_t mid = split(r.begin, r.end);
+                ch[pick].end = mid;
+                ch[pick].box = box_of(r.begin, mid);
+                ch[n].begin = mid; ch[n].end = r.end;
+                ch[n].box = box_of(mid, r.end);
+                ++n;
+            }
+
+            size_t index = nodes.size();
+            nodes.push_back(node_t());
+            for(unsigned c = 0; c < W; ++c) clear_slot(nodes[index], c);
+            for(unsigned c = 0; c < n; ++c) {
+                set_slot(nodes[index], c, ch[c].box);
+                size_t count = ch[c].end - ch[c].begin;
+                if(count <= leaf_size || depth + 1 >= ipriv::bvh_max_depth) {
+                    nodes[index].child[c] = ~int32_t(ch[c].begin);
+                    nodes[index].count[c] = uint32_t(count);
+                } else if(top && count <= task_size) {
+                    task_t t = { index, c, ch[c].begin, ch[c].end, ch[c].box, depth + 1 };
+                    tasks.push_back(t);
+                    nodes[index].count[c] = 0;
+                } else {
+                    int32_t child = build(nodes, ch[c].begin, ch[c].end, ch[c].box, depth + 1, top);
+                    nodes[index].child[c] = child;
+                    nodes[index].count[c] = 0;
+                }
+            }
+            return int32_t(index);
+        }
+    };
+
+    template<typename F>
+    bool traverse(const vec4f_t & origin, const vec4f_t & dir, float tmin, float & tmax, F & f, bool any) const
+    {
+        if(nodes_.empty()) return false;
+        const vec4f_t inv(1.0f / dir[0], 1.0f / dir[1], 1.0f / dir[2], 0.0f);
+        struct entry_t { uint32_t node; float t; };
+        entry_t stack[ipriv::bvh_max_depth * W + 1];
+        unsigned sp = 0;
+        stack[sp].node = 0; stack[sp].t = tmin; ++sp;
+        bool hit = false;
+        while(sp) {
+            entry_t e = stack[--sp];
+            if(e.t > tmax) continue; // behind the closest hit
+            const node_t & nd = nodes_[e.node];
+            V tn;
+            unsigned bits = mask_bits(ray_box(origin, inv, nd.box, tmin, tmax, tn));
+
+            // leaves first, the inner children sorted by entry distance
+            entry_t inner[W];
+            unsigned ni = 0;
+            for(unsigned c = 0; bits; ++c, bits >>= 1) {
+                if(!(bits & 1)) continue;
+                if(nd.count[c]) {
+                    uint32_t first = uint32_t(~nd.child[c]);
+                    for(uint32_t j = first; j < first + nd.count[c]; ++j)
+                        if(f(prims_[j], tmax)) {
+                            hit = true;
+                            if(any) return true;
+                        }
+                } else if(nd.child[c] >= 0) {
+                    entry_t ce = { uint32_t(nd.child[c]), tn[c] };
+                    unsigned k = ni++;
+                    for(; k > 0 && inner[k - 1].t < ce.t; --k) inner[k] = inner[k - 1];
+                    inner[k] = ce;
+                }
+            }
+            // farthest first, so the nearest is popped next
+            for(unsigned k = 0; k < ni; ++k) stack[sp++] = inner[k];
+        }
+        return hit;
+    }
+
+    aligned_vector_t<node_t> nodes_;
+    std::vector<uint32_t> prims_;
+    ipriv::bvh_box_t bounds_;
+};
+
+} // namespace math
+
+#endif // PBVH_H
@@ -0,0 +1,445 @@
+/*******************************************************************************
+ * pcomplex.h                                                                  *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PCOMPLEX_H
+#define PCOMPLEX_H
+
+#include <pvecf.h>
+#include <stddef.h>
+#include <string.h>
+#include <complex>
+
+
+/*
+complex numbers
+---------------
+complex_t<R,N,P> holds N complex numbers interleaved {re0,im0,re1,im1,..} in
+one register, the memory layout of std::complex<R> arrays:
+
+  complex2d_t   1 x std::complex<double>   __m128d (SSE2)
+  complex4f_t   2 x std::complex<float>    __m128
+  complex8f_t   4 x std::complex<float>    __m256 (AVX)
+
+  complex4f_t z(re, im)          all N numbers set to re + im i
+  z.loadu(const std::complex<R> *), z.storeu(std::complex<R> *)
+  z.get(k), z.set(k, c)          single numbers as std::complex<R>
+
+  + - * /, * and / by a real, +=, -=, *=, /=
+  conj(z)            re - im i
+  norm(z)            |z|^2
+  abs(z)             |z| (math_t::sqrt_packed(): for float the 1/sqrt estimate
+                     with a Newton step, relative error about 1e-7)
+  arg(z)             the phase in [-pi,pi], a polynomial atan2 with an absolute
+                     error below 2e-6 (for double as well)
+  mul_add(a, b, c)   a * b + c
+
+  norm(), abs() and arg() return complex numbers with the value in re and
+  zero in im, so they can be used in further complex arithmetic
+
+multiplication: the real and imaginary parts of a duplicated (moveldup/
+movehdup with SSE3, shuffles otherwise), the products combined by
+fmaddsub (FMA), addsubps/addsubpd (SSE3) or an xor of the sign and an add;
+division: a * conj(b) / |b|^2 (no scaling: |b|^2 over- or underflows for
+|b| beyond about 1e19 or below 1e-19 with float, unlike std::complex which
+may scale)
+
+array kernels (std::complex<float> with complex8f_t on AVX, complex4f_t
+otherwise, std::complex<double> with complex2d_t):
+  cmul_many(dst, a, b, n)        dst[i] = a[i] * b[i]
+  cmac_many(acc, a, b, n)        acc[i] += a[i] * b[i]
+  norm_many(dst, src, n)         dst[i] = |src[i]|^2 (real arrays, power spectrum)
+  abs_many(dst, src, n)          dst[i] = |src[i]| (magnitude spectrum)
+  arg_many(dst, src, n)          dst[i] = arg(src[i]) (phase spectrum)
+  dst may be one of the sources
+*/
+
+// TODO:
+// - ARM NEON (vld2q_f32 de-interleaves for free)
+// - complex4d_t (__m256d)
+// - AVX-512 (vfmaddsub on 16 floats)
+
+
+namespace math {
+
+#if defined(PVECF_INTEL)
+
+namespace ipriv {
+
+    // the complex specific operations on the packed types, interleaved
+    // {re,im} pairs; the element wise arithmetic, logic and comparisons are
+    // the ones of math_t (operators +-*/ and math_t<R,P>::*_packed())
+    template<typename P> struct cplx_simd_t;
+
+    template<> struct cplx_simd_t<__m128>
+    {
+        typedef float real_t;
+        typedef math::math_t<float,__m128> math_t;
+        static const unsigned N = 2;
+
+        static inline __m128 set(float re, float im) { return _mm_setr_ps(re, im, re, im); }
+        static inline __m128 loadu(const float * p) { return _mm_loadu_ps(p); }
+        static inline void storeu(float * p, __m128 v) { _mm_storeu_ps(p, v); }
+
+        // {-0,0,..}: sign of the re lanes, {0,-0,..}: sign of the im lanes
+        static inline __m128 sign_re() { return _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f); }
+        static inline __m128 sign_im() { return _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f); }
+        // all bits set in the re lanes
+        static inline __m128 re_mask() { return _mm_cmplt_ps(_mm_setr_ps(-1.0f, 0.0f, -1.0f, 0.0f), _mm_setzero_ps()); }
+
+        // {re,re,..}, {im,im,..}, {im,re,..}
+#if defined(SSE3)
+        static inline __m128 dup_re(__m128 a) { return _mm_moveldup_ps(a); }
+        static inline __m128 dup_im(__m128 a) { return _mm_movehdup_ps(a); }
+#else
+        static inline __m128 dup_re(__m128 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,2,0,0)); }
+        static inline __m128 dup_im(__m128 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3,3,1,1)); }
+#endif
+        static inline __m128 swap(__m128 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1)); }
+
+        // a * b - c in the re lanes, a * b + c in the im lanes
+        static inline __m128 mul_addsub(__m128 a, __m128 b, __m128 c)
+#if defined(FMA)
+        { return _mm_fmaddsub_ps(a, b, c); }
+#elif defined(SSE3)
+        { return _mm_addsub_ps(_mm_mul_ps(a, b), c); }
+#else
+        { return _mm_add_ps(_mm_mul_ps(a, b), _mm_xor_ps(c, sign_re())); }
+#endif
+    };
+
+# if defined(SSE2) || defined(AVX)
+    template<> struct cplx_simd_t<__m128d>
+    {
+        typedef double real_t;
+        typedef math::math_t<double,__m128d> math_t;
+        static const unsigned N = 1;
+
+        static inline __m128d set(double re, double im) { return _mm_setr_pd(re, im); }
+        static inline __m128d loadu(const double * p) { return _mm_loadu_pd(p); }
+        static inline void storeu(double * p, __m128d v) { _mm_storeu_pd(p, v); }
+
+        static inline __m128d sign_re() { return _mm_setr_pd(-0.0, 0.0); }
+        static inline __m128d sign_im() { return _mm_setr_pd(0.0, -0.0); }
+        static inline __m128d re_mask() { return _mm_cmplt_pd(_mm_setr_pd(-1.0, 0.0), _mm_setzero_pd()); }
+
+#if defined(SSE3)
+        static inline __m128d dup_re(__m128d a) { return _mm_movedup_pd(a); }
+#else
+        static inline __m128d dup_re(__m128d a) { return _mm_unpacklo_pd(a, a); }
+#endif
+        static inline __m128d dup_im(__m128d a) { return _mm_unpackhi_pd(a, a); }
+        static inline __m128d swap(__m128d a) { return _mm_shuffle_pd(a, a, 1); }
+
+        static inline __m128d mul_addsub(__m128d a, __m128d b, __m128d c)
+#if defined(FMA)
+        { return _mm_fmaddsub_pd(a, b, c); }
+#elif defined(SSE3)
+        { return _mm_addsub_pd(_mm_mul_pd(a, b), c); }
+#else
+        { return _mm_add_pd(_mm_mul_pd(a, b), _mm_xor_pd(c, sign_re())); }
+#endif
+    };
+# endif // defined(SSE2) || defined(AVX)
+
+# if defined(AVX)
+    template<> struct cplx_simd_t<__m256>
+    {
+        typedef float real_t;
+        typedef math::math_t<float,__m256> math_t;
+        static const unsigned N = 4;
+
+        static inline __m256 set(float re, float im) { return _mm256_setr_ps(re, im, re, im, re, im, re, im); }
+        static inline __m256 loadu(const float * p) { return _mm256_loadu_ps(p); }
+        static inline void storeu(float * p, __m256 v) { _mm256_storeu_ps(p, v); }
+
+        static inline __m256 sign_re() { return _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f); }
+        static inline __m256 sign_im() { return _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f); }
+        static inline __m256 re_mask() { return _mm256_cmp_ps(_mm256_setr_ps(-1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f), _mm256_setzero_ps(), _CMP_LT_OQ); }
+
+        static inline __m256 dup_re(__m256 a) { return _mm256_moveldup_ps(a); }
+        static inline __m256 dup_im(__m256 a) { return _mm256_movehdup_ps(a); }
+        static inline __m256 swap(__m256 a) { return _mm256_permute_ps(a, _MM_SHUFFLE(2,3,0,1)); }
+
+        static inline __m256 mul_addsub(__m256 a, __m256 b, __m256 c)
+#if defined(FMA)
+        { return _mm256_fmaddsub_ps(a, b, c); }
+#else
+        { return _mm256_addsub_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    };
+# endif // defined(AVX)
+
+    // sqrt(x) of x >= 0 per math_t::sqrt_packed(), x * 1/sqrt(x), with the
+    // 0 * inf of x == 0 masked out
+    template<typename S, typename P>
+    inline P cplx_sqrt(P x)
+    {
+        typedef typename S::math_t M;
+        return M::and_packed(M::sqrt_packed(x), M::cmpgt_packed(x, M::zeroes()));
+    }
+
+    // a where m is set, b elsewhere
+    template<typename S, typename P>
+    inline P cplx_select(P m, P a, P b)
+    {
+        typedef typename S::math_t M;
+        return M::xor_packed(b, M::and_packed(m, M::xor_packed(a, b)));
+    }
+
+    // atan2(y, x) per lane: atan of min/max on [0,1] (odd polynomial,
+    // |error| < 1.7e-6), then the octant and quadrant corrections
+    template<typename S, typename P>
+    inline P cplx_atan2(P y, P x)
+    {
+        typedef typename S::real_t R;
+        typedef typename S::math_t M;
+        const P zero(M::zeroes());
+        const P ax(M::and_packed(M::abs_mask(), x)), ay(M::and_packed(M::abs_mask(), y));
+        const P mn(M::min_packed(ax, ay)), mx(M::max_packed(ax, ay));
+        // atan2(0, 0) = 0: the NaN of 0/0 masked out
+        const P r(M::and_packed(mn / mx, M::cmpgt_packed(mx, zero)));
+        const P s(r * r);
+        P p(M::set1(R(-0.01172120)));
+        p = M::mul_add(p, s, M::set1(R(0.05265332)));
+        p = M::mul_add(p, s, M::set1(R(-0.11643287)));
+        p = M::mul_add(p, s, M::set1(R(0.19354346)));
+        p = M::mul_add(p, s, M::set1(R(-0.33262347)));
+        p = M::mul_add(p, s, M::set1(R(0.99997726)));
+        P a(p * r);
+        a = cplx_select<S>(M::cmpgt_packed(ay, ax), M::set1(R(1.57079632679489661923)) - a, a);
+        a = cplx_select<S>(M::cmplt_packed(x, zero), M::set1(R(3.14159265358979323846)) - a, a);
+        return M::xor_packed(a, M::and_packed(M::sign_mask(), y));
+    }
+
+} // namespace ipriv
+
+
+template<typename R, unsigned t_n, typename P>
+class complex_t
+{
+public:
+    typedef R real_t;
+    typedef P packed_t;
+    typedef ipriv::cplx_simd_t<P> simd_t;
+    typedef typename simd_t::math_t math_t;
+    static const unsigned N = t_n; // complex numbers
+
+    complex_t() { p = math_t::zeroes(); }
+    explicit complex_t(packed_t v) { p = v; }
+    explicit complex_t(real_t re, real_t im = real_t(0)) { p = simd_t::set(re, im); }
+    explicit complex_t(const std::complex<real_t> & c) { p = simd_t::set(c.real(), c.imag()); }
+
+    inline void loadu(const std::complex<real_t> * c) { p = simd_t::loadu(reinterpret_cast<const real_t *>(c)); }
+    inline void storeu(std::complex<real_t> * c) const { simd_t::storeu(reinterpret_cast<real_t *>(c), p); }
+
+    inline std::complex<real_t> get(unsigned k) const { return std::complex<real_t>(v[2 * k], v[2 * k + 1]); }
+    inline void set(unsigned k, const std::complex<real_t> & c) { v[2 * k] = c.real(); v[2 * k + 1] = c.imag(); }
+    inline real_t re(unsigned k) const { return v[2 * k]; }
+    inline real_t im(unsigned k) const { return v[2 * k + 1]; }
+
+    inline complex_t & operator+=(const complex_t & z) { p = p + z.p; return *this; }
+    inline complex_t & operator-=(const complex_t & z) { p = p - z.p; return *this; }
+    inline complex_t & operator*=(const complex_t & z) { p = mul(p, z.p); return *this; }
+    inline complex_t & operator/=(const complex_t & z)
+    { p = mul(p, math_t::xor_packed(z.p, simd_t::sign_im())) / norm_dup(z.p); return *this; }
+    inline complex_t & operator*=(real_t s) { p = p * math_t::set1(s); return *this; }
+    inline complex_t & operator/=(real_t s) { p = p / math_t::set1(s); return *this; }
+
+    // a * b
+    static inline packed_t mul(packed_t a, packed_t b)
+    { return simd_t::mul_addsub(simd_t::dup_re(a), b, simd_t::dup_im(a) * simd_t::swap(b)); }
+    // a * b + c
+    static inline packed_t mul_add(packed_t a, packed_t b, packed_t c)
+    { return mul(a, b) + c; }
+    // |a|^2 in re and im
+    static inline packed_t norm_dup(packed_t a)
+    { packed_t m = a * a; return m + simd_t::swap(m); }
+
+    union {
+        packed_t p;
+        real_t v[2 * t_n];
+    };
+};
+
+typedef complex_t<float,2,__m128> complex4f_t;
+# if defined(SSE2) || defined(AVX)
+typedef complex_t<double,1,__m128d> complex2d_t;
+# endif
+# if defined(AVX)
+typedef complex_t<float,4,__m256> complex8f_t;
+# endif
+
+
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator+(const complex_t<R,N,P> & a, const complex_t<R,N,P> & b)
+{ return complex_t<R,N,P>(a) += b; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator-(const complex_t<R,N,P> & a, const complex_t<R,N,P> & b)
+{ return complex_t<R,N,P>(a) -= b; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator*(const complex_t<R,N,P> & a, const complex_t<R,N,P> & b)
+{ return complex_t<R,N,P>(a) *= b; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator/(const complex_t<R,N,P> & a, const complex_t<R,N,P> & b)
+{ return complex_t<R,N,P>(a) /= b; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator*(const complex_t<R,N,P> & a, R s) { return complex_t<R,N,P>(a) *= s; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator*(R s, const complex_t<R,N,P> & a) { return complex_t<R,N,P>(a) *= s; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator/(const complex_t<R,N,P> & a, R s) { return complex_t<R,N,P>(a) /= s; }
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> operator-(const complex_t<R,N,P> & a)
+{ typedef typename complex_t<R,N,P>::math_t M; return complex_t<R,N,P>(M::xor_packed(a.p, M::sign_mask())); }
+
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> conj(const complex_t<R,N,P> & a)
+{
+    typedef typename complex_t<R,N,P>::simd_t S;
+    return complex_t<R,N,P>(S::math_t::xor_packed(a.p, S::sign_im()));
+}
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> norm(const complex_t<R,N,P> & a)
+{
+    typedef typename complex_t<R,N,P>::simd_t S;
+    return complex_t<R,N,P>(S::math_t::and_packed(S::re_mask(), complex_t<R,N,P>::norm_dup(a.p)));
+}
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> abs(const complex_t<R,N,P> & a)
+{
+    typedef typename complex_t<R,N,P>::simd_t S;
+    return complex_t<R,N,P>(S::math_t::and_packed(S::re_mask(), ipriv::cplx_sqrt<S>(complex_t<R,N,P>::norm_dup(a.p))));
+}
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> arg(const complex_t<R,N,P> & a)
+{
+    typedef typename complex_t<R,N,P>::simd_t S;
+    return complex_t<R,N,P>(S::math_t::and_packed(S::re_mask(), ipriv::cplx_atan2<S>(S::dup_im(a.p), S::dup_re(a.p))));
+}
+template<typename R, unsigned N, typename P>
+inline complex_t<R,N,P> mul_add(const complex_t<R,N,P> & a, const complex_t<R,N,P> & b, const complex_t<R,N,P> & c)
+{ return complex_t<R,N,P>(complex_t<R,N,P>::mul_add(a.p, b.p, c.p)); }
+
+
+namespace ipriv {
+
+    // widest complex_t for the arrays
+    template<typename R> struct cplx_array_t;
+# if defined(AVX)
+    template<> struct cplx_array_t<float> { typedef complex8f_t type; };
+# else
+    template<> struct cplx_array_t<float> { typedef complex4f_t type; };
+# endif
+# if defined(SSE2) || defined(AVX)
+    template<> struct cplx_array_t<double> { typedef complex2d_t type; };
+# endif
+
+    // real results, SoA: the re and im parts of two registers
+    template<typename R> struct cplx_real_t;
+    template<> struct cplx_real_t<float> { typedef __m128 packed_t; };
+# if defined(SSE2) || defined(AVX)
+    template<> struct cplx_real_t<double> { typedef __m128d packed_t; };
+# endif
+
+    inline void cplx_split(__m128 a, __m128 b, __m128 & re, __m128 & im)
+    { re = xzxz(a, b); im = ywyw(a, b); }
+# if defined(SSE2) || defined(AVX)
+    inline void cplx_split(__m128d a, __m128d b, __m128d & re, __m128d & im)
+    { re = _mm_unpacklo_pd(a, b); im = _mm_unpackhi_pd(a, b); }
+# endif
+
+    // dst[i] = f(re, im), L = 4 (float) or 2 (double) numbers per step
+    template<typename R, typename F>
+    inline void cplx_real_many(R * dst, const std::complex<R> * src, size_t n, F f)
+    {
+        typedef typename cplx_real_t<R>::packed_t P;
+        typedef cplx_simd_t<P> S;
+        const unsigned L = sizeof(P) / sizeof(R);
+        const R * s = reinterpret_cast<const R *>(src);
+        P re, im;
+        size_t i = 0;
+        for(; i + L <= n; i += L) {
+            cplx_split(S::loadu(s + 2 * i), S::loadu(s + 2 * i + L), re, im);
+            S::storeu(dst + i, f(re, im));
+        }
+        if(i < n) {
+            R t[2 * L], o[L];
+            memset(t, 0, sizeof(t));
+            memcpy(t, s + 2 * i, 2 * (n - i) * sizeof(R));
+            cplx_split(S::loadu(t), S::loadu(t + L), re, im);
+            S::storeu(o, f(re, im));
+            memcpy(dst + i, o, (n - i) * sizeof(R));
+        }
+    }
+
+} // namespace ipriv
+
+
+// dst[i] = a[i] * b[i]
+template<typename R>
+inline void cmul_many(std::complex<R> * dst, const std::complex<R> * a, const std::complex<R> * b, size_t n)
+{
+    typedef typename ipriv::cplx_array_t<R>::type C;
+    size_t i = 0;
+    C x, y;
+    for(; i + C::N <= n; i += C::N) {
+        x.loadu(a + i); y.loadu(b + i);
+        (x * y).storeu(dst + i);
+    }
+    for(; i < n; ++i) dst[i] = (C(a[i]) * C(b[i])).get(0);
+}
+
+// acc[i] += a[i] * b[i]
+template<typename R>
+inline void cmac_many(std::complex<R> * acc, const std::complex<R> * a, const std::complex<R> * b, size_t n)
+{
+    typedef typename ipriv::cplx_array_t<R>::type C;
+    size_t i = 0;
+    C x, y, z;
+    for(; i + C::N <= n; i += C::N) {
+        x.loadu(a + i); y.loadu(b + i); z.loadu(acc + i);
+        mul_add(x, y, z).storeu(acc + i);
+    }
+    for(; i < n; ++i) acc[i] = mul_add(C(a[i]), C(b[i]), C(acc[i])).get(0);
+}
+
+// dst[i] = |src[i]|^2
+template<typename R>
+inline void norm_many(R * dst, const std::complex<R> * src, size_t n)
+{
+    typedef typename ipriv::cplx_real_t<R>::packed_t P;
+    typedef typename ipriv::cplx_simd_t<P>::math_t M;
+    ipriv::cplx_real_many(dst, src, n, [](P re, P im) { return M::mul_add(re, re, im * im); });
+}
+
+// dst[i] = |src[i]|
+template<typename R>
+inline void abs_many(R * dst, const std::complex<R> * src, size_t n)
+{
+    typedef typename ipriv::cplx_real_t<R>::packed_t P;
+    typedef ipriv::cplx_simd_t<P> S;
+    ipriv::cplx_real_many(dst, src, n, [](P re, P im) { return ipriv::cplx_sqrt<S>(S::math_t::mul_add(re, re, im * im)); });
+}
+
+// dst[i] = arg(src[i])
+template<typename R>
+inline void arg_many(R * dst, const std::complex<R> * src, size_t n)
+{
+    typedef typename ipriv::cplx_real_t<R>::packed_t P;
+    typedef ipriv::cplx_simd_t<P> S;
+    ipriv::cplx_real_many(dst, src, n, [](P re, P im) { return ipriv::cplx_atan2<S>(im, re); });
+}
+
+#else
+#error "pcomplex.h: x86 (SSE/AVX) only for now"
+#endif // defined(PVECF_INTEL)
+
+} // namespace math
+
+#endif // PCOMPLEX_H
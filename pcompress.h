@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * pcompress.h                                                                 *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PCOMPRESS_H
+#define PCOMPRESS_H
+
+#include <pvecf.h>
+#include <pveci.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+
+/*
+stream compaction (left-packing)
+--------------------------------
+compress_store(mask, v, out) stores the elements of v whose mask lanes are set
+(all bits set, as returned by cmp_*() or the integer comparisons) contiguously
+to out and returns their number; mask_bits(mask) returns the lanes as bit mask
+(lane i -> bit i), compress_store(bits, v, out) takes such a bit mask
+
+  the whole vector is stored, so out needs room for N elements, the elements
+  past the returned count are unspecified
+
+array kernels (no branches on the data, dst needs room for n elements):
+  filter_many<V>(dst, src, n, pred)  keeps src[i] where pred(V) sets the lane
+  compress_many(dst, src, keep, n)   keeps src[i] where keep[i] != 0
+  both return the number of elements written to dst
+
+instruction set tiers (32 bit elements, 64 bit ones accordingly):
+  SSE2:      element-wise stores, the output index advanced per mask bit
+  SSSE3:     pshufb with a 16 entry shuffle table
+  AVX2:      vpermps/vpermd with a 256 entry index table (8 x 32 bit)
+  AVX512VL:  vcompressps/vpcompressd/vcompresspd/vpcompressq
+  NEON:      tbl (vqtbl1q_u8) with the shuffle table on AArch64, element-wise
+             stores on ARMv7
+
+supported types: vec4f_t, vec2d_t, vec8f_t, veci_[u]i32x4_t, veci_[u]i64x2_t,
+veci_[u]i32x8_t (AVX2), all other vector types use the element-wise fallback
+*/
+
+// TODO:
+// - 8/16 bit elements (pshufb tables for 8 lanes, two passes for 16 lanes)
+
+
+namespace math {
+
+namespace ipriv {
+
+    // lane of a comparison result set?
+    template<typename E> inline bool lane_set(E e)
+    {
+        typedef typename std::conditional<sizeof(E) == 8, uint64_t,
+                typename std::conditional<sizeof(E) == 4, uint32_t,
+                typename std::conditional<sizeof(E) == 2, uint16_t, uint8_t>::type>::type>::type bits_t;
+        bits_t b;
+        memcpy(&b, &e, sizeof(b));
+        return b != 0;
+    }
+
+    inline unsigned popcount8(unsigned bits)
+    {
+        static const unsigned char pop4[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+        return unsigned(pop4[bits & 0xF] + pop4[(bits >> 4) & 0xF]);
+    }
+
+    // byte shuffles left-packing the 32 bit lanes selected by 4 mask bits
+    // (128: zero the byte)
+    inline const uint8_t * compress_shuffle_32x4(unsigned bits)
+    {
+        static const uint8_t lut[16][16] = {
+            { 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   4,   5,   6,   7, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,   4,   5,   6,   7, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   8,   9,  10,  11, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,   8,   9,  10,  11, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   4,   5,   6,   7,   8,   9,  10,  11, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11, 128, 128, 128, 128 },
+            {  12,  13,  14,  15, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,  12,  13,  14,  15, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   4,   5,   6,   7,  12,  13,  14,  15, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,   4,   5,   6,   7,  12,  13,  14,  15, 128, 128, 128, 128 },
+            {   8,   9,  10,  11,  12,  13,  14,  15, 128, 128, 128, 128, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,   8,   9,  10,  11,  12,  13,  14,  15, 128, 128, 128, 128 },
+            {   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15, 128, 128, 128, 128 },
+            {   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15 }
+        };
+        return lut[bits];
+    }
+
+    // element-wise fallback: out[k] = v[i], k advanced per mask bit
+    template<size_t S> inline void compress_scalar(unsigned bits, const void * v, unsigned n, void * out)
+    {
+        const char * s = static_cast<const char *>(v);
+        char * o = static_cast<char *>(out);
+        size_t k = 0;
+        for(unsigned i = 0; i < n; ++i) {
+            memcpy(o + k * S, s + i * S, S);
+            k += (bits >> i) & 1;
+        }
+    }
+
+#if defined(PVECF_INTEL)
+
+    inline unsigned mask_bits_ps(__m128 m) { return unsigned(_mm_movemask_ps(m)); }
+
+    inline void compress_ps(unsigned bits, __m128 v, void * out)
+    {
+# if defined(AVX512VL)
+        _mm_storeu_ps(static_cast<float *>(out), _mm_maskz_compress_ps(__mmask8(bits), v));
+# elif defined(SSSE3)
+        __m128i shuf = _mm_loadu_si128(reinterpret_cast<const __m128i *>(compress_shuffle_32x4(bits)));
+        _mm_storeu_si128(static_cast<__m128i *>(out), _mm_shuffle_epi8(_mm_castps_si128(v), shuf));
+# else
+        float t[4];
+        _mm_storeu_ps(t, v);
+        compress_scalar<4>(bits, t, 4, out);
+# endif
+    }
+
+# if defined(SSE2) || defined(AVX)
+    inline unsigned mask_bits_pd(__m128d m) { return unsigned(_mm_movemask_pd(m)); }
+
+    inline void compress_pd(unsigned bits, __m128d v, void * out)
+    {
+#  if defined(AVX512VL)
+        _mm_storeu_pd(static_cast<double *>(out), _mm_maskz_compress_pd(__mmask8(bits), v));
+#  else
+        // only {0,1} needs a move: lane 1 to lane 0
+        __m128d sel = _mm_castsi128_pd(_mm_set1_epi32(-int(bits == 2)));
+        _mm_storeu_pd(static_cast<double *>(out),
+                      _mm_or_pd(_mm_and_pd(sel, _mm_unpackhi_pd(v, v)), _mm_andnot_pd(sel, v)));
+#  endif
+    }
+# endif // SSE2 || AVX
+
+# if defined(AVX) || defined(AVX2)
+    inline unsigned mask_bits_ps256(__m256 m) { return unsigned(_mm256_movemask_ps(m)); }
+
+    // packed lane indices (4 bits each) left-packing the lanes selected by
+    // 8 mask bits
+    inline uint32_t compress_index_32x8(unsigned bits)
+    {
+        static const uint32_t lut[256] = {
+            0x00000000, 0x00000000, 0x00000001, 0x00000010, 0x00000002, 0x00000020, 0x00000021, 0x00000210,
+            0x00000003, 0x00000030, 0x00000031, 0x00000310, 0x00000032, 0x00000320, 0x00000321, 0x00003210,
+            0x00000004, 0x00000040, 0x00000041, 0x00000410, 0x00000042, 0x00000420, 0x00000421, 0x00004210,
+            0x00000043, 0x00000430, 0x00000431, 0x00004310, 0x00000432, 0x00004320, 0x00004321, 0x00043210,
+            0x00000005, 0x00000050, 0x00000051, 0x00000510, 0x00000052, 0x00000520, 0x00000521, 0x00005210,
+            0x00000053, 0x00000530, 0x00000531, 0x00005310, 0x00000532, 0x00005320, 0x00005321, 0x00053210,
+            0x00000054, 0x00000540, 0x00000541, 0x00005410, 0x00000542, 0x00005420, 0x00005421, 0x00054210,
+            0x00000543, 0x00005430, 0x00005431, 0x00054310, 0x00005432, 0x00054320, 0x00054321, 0x00543210,
+            0x00000006, 0x00000060, 0x00000061, 0x00000610, 0x00000062, 0x00000620, 0x00000621, 0x00006210,
+            0x00000063, 0x00000630, 0x00000631, 0x00006310, 0x00000632, 0x00006320, 0x00006321, 0x00063210,
+            0x00000064, 0x00000640, 0x00000641, 0x00006410, 0x00000642, 0x00006420, 0x00006421, 0x00064210,
+            0x00000643, 0x00006430, 0x00006431, 0x00064310, 0x00006432, 0x00064320, 0x00064321, 0x00643210,
+            0x00000065, 0x00000650, 0x00000651, 0x00006510, 0x00000652, 0x00006520, 0x00006521, 0x00065210,
+            0x00000653, 0x00006530, 0x00006531, 0x00065310, 0x00006532, 0x00065320, 0x00065321, 0x00653210,
+            0x00000654, 0x00006540, 0x00006541, 0x00065410, 0x00006542, 0x00065420, 0x00065421, 0x00654210,
+            0x00006543, 0x00065430, 0x00065431, 0x00654310, 0x00065432, 0x00654320, 0x00654321, 0x06543210,
+            0x00000007, 0x00000070, 0x00000071, 0x00000710, 0x00000072, 0x00000720, 0x00000721, 0x00007210,
+            0x00000073, 0x00000730, 0x00000731, 0x00007310, 0x00000732, 0x00007320, 0x00007321, 0x00073210,
+            0x00000074, 0x00000740, 0x00000741, 0x00007410, 0x00000742, 0x00007420, 0x00007421, 0x00074210,
+            0x00000743, 0x00007430, 0x00007431, 0x00074310, 0x00007432, 0x00074320, 0x00074321, 0x00743210,
+            0x00000075, 0x00000750, 0x00000751, 0x00007510, 0x00000752, 0x00007520, 0x00007521, 0x00075210,
+            0x00000753, 0x00007530, 0x00007531, 0x00075310, 0x00007532, 0x00075320, 0x00075321, 0x00753210,
+            0x00000754, 0x00007540, 0x00007541, 0x00075410, 0x00007542, 0x00075420, 0x00075421, 0x00754210,
+            0x00007543, 0x00075430, 0x00075431, 0x00754310, 0x00075432, 0x00754320, 0x00754321, 0x07543210,
+            0x00000076, 0x00000760, 0x00000761, 0x00007610, 0x00000762, 0x00007620, 0x00007621, 0x00076210,
+            0x00000763, 0x00007630, 0x00007631, 0x00076310, 0x00007632, 0x00076320, 0x00076321, 0x00763210,
+            0x00000764, 0x00007640, 0x00007641, 0x00076410, 0x00007642, 0x00076420, 0x00076421, 0x00764210,
+            0x00007643, 0x00076430, 0x00076431, 0x00764310, 0x00076432, 0x00764320, 0x00764321, 0x07643210,
+            0x00000765, 0x00007650, 0x00007651, 0x00076510, 0x00007652, 0x00076520, 0x00076521, 0x00765210,
+            0x00007653, 0x00076530, 0x00076531, 0x00765310, 0x00076532, 0x00765320, 0x00765321, 0x07653210,
+            0x00007654, 0x00076540, 0x00076541, 0x00765410, 0x00076542, 0x00765420, 0x00765421, 0x07654210,
+            0x00076543, 0x00765430, 0x00765431, 0x07654310, 0x00765432, 0x07654320, 0x07654321, 0x76543210
+        };
+        return lut[bits];
+    }
+
+    inline void compress_ps256(unsigned bits, __m256 v, void * out)
+    {
+#  if defined(AVX512VL)
+        _mm256_storeu_ps(static_cast<float *>(out), _mm256_maskz_compress_ps(__mmask8(bits), v));
+#  elif defined(AVX2)
+        __m256i idx = _mm256_srlv_epi32(_mm256_set1_epi32(int(compress_index_32x8(bits))),
+                                        _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28));
+        _mm256_storeu_ps(static_cast<float *>(out), _mm256_permutevar8x32_ps(v, idx));
+#  else
+        float t[8];
+        _mm256_storeu_ps(t, v);
+        compress_scalar<4>(bits, t, 8, out);
+#  endif
+    }
+# endif // AVX || AVX2
+
+#elif defined(PVECF_ARM)
+
+    inline unsigned mask_bits_u32(uint32x4_t m)
+    {
+        static const int32_t shifts[4] = { 0, 1, 2, 3 };
+        uint32x4_t b = vshlq_u32(vshrq_n_u32(m, 31), vld1q_s32(shifts));
+# if defined(__aarch64__)
+        return vaddvq_u32(b);
+# else
+        uint32x2_t s = vpadd_u32(vget_low_u32(b), vget_high_u32(b));
+        return vget_lane_u32(vpadd_u32(s, s), 0);
+# endif
+    }
+    inline unsigned mask_bits_u64(uint64x2_t m)
+    { return unsigned(vgetq_lane_u64(m, 0) >> 63) | unsigned(vgetq_lane_u64(m, 1) >> 63) << 1; }
+
+    inline void compress_u32(unsigned bits, uint32x4_t v, void * out)
+    {
+# if defined(__aarch64__)
+        vst1q_u8(static_cast<uint8_t *>(out),
+                 vqtbl1q_u8(vreinterpretq_u8_u32(v), vld1q_u8(compress_shuffle_32x4(bits))));
+# else
+        uint32_t t[4];
+        vst1q_u32(t, v);
+        compress_scalar<4>(bits, t, 4, out);
+# endif
+    }
+    inline void compress_u64(unsigned bits, uint64x2_t v, void * out)
+    {
+        uint64_t t[2];
+        vst1q_u64(t, v);
+        compress_scalar<8>(bits, t, 2, out);
+    }
+
+#endif // PVECF_ARM
+
+} // namespace ipriv
+
+
+//
+// element-wise fallback for all vector types
+//
+template<typename V>
+inline unsigned mask_bits(const V & mask)
+{
+    unsigned bits = 0;
+    for(unsigned i = 0; i < V::N; ++i)
+        bits |= unsigned(ipriv::lane_set(mask[i])) << i;
+    return bits;
+}
+template<typename V>
+inline size_t compress_store(unsigned bits, const V & v, typename ipriv::vec_elem<V>::type * out)
+{
+    typedef typename ipriv::vec_elem<V>::type elem_t;
+    elem_t t[V::N];
+    for(unsigned i = 0; i < V::N; ++i) t[i] = v[i];
+    ipriv::compress_scalar<sizeof(elem_t)>(bits, t, V::N, out);
+    size_t k = 0;
+    for(unsigned i = 0; i < V::N; ++i) k += (bits >> i) & 1;
+    return k;
+}
+template<typename V>
+inline size_t compress_store(const V & mask, const V & v, typename ipriv::vec_elem<V>::type * out)
+{ return compress_store(mask_bits(mask), v, out); }
+
+
+#if defined(PVECF_INTEL)
+
+inline unsigned mask_bits(const vec4f_t & mask)
+{ return ipriv::mask_bits_ps(mask.p); }
+inline size_t compress_store(unsigned bits, const vec4f_t & v, float * out)
+{ ipriv::compress_ps(bits, v.p, out); return ipriv::popcount8(bits); }
+inline size_t compress_store(const vec4f_t & mask, const vec4f_t & v, float * out)
+{ return compress_store(mask_bits(mask), v, out); }
+
+# if defined(SSE2) || defined(AVX)
+inline unsigned mask_bits(const vec2d_t & mask)
+{ return ipriv::mask_bits_pd(mask.p); }
+inline size_t compress_store(unsigned bits, const vec2d_t & v, double * out)
+{ ipriv::compress_pd(bits, v.p, out); return ipriv::popcount8(bits); }
+inline size_t compress_store(const vec2d_t & mask, const vec2d_t & v, double * out)
+{ return compress_store(mask_bits(mask), v, out); }
+
+#  define PCOMPRESS_32X4_(V,T) \
+inline unsigned mask_bits(const V & mask) \
+{ return ipriv::mask_bits_ps(_mm_castsi128_ps(mask.p)); } \
+inline size_t compress_store(unsigned bits, const V & v, T * out) \
+{ ipriv::compress_ps(bits, _mm_castsi128_ps(v.p), out); return ipriv::popcount8(bits); } \
+inline size_t compress_store(const V & mask, const V & v, T * out) \
+{ return compress_store(mask_bits(mask), v, out); }
+#  define PCOMPRESS_64X2_(V,T) \
+inline unsigned mask_bits(const V & mask) \
+{ return ipriv::mask_bits_pd(_mm_castsi128_pd(mask.p)); } \
+inline size_t compress_store(unsigned bits, const V & v, T * out) \
+{ ipriv::compress_pd(bits, _mm_castsi128_pd(v.p), out); return ipriv::popcount8(bits); } \
+inline size_t compress_store(const V & mask, const V & v, T * out) \
+{ return compress_store(mask_bits(mask), v, out); }
+PCOMPRESS_32X4_(veci_i32x4_t, int32_t)
+PCOMPRESS_32X4_(veci_ui32x4_t, uint32_t)
+PCOMPRESS_64X2_(veci_i64x2_t, int64_t)
+PCOMPRESS_64X2_(veci_ui64x2_t, uint64_t)
+#  undef PCOMPRESS_32X4_
+#  undef PCOMPRESS_64X2_
+# endif // SSE2 || AVX
+
+# if defined(AVX)
+inline unsigned mask_bits(const vec8f_t & mask)
+{ return ipriv::mask_bits_ps256(mask.p); }
+inline size_t compress_store(unsigned bits, const vec8f_t & v, float * out)
+{ ipriv::compress_ps256(bits, v.p, out); return ipriv::popcount8(bits); }
+inline size_t compress_store(const vec8f_t & mask, const vec8f_t & v, float * out)
+{ return compress_store(mask_bits(mask), v, out); }
+# endif // AVX
+
+# if defined(AVX2)
+#  define PCOMPRESS_32X8_(V,T) \
+inline unsigned mask_bits(const V & mask) \
+{ return ipriv::mask_bits_ps256(_mm256_castsi256_ps(mask.p)); } \
+inline size_t compress_store(unsigned bits, const V & v, T * out) \
+{ ipriv::compress_ps256(bits, _mm256_castsi256_ps(v.p), out); return ipriv::popcount8(bits); } \
+inline size_t compress_store(const V & mask, const V & v, T * out) \
+{ return compress_store(mask_bits(mask), v, out); }
+PCOMPRESS_32X8_(veci_i32x8_t, int32_t)
+PCOMPRESS_32X8_(veci_ui32x8_t, uint32_t)
+#  undef PCOMPRESS_32X8_
+# endif // AVX2
+
+#elif defined(PVECF_ARM)
+
+inline unsigned mask_bits(const vec4f_t & mask)
+{ return ipriv::mask_bits_u32(vreinterpretq_u32_f32(mask.p)); }
+inline size_t compress_store(unsigned bits, const vec4f_t & v, float * out)
+{ ipriv::compress_u32(bits, vreinterpretq_u32_f32(v.p), out); return ipriv::popcount8(bits); }
+inline size_t compress_store(const vec4f_t & mask, const vec4f_t & v, float * out)
+{ return compress_store(mask_bits(mask), v, out); }
+
+# define PCOMPRESS_NEON_(V,T,W,S) \
+inline unsigned mask_bits(const V & mask) \
+{ return ipriv::mask_bits_u##W(vreinterpretq_u##W##_##S(mask.p)); } \
+inline size_t compress_store(unsigned bits, const V & v, T * out) \
+{ ipriv::compress_u##W(bits, vreinterpretq_u##W##_##S(v.p), out); return ipriv::popcount8(bits); } \
+inline size_t compress_store(const V & mask, const V & v, T * out) \
+{ return compress_store(mask_bits(mask), v, out); }
+PCOMPRESS_NEON_(veci_i32x4_t, int32_t, 32, s32)
+PCOMPRESS_NEON_(veci_i64x2_t, int64_t, 64, s64)
+# undef PCOMPRESS_NEON_
+inline unsigned mask_bits(const veci_ui32x4_t & mask)
+{ return ipriv::mask_bits_u32(mask.p); }
+inline size_t compress_store(unsigned bits, const veci_ui32x4_t & v, uint32_t * out)
+{ ipriv::compress_u32(bits, v.p, out); return ipriv::popcount8(bits); }
+inline size_t compress_store(const veci_ui32x4_t & mask, const veci_ui32x4_t & v, uint32_t * out)
+{ return compress_store(mask_bits(mask), v, out); }
+inline unsigned mask_bits(const veci_ui64x2_t & mask)
+{ return ipriv::mask_bits_u64(mask.p); }
+inline size_t compress_store(unsigned bits, const veci_ui64x2_t & v, uint64_t * out)
+{ ipriv::compress_u64(bits, v.p, out); return ipriv::popcount8(bits); }
+inline size_t compress_store(const veci_ui64x2_t & mask, const veci_ui64x2_t & v, uint64_t * out)
+{ return compress_store(mask_bits(mask), v, out); }
+
+#endif // PVECF_ARM
+
+
+//
+// array kernels
+//
+namespace ipriv {
+
+    // widest vector type with a compress_store() specialization
+    template<typename T> struct compress_vec;
+    template<> struct compress_vec<float>    { typedef vec4f_t type; };
+#if defined(PVECF_INTEL) && (defined(SSE2) || defined(AVX))
+    template<> struct compress_vec<double>   { typedef vec2d_t type; };
+#endif
+#if defined(PVECF_INTEL) && defined(AVX2)
+    template<> struct compress_vec<int32_t>  { typedef veci_i32x8_t type; };
+    template<> struct compress_vec<uint32_t> { typedef veci_ui32x8_t type; };
+#else
+    template<> struct compress_vec<int32_t>  { typedef veci_i32x4_t type; };
+    template<> struct compress_vec<uint32_t> { typedef veci_ui32x4_t type; };
+#endif
+    template<> struct compress_vec<int64_t>  { typedef veci_i64x2_t type; };
+    template<> struct compress_vec<uint64_t> { typedef veci_ui64x2_t type; };
+
+} // namespace ipriv
+
+// dst[k++] = src[i] where pred(V) sets lane i, returns k
+template<typename V, typename T, typename P>
+inline size_t filter_many(T * dst, const T * src, size_t n, P pred)
+{
+    static_assert(std::is_same<T, typename ipriv::vec_elem<V>::type>::value,
+                  "filter_many: element type of V does not match the arrays");
+    size_t k = 0, i = 0;
+    // full stores stay within dst: k <= i
+    for(; i + V::N <= n; i += V::N) {
+        V v;
+        v.loadu(src + i);
+        k += compress_store(pred(v), v, dst + k);
+    }
+    if(i < n) {
+        T t[V::N], o[V::N];
+        memset(t, 0, sizeof(t));
+        memcpy(t, src + i, (n - i) * sizeof(T));
+        V v;
+        v.loadu(t);
+        unsigned bits = mask_bits(V(pred(v))) & ((1u << (n - i)) - 1);
+        size_t m = compress_store(bits, v, o);
+        memcpy(dst + k, o, m * sizeof(T));
+        k += m;
+    }
+    return k;
+}
+
+// dst[k++] = src[i] where keep[i] != 0, returns k
+template<typename T>
+inline size_t compress_many(T * dst, const T * src, const uint8_t * keep, size_t n)
+{
+    typedef typename ipriv::compress_vec<T>::type V;
+    size_t k = 0, i = 0;
+    for(; i + V::N <= n; i += V::N) {
+        unsigned bits = 0;
+        for(unsigned l = 0; l < V::N; ++l)
+            bits |= unsigned(keep[i + l] != 0) << l;
+        V v;
+        v.loadu(src + i);
+        k += compress_store(bits, v, dst + k);
+    }
+    for(; i < n; ++i) {
+        dst[k] = src[i];
+        k += keep[i] != 0;
+    }
+    return k;
+}
+
+} // namespace math
+
+#endif // PCOMPRESS_H
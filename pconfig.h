@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * pconfig.h                                                                   *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PCONFIG_H
+#define PCONFIG_H
+
+
+// instruction set defines, included first by pmath.h and pmathi.h so every
+// header sees the same set; on Intel each define implies the ones of the
+// lower tiers (SSE4 denotes SSE4.1), the headers test each path for its own
+// define only
+// AVX is not implied by AVX2, the 8 wide float types need it explicitly
+
+#if (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))) || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+# if defined(AVX512VL) && !defined(AVX2)
+#   define AVX2
+# endif
+# if defined(AVX2) && !defined(SSE4_2)
+#   define SSE4_2
+# endif
+# if defined(SSE4_2) && !defined(SSE4)
+#   define SSE4
+# endif
+# if defined(SSE4) && !defined(SSSE3)
+#   define SSSE3
+# endif
+# if defined(SSSE3) && !defined(SSE3)
+#   define SSE3
+# endif
+# if defined(SSE3) && !defined(SSE2)
+#   define SSE2
+# endif
+#endif
+
+
+#endif // PCONFIG_H
@@ -0,0 +1,294 @@
+/*******************************************************************************
+ * pcull.h                                                                     *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PCULL_H
+#define PCULL_H
+
+#include <pgeom.h>
+#include <pcompress.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+
+
+/*
+frustum culling
+---------------
+frustum_t(view_proj) extracts the six planes (Gribb/Hartmann) of a view
+projection matrix for column vectors (clip = view_proj * p, as mat4f_t's
+operator*), the planes are normalized and point inwards, the order is left,
+right, bottom, top, near, far; clip_depth_t::zero_one for projections mapping
+the depth to [0,1] (Direct3D, Vulkan), neg_one_one (default) for OpenGL
+
+the objects are passed as SoA arrays (sphere_soa_t: x, y, z, r, aabb_soa_t:
+minx .. maxz), V::N objects (4 with vec4f_t, 8 with vec8f_t) are tested against
+all planes at once:
+
+  frustum_cull<V>(f, objs, n, idx)       indices of the visible objects to idx
+                                         (room for n), returns their number
+  frustum_cull_bits<V>(f, objs, n, bits) bit i of bits[i / 32] set for visible
+                                         objects ((n + 31) / 32 words), returns
+                                         their number
+  frustum_classify<V>(f, objs, n, out)   cull_t::outside, intersecting or inside
+                                         for each object
+
+  f.classify(center, radius), f.classify(bmin, bmax) classify a single object
+
+visible means not outside; objects touching a plane count as intersecting;
+the box test is conservative: boxes outside the frustum but not completely
+behind one plane (near the edges and corners) are classified intersecting
+*/
+
+// TODO:
+// - occlusion culling against a hierarchical depth buffer
+// - plane coherency (test the plane that culled the object last time first)
+// - AVX-512 masks instead of the compares
+
+
+namespace math {
+
+enum class clip_depth_t { neg_one_one, zero_one };
+
+enum class cull_t : uint8_t { outside = 0, intersecting = 1, inside = 2 };
+
+// bounding spheres, SoA
+struct sphere_soa_t
+{
+    const float * x;
+    const float * y;
+    const float * z;
+    const float * r;
+};
+
+// axis aligned boxes, SoA
+struct aabb_soa_t
+{
+    const float * minx;
+    const float * miny;
+    const float * minz;
+    const float * maxx;
+    const float * maxy;
+    const float * maxz;
+};
+
+class frustum_t
+{
+public:
+    frustum_t() {}
+    explicit frustum_t(const mat4f_t & view_proj, clip_depth_t depth = clip_depth_t::neg_one_one)
+    { set(view_proj, depth); }
+
+    void set(const mat4f_t & view_proj, clip_depth_t depth = clip_depth_t::neg_one_one)
+    {
+        const vec4f_t r0(view_proj.row(0)), r1(view_proj.row(1)), r2(view_proj.row(2)), r3(view_proj.row(3));
+        plane[0] = r3 + r0;
+        plane[1] = r3 - r0;
+        plane[2] = r3 + r1;
+        plane[3] = r3 - r1;
+        plane[4] = depth == clip_depth_t::zero_one ? r2 : r3 + r2;
+        plane[5] = r3 - r2;
+        for(unsigned k = 0; k < 6; ++k) {
+            vec4f_t & p = plane[k];
+            float len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            if(len > 0.0f) p *= 1.0f / len;
+        }
+    }
+
+    // a single sphere or box (the xyz lanes)
+    cull_t classify(const vec4f_t & center, float radius) const
+    {
+        cull_t ret = cull_t::inside;
+        for(unsigned k = 0; k < 6; ++k) {
+            const vec4f_t & p = plane[k];
+            float d = p[0] * center[0] + p[1] * center[1] + p[2] * center[2] + p[3];
+            if(d < -radius) return cull_t::outside;
+            if(d < radius) ret = cull_t::intersecting;
+        }
+        return ret;
+    }
+    cull_t classify(const vec4f_t & bmin, const vec4f_t & bmax) const
+    {
+        const vec4f_t c((bmin + bmax) * 0.5f), e((bmax - bmin) * 0.5f);
+        cull_t ret = cull_t::inside;
+        for(unsigned k = 0; k < 6; ++k) {
+            const vec4f_t & p = plane[k];
+            float d = p[0] * c[0] + p[1] * c[1] + p[2] * c[2] + p[3];
+            float r = std::fabs(p[0]) * e[0] + std::fabs(p[1]) * e[1] + std::fabs(p[2]) * e[2];
+            if(d < -r) return cull_t::outside;
+            if(d < r) ret = cull_t::intersecting;
+        }
+        return ret;
+    }
+
+    vec4f_t plane[6]; // {a,b,c,d}: a x + b y + c z + d >= 0 inside
+};
+
+
+namespace ipriv {
+
+    // unaligned load of V::N floats
+    template<typename V> inline V cull_load(const float * p);
+    template<> inline vec4f_t cull_load<vec4f_t>(const float * p) { vec4f_t v; v.loadu(p); return v; }
+#if defined(PVECF_INTEL) && defined(AVX)
+    template<> inline vec8f_t cull_load<vec8f_t>(const float * p) { return vec8f_t(_mm256_loadu_ps(p)); }
+#endif
+
+    // 32 bit lane indices for compress_store()
+    template<typename V> struct cull_index;
+    template<> struct cull_index<vec4f_t> { typedef veci_ui32x4_t type; };
+#if defined(PVECF_INTEL) && defined(AVX) && defined(AVX2)
+    template<> struct cull_index<vec8f_t> { typedef veci_ui32x8_t type; };
+#endif
+
+    // the planes splat, |a|,|b|,|c| for the box extents
+    template<typename V>
+    struct cull_planes_t
+    {
+        explicit cull_planes_t(const frustum_t & f)
+        {
+            for(unsigned k = 0; k < 6; ++k) {
+                const vec4f_t & p = f.plane[k];
+                a[k] = geom_splat<V>(p[0]); b[k] = geom_splat<V>(p[1]);
+                c[k] = geom_splat<V>(p[2]); d[k] = geom_splat<V>(p[3]);
+                aa[k] = geom_splat<V>(std::fabs(p[0])); ab[k] = geom_splat<V>(std::fabs(p[1]));
+                ac[k] = geom_splat<V>(std::fabs(p[2]));
+            }
+            zero = geom_splat<V>(0.0f);
+        }
+        V a[6], b[6], c[6], d[6], aa[6], ab[6], ac[6], zero;
+    };
+
+    // visible and inside lanes of V::N objects starting at i; with count <
+    // V::N the lanes past count are loaded from zeroed copies
+    template<typename V>
+    inline void cull_lanes(const cull_planes_t<V> & pl, const sphere_soa_t & s, size_t i, size_t count,
+                           V & visible, V & inside)
+    {
+        V x, y, z, r;
+        if(count == V::N) {
+            x = cull_load<V>(s.x + i); y = cull_load<V>(s.y + i);
+            z = cull_load<V>(s.z + i); r = cull_load<V>(s.r + i);
+        } else {
+            float t[4][V::N];
+            memset(t, 0, sizeof(t));
+            memcpy(t[0], s.x + i, count * sizeof(float)); memcpy(t[1], s.y + i, count * sizeof(float));
+            memcpy(t[2], s.z + i, count * sizeof(float)); memcpy(t[3], s.r + i, count * sizeof(float));
+            x = cull_load<V>(t[0]); y = cull_load<V>(t[1]); z = cull_load<V>(t[2]); r = cull_load<V>(t[3]);
+        }
+        for(unsigned k = 0; k < 6; ++k) {
+            V dist(pl.a[k] * x + pl.b[k] * y + pl.c[k] * z + pl.d[k]);
+            V m0(geom_gte(dist + r, pl.zero)), m1(geom_gte(dist - r, pl.zero));
+            if(k == 0) { visible = m0; inside = m1; }
+            else { visible = visible & m0; inside = inside & m1; }
+        }
+    }
+    template<typename V>
+    inline void cull_lanes(const cull_planes_t<V> & pl, const aabb_soa_t & b, size_t i, size_t count,
+                           V & visible, V & inside)
+    {
+        V x0, y0, z0, x1, y1, z1;
+        if(count == V::N) {
+            x0 = cull_load<V>(b.minx + i); y0 = cull_load<V>(b.miny + i); z0 = cull_load<V>(b.minz + i);
+            x1 = cull_load<V>(b.maxx + i); y1 = cull_load<V>(b.maxy + i); z1 = cull_load<V>(b.maxz + i);
+        } else {
+            float t[6][V::N];
+            memset(t, 0, sizeof(t));
+            const float * src[6] = { b.minx, b.miny, b.minz, b.maxx, b.maxy, b.maxz };
+            for(unsigned j = 0; j < 6; ++j) memcpy(t[j], src[j] + i, count * sizeof(float));
+            x0 = cull_load<V>(t[0]); y0 = cull_load<V>(t[1]); z0 = cull_load<V>(t[2]);
+            x1 = cull_load<V>(t[3]); y1 = cull_load<V>(t[4]); z1 = cull_load<V>(t[5]);
+        }
+        const V half(geom_splat<V>(0.5f));
+        const V cx((x0 + x1) * half), cy((y0 + y1) * half), cz((z0 + z1) * half);
+        const V ex((x1 - x0) * half), ey((y1 - y0) * half), ez((z1 - z0) * half);
+        for(unsigned k = 0; k < 6; ++k) {
+            V dist(pl.a[k] * cx + pl.b[k] * cy + pl.c[k] * cz + pl.d[k]);
+            V rad(pl.aa[k] * ex + pl.ab[k] * ey + pl.ac[k] * ez);
+            V m0(geom_gte(dist + rad, pl.zero)), m1(geom_gte(dist - rad, pl.zero));
+            if(k == 0) { visible = m0; inside = m1; }
+            else { visible = visible & m0; inside = inside & m1; }
+        }
+    }
+
+    inline unsigned cull_tail_bits(size_t count) { return count >= 32 ? ~0u : (1u << count) - 1; }
+
+} // namespace ipriv
+
+
+// indices of the visible objects (sphere_soa_t or aabb_soa_t) to idx (room
+// for n indices), returns their number
+template<typename V = vec4f_t, typename S>
+inline size_t frustum_cull(const frustum_t & f, const S & objs, size_t n, uint32_t * idx)
+{
+    typedef typename ipriv::cull_index<V>::type I;
+    const ipriv::cull_planes_t<V> pl(f);
+    uint32_t iota[V::N];
+    for(unsigned l = 0; l < V::N; ++l) iota[l] = l;
+    I lane;
+    lane.loadu(iota);
+    size_t k = 0, i = 0;
+    V visible, inside;
+    // full stores stay within idx: k <= i
+    for(; i + V::N <= n; i += V::N, lane = lane + uint32_t(V::N)) {
+        ipriv::cull_lanes(pl, objs, i, V::N, visible, inside);
+        k += compress_store(mask_bits(visible), lane, idx + k);
+    }
+    if(i < n) {
+        uint32_t o[V::N];
+        ipriv::cull_lanes(pl, objs, i, n - i, visible, inside);
+        size_t m = compress_store(mask_bits(visible) & ipriv::cull_tail_bits(n - i), lane, o);
+        memcpy(idx + k, o, m * sizeof(uint32_t));
+        k += m;
+    }
+    return k;
+}
+
+// visibility bits, bit i % 32 of bits[i / 32] for object i ((n + 31) / 32
+// words), returns the number of visible objects
+template<typename V = vec4f_t, typename S>
+inline size_t frustum_cull_bits(const frustum_t & f, const S & objs, size_t n, uint32_t * bits)
+{
+    static_assert(32 % V::N == 0, "frustum_cull_bits: V::N must divide 32");
+    const ipriv::cull_planes_t<V> pl(f);
+    size_t k = 0;
+    uint32_t word = 0;
+    V visible, inside;
+    for(size_t i = 0; i < n; i += V::N) {
+        size_t count = n - i < V::N ? n - i : V::N;
+        ipriv::cull_lanes(pl, objs, i, count, visible, inside);
+        uint32_t m = mask_bits(visible) & ipriv::cull_tail_bits(count);
+        k += ipriv::popcount8(m & 0xff);
+        word |= m << (i & 31);
+        if(((i + V::N) & 31) == 0 || i + V::N >= n) {
+            bits[i / 32] = word;
+            word = 0;
+        }
+    }
+    return k;
+}
+
+// cull_t for each object
+template<typename V = vec4f_t, typename S>
+inline void frustum_classify(const frustum_t & f, const S & objs, size_t n, cull_t * out)
+{
+    const ipriv::cull_planes_t<V> pl(f);
+    V visible, inside;
+    for(size_t i = 0; i < n; i += V::N) {
+        size_t count = n - i < V::N ? n - i : V::N;
+        ipriv::cull_lanes(pl, objs, i, count, visible, inside);
+        unsigned vb = mask_bits(visible), ib = mask_bits(inside);
+        for(unsigned l = 0; l < count; ++l)
+            out[i + l] = cull_t(((vb >> l) & 1) + ((ib >> l) & 1));
+    }
+}
+
+} // namespace math
+
+#endif // PCULL_H
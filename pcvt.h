@@ -0,0 +1,1010 @@
+/*******************************************************************************
+ * pcvt.h                                                                      *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PCVT_H
+#define PCVT_H
+
+#include <pvecf.h>
+#include <pveci.h>
+#include <stddef.h>
+
+
+/*
+conversions between packed integers and packed floating point values
+--------------------------------------------------------------------
+int -> float conversions round to nearest (only uint32_t, int64_t values with
+more significant bits than the mantissa provides are affected), the
+uint8_t/uint16_t conversions are exact; the *_norm variants scale the result
+to [0,1] per multiplication with the reciprocal of the largest value
+(the largest value results in exactly 1.0f)
+
+float -> int conversions take the rounding as template argument:
+  round_t::nearest_even  round half to even
+  round_t::trunc         towards zero
+  round_t::floor         towards -inf
+  round_t::ceil          towards +inf
+
+  the plain conversions have unspecified results for values out of range
+  of the integer type (and for NaNs), the *_sat variants saturate to the
+  range of the integer type and convert NaNs to 0
+
+instruction set tiers:
+  SSE2:      float <-> int32 native, uint32 per two int32 conversions,
+             floor/ceil per correction of the truncated result,
+             nearest_even per cvtps2dq (uses the current MXCSR rounding
+             mode, round to nearest even by default, see pfenv.h),
+             int64 <-> double per exponent tricks / scalar cvttsd2si
+  SSE4:      rounding per roundps/roundpd
+  AVX512VL:  native uint32 <-> float (vcvtudq2ps, vcvttps2udq),
+             with AVX512DQ native int64 <-> double (vcvtqq2pd, vcvttpd2qq)
+  NEON:      conversions saturate natively; ARMv7 lacks the directed
+             rounding conversions of ARMv8 (vcvtnq, vcvtmq, vcvtpq), these
+             are emulated; there's no vec2d_t on ARM, so no int64 <-> double
+
+the *_many() array variants convert the remainder not filling a whole vector
+per vector conversion of a zero-padded copy, so all elements are converted
+identically
+
+with AVX and AVX2 the int32_t <-> float conversions are also available for
+vec8f_t/veci_i32x8_t
+
+
+reinterpretation
+----------------
+as_f32(), as_i32(), as_u32() reinterpret the bits of 32 bit elements as
+float/int32_t/uint32_t (no conversion, no instructions), e.g. for exponent and
+mantissa manipulations with the integer operations
+
+
+conversions between integer element widths
+------------------------------------------
+widen_lo()/widen_hi() sign extend (signed types) or zero extend (unsigned
+types) the lower/upper half of the elements to the next wider type:
+  int8_t -> int16_t -> int32_t -> int64_t
+  uint8_t -> uint16_t -> uint32_t -> uint64_t
+
+narrow_*(lo, hi) combine the elements of two vectors to one vector of the
+next narrower type (elements of lo -> lower half, hi -> upper half):
+  narrow_sat()    saturates to the range of the narrower type of the same
+                  signedness (packsswb/packssdw, vqmovn)
+  narrow_usat()   signed -> unsigned, saturates negative values to 0
+                  (packuswb/packusdw, vqmovun)
+  narrow_trunc()  keeps the lower bits (vmovn)
+
+SSE2 lacks unsigned saturating packs and any 64 -> 32 bit packs, these are
+emulated per masks; SSE4 adds packusdw and the sign/zero extensions
+(pmovsx*, pmovzx*), AVX512VL the saturating 64 -> 32 bit (and unsigned
+32 -> 16 bit) conversions (vpmov[u]s*)
+
+the *_many() buffer variants widen/narrow arrays of elements
+*/
+
+// TODO:
+// - vec8f_t (AVX) variants besides int32_t <-> float, vec4d_t variants
+// - float -> uint8_t/uint16_t with saturation (packus*)
+// - 256 bit (AVX2) widening/narrowing
+
+
+namespace math {
+
+namespace ipriv {
+
+#if defined(PVECI_INTEL)
+
+    // float -> int32, out of range values and NaNs result in 0x80000000
+    template<round_t R> inline __m128i cvt_ps_epi32(__m128 x);
+
+    template<> inline __m128i cvt_ps_epi32<round_t::nearest_even>(__m128 x)
+    {
+# if defined(SSE4)
+        return _mm_cvttps_epi32(_mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+# else
+        return _mm_cvtps_epi32(x);
+# endif
+    }
+    template<> inline __m128i cvt_ps_epi32<round_t::trunc>(__m128 x)
+    { return _mm_cvttps_epi32(x); }
+    template<> inline __m128i cvt_ps_epi32<round_t::floor>(__m128 x)
+    {
+# if defined(SSE4)
+        return _mm_cvttps_epi32(_mm_floor_ps(x));
+# else
+        __m128i i = _mm_cvttps_epi32(x);
+        // x < trunc(x) -> add -1
+        return _mm_add_epi32(i, _mm_castps_si128(_mm_cmplt_ps(x, _mm_cvtepi32_ps(i))));
+# endif
+    }
+    template<> inline __m128i cvt_ps_epi32<round_t::ceil>(__m128 x)
+    {
+# if defined(SSE4)
+        return _mm_cvttps_epi32(_mm_ceil_ps(x));
+# else
+        __m128i i = _mm_cvttps_epi32(x);
+        // x > trunc(x) -> subtract -1
+        return _mm_sub_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(x, _mm_cvtepi32_ps(i))));
+# endif
+    }
+
+    template<round_t R> inline __m128i cvt_ps_epi32_sat(__m128 x)
+    {
+        __m128 lim = _mm_set1_ps(2147483648.0f);                           // 2^31
+        __m128i hi = _mm_castps_si128(_mm_cmpge_ps(x, lim));
+        __m128i lo = _mm_castps_si128(_mm_cmplt_ps(x, _mm_sub_ps(_mm_setzero_ps(), lim)));
+        __m128i r = cvt_ps_epi32<R>(x);
+        r = _mm_or_si128(_mm_andnot_si128(hi, r), _mm_srli_epi32(hi, 1));  // 0x7FFFFFFF
+        r = _mm_or_si128(_mm_andnot_si128(lo, r), _mm_slli_epi32(lo, 31)); // 0x80000000
+        return _mm_and_si128(r, _mm_castps_si128(_mm_cmpord_ps(x, x)));    // NaN -> 0
+    }
+
+    // rounds to integral values (pvecf.h)
+    using fpriv::round_ps;
+
+    template<round_t R> inline __m128i cvt_ps_epu32(__m128 x)
+    {
+        __m128 y = round_ps<R>(x);
+# if defined(AVX512VL)
+        return _mm_cvttps_epu32(y);
+# else
+        // values >= 2^31 are converted with 2^31 subtracted, the MSB is set afterwards
+        __m128 lim = _mm_set1_ps(2147483648.0f);
+        __m128 big = _mm_cmpge_ps(y, lim);
+        __m128i r = _mm_cvttps_epi32(_mm_sub_ps(y, _mm_and_ps(big, lim)));
+        return _mm_xor_si128(r, _mm_slli_epi32(_mm_castps_si128(big), 31));
+# endif
+    }
+
+    template<round_t R> inline __m128i cvt_ps_epu32_sat(__m128 x)
+    {
+        // max() returns the second operand for NaNs
+        __m128 y = _mm_max_ps(round_ps<R>(x), _mm_setzero_ps());
+# if defined(AVX512VL)
+        return _mm_cvttps_epu32(y); // out of range -> 0xFFFFFFFF
+# else
+        __m128 lim = _mm_set1_ps(2147483648.0f);
+        __m128 big = _mm_cmpge_ps(y, lim);
+        __m128i r = _mm_cvttps_epi32(_mm_sub_ps(y, _mm_and_ps(big, lim)));
+        r = _mm_xor_si128(r, _mm_slli_epi32(_mm_castps_si128(big), 31));
+        return _mm_or_si128(r, _mm_castps_si128(_mm_cmpge_ps(y, _mm_add_ps(lim, lim))));
+# endif
+    }
+
+    inline __m128 cvt_epu32_ps(__m128i v)
+    {
+# if defined(AVX512VL)
+        return _mm_cvtepu32_ps(v);
+# else
+        // hi * 2^16 and lo are exact, the addition rounds once
+        __m128i lo = _mm_and_si128(v, _mm_srli_epi32(imath_t<uint32_t,__m128i>::onebits(), 16));
+        __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(v, 16));
+        return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.0f)), _mm_cvtepi32_ps(lo));
+# endif
+    }
+
+# if defined(SSE2) || defined(AVX)
+    using fpriv::round_pd;
+
+    // double (integral valued) -> int64, out of range values and NaNs
+    // result in 0x8000000000000000 (unspecified without x64/AVX512DQ)
+    inline __m128i cvtt_pd_epi64(__m128d y)
+    {
+#   if defined(AVX512VL) && defined(AVX512DQ)
+        return _mm_cvttpd_epi64(y);
+#   elif defined(_M_X64) || defined(__x86_64__)
+        return _mm_set_epi64x(_mm_cvttsd_si64(_mm_unpackhi_pd(y, y)), _mm_cvttsd_si64(y));
+#   else
+        double d[2];
+        _mm_storeu_pd(d, y);
+        return _mm_set_epi64x(int64_t(d[1]), int64_t(d[0]));
+#   endif
+    }
+
+    inline __m128i cvtt_pd_epi64_sat(__m128d y)
+    {
+        __m128d lim = _mm_set1_pd(9223372036854775808.0);                 // 2^63
+        __m128i hi = _mm_castpd_si128(_mm_cmpge_pd(y, lim));
+        y = _mm_and_pd(y, _mm_cmpord_pd(y, y));                             // NaN -> 0
+        y = _mm_max_pd(y, _mm_sub_pd(_mm_setzero_pd(), lim));
+        y = _mm_min_pd(y, _mm_set1_pd(9223372036854774784.0));             // largest double < 2^63
+        __m128i r = cvtt_pd_epi64(y);
+        return _mm_or_si128(_mm_andnot_si128(hi, r), _mm_srli_epi64(hi, 1)); // 0x7FFF...
+    }
+
+    // full range, correctly rounded: the upper 16 bits are scaled into a double
+    // of magnitude 3*2^67 and the lower 48 bits into one of magnitude 2^52,
+    // both per integer addition into the mantissa
+    inline __m128d cvt_epi64_pd(__m128i x)
+    {
+#   if defined(AVX512VL) && defined(AVX512DQ)
+        return _mm_cvtepi64_pd(x);
+#   else
+        __m128i ones = imath_t<int64_t,__m128i>::onebits();
+        __m128i xh = _mm_and_si128(_mm_srai_epi32(x, 16), _mm_slli_epi64(ones, 32));  // (x >> 48) << 32
+        xh = _mm_add_epi64(xh, _mm_castpd_si128(_mm_set1_pd(442721857769029238784.0))); // 3*2^67
+        __m128i xl =
+            _mm_or_si128(
+                _mm_and_si128(x, _mm_srli_epi64(ones, 16)),                        // lower 48 bits
+                _mm_castpd_si128(_mm_set1_pd(4503599627370496.0))                  // 2^52
+            );
+        __m128d f = _mm_sub_pd(_mm_castsi128_pd(xh), _mm_set1_pd(442726361368656609280.0)); // 3*2^67 + 2^52
+        return _mm_add_pd(f, _mm_castsi128_pd(xl));
+#   endif
+    }
+# endif // SSE2 || AVX
+
+    // lower dwords of the qwords of lo (-> elements 0,1) and hi (-> 2,3)
+    inline __m128i pack_lo32(__m128i lo, __m128i hi)
+    {
+        return
+            _mm_castps_si128(
+                _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2,0,2,0))
+            );
+    }
+
+    // int64 -> int32 saturated in the lower dwords
+    inline __m128i sat_epi64_epi32(__m128i x)
+    {
+        // in range if the upper dword is the sign extension of the lower one
+        __m128i s = _mm_srai_epi32(x, 31);
+        __m128i in = _mm_shuffle_epi32(_mm_cmpeq_epi32(x, _mm_slli_epi64(s, 32)), _MM_SHUFFLE(3,3,1,1));
+        __m128i sat = _mm_xor_si128(_mm_shuffle_epi32(s, _MM_SHUFFLE(3,3,1,1)), _mm_set1_epi32(0x7FFFFFFF));
+        return blendv_epi8(sat, x, in);
+    }
+
+    // uint64 -> uint32 saturated in the lower dwords
+    inline __m128i sat_epu64_epu32(__m128i x)
+    {
+        __m128i in = _mm_cmpeq_epi32(_mm_shuffle_epi32(x, _MM_SHUFFLE(3,3,1,1)), _mm_setzero_si128());
+        return _mm_or_si128(x, _mm_xor_si128(in, _mm_cmpeq_epi32(in, in)));
+    }
+
+    // int32 -> uint16 saturated
+    inline __m128i packus_epi32(__m128i lo, __m128i hi)
+    {
+# if defined(SSE4)
+        return _mm_packus_epi32(lo, hi);
+# else
+        // negative values -> 0, then bias to the int16_t range for packssdw
+        __m128i bias = _mm_set1_epi32(0x8000);
+        lo = _mm_sub_epi32(_mm_andnot_si128(_mm_srai_epi32(lo, 31), lo), bias);
+        hi = _mm_sub_epi32(_mm_andnot_si128(_mm_srai_epi32(hi, 31), hi), bias);
+        return _mm_xor_si128(_mm_packs_epi32(lo, hi), _mm_set1_epi16(-0x8000));
+# endif
+    }
+
+#elif defined(PVECI_ARM)
+
+    // rounds to integral values (pvecf.h)
+    using fpriv::round_ps;
+
+    // NEON conversions saturate and convert NaNs to 0
+    template<round_t R> inline int32x4_t cvt_ps_epi32(float32x4_t x)
+    {
+# if defined(__aarch64__)
+        return
+            R == round_t::nearest_even ? vcvtnq_s32_f32(x) :
+            R == round_t::trunc ? vcvtq_s32_f32(x) :
+            R == round_t::floor ? vcvtmq_s32_f32(x) : vcvtpq_s32_f32(x);
+# else
+        return vcvtq_s32_f32(round_ps<R>(x));
+# endif
+    }
+    template<round_t R> inline int32x4_t cvt_ps_epi32_sat(float32x4_t x)
+    { return cvt_ps_epi32<R>(x); }
+
+    template<round_t R> inline uint32x4_t cvt_ps_epu32(float32x4_t x)
+    {
+# if defined(__aarch64__)
+        return
+            R == round_t::nearest_even ? vcvtnq_u32_f32(x) :
+            R == round_t::trunc ? vcvtq_u32_f32(x) :
+            R == round_t::floor ? vcvtmq_u32_f32(x) : vcvtpq_u32_f32(x);
+# else
+        return vcvtq_u32_f32(round_ps<R>(x));
+# endif
+    }
+    template<round_t R> inline uint32x4_t cvt_ps_epu32_sat(float32x4_t x)
+    { return cvt_ps_epu32<R>(x); }
+
+#endif
+
+    // converts n elements per block(dst, src) converting K elements each
+    template<size_t K, typename TD, typename TS, typename F>
+    inline void cvt_many(TD * dst, const TS * src, size_t n, F block)
+    {
+        PVEC_PROBE_N("cvt_many() (pcvt.h)", n);
+        size_t i = 0;
+        for(; i + K <= n; i += K)
+            block(dst + i, src + i);
+        if(i < n) {
+            TS in[K] = {};
+            TD out[K];
+            for(size_t j = 0; i + j < n; ++j) in[j] = src[i + j];
+            block(out, in);
+            for(size_t j = 0; i + j < n; ++j) dst[i + j] = out[j];
+        }
+    }
+
+} // namespace ipriv
+
+
+//
+// int32_t <-> float
+//
+inline vec4f_t cvt_f32(const veci_i32x4_t & v)
+{
+#if defined(PVECI_INTEL)
+    return vec4f_t(_mm_cvtepi32_ps(v.p));
+#elif defined(PVECI_ARM)
+    return vec4f_t(vcvtq_f32_s32(v.p));
+#endif
+}
+
+template<round_t R> inline veci_i32x4_t cvt_i32(const vec4f_t & v)
+{ return veci_i32x4_t(ipriv::cvt_ps_epi32<R>(v.p)); }
+
+template<round_t R> inline veci_i32x4_t cvt_i32_sat(const vec4f_t & v)
+{ return veci_i32x4_t(ipriv::cvt_ps_epi32_sat<R>(v.p)); }
+
+
+//
+// uint32_t <-> float
+//
+inline vec4f_t cvt_f32(const veci_ui32x4_t & v)
+{
+#if defined(PVECI_INTEL)
+    return vec4f_t(ipriv::cvt_epu32_ps(v.p));
+#elif defined(PVECI_ARM)
+    return vec4f_t(vcvtq_f32_u32(v.p));
+#endif
+}
+
+template<round_t R> inline veci_ui32x4_t cvt_u32(const vec4f_t & v)
+{ return veci_ui32x4_t(ipriv::cvt_ps_epu32<R>(v.p)); }
+
+template<round_t R> inline veci_ui32x4_t cvt_u32_sat(const vec4f_t & v)
+{ return veci_ui32x4_t(ipriv::cvt_ps_epu32_sat<R>(v.p)); }
+
+
+//
+// int32_t <-> float, 8 elements
+//
+#if defined(PVECI_INTEL) && defined(AVX) && defined(AVX2)
+inline vec8f_t cvt_f32(const veci_i32x8_t & v)
+{ return vec8f_t(_mm256_cvtepi32_ps(v.p)); }
+
+template<round_t R> inline veci_i32x8_t cvt_i32(const vec8f_t & v)
+{
+    return
+        veci_i32x8_t(
+            R == round_t::trunc ?
+                _mm256_cvttps_epi32(v.p) :
+                _mm256_cvttps_epi32(fpriv::round_ps<R>(v.p))
+        );
+}
+#endif
+
+
+//
+// reinterpretation of 32 bit elements
+//
+#if defined(PVECI_INTEL)
+inline vec4f_t as_f32(const veci_i32x4_t & v) { return vec4f_t(_mm_castsi128_ps(v.p)); }
+inline vec4f_t as_f32(const veci_ui32x4_t & v) { return vec4f_t(_mm_castsi128_ps(v.p)); }
+inline veci_i32x4_t as_i32(const vec4f_t & v) { return veci_i32x4_t(_mm_castps_si128(v.p)); }
+inline veci_i32x4_t as_i32(const veci_ui32x4_t & v) { return veci_i32x4_t(v.p); }
+inline veci_ui32x4_t as_u32(const vec4f_t & v) { return veci_ui32x4_t(_mm_castps_si128(v.p)); }
+inline veci_ui32x4_t as_u32(const veci_i32x4_t & v) { return veci_ui32x4_t(v.p); }
+# if defined(AVX2)
+inline veci_i32x8_t as_i32(const veci_ui32x8_t & v) { return veci_i32x8_t(v.p); }
+inline veci_ui32x8_t as_u32(const veci_i32x8_t & v) { return veci_ui32x8_t(v.p); }
+#  if defined(AVX)
+inline vec8f_t as_f32(const veci_i32x8_t & v) { return vec8f_t(_mm256_castsi256_ps(v.p)); }
+inline vec8f_t as_f32(const veci_ui32x8_t & v) { return vec8f_t(_mm256_castsi256_ps(v.p)); }
+inline veci_i32x8_t as_i32(const vec8f_t & v) { return veci_i32x8_t(_mm256_castps_si256(v.p)); }
+inline veci_ui32x8_t as_u32(const vec8f_t & v) { return veci_ui32x8_t(_mm256_castps_si256(v.p)); }
+#  endif
+# endif
+#elif defined(PVECI_ARM)
+inline vec4f_t as_f32(const veci_i32x4_t & v) { return vec4f_t(vreinterpretq_f32_s32(v.p)); }
+inline vec4f_t as_f32(const veci_ui32x4_t & v) { return vec4f_t(vreinterpretq_f32_u32(v.p)); }
+inline veci_i32x4_t as_i32(const vec4f_t & v) { return veci_i32x4_t(vreinterpretq_s32_f32(v.p)); }
+inline veci_i32x4_t as_i32(const veci_ui32x4_t & v) { return veci_i32x4_t(vreinterpretq_s32_u32(v.p)); }
+inline veci_ui32x4_t as_u32(const vec4f_t & v) { return veci_ui32x4_t(vreinterpretq_u32_f32(v.p)); }
+inline veci_ui32x4_t as_u32(const veci_i32x4_t & v) { return veci_ui32x4_t(vreinterpretq_u32_s32(v.p)); }
+#endif
+
+
+//
+// uint16_t -> float (elements 0..3 -> lo, 4..7 -> hi)
+//
+inline void cvt_f32(const veci_ui16x8_t & v, vec4f_t & lo, vec4f_t & hi)
+{
+#if defined(PVECI_INTEL)
+    __m128i z = _mm_setzero_si128();
+    lo.p = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v.p, z));
+    hi.p = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v.p, z));
+#elif defined(PVECI_ARM)
+    lo.p = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v.p)));
+    hi.p = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v.p)));
+#endif
+}
+
+inline void cvt_f32_norm(const veci_ui16x8_t & v, vec4f_t & lo, vec4f_t & hi)
+{
+    cvt_f32(v, lo, hi);
+    lo *= 1.0f / 65535.0f;
+    hi *= 1.0f / 65535.0f;
+}
+
+
+//
+// uint8_t -> float (elements 4*i..4*i+3 -> r[i])
+//
+inline void cvt_f32(const veci_ui8x16_t & v, vec4f_t (&r)[4])
+{
+#if defined(PVECI_INTEL)
+    __m128i z = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(v.p, z), hi = _mm_unpackhi_epi8(v.p, z);
+    r[0].p = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, z));
+    r[1].p = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, z));
+    r[2].p = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, z));
+    r[3].p = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, z));
+#elif defined(PVECI_ARM)
+    uint16x8_t lo = vmovl_u8(vget_low_u8(v.p)), hi = vmovl_u8(vget_high_u8(v.p));
+    r[0].p = vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo)));
+    r[1].p = vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo)));
+    r[2].p = vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi)));
+    r[3].p = vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi)));
+#endif
+}
+
+inline void cvt_f32_norm(const veci_ui8x16_t & v, vec4f_t (&r)[4])
+{
+    cvt_f32(v, r);
+    for(int i = 0; i < 4; ++i) r[i] *= 1.0f / 255.0f;
+}
+
+
+//
+// int64_t <-> double
+//
+#if defined(PVECI_INTEL) && (defined(SSE2) || defined(AVX))
+inline vec2d_t cvt_f64(const veci_i64x2_t & v)
+{ return vec2d_t(ipriv::cvt_epi64_pd(v.p)); }
+
+template<round_t R> inline veci_i64x2_t cvt_i64(const vec2d_t & v)
+{ return veci_i64x2_t(ipriv::cvtt_pd_epi64(ipriv::round_pd<R>(v.p))); }
+
+template<round_t R> inline veci_i64x2_t cvt_i64_sat(const vec2d_t & v)
+{ return veci_i64x2_t(ipriv::cvtt_pd_epi64_sat(ipriv::round_pd<R>(v.p))); }
+#endif
+
+
+//
+// widening/narrowing between integer element widths
+//
+inline veci_i16x8_t widen_lo(const veci_i8x16_t & v)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return veci_i16x8_t(_mm_cvtepi8_epi16(v.p));
+# else
+    return veci_i16x8_t(_mm_srai_epi16(_mm_unpacklo_epi8(v.p, v.p), 8));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_i16x8_t(vmovl_s8(vget_low_s8(v.p)));
+#endif
+}
+
+inline veci_i16x8_t widen_hi(const veci_i8x16_t & v)
+{
+#if defined(PVECI_INTEL)
+    return veci_i16x8_t(_mm_srai_epi16(_mm_unpackhi_epi8(v.p, v.p), 8));
+#elif defined(PVECI_ARM)
+    return veci_i16x8_t(vmovl_s8(vget_high_s8(v.p)));
+#endif
+}
+
+inline veci_ui16x8_t widen_lo(const veci_ui8x16_t & v)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return veci_ui16x8_t(_mm_cvtepu8_epi16(v.p));
+# else
+    return veci_ui16x8_t(_mm_unpacklo_epi8(v.p, _mm_setzero_si128()));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui16x8_t(vmovl_u8(vget_low_u8(v.p)));
+#endif
+}
+
+inline veci_ui16x8_t widen_hi(const veci_ui8x16_t & v)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui16x8_t(_mm_unpackhi_epi8(v.p, _mm_setzero_si128()));
+#elif defined(PVECI_ARM)
+    return veci_ui16x8_t(vmovl_u8(vget_high_u8(v.p)));
+#endif
+}
+
+inline veci_i32x4_t widen_lo(const veci_i16x8_t & v)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return veci_i32x4_t(_mm_cvtepi16_epi32(v.p));
+# else
+    return veci_i32x4_t(_mm_srai_epi32(_mm_unpacklo_epi16(v.p, v.p), 16));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_i32x4_t(vmovl_s16(vget_low_s16(v.p)));
+#endif
+}
+
+inline veci_i32x4_t widen_hi(const veci_i16x8_t & v)
+{
+#if defined(PVECI_INTEL)
+    return veci_i32x4_t(_mm_srai_epi32(_mm_unpackhi_epi16(v.p, v.p), 16));
+#elif defined(PVECI_ARM)
+    return veci_i32x4_t(vmovl_s16(vget_high_s16(v.p)));
+#endif
+}
+
+inline veci_ui32x4_t widen_lo(const veci_ui16x8_t & v)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return veci_ui32x4_t(_mm_cvtepu16_epi32(v.p));
+# else
+    return veci_ui32x4_t(_mm_unpacklo_epi16(v.p, _mm_setzero_si128()));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui32x4_t(vmovl_u16(vget_low_u16(v.p)));
+#endif
+}
+
+inline veci_ui32x4_t widen_hi(const veci_ui16x8_t & v)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui32x4_t(_mm_unpackhi_epi16(v.p, _mm_setzero_si128()));
+#elif defined(PVECI_ARM)
+    return veci_ui32x4_t(vmovl_u16(vget_high_u16(v.p)));
+#endif
+}
+
+inline veci_i64x2_t widen_lo(const veci_i32x4_t & v)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return veci_i64x2_t(_mm_cvtepi32_epi64(v.p));
+# else
+    return veci_i64x2_t(_mm_unpacklo_epi32(v.p, _mm_srai_epi32(v.p, 31)));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_i64x2_t(vmovl_s32(vget_low_s32(v.p)));
+#endif
+}
+
+inline veci_i64x2_t widen_hi(const veci_i32x4_t & v)
+{
+#if defined(PVECI_INTEL)
+    return veci_i64x2_t(_mm_unpackhi_epi32(v.p, _mm_srai_epi32(v.p, 31)));
+#elif defined(PVECI_ARM)
+    return veci_i64x2_t(vmovl_s32(vget_high_s32(v.p)));
+#endif
+}
+
+inline veci_ui64x2_t widen_lo(const veci_ui32x4_t & v)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return veci_ui64x2_t(_mm_cvtepu32_epi64(v.p));
+# else
+    return veci_ui64x2_t(_mm_unpacklo_epi32(v.p, _mm_setzero_si128()));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui64x2_t(vmovl_u32(vget_low_u32(v.p)));
+#endif
+}
+
+inline veci_ui64x2_t widen_hi(const veci_ui32x4_t & v)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui64x2_t(_mm_unpackhi_epi32(v.p, _mm_setzero_si128()));
+#elif defined(PVECI_ARM)
+    return veci_ui64x2_t(vmovl_u32(vget_high_u32(v.p)));
+#endif
+}
+
+
+// 16 -> 8 bit
+inline veci_i8x16_t narrow_sat(const veci_i16x8_t & lo, const veci_i16x8_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_i8x16_t(_mm_packs_epi16(lo.p, hi.p));
+#elif defined(PVECI_ARM)
+    return veci_i8x16_t(vcombine_s8(vqmovn_s16(lo.p), vqmovn_s16(hi.p)));
+#endif
+}
+
+inline veci_ui8x16_t narrow_sat(const veci_ui16x8_t & lo, const veci_ui16x8_t & hi)
+{
+#if defined(PVECI_INTEL)
+    __m128i m = _mm_set1_epi16(0xFF);
+# if defined(SSE4)
+    return veci_ui8x16_t(_mm_packus_epi16(_mm_min_epu16(lo.p, m), _mm_min_epu16(hi.p, m)));
+# else
+    // min(x, 255) = x - max(x - 255, 0)
+    return
+        veci_ui8x16_t(
+            _mm_packus_epi16(
+                _mm_sub_epi16(lo.p, _mm_subs_epu16(lo.p, m)),
+                _mm_sub_epi16(hi.p, _mm_subs_epu16(hi.p, m))
+            )
+        );
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui8x16_t(vcombine_u8(vqmovn_u16(lo.p), vqmovn_u16(hi.p)));
+#endif
+}
+
+inline veci_ui8x16_t narrow_usat(const veci_i16x8_t & lo, const veci_i16x8_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui8x16_t(_mm_packus_epi16(lo.p, hi.p));
+#elif defined(PVECI_ARM)
+    return veci_ui8x16_t(vcombine_u8(vqmovun_s16(lo.p), vqmovun_s16(hi.p)));
+#endif
+}
+
+inline veci_i8x16_t narrow_trunc(const veci_i16x8_t & lo, const veci_i16x8_t & hi)
+{
+#if defined(PVECI_INTEL)
+    __m128i m = _mm_set1_epi16(0xFF);
+    return veci_i8x16_t(_mm_packus_epi16(_mm_and_si128(lo.p, m), _mm_and_si128(hi.p, m)));
+#elif defined(PVECI_ARM)
+    return veci_i8x16_t(vcombine_s8(vmovn_s16(lo.p), vmovn_s16(hi.p)));
+#endif
+}
+
+inline veci_ui8x16_t narrow_trunc(const veci_ui16x8_t & lo, const veci_ui16x8_t & hi)
+{
+#if defined(PVECI_INTEL)
+    __m128i m = _mm_set1_epi16(0xFF);
+    return veci_ui8x16_t(_mm_packus_epi16(_mm_and_si128(lo.p, m), _mm_and_si128(hi.p, m)));
+#elif defined(PVECI_ARM)
+    return veci_ui8x16_t(vcombine_u8(vmovn_u16(lo.p), vmovn_u16(hi.p)));
+#endif
+}
+
+// 32 -> 16 bit
+inline veci_i16x8_t narrow_sat(const veci_i32x4_t & lo, const veci_i32x4_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_i16x8_t(_mm_packs_epi32(lo.p, hi.p));
+#elif defined(PVECI_ARM)
+    return veci_i16x8_t(vcombine_s16(vqmovn_s32(lo.p), vqmovn_s32(hi.p)));
+#endif
+}
+
+inline veci_ui16x8_t narrow_sat(const veci_ui32x4_t & lo, const veci_ui32x4_t & hi)
+{
+#if defined(PVECI_INTEL)
+# if defined(AVX512VL)
+    return veci_ui16x8_t(_mm_unpacklo_epi64(_mm_cvtusepi32_epi16(lo.p), _mm_cvtusepi32_epi16(hi.p)));
+# elif defined(SSE4)
+    __m128i m = _mm_set1_epi32(0xFFFF);
+    return veci_ui16x8_t(_mm_packus_epi32(_mm_min_epu32(lo.p, m), _mm_min_epu32(hi.p, m)));
+# else
+    // values >= 2^16 -> 0xFFFF
+    __m128i m = _mm_set1_epi32(0xFFFF), z = _mm_setzero_si128();
+    __m128i inl = _mm_cmpeq_epi32(_mm_srli_epi32(lo.p, 16), z);
+    __m128i inh = _mm_cmpeq_epi32(_mm_srli_epi32(hi.p, 16), z);
+    return
+        veci_ui16x8_t(
+            ipriv::packus_epi32(
+                _mm_or_si128(_mm_and_si128(inl, lo.p), _mm_andnot_si128(inl, m)),
+                _mm_or_si128(_mm_and_si128(inh, hi.p), _mm_andnot_si128(inh, m))
+            )
+        );
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui16x8_t(vcombine_u16(vqmovn_u32(lo.p), vqmovn_u32(hi.p)));
+#endif
+}
+
+inline veci_ui16x8_t narrow_usat(const veci_i32x4_t & lo, const veci_i32x4_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui16x8_t(ipriv::packus_epi32(lo.p, hi.p));
+#elif defined(PVECI_ARM)
+    return veci_ui16x8_t(vcombine_u16(vqmovun_s32(lo.p), vqmovun_s32(hi.p)));
+#endif
+}
+
+inline veci_i16x8_t narrow_trunc(const veci_i32x4_t & lo, const veci_i32x4_t & hi)
+{
+#if defined(PVECI_INTEL)
+# if defined(SSE4)
+    __m128i m = _mm_set1_epi32(0xFFFF);
+    return veci_i16x8_t(_mm_packus_epi32(_mm_and_si128(lo.p, m), _mm_and_si128(hi.p, m)));
+# else
+    // sign extend the lower words, packssdw keeps them unchanged
+    return
+        veci_i16x8_t(
+            _mm_packs_epi32(
+                _mm_srai_epi32(_mm_slli_epi32(lo.p, 16), 16),
+                _mm_srai_epi32(_mm_slli_epi32(hi.p, 16), 16)
+            )
+        );
+# endif
+#elif defined(PVECI_ARM)
+    return veci_i16x8_t(vcombine_s16(vmovn_s32(lo.p), vmovn_s32(hi.p)));
+#endif
+}
+
+inline veci_ui16x8_t narrow_trunc(const veci_ui32x4_t & lo, const veci_ui32x4_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui16x8_t(narrow_trunc(veci_i32x4_t(lo.p), veci_i32x4_t(hi.p)).p);
+#elif defined(PVECI_ARM)
+    return veci_ui16x8_t(vcombine_u16(vmovn_u32(lo.p), vmovn_u32(hi.p)));
+#endif
+}
+
+// 64 -> 32 bit
+inline veci_i32x4_t narrow_sat(const veci_i64x2_t & lo, const veci_i64x2_t & hi)
+{
+#if defined(PVECI_INTEL)
+# if defined(AVX512VL)
+    return veci_i32x4_t(_mm_unpacklo_epi64(_mm_cvtsepi64_epi32(lo.p), _mm_cvtsepi64_epi32(hi.p)));
+# else
+    return veci_i32x4_t(ipriv::pack_lo32(ipriv::sat_epi64_epi32(lo.p), ipriv::sat_epi64_epi32(hi.p)));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_i32x4_t(vcombine_s32(vqmovn_s64(lo.p), vqmovn_s64(hi.p)));
+#endif
+}
+
+inline veci_ui32x4_t narrow_sat(const veci_ui64x2_t & lo, const veci_ui64x2_t & hi)
+{
+#if defined(PVECI_INTEL)
+# if defined(AVX512VL)
+    return veci_ui32x4_t(_mm_unpacklo_epi64(_mm_cvtusepi64_epi32(lo.p), _mm_cvtusepi64_epi32(hi.p)));
+# else
+    return veci_ui32x4_t(ipriv::pack_lo32(ipriv::sat_epu64_epu32(lo.p), ipriv::sat_epu64_epu32(hi.p)));
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui32x4_t(vcombine_u32(vqmovn_u64(lo.p), vqmovn_u64(hi.p)));
+#endif
+}
+
+inline veci_ui32x4_t narrow_usat(const veci_i64x2_t & lo, const veci_i64x2_t & hi)
+{
+#if defined(PVECI_INTEL)
+# if defined(AVX512VL)
+    __m128i z = _mm_setzero_si128();
+    return
+        veci_ui32x4_t(
+            _mm_unpacklo_epi64(
+                _mm_cvtusepi64_epi32(_mm_max_epi64(lo.p, z)),
+                _mm_cvtusepi64_epi32(_mm_max_epi64(hi.p, z))
+            )
+        );
+# else
+    // negative values -> 0, then saturate as unsigned
+    __m128i nl = _mm_shuffle_epi32(_mm_srai_epi32(lo.p, 31), _MM_SHUFFLE(3,3,1,1));
+    __m128i nh = _mm_shuffle_epi32(_mm_srai_epi32(hi.p, 31), _MM_SHUFFLE(3,3,1,1));
+    return
+        veci_ui32x4_t(
+            ipriv::pack_lo32(
+                ipriv::sat_epu64_epu32(_mm_andnot_si128(nl, lo.p)),
+                ipriv::sat_epu64_epu32(_mm_andnot_si128(nh, hi.p))
+            )
+        );
+# endif
+#elif defined(PVECI_ARM)
+    return veci_ui32x4_t(vcombine_u32(vqmovun_s64(lo.p), vqmovun_s64(hi.p)));
+#endif
+}
+
+inline veci_i32x4_t narrow_trunc(const veci_i64x2_t & lo, const veci_i64x2_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_i32x4_t(ipriv::pack_lo32(lo.p, hi.p));
+#elif defined(PVECI_ARM)
+    return veci_i32x4_t(vcombine_s32(vmovn_s64(lo.p), vmovn_s64(hi.p)));
+#endif
+}
+
+inline veci_ui32x4_t narrow_trunc(const veci_ui64x2_t & lo, const veci_ui64x2_t & hi)
+{
+#if defined(PVECI_INTEL)
+    return veci_ui32x4_t(ipriv::pack_lo32(lo.p, hi.p));
+#elif defined(PVECI_ARM)
+    return veci_ui32x4_t(vcombine_u32(vmovn_u64(lo.p), vmovn_u64(hi.p)));
+#endif
+}
+
+
+//
+// array variants
+//
+inline void cvt_f32_many(float * dst, const int32_t * src, size_t n)
+{
+    ipriv::cvt_many<4>(dst, src, n, [](float * d, const int32_t * s) {
+        veci_i32x4_t v; v.loadu(s); cvt_f32(v).storeu(d);
+    });
+}
+
+inline void cvt_f32_many(float * dst, const uint32_t * src, size_t n)
+{
+    ipriv::cvt_many<4>(dst, src, n, [](float * d, const uint32_t * s) {
+        veci_ui32x4_t v; v.loadu(s); cvt_f32(v).storeu(d);
+    });
+}
+
+inline void cvt_f32_many(float * dst, const uint16_t * src, size_t n)
+{
+    ipriv::cvt_many<8>(dst, src, n, [](float * d, const uint16_t * s) {
+        veci_ui16x8_t v; v.loadu(s); vec4f_t lo, hi; cvt_f32(v, lo, hi);
+        lo.storeu(d); hi.storeu(d + 4);
+    });
+}
+
+inline void cvt_f32_norm_many(float * dst, const uint16_t * src, size_t n)
+{
+    ipriv::cvt_many<8>(dst, src, n, [](float * d, const uint16_t * s) {
+        veci_ui16x8_t v; v.loadu(s); vec4f_t lo, hi; cvt_f32_norm(v, lo, hi);
+        lo.storeu(d); hi.storeu(d + 4);
+    });
+}
+
+inline void cvt_f32_many(float * dst, const uint8_t * src, size_t n)
+{
+    ipriv::cvt_many<16>(dst, src, n, [](float * d, const uint8_t * s) {
+        veci_ui8x16_t v; v.loadu(s); vec4f_t r[4]; cvt_f32(v, r);
+        for(int i = 0; i < 4; ++i) r[i].storeu(d + 4*i);
+    });
+}
+
+inline void cvt_f32_norm_many(float * dst, const uint8_t * src, size_t n)
+{
+    ipriv::cvt_many<16>(dst, src, n, [](float * d, const uint8_t * s) {
+        veci_ui8x16_t v; v.loadu(s); vec4f_t r[4]; cvt_f32_norm(v, r);
+        for(int i = 0; i < 4; ++i) r[i].storeu(d + 4*i);
+    });
+}
+
+template<round_t R> inline void cvt_i32_many(int32_t * dst, const float * src, size_t n)
+{
+    ipriv::cvt_many<4>(dst, src, n, [](int32_t * d, const float * s) {
+        vec4f_t v; v.loadu(s); cvt_i32<R>(v).storeu(d);
+    });
+}
+
+template<round_t R> inline void cvt_i32_sat_many(int32_t * dst, const float * src, size_t n)
+{
+    ipriv::cvt_many<4>(dst, src, n, [](int32_t * d, const float * s) {
+        vec4f_t v; v.loadu(s); cvt_i32_sat<R>(v).storeu(d);
+    });
+}
+
+template<round_t R> inline void cvt_u32_many(uint32_t * dst, const float * src, size_t n)
+{
+    ipriv::cvt_many<4>(dst, src, n, [](uint32_t * d, const float * s) {
+        vec4f_t v; v.loadu(s); cvt_u32<R>(v).storeu(d);
+    });
+}
+
+template<round_t R> inline void cvt_u32_sat_many(uint32_t * dst, const float * src, size_t n)
+{
+    ipriv::cvt_many<4>(dst, src, n, [](uint32_t * d, const float * s) {
+        vec4f_t v; v.loadu(s); cvt_u32_sat<R>(v).storeu(d);
+    });
+}
+
+#if defined(PVECI_INTEL) && (defined(SSE2) || defined(AVX))
+inline void cvt_f64_many(double * dst, const int64_t * src, size_t n)
+{
+    ipriv::cvt_many<2>(dst, src, n, [](double * d, const int64_t * s) {
+        veci_i64x2_t v; v.loadu(s); _mm_storeu_pd(d, cvt_f64(v).p);
+    });
+}
+
+template<round_t R> inline void cvt_i64_many(int64_t * dst, const double * src, size_t n)
+{
+    ipriv::cvt_many<2>(dst, src, n, [](int64_t * d, const double * s) {
+        cvt_i64<R>(vec2d_t(_mm_loadu_pd(s))).storeu(d);
+    });
+}
+
+template<round_t R> inline void cvt_i64_sat_many(int64_t * dst, const double * src, size_t n)
+{
+    ipriv::cvt_many<2>(dst, src, n, [](int64_t * d, const double * s) {
+        cvt_i64_sat<R>(vec2d_t(_mm_loadu_pd(s))).storeu(d);
+    });
+}
+#endif
+
+
+namespace ipriv {
+
+    // widens n elements per VN (narrow type) vectors
+    template<typename VN, typename VW>
+    inline void widen_many(typename VW::type_t * dst, const typename VN::type_t * src, size_t n)
+    {
+        typedef typename VN::type_t tn_t;
+        typedef typename VW::type_t tw_t;
+        cvt_many<VN::N>(dst, src, n, [](tw_t * d, const tn_t * s) {
+            VN v; v.loadu(s); widen_lo(v).storeu(d); widen_hi(v).storeu(d + VW::N);
+        });
+    }
+
+    // narrows n elements per F (one of narrow_sat(), narrow_usat(), narrow_trunc())
+    template<typename VW, typename VN, VN (*F)(const VW &, const VW &)>
+    inline void narrow_many(typename VN::type_t * dst, const typename VW::type_t * src, size_t n)
+    {
+        typedef typename VN::type_t tn_t;
+        typedef typename VW::type_t tw_t;
+        cvt_many<VN::N>(dst, src, n, [](tn_t * d, const tw_t * s) {
+            VW lo, hi; lo.loadu(s); hi.loadu(s + VW::N); F(lo, hi).storeu(d);
+        });
+    }
+
+} // namespace ipriv
+
+inline void widen_many(int16_t * dst, const int8_t * src, size_t n)
+{ ipriv::widen_many<veci_i8x16_t,veci_i16x8_t>(dst, src, n); }
+inline void widen_many(uint16_t * dst, const uint8_t * src, size_t n)
+{ ipriv::widen_many<veci_ui8x16_t,veci_ui16x8_t>(dst, src, n); }
+inline void widen_many(int32_t * dst, const int16_t * src, size_t n)
+{ ipriv::widen_many<veci_i16x8_t,veci_i32x4_t>(dst, src, n); }
+inline void widen_many(uint32_t * dst, const uint16_t * src, size_t n)
+{ ipriv::widen_many<veci_ui16x8_t,veci_ui32x4_t>(dst, src, n); }
+inline void widen_many(int64_t * dst, const int32_t * src, size_t n)
+{ ipriv::widen_many<veci_i32x4_t,veci_i64x2_t>(dst, src, n); }
+inline void widen_many(uint64_t * dst, const uint32_t * src, size_t n)
+{ ipriv::widen_many<veci_ui32x4_t,veci_ui64x2_t>(dst, src, n); }
+
+inline void narrow_sat_many(int8_t * dst, const int16_t * src, size_t n)
+{ ipriv::narrow_many<veci_i16x8_t,veci_i8x16_t,narrow_sat>(dst, src, n); }
+inline void narrow_sat_many(uint8_t * dst, const uint16_t * src, size_t n)
+{ ipriv::narrow_many<veci_ui16x8_t,veci_ui8x16_t,narrow_sat>(dst, src, n); }
+inline void narrow_sat_many(int16_t * dst, const int32_t * src, size_t n)
+{ ipriv::narrow_many<veci_i32x4_t,veci_i16x8_t,narrow_sat>(dst, src, n); }
+inline void narrow_sat_many(uint16_t * dst, const uint32_t * src, size_t n)
+{ ipriv::narrow_many<veci_ui32x4_t,veci_ui16x8_t,narrow_sat>(dst, src, n); }
+inline void narrow_sat_many(int32_t * dst, const int64_t * src, size_t n)
+{ ipriv::narrow_many<veci_i64x2_t,veci_i32x4_t,narrow_sat>(dst, src, n); }
+inline void narrow_sat_many(uint32_t * dst, const uint64_t * src, size_t n)
+{ ipriv::narrow_many<veci_ui64x2_t,veci_ui32x4_t,narrow_sat>(dst, src, n); }
+
+inline void narrow_usat_many(uint8_t * dst, const int16_t * src, size_t n)
+{ ipriv::narrow_many<veci_i16x8_t,veci_ui8x16_t,narrow_usat>(dst, src, n); }
+inline void narrow_usat_many(uint16_t * dst, const int32_t * src, size_t n)
+{ ipriv::narrow_many<veci_i32x4_t,veci_ui16x8_t,narrow_usat>(dst, src, n); }
+inline void narrow_usat_many(uint32_t * dst, const int64_t * src, size_t n)
+{ ipriv::narrow_many<veci_i64x2_t,veci_ui32x4_t,narrow_usat>(dst, src, n); }
+
+inline void narrow_trunc_many(int8_t * dst, const int16_t * src, size_t n)
+{ ipriv::narrow_many<veci_i16x8_t,veci_i8x16_t,narrow_trunc>(dst, src, n); }
+inline void narrow_trunc_many(uint8_t * dst, const uint16_t * src, size_t n)
+{ ipriv::narrow_many<veci_ui16x8_t,veci_ui8x16_t,narrow_trunc>(dst, src, n); }
+inline void narrow_trunc_many(int16_t * dst, const int32_t * src, size_t n)
+{ ipriv::narrow_many<veci_i32x4_t,veci_i16x8_t,narrow_trunc>(dst, src, n); }
+inline void narrow_trunc_many(uint16_t * dst, const uint32_t * src, size_t n)
+{ ipriv::narrow_many<veci_ui32x4_t,veci_ui16x8_t,narrow_trunc>(dst, src, n); }
+inline void narrow_trunc_many(int32_t * dst, const int64_t * src, size_t n)
+{ ipriv::narrow_many<veci_i64x2_t,veci_i32x4_t,narrow_trunc>(dst, src, n); }
+inline void narrow_trunc_many(uint32_t * dst, const uint64_t * src, size_t n)
+{ ipriv::narrow_many<veci_ui64x2_t,veci_ui32x4_t,narrow_trunc>(dst, src, n); }
+
+} // namespace math
+
+#endif // !defined(PCVT_H)
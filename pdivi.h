@@ -0,0 +1,559 @@
+/*******************************************************************************
+ * pdivi.h                                                                     *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PDIVI_H
+#define PDIVI_H
+
+#include <pveci.h>
+#include <stddef.h>
+
+
+/*
+integer division by runtime-invariant divisors
+----------------------------------------------
+neither SSE nor NEON provide packed integer divisions, so a division by a
+divisor d that is known at runtime only (but used for many numerators) is
+replaced by a multiplication with a precomputed "magic" number m followed by
+shifts (see Granlund/Montgomery, "Division by Invariant Integers using
+Multiplication" and Hacker's Delight, chapter 10):
+
+  unsigned, W bits, l = floor(log2(d)):
+    d == 2^l:           q = n >> l
+    m fits into W bits: q = mulhi(m, n) >> l
+    otherwise:          t = mulhi(m, n), q = (((n - t) >> 1) + t) >> l
+                        (m is W+1 bits wide, the MSB is handled by the add)
+
+  signed, W bits, l = floor(log2(|d|)):
+    |d| == 2^l:         q = (n + ((n >> (W-1)) >>> (W-l))) >> l, negated for d < 0
+    otherwise:          q = mulhi_signed(m, n) [+ n for the add variant] >> s,
+                        q = q - (q >> (W-1)) (round towards zero),
+                        sign of d folded into m (or applied to n for the add variant)
+
+the divisor object does the (scalar) precomputation once, the division of a
+whole vector then uses mulhi, shifts and adds only; the remainder is computed
+as n - q*d
+
+the kind of algorithm is selected per divisor (not per element), so the branch
+in div() is perfectly predictable in loops
+
+a divisor of 0 is not supported (the results are undefined); INT32_MIN / -1
+wraps to INT32_MIN with a remainder of 0 (the scalar division is undefined there)
+*/
+
+// TODO:
+// - [u]int64x2_t (needs a 64 bit mulhi emulation)
+// - int16x8_t / [u]int8x16_t (widening to 16 bits)
+
+
+namespace math {
+
+namespace ipriv {
+
+    // floor(log2(v)) for v > 0
+    inline unsigned floor_log2(uint32_t v)
+    {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse(&idx, v);
+        return unsigned(idx);
+#elif defined(__GNUC__)
+        return 31u - unsigned(__builtin_clz(v));
+#else
+        unsigned r = 0;
+        while(v >>= 1) ++r;
+        return r;
+#endif
+    }
+
+} // namespace ipriv
+
+
+//
+// divisor_t general template
+//
+template<typename veci_type>
+class divisor_t;
+
+
+/*****************************************************************************
+ *                                                                           *
+ * divisor_t<veci_ui32x4_t>                                                  *
+ *                                                                           *
+ *****************************************************************************/
+template<>
+class divisor_t<veci_ui32x4_t>
+{
+public:
+    typedef uint32_t type_t;
+    typedef veci_ui32x4_t vec_t;
+    typedef veci_ui32x4_t::packed_t packed_t;
+    typedef veci_ui32x4_t::math_t math_t;
+
+    inline explicit divisor_t(uint32_t d)
+        : d_(d), magic_(0), shift_(0), algo_(algo_shift)
+    {
+        unsigned l = ipriv::floor_log2(d);
+        if((d & (d - 1)) == 0) {
+            // power of 2 (including 1)
+            shift_ = l;
+            return;
+        }
+        // 2^(32+l) / d, fits into 32 bits since d > 2^l
+        uint64_t num = uint64_t(1) << (32 + l);
+        uint32_t m = uint32_t(num / d), rem = uint32_t(num % d);
+        uint32_t e = d - rem;
+        if(e < (uint32_t(1) << l)) {
+            // m+1 is precise enough (error less than 2^l)
+            algo_ = algo_mul;
+        } else {
+            // need 33 bits for the magic number (round up 2^(33+l) / d)
+            m += m;
+            uint32_t twice_rem = rem + rem;
+            if(twice_rem >= d || twice_rem < rem) m += 1;
+            algo_ = algo_mul_add;
+        }
+        magic_ = m + 1;
+        shift_ = l;
+    }
+
+    inline uint32_t divisor() const { return d_; }
+
+    // scalar versions (tails of arrays)
+    inline uint32_t div(uint32_t n) const
+    {
+        if(algo_ == algo_shift) return n >> shift_;
+        uint32_t q = uint32_t((uint64_t(magic_) * n) >> 32);
+        if(algo_ == algo_mul) return q >> shift_;
+        return (((n - q) >> 1) + q) >> shift_;
+    }
+    inline uint32_t mod(uint32_t n) const { return n - div(n) * d_; }
+
+    inline veci_ui32x4_t div(const veci_ui32x4_t & n) const { return veci_ui32x4_t(div(n.p)); }
+    inline veci_ui32x4_t mod(const veci_ui32x4_t & n) const { return veci_ui32x4_t(mod(n.p)); }
+
+    inline packed_t div(packed_t n) const
+    {
+#if defined(PVECI_INTEL)
+        __m128i cnt = _mm_cvtsi32_si128(int(shift_));
+        if(algo_ == algo_shift) return _mm_srl_epi32(n, cnt);
+        __m128i q = mulhi(n);
+        if(algo_ == algo_mul) return _mm_srl_epi32(q, cnt);
+        __m128i t = _mm_add_epi32(_mm_srli_epi32(_mm_sub_epi32(n, q), 1), q);
+        return _mm_srl_epi32(t, cnt);
+#elif defined(PVECI_ARM)
+        int32x4_t cnt = vdupq_n_s32(-int(shift_));
+        if(algo_ == algo_shift) return vshlq_u32(n, cnt);
+        uint32x4_t q = mulhi(n);
+        if(algo_ == algo_mul) return vshlq_u32(q, cnt);
+        uint32x4_t t = vsraq_n_u32(q, vsubq_u32(n, q), 1); // q + ((n-q) >> 1)
+        return vshlq_u32(t, cnt);
+#endif
+    }
+    inline packed_t mod(packed_t n) const
+    {
+#if defined(PVECI_INTEL)
+        if(algo_ == algo_shift)
+            return _mm_and_si128(n, _mm_set1_epi32(int(d_ - 1)));
+        return _mm_sub_epi32(n, mullo(div(n), _mm_set1_epi32(int(d_))));
+#elif defined(PVECI_ARM)
+        if(algo_ == algo_shift)
+            return vandq_u32(n, vdupq_n_u32(d_ - 1));
+        return vmlsq_u32(n, div(n), vdupq_n_u32(d_)); // n - q*d
+#endif
+    }
+
+    // whole-array versions (in-place, unaligned)
+    inline void div_many(uint32_t * p, size_t n) const
+    {
+        size_t i = 0;
+        for(veci_ui32x4_t v; i + 4 <= n; i += 4) {
+            v.loadu(p + i); v.p = div(v.p); v.storeu(p + i);
+        }
+        for(; i < n; ++i) p[i] = div(p[i]);
+    }
+    inline void mod_many(uint32_t * p, size_t n) const
+    {
+        size_t i = 0;
+        for(veci_ui32x4_t v; i + 4 <= n; i += 4) {
+            v.loadu(p + i); v.p = mod(v.p); v.storeu(p + i);
+        }
+        for(; i < n; ++i) p[i] = mod(p[i]);
+    }
+
+private:
+    enum algo_t { algo_shift, algo_mul, algo_mul_add };
+
+#if defined(PVECI_INTEL)
+    // upper 32 bits of the 64 bit products n[i]*magic_
+    inline __m128i mulhi(__m128i n) const
+    {
+        __m128i m = _mm_set1_epi32(int(magic_));
+        __m128i even = _mm_srli_epi64(_mm_mul_epu32(n, m), 32);        // {h0,0,h2,0}
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(n, 32), m);         // {l1,h1,l3,h3}
+        return _mm_or_si128(even, _mm_and_si128(odd, _mm_slli_epi64(math_t::onebits(), 32)));
+    }
+    // lower 32 bits of the products a[i]*b[i]
+    static inline __m128i mullo(__m128i a, __m128i b)
+    {
+# if defined(SSE4)
+        return _mm_mullo_epi32(a, b);
+# else
+        __m128i even = _mm_mul_epu32(a, b);                                     // {l0,h0,l2,h2}
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)); // {l1,h1,l3,h3}
+        return
+            _mm_unpacklo_epi32(
+                _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), // {l0,l2,..}
+                _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))   // {l1,l3,..}
+            ); // {l0,l1,l2,l3}
+# endif
+    }
+#elif defined(PVECI_ARM)
+    inline uint32x4_t mulhi(uint32x4_t n) const
+    {
+        uint32x2_t m = vdup_n_u32(magic_);
+        return
+            vcombine_u32(
+                vshrn_n_u64(vmull_u32(vget_low_u32(n), m), 32),
+                vshrn_n_u64(vmull_u32(vget_high_u32(n), m), 32)
+            );
+    }
+#endif
+
+    uint32_t d_;
+    uint32_t magic_;
+    unsigned shift_;
+    algo_t algo_;
+};
+
+
+/*****************************************************************************
+ *                                                                           *
+ * divisor_t<veci_i32x4_t>                                                   *
+ *                                                                           *
+ *****************************************************************************/
+template<>
+class divisor_t<veci_i32x4_t>
+{
+public:
+    typedef int32_t type_t;
+    typedef veci_i32x4_t vec_t;
+    typedef veci_i32x4_t::packed_t packed_t;
+    typedef veci_i32x4_t::math_t math_t;
+
+    inline explicit divisor_t(int32_t d)
+        : d_(d), magic_(0), shift_(0), algo_(algo_shift), neg_(d < 0)
+    {
+        uint32_t abs_d = d < 0 ? 0u - uint32_t(d) : uint32_t(d);
+        unsigned l = ipriv::floor_log2(abs_d);
+        if((abs_d & (abs_d - 1)) == 0) {
+            // power of 2 (including +-1 and INT32_MIN)
+            shift_ = l;
+            return;
+        }
+        // 2^(31+l) / |d|
+        uint64_t num = uint64_t(1) << (31 + l);
+        uint32_t m = uint32_t(num / abs_d), rem = uint32_t(num % abs_d);
+        uint32_t e = abs_d - rem;
+        if(e < (uint32_t(1) << l)) {
+            shift_ = l - 1;
+            algo_ = algo_mul;
+        } else {
+            // magic number needs 33 bits, the numerator is added after mulhi
+            m += m;
+            uint32_t twice_rem = rem + rem;
+            if(twice_rem >= abs_d || twice_rem < rem) m += 1;
+            shift_ = l;
+            algo_ = algo_mul_add;
+        }
+        m += 1;
+        // the sign of the divisor is folded into the magic number
+        magic_ = int32_t(neg_ ? 0u - m : m);
+    }
+
+    inline int32_t divisor() const { return d_; }
+
+    // scalar versions (tails of arrays)
+    inline int32_t div(int32_t n) const
+    {
+        if(algo_ == algo_shift) {
+            uint32_t mask = (uint32_t(1) << shift_) - 1;
+            int32_t q = int32_t(uint32_t(n) + (uint32_t(n >> 31) & mask)) >> shift_;
+            return neg_ ? int32_t(0u - uint32_t(q)) : q;
+        }
+        int32_t q = int32_t((int64_t(magic_) * n) >> 32);
+        if(algo_ == algo_mul_add)
+            q = int32_t(uint32_t(q) + (neg_ ? 0u - uint32_t(n) : uint32_t(n)));
+        q >>= shift_;
+        return q + int32_t(uint32_t(q) >> 31);
+    }
+    inline int32_t mod(int32_t n) const { return int32_t(uint32_t(n) - uint32_t(div(n)) * uint32_t(d_)); }
+
+    inline veci_i32x4_t div(const veci_i32x4_t & n) const { return veci_i32x4_t(div(n.p)); }
+    inline veci_i32x4_t mod(const veci_i32x4_t & n) const { return veci_i32x4_t(mod(n.p)); }
+
+    inline packed_t div(packed_t n) const
+    {
+#if defined(PVECI_INTEL)
+        __m128i cnt = _mm_cvtsi32_si128(int(shift_));
+        __m128i q;
+        if(algo_ == algo_shift) {
+            // add 2^l-1 to negative numerators to round towards zero
+            __m128i bias = _mm_srl_epi32(_mm_srai_epi32(n, 31), _mm_cvtsi32_si128(int(32 - shift_)));
+            q = _mm_sra_epi32(_mm_add_epi32(n, bias), cnt);
+            return neg_ ? _mm_sub_epi32(math_t::zeroes(), q) : q;
+        }
+        q = mulhi(n);
+        if(algo_ == algo_mul_add)
+            q = neg_ ? _mm_sub_epi32(q, n) : _mm_add_epi32(q, n);
+        q = _mm_sra_epi32(q, cnt);
+        return _mm_add_epi32(q, _mm_srli_epi32(q, 31));
+#elif defined(PVECI_ARM)
+        int32x4_t q;
+        if(algo_ == algo_shift) {
+            int32x4_t bias =
+                vreinterpretq_s32_u32(
+                    vshlq_u32(vreinterpretq_u32_s32(vshrq_n_s32(n, 31)), vdupq_n_s32(int(shift_) - 32))
+                );
+            q = vshlq_s32(vaddq_s32(n, bias), vdupq_n_s32(-int(shift_)));
+            return neg_ ? vnegq_s32(q) : q;
+        }
+        q = mulhi(n);
+        if(algo_ == algo_mul_add)
+            q = neg_ ? vsubq_s32(q, n) : vaddq_s32(q, n);
+        q = vshlq_s32(q, vdupq_n_s32(-int(shift_)));
+        return vaddq_s32(q, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(q), 31)));
+#endif
+    }
+    inline packed_t mod(packed_t n) const
+    {
+#if defined(PVECI_INTEL)
+        return _mm_sub_epi32(n, mullo(div(n), _mm_set1_epi32(d_)));
+#elif defined(PVECI_ARM)
+        return vmlsq_s32(n, div(n), vdupq_n_s32(d_)); // n - q*d
+#endif
+    }
+
+    // whole-array versions (in-place, unaligned)
+    inline void div_many(int32_t * p, size_t n) const
+    {
+        size_t i = 0;
+        for(veci_i32x4_t v; i + 4 <= n; i += 4) {
+            v.loadu(p + i); v.p = div(v.p); v.storeu(p + i);
+        }
+        for(; i < n; ++i) p[i] = div(p[i]);
+    }
+    inline void mod_many(int32_t * p, size_t n) const
+    {
+        size_t i = 0;
+        for(veci_i32x4_t v; i + 4 <= n; i += 4) {
+            v.loadu(p + i); v.p = mod(v.p); v.storeu(p + i);
+        }
+        for(; i < n; ++i) p[i] = mod(p[i]);
+    }
+
+private:
+    enum algo_t { algo_shift, algo_mul, algo_mul_add };
+
+#if defined(PVECI_INTEL)
+    // upper 32 bits of the signed 64 bit products n[i]*magic_
+    inline __m128i mulhi(__m128i n) const
+    {
+        __m128i m = _mm_set1_epi32(magic_);
+# if defined(SSE4)
+        __m128i even = _mm_srli_epi64(_mm_mul_epi32(n, m), 32);
+        __m128i odd = _mm_mul_epi32(_mm_srli_epi64(n, 32), m);
+        return _mm_or_si128(even, _mm_and_si128(odd, _mm_slli_epi64(math_t::onebits(), 32)));
+# else
+        // unsigned mulhi corrected for the signs of the operands:
+        // hi_s(a,b) = hi_u(a,b) - (a<0 ? b : 0) - (b<0 ? a : 0)
+        __m128i even = _mm_srli_epi64(_mm_mul_epu32(n, m), 32);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(n, 32), m);
+        __m128i hi = _mm_or_si128(even, _mm_and_si128(odd, _mm_slli_epi64(math_t::onebits(), 32)));
+        __m128i corr =
+            _mm_add_epi32(
+                _mm_and_si128(_mm_srai_epi32(n, 31), m),
+                _mm_and_si128(_mm_srai_epi32(m, 31), n)
+            );
+        return _mm_sub_epi32(hi, corr);
+# endif
+    }
+    static inline __m128i mullo(__m128i a, __m128i b)
+    {
+# if defined(SSE4)
+        return _mm_mullo_epi32(a, b);
+# else
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return
+            _mm_unpacklo_epi32(
+                _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))
+            );
+# endif
+    }
+#elif defined(PVECI_ARM)
+    inline int32x4_t mulhi(int32x4_t n) const
+    {
+        int32x2_t m = vdup_n_s32(magic_);
+        return
+            vcombine_s32(
+                vshrn_n_s64(vmull_s32(vget_low_s32(n), m), 32),
+                vshrn_n_s64(vmull_s32(vget_high_s32(n), m), 32)
+            );
+    }
+#endif
+
+    int32_t d_;
+    int32_t magic_;
+    unsigned shift_;
+    algo_t algo_;
+    bool neg_;
+};
+
+
+/*****************************************************************************
+ *                                                                           *
+ * divisor_t<veci_ui16x8_t>                                                  *
+ *                                                                           *
+ *****************************************************************************/
+template<>
+class divisor_t<veci_ui16x8_t>
+{
+public:
+    typedef uint16_t type_t;
+    typedef veci_ui16x8_t vec_t;
+    typedef veci_ui16x8_t::packed_t packed_t;
+    typedef veci_ui16x8_t::math_t math_t;
+
+    inline explicit divisor_t(uint16_t d)
+        : d_(d), magic_(0), shift_(0), algo_(algo_shift)
+    {
+        unsigned l = ipriv::floor_log2(d);
+        if((d & (d - 1)) == 0) {
+            shift_ = l;
+            return;
+        }
+        // 2^(16+l) / d
+        uint32_t num = uint32_t(1) << (16 + l);
+        uint16_t m = uint16_t(num / d), rem = uint16_t(num % d);
+        uint16_t e = uint16_t(d - rem);
+        if(e < (1u << l)) {
+            algo_ = algo_mul;
+        } else {
+            m = uint16_t(m + m);
+            uint16_t twice_rem = uint16_t(rem + rem);
+            if(twice_rem >= d || twice_rem < rem) m = uint16_t(m + 1);
+            algo_ = algo_mul_add;
+        }
+        magic_ = uint16_t(m + 1);
+        shift_ = l;
+    }
+
+    inline uint16_t divisor() const { return d_; }
+
+    // scalar versions (tails of arrays)
+    inline uint16_t div(uint16_t n) const
+    {
+        if(algo_ == algo_shift) return uint16_t(n >> shift_);
+        uint16_t q = uint16_t((uint32_t(magic_) * n) >> 16);
+        if(algo_ == algo_mul) return uint16_t(q >> shift_);
+        return uint16_t(((uint16_t(n - q) >> 1) + q) >> shift_);
+    }
+    inline uint16_t mod(uint16_t n) const { return uint16_t(n - div(n) * d_); }
+
+    inline veci_ui16x8_t div(const veci_ui16x8_t & n) const { return veci_ui16x8_t(div(n.p)); }
+    inline veci_ui16x8_t mod(const veci_ui16x8_t & n) const { return veci_ui16x8_t(mod(n.p)); }
+
+    inline packed_t div(packed_t n) const
+    {
+#if defined(PVECI_INTEL)
+        __m128i cnt = _mm_cvtsi32_si128(int(shift_));
+        if(algo_ == algo_shift) return _mm_srl_epi16(n, cnt);
+        __m128i q = _mm_mulhi_epu16(n, _mm_set1_epi16(short(magic_)));
+        if(algo_ == algo_mul) return _mm_srl_epi16(q, cnt);
+        __m128i t = _mm_add_epi16(_mm_srli_epi16(_mm_sub_epi16(n, q), 1), q);
+        return _mm_srl_epi16(t, cnt);
+#elif defined(PVECI_ARM)
+        int16x8_t cnt = vdupq_n_s16(int16_t(-int(shift_)));
+        if(algo_ == algo_shift) return vshlq_u16(n, cnt);
+        uint16x4_t m = vdup_n_u16(magic_);
+        uint16x8_t q =
+            vcombine_u16(
+                vshrn_n_u32(vmull_u16(vget_low_u16(n), m), 16),
+                vshrn_n_u32(vmull_u16(vget_high_u16(n), m), 16)
+            );
+        if(algo_ == algo_mul) return vshlq_u16(q, cnt);
+        uint16x8_t t = vsraq_n_u16(q, vsubq_u16(n, q), 1);
+        return vshlq_u16(t, cnt);
+#endif
+    }
+    inline packed_t mod(packed_t n) const
+    {
+#if defined(PVECI_INTEL)
+        if(algo_ == algo_shift)
+            return _mm_and_si128(n, _mm_set1_epi16(short(d_ - 1)));
+        return _mm_sub_epi16(n, _mm_mullo_epi16(div(n), _mm_set1_epi16(short(d_))));
+#elif defined(PVECI_ARM)
+        if(algo_ == algo_shift)
+            return vandq_u16(n, vdupq_n_u16(uint16_t(d_ - 1)));
+        return vmlsq_u16(n, div(n), vdupq_n_u16(d_));
+#endif
+    }
+
+    // whole-array versions (in-place, unaligned)
+    inline void div_many(uint16_t * p, size_t n) const
+    {
+        size_t i = 0;
+        for(veci_ui16x8_t v; i + 8 <= n; i += 8) {
+            v.loadu(p + i); v.p = div(v.p); v.storeu(p + i);
+        }
+        for(; i < n; ++i) p[i] = div(p[i]);
+    }
+    inline void mod_many(uint16_t * p, size_t n) const
+    {
+        size_t i = 0;
+        for(veci_ui16x8_t v; i + 8 <= n; i += 8) {
+            v.loadu(p + i); v.p = mod(v.p); v.storeu(p + i);
+        }
+        for(; i < n; ++i) p[i] = mod(p[i]);
+    }
+
+private:
+    enum algo_t { algo_shift, algo_mul, algo_mul_add };
+
+    uint16_t d_;
+    uint16_t magic_;
+    unsigned shift_;
+    algo_t algo_;
+};
+
+
+// free-standing operators
+inline veci_ui32x4_t operator/(const veci_ui32x4_t & n, const divisor_t<veci_ui32x4_t> & d)
+{ return d.div(n); }
+inline veci_ui32x4_t operator%(const veci_ui32x4_t & n, const divisor_t<veci_ui32x4_t> & d)
+{ return d.mod(n); }
+inline veci_i32x4_t operator/(const veci_i32x4_t & n, const divisor_t<veci_i32x4_t> & d)
+{ return d.div(n); }
+inline veci_i32x4_t operator%(const veci_i32x4_t & n, const divisor_t<veci_i32x4_t> & d)
+{ return d.mod(n); }
+inline veci_ui16x8_t operator/(const veci_ui16x8_t & n, const divisor_t<veci_ui16x8_t> & d)
+{ return d.div(n); }
+inline veci_ui16x8_t operator%(const veci_ui16x8_t & n, const divisor_t<veci_ui16x8_t> & d)
+{ return d.mod(n); }
+
+typedef divisor_t<veci_ui32x4_t> divisor_ui32x4_t;
+typedef divisor_t<veci_i32x4_t> divisor_i32x4_t;
+typedef divisor_t<veci_ui16x8_t> divisor_ui16x8_t;
+
+
+} // namespace math
+
+
+#endif // !defined(PDIVI_H)
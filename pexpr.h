@@ -0,0 +1,383 @@
+/*******************************************************************************
+ * pexpr.h                                                                     *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PEXPR_H
+#define PEXPR_H
+
+#include <pvecf.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+
+/*
+lazy array expressions
+----------------------
+operators on whole buffers (valarray style) that don't compute anything but
+build an expression tree; the assignment evaluates the tree in a single pass
+over the buffers, one vector register at a time, without temporary arrays:
+
+  array_ref(out, n) = array_ref(a, n) * array_ref(b, n)
+                    + fast_sin(array_ref(c, n)) * 0.5f;
+
+is the same loop as
+
+  for(i = 0; i < n; i += N)
+      out[i..] = mul_add(a[i..], b[i..], fast_sin_1(c[i..]) * 0.5f);
+
+terminals:
+  array_ref(p, n)     n elements at p (float or double, const for inputs),
+                      assignable if p is not const
+  scalars             float/double constants are broadcast
+
+operations:
+  + - * /             element-wise, expression/expression or expression/scalar
+  -e                  negation
+  abs_(e)             absolute value
+  min_(e1, e2)        element-wise minimum/maximum (expressions or scalars)
+  max_(e1, e2)
+  fast_sin(e)         math_t::fast_sin_1()/fast_cos_1(), so the same ranges
+  fast_cos(e)         and errors apply (angles in [0,pi/2])
+  map(e, f)           user defined: vec_t f(vec_t) per register
+
+evaluation:
+  the register type is vec4f_t/vec2d_t (vec8f_t/vec4d_t with AVX), a sum
+  with a product as operand (a*b + c, c + a*b) is evaluated per
+  math_t::mul_add(), so it maps to a single FMA instruction if FMA is defined;
+  the last n % N elements are evaluated in a zero padded register and only
+  the valid elements are stored, so the buffers need no padding
+
+  evaluate(dst, e, begin, end) evaluates the range [begin, end) only, e.g.
+  per parallel_for() chunk (pparallel.h)
+
+all arrays of an expression must have the same size; the expression stores
+the pointers only, the buffers have to outlive it; the destination may be
+one of the operands (every element is read before it's written)
+*/
+
+// TODO:
+// - fused multiply-subtract (a*b - c), math_t has no mul_sub() yet
+// - reductions (sum, dot) over expressions
+
+
+namespace math {
+
+namespace ipriv {
+
+    // register type used for the evaluation
+    template<typename real_t> struct expr_vec;
+#if defined(PVECF_INTEL)
+#if defined(AVX)
+    template<> struct expr_vec<float>  { typedef vec8f_t type; };
+    template<> struct expr_vec<double> { typedef vec4d_t type; };
+#else
+    template<> struct expr_vec<float>  { typedef vec4f_t type; };
+#if defined(SSE2)
+    template<> struct expr_vec<double> { typedef vec2d_t type; };
+#endif
+#endif
+#elif defined(PVECF_ARM)
+    template<> struct expr_vec<float>  { typedef vec4f_t type; };
+#endif
+
+    struct expr_base_t {};
+
+    template<typename E> struct is_expr
+        : std::is_base_of<expr_base_t, typename std::decay<E>::type> {};
+
+    template<typename E1, typename E2> struct expr_real
+    {
+        typedef typename E1::real_t type;
+        static_assert(std::is_same<type, typename E2::real_t>::value,
+                      "array expression: float and double operands mixed");
+    };
+
+    // size of the arrays, 0: scalar
+    inline size_t expr_size(size_t n1, size_t n2) { return n1 ? n1 : n2; }
+
+} // namespace ipriv
+
+
+//
+// terminals
+//
+template<typename T>
+class array_ref_t : public ipriv::expr_base_t
+{
+public:
+    typedef typename std::remove_const<T>::type real_t;
+
+    array_ref_t(T * p, size_t n) : p_(p), n_(n) {}
+    // copies refer to the same elements, the expression nodes hold copies
+    array_ref_t(const array_ref_t &) = default;
+
+    size_t size() const { return n_; }
+    T * data() const { return p_; }
+
+    template<typename V, bool Full> V eval(size_t i, size_t m) const
+    {
+        V v;
+        if(Full)
+            v.loadu(p_ + i);
+        else {
+            real_t tmp[V::N] = {};
+            memcpy(tmp, p_ + i, m * sizeof(real_t));
+            v.loadu(tmp);
+        }
+        return v;
+    }
+
+    // evaluate into the array
+    array_ref_t & operator=(const array_ref_t & a) { return assign(a); }
+    template<typename E>
+    typename std::enable_if<ipriv::is_expr<E>::value, array_ref_t &>::type
+    operator=(const E & e) { return assign(e); }
+    array_ref_t & operator=(real_t s);
+
+    template<typename E> array_ref_t & operator+=(const E & e) { return assign(*this + e); }
+    template<typename E> array_ref_t & operator-=(const E & e) { return assign(*this - e); }
+    template<typename E> array_ref_t & operator*=(const E & e) { return assign(*this * e); }
+    template<typename E> array_ref_t & operator/=(const E & e) { return assign(*this / e); }
+
+private:
+    template<typename E> array_ref_t & assign(const E & e);
+
+    T * p_;
+    size_t n_;
+};
+
+template<typename T> inline array_ref_t<T> array_ref(T * p, size_t n)
+{ return array_ref_t<T>(p, n); }
+
+template<typename R>
+class expr_scalar_t : public ipriv::expr_base_t
+{
+public:
+    typedef R real_t;
+
+    explicit expr_scalar_t(R s) : s_(s) {}
+
+    size_t size() const { return 0; }
+
+    template<typename V, bool> V eval(size_t, size_t) const
+    { return V(V::math_t::set1(s_)); }
+
+private:
+    R s_;
+};
+
+
+//
+// nodes
+//
+template<typename Op, typename A>
+class expr_unary_t : public ipriv::expr_base_t
+{
+public:
+    typedef typename A::real_t real_t;
+
+    expr_unary_t(const A & a, const Op & op = Op()) : a_(a), op_(op) {}
+
+    size_t size() const { return a_.size(); }
+
+    template<typename V, bool Full> V eval(size_t i, size_t m) const
+    { return op_(a_.template eval<V,Full>(i, m)); }
+
+private:
+    A a_;
+    Op op_;
+};
+
+template<typename Op, typename L, typename R>
+class expr_binary_t : public ipriv::expr_base_t
+{
+public:
+    typedef typename ipriv::expr_real<L,R>::type real_t;
+
+    expr_binary_t(const L & l, const R & r) : l_(l), r_(r) {}
+
+    size_t size() const { return ipriv::expr_size(l_.size(), r_.size()); }
+    const L & lhs() const { return l_; }
+    const R & rhs() const { return r_; }
+
+    template<typename V, bool Full> V eval(size_t i, size_t m) const
+    { return Op::template eval<V,Full>(l_, r_, i, m); }
+
+private:
+    L l_;
+    R r_;
+};
+
+namespace ipriv {
+
+    struct expr_mul;
+
+    // a*b + c and c + a*b per mul_add()
+    template<typename V, bool Full, typename L, typename R>
+    inline V expr_add_eval(const L & l, const R & r, size_t i, size_t m)
+    { return l.template eval<V,Full>(i, m) + r.template eval<V,Full>(i, m); }
+    template<typename V, bool Full, typename A, typename B, typename R>
+    inline V expr_add_eval(const expr_binary_t<expr_mul,A,B> & l, const R & r, size_t i, size_t m)
+    {
+        return V(V::math_t::mul_add(l.lhs().template eval<V,Full>(i, m).p,
+                                    l.rhs().template eval<V,Full>(i, m).p,
+                                    r.template eval<V,Full>(i, m).p));
+    }
+    template<typename V, bool Full, typename L, typename A, typename B>
+    inline V expr_add_eval(const L & l, const expr_binary_t<expr_mul,A,B> & r, size_t i, size_t m)
+    {
+        return V(V::math_t::mul_add(r.lhs().template eval<V,Full>(i, m).p,
+                                    r.rhs().template eval<V,Full>(i, m).p,
+                                    l.template eval<V,Full>(i, m).p));
+    }
+    template<typename V, bool Full, typename A, typename B, typename C, typename D>
+    inline V expr_add_eval(const expr_binary_t<expr_mul,A,B> & l, const expr_binary_t<expr_mul,C,D> & r,
+                           size_t i, size_t m)
+    {
+        return V(V::math_t::mul_add(l.lhs().template eval<V,Full>(i, m).p,
+                                    l.rhs().template eval<V,Full>(i, m).p,
+                                    r.template eval<V,Full>(i, m).p));
+    }
+
+    struct expr_add
+    {
+        template<typename V, bool Full, typename L, typename R>
+        static V eval(const L & l, const R & r, size_t i, size_t m)
+        { return expr_add_eval<V,Full>(l, r, i, m); }
+    };
+
+#define PEXPR_BINARY_OP_(name, expr) \
+    struct name \
+    { \
+        template<typename V, bool Full, typename L, typename R> \
+        static V eval(const L & l, const R & r, size_t i, size_t m) \
+        { V a(l.template eval<V,Full>(i, m)), b(r.template eval<V,Full>(i, m)); return expr; } \
+    };
+    PEXPR_BINARY_OP_(expr_sub, a - b)
+    PEXPR_BINARY_OP_(expr_mul, a * b)
+    PEXPR_BINARY_OP_(expr_div, a / b)
+    PEXPR_BINARY_OP_(expr_min, V::min_(a, b))
+    PEXPR_BINARY_OP_(expr_max, V::max_(a, b))
+#undef PEXPR_BINARY_OP_
+
+    struct expr_neg      { template<typename V> V operator()(const V & a) const { return V() - a; } };
+    struct expr_abs      { template<typename V> V operator()(const V & a) const { return a.abs_(); } };
+    struct expr_fast_sin { template<typename V> V operator()(const V & a) const { return V(V::math_t::fast_sin_1(a.p)); } };
+    struct expr_fast_cos { template<typename V> V operator()(const V & a) const { return V(V::math_t::fast_cos_1(a.p)); } };
+
+    // scalars become expr_scalar_t, expressions are stored as they are
+    template<typename E, typename R, bool = is_expr<E>::value> struct expr_operand
+    {
+        typedef E type;
+        static const E & wrap(const E & e) { return e; }
+    };
+    template<typename E, typename R> struct expr_operand<E, R, false>
+    {
+        typedef expr_scalar_t<R> type;
+        static type wrap(const E & s) { return type(R(s)); }
+    };
+
+    // result of a binary operation, at least one operand is an expression
+    template<typename Op, typename E1, typename E2, bool X1> struct expr_result_impl
+    {
+        typedef typename std::conditional<X1, E1, E2>::type::real_t real_t;
+        typedef expr_operand<E1, real_t> o1;
+        typedef expr_operand<E2, real_t> o2;
+        typedef expr_binary_t<Op, typename o1::type, typename o2::type> type;
+        static type make(const E1 & e1, const E2 & e2) { return type(o1::wrap(e1), o2::wrap(e2)); }
+    };
+    template<typename Op, typename E1, typename E2, typename = void> struct expr_result {};
+    template<typename Op, typename E1, typename E2>
+    struct expr_result<Op, E1, E2, typename std::enable_if<is_expr<E1>::value &&
+        (is_expr<E2>::value || std::is_arithmetic<E2>::value)>::type>
+        : expr_result_impl<Op, E1, E2, true> {};
+    template<typename Op, typename E1, typename E2>
+    struct expr_result<Op, E1, E2, typename std::enable_if<std::is_arithmetic<E1>::value &&
+        is_expr<E2>::value>::type>
+        : expr_result_impl<Op, E1, E2, false> {};
+
+} // namespace ipriv
+
+
+//
+// operators and functions
+//
+#define PEXPR_BINARY_FN_(fn, op) \
+template<typename E1, typename E2> \
+inline typename ipriv::expr_result<ipriv::op, E1, E2>::type fn(const E1 & e1, const E2 & e2) \
+{ return ipriv::expr_result<ipriv::op, E1, E2>::make(e1, e2); }
+PEXPR_BINARY_FN_(operator+, expr_add)
+PEXPR_BINARY_FN_(operator-, expr_sub)
+PEXPR_BINARY_FN_(operator*, expr_mul)
+PEXPR_BINARY_FN_(operator/, expr_div)
+PEXPR_BINARY_FN_(min_, expr_min)
+PEXPR_BINARY_FN_(max_, expr_max)
+#undef PEXPR_BINARY_FN_
+
+#define PEXPR_UNARY_FN_(fn, op) \
+template<typename E> \
+inline typename std::enable_if<ipriv::is_expr<E>::value, expr_unary_t<ipriv::op, E> >::type \
+fn(const E & e) { return expr_unary_t<ipriv::op, E>(e); }
+PEXPR_UNARY_FN_(operator-, expr_neg)
+PEXPR_UNARY_FN_(abs_, expr_abs)
+PEXPR_UNARY_FN_(fast_sin, expr_fast_sin)
+PEXPR_UNARY_FN_(fast_cos, expr_fast_cos)
+#undef PEXPR_UNARY_FN_
+
+// f: vec_t f(const vec_t &) for the register type vec_t (see above)
+template<typename E, typename F>
+inline typename std::enable_if<ipriv::is_expr<E>::value, expr_unary_t<F, E> >::type
+map(const E & e, F f) { return expr_unary_t<F, E>(e, f); }
+
+
+//
+// evaluation
+//
+template<typename R, typename E>
+inline void evaluate(R * dst, const E & e, size_t begin, size_t end)
+{
+    static_assert(ipriv::is_expr<E>::value, "evaluate(): not an array expression");
+    static_assert(std::is_same<R, typename E::real_t>::value,
+                  "evaluate(): destination and expression differ in type");
+    typedef typename ipriv::expr_vec<R>::type vec_t;
+    const size_t N = vec_t::N;
+    PVEC_PROBE_N("evaluate() (pexpr.h)", end - begin);
+
+    size_t i = begin;
+    for(; i + N <= end; i += N) {
+        vec_t r(e.template eval<vec_t,true>(i, N));
+        r.storeu(dst + i);
+    }
+    if(i < end) {
+        R tmp[N];
+        vec_t r(e.template eval<vec_t,false>(i, end - i));
+        r.storeu(tmp);
+        memcpy(dst + i, tmp, (end - i) * sizeof(R));
+    }
+}
+
+template<typename R, typename E>
+inline void evaluate(R * dst, const E & e)
+{ evaluate(dst, e, 0, e.size()); }
+
+template<typename T> template<typename E>
+inline array_ref_t<T> & array_ref_t<T>::assign(const E & e)
+{
+    static_assert(!std::is_const<T>::value, "array_ref_t: assignment to a const array");
+    evaluate(p_, e, 0, n_);
+    return *this;
+}
+
+template<typename T>
+inline array_ref_t<T> & array_ref_t<T>::operator=(real_t s)
+{ return assign(expr_scalar_t<real_t>(s)); }
+
+} // namespace math
+
+#endif // PEXPR_H
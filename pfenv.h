@@ -0,0 +1,239 @@
+/*******************************************************************************
+ * pfenv.h                                                                     *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PFENV_H
+#define PFENV_H
+
+#include <pcvt.h>
+#include <stdint.h>
+#include <utility>
+
+
+/*
+floating point environment
+--------------------------
+denormal (subnormal) operands and results are handled in microcode on most
+x86 cores, every instruction touching one takes ~100 cycles instead of a few;
+decaying simulations, near-singular matrix inverses and the tails of the
+polynomial approximations produce them easily; flushing them to zero trades
+the gradual underflow for constant speed:
+
+  {
+      fenv_scope_t fenv(fp_env_t::fast()); // FTZ + DAZ, round to nearest
+      step_physics(...);
+  }                                        // previous environment restored
+
+  fp_env_t  { ftz, daz, round }
+    ftz     flush denormal results to zero
+    daz     treat denormal operands as zero
+    round   rounding mode of the arithmetic (round_t of pvecf.h):
+            nearest_even, trunc (towards zero), floor (towards -inf),
+            ceil (towards +inf)
+  fp_env_t::ieee()  no flushing, round to nearest (the default environment)
+  fp_env_t::fast()  ftz + daz, round to nearest
+
+  get_fenv(), set_fenv(env)   current environment of the calling thread
+  fenv_scope_t(env)           sets env, the destructor restores the previous
+                              environment (the exception flags raised in
+                              between are kept)
+
+the environment is a per thread register, so it has to be set in every thread
+running the kernels; with_fenv(env, f) wraps a kernel so it runs with env in
+whichever thread calls it, e.g. for the thread pool of pparallel.h:
+
+  parallel_transform(dst, src, n, with_fenv(fp_env_t::fast(), kernel));
+
+registers:
+  SSE/AVX   MXCSR (FTZ bit 15, DAZ bit 6, RC bits 13-14), affects the vector
+            and scalar SSE/AVX instructions but not x87 code
+  AArch64   FPCR (FZ bit 24, RMode bits 22-23), FZ flushes operands and
+            results, so ftz and daz can't be set separately (either one sets
+            FZ, get_fenv() reports FZ for both)
+  AArch32   FPSCR, same bits as FPCR, but they only affect the VFP
+            instructions: ARMv7 NEON always flushes denormals to zero and
+            rounds to nearest
+
+the compilers assume the default environment: arithmetic on values at hand
+may be moved across set_fenv() and constants are folded with round to
+nearest; a scope should enclose whole (non-inlined) kernels, or the code has
+to be compiled with -frounding-math (GCC/Clang) or /fp:strict (MSVC) if the
+rounding mode matters for individual expressions
+
+note that the round_t::nearest_even conversions of pcvt.h and round_even()
+of the vecf_t types use the rounding mode of the environment below SSE4.1
+(cvtps2dq, the 2^23 addition) and follow a changed mode
+*/
+
+// TODO:
+// - MSVC on ARM (_ReadStatusReg/_WriteStatusReg)
+// - exception masks (trap on invalid/divide by zero for debugging)
+
+
+namespace math {
+
+struct fp_env_t
+{
+    bool ftz;
+    bool daz;
+    round_t round;
+
+    static fp_env_t ieee() { fp_env_t e = { false, false, round_t::nearest_even }; return e; }
+    static fp_env_t fast() { fp_env_t e = { true, true, round_t::nearest_even }; return e; }
+};
+
+inline bool operator==(const fp_env_t & a, const fp_env_t & b)
+{ return a.ftz == b.ftz && a.daz == b.daz && a.round == b.round; }
+inline bool operator!=(const fp_env_t & a, const fp_env_t & b)
+{ return !(a == b); }
+
+namespace ipriv {
+
+#if defined(PVECF_INTEL)
+
+    typedef uint32_t fenv_reg_t;
+
+    static const uint32_t fenv_ftz = 0x8000;
+    static const uint32_t fenv_daz = 0x0040;
+    static const uint32_t fenv_rc_mask = 0x6000;
+    static const uint32_t fenv_rc_shift = 13;
+    static const uint32_t fenv_flags = 0x003F; // sticky exception flags
+
+    inline fenv_reg_t fenv_read() { return _mm_getcsr(); }
+    inline void fenv_write(fenv_reg_t r) { _mm_setcsr(r); }
+
+    // RC: 0 nearest, 1 down, 2 up, 3 towards zero
+    inline uint32_t fenv_rc(round_t r)
+    {
+        return r == round_t::floor ? 1u : r == round_t::ceil ? 2u : r == round_t::trunc ? 3u : 0u;
+    }
+    inline round_t fenv_round(uint32_t rc)
+    {
+        static const round_t modes[] = { round_t::nearest_even, round_t::floor, round_t::ceil, round_t::trunc };
+        return modes[rc & 3];
+    }
+
+#elif defined(PVECF_ARM) && defined(__GNUC__)
+
+#if defined(__aarch64__)
+    typedef uint64_t fenv_reg_t;
+    static const uint64_t fenv_flags = 0; // the flags live in FPSR
+
+    inline fenv_reg_t fenv_read()
+    { uint64_t r; __asm__ __volatile__("mrs %0, fpcr" : "=r"(r)); return r; }
+    inline void fenv_write(fenv_reg_t r)
+    { __asm__ __volatile__("msr fpcr, %0" : : "r"(r)); }
+#else
+    typedef uint32_t fenv_reg_t;
+    static const uint32_t fenv_flags = 0x9F; // cumulative exception flags
+
+    inline fenv_reg_t fenv_read()
+    { uint32_t r; __asm__ __volatile__("vmrs %0, fpscr" : "=r"(r)); return r; }
+    inline void fenv_write(fenv_reg_t r)
+    { __asm__ __volatile__("vmsr fpscr, %0" : : "r"(r)); }
+#endif
+
+    static const fenv_reg_t fenv_ftz = fenv_reg_t(1) << 24;
+    static const fenv_reg_t fenv_daz = fenv_ftz;
+    static const fenv_reg_t fenv_rc_mask = fenv_reg_t(3) << 22;
+    static const unsigned fenv_rc_shift = 22;
+
+    // RMode: 0 nearest, 1 up, 2 down, 3 towards zero
+    inline uint32_t fenv_rc(round_t r)
+    {
+        return r == round_t::ceil ? 1u : r == round_t::floor ? 2u : r == round_t::trunc ? 3u : 0u;
+    }
+    inline round_t fenv_round(uint32_t rc)
+    {
+        static const round_t modes[] = { round_t::nearest_even, round_t::ceil, round_t::floor, round_t::trunc };
+        return modes[rc & 3];
+    }
+
+#else
+
+    // no access to the environment: ieee() only, set_fenv() does nothing
+    typedef uint32_t fenv_reg_t;
+    static const uint32_t fenv_ftz = 0, fenv_daz = 0, fenv_rc_mask = 0, fenv_rc_shift = 0;
+    static const uint32_t fenv_flags = 0;
+    inline fenv_reg_t fenv_read() { return 0; }
+    inline void fenv_write(fenv_reg_t) {}
+    inline uint32_t fenv_rc(round_t) { return 0; }
+    inline round_t fenv_round(uint32_t) { return round_t::nearest_even; }
+
+#endif
+
+} // namespace ipriv
+
+
+inline fp_env_t get_fenv()
+{
+    ipriv::fenv_reg_t r = ipriv::fenv_read();
+    fp_env_t e = {
+        (r & ipriv::fenv_ftz) != 0,
+        (r & ipriv::fenv_daz) != 0,
+        ipriv::fenv_round(uint32_t((r & ipriv::fenv_rc_mask) >> ipriv::fenv_rc_shift))
+    };
+    return e;
+}
+
+inline void set_fenv(const fp_env_t & env)
+{
+    ipriv::fenv_reg_t r = ipriv::fenv_read();
+    r &= ~(ipriv::fenv_ftz | ipriv::fenv_daz | ipriv::fenv_rc_mask);
+    if(env.ftz) r |= ipriv::fenv_ftz;
+    if(env.daz) r |= ipriv::fenv_daz;
+    r |= ipriv::fenv_reg_t(ipriv::fenv_rc(env.round)) << ipriv::fenv_rc_shift;
+    ipriv::fenv_write(r);
+}
+
+
+class fenv_scope_t
+{
+public:
+    explicit fenv_scope_t(const fp_env_t & env = fp_env_t::fast())
+        : saved_(ipriv::fenv_read())
+    { set_fenv(env); }
+    ~fenv_scope_t()
+    {
+        // restore the control bits, keep the exception flags raised meanwhile
+        ipriv::fenv_write((saved_ & ~ipriv::fenv_flags) |
+                          ((saved_ | ipriv::fenv_read()) & ipriv::fenv_flags));
+    }
+
+private:
+    fenv_scope_t(const fenv_scope_t &);
+    fenv_scope_t & operator=(const fenv_scope_t &);
+
+    ipriv::fenv_reg_t saved_;
+};
+
+
+namespace ipriv {
+
+    template<typename F> struct fenv_fn_t
+    {
+        fp_env_t env;
+        F f;
+
+        template<typename... A>
+        auto operator()(A &&... a) -> decltype(std::declval<F &>()(std::forward<A>(a)...))
+        {
+            fenv_scope_t scope(env);
+            return f(std::forward<A>(a)...);
+        }
+    };
+
+} // namespace ipriv
+
+// f with env set around every call (in the calling thread)
+template<typename F> inline ipriv::fenv_fn_t<F> with_fenv(const fp_env_t & env, F f)
+{ ipriv::fenv_fn_t<F> w = { env, f }; return w; }
+
+} // namespace math
+
+#endif // PFENV_H
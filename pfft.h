@@ -0,0 +1,402 @@
+/*******************************************************************************
+ * pfft.h                                                                      *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PFFT_H
+#define PFFT_H
+
+#include <pcomplex.h>
+#include <palloc.h>
+#include <stddef.h>
+#include <string.h>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+
+/*
+fast Fourier transform
+----------------------
+power of two sizes, Stockham autosort (no bit reversal pass): radix-4 stages
+and one radix-2 stage for odd powers of two, each stage reads one buffer and
+writes the other; the butterflies run on complex4f_t (float, 2 numbers per
+register) or complex2d_t (double) of pcomplex.h
+
+  fft_plan_t<R> plan(n[, batch])   R = float (default) or double; the
+                                   twiddle factors of all stages are computed
+                                   once (in double)
+  plan.forward(in, out)            X[k] = sum x[j] exp(-2 pi i jk/n)
+  plan.inverse(in, out)            x[j] = sum X[k] exp(+2 pi i jk/n), not
+                                   scaled (inverse(forward(x)) = n x)
+  plan.forward_many(in, out, count), plan.inverse_many(in, out, count)
+                                   count transforms stored one after another
+
+  in and out are std::complex<R> arrays, out may be in (in-place)
+
+  batch > 1 transforms batch interleaved sequences at once, element j of
+  sequence c at [j * batch + c] (e.g. the columns of a row major matrix with
+  batch columns); all stages then work on contiguous vectors, which makes
+  this the fastest way to run many small transforms
+
+fft_real_plan_t<R> plan(n)         real input, n >= 2
+  plan.forward(in, out)            n reals to the n/2 + 1 complex values X[0]
+                                   .. X[n/2] (the rest is conj(X[n-k]))
+  plan.inverse(in, out)            n/2 + 1 complex values to n reals (scaled
+                                   by n as the complex inverse)
+  the reals are packed to n/2 complex numbers (x[2j] + i x[2j+1]), transformed
+  with the complex plan of size n/2 and separated afterwards
+
+fft2d_plan_t<R> plan(rows, cols)   row major rows x cols matrices
+  plan.forward(in, out), plan.inverse(in, out)
+  the rows one after another, then all columns at once (batch = cols)
+
+sizes other than powers of two throw std::invalid_argument; the plans own a
+work buffer, so one plan must not be used by several threads at a time
+*/
+
+// TODO:
+// - mixed radix (3, 5) for other sizes
+// - complex8f_t (AVX) stages, the first two stages need 4-way transposes
+// - real transforms of the columns in 2D (real input)
+// - parallel_for() over the rows / batches for large 2D transforms
+
+
+namespace math {
+
+#if defined(PVECF_INTEL)
+
+namespace ipriv {
+
+    template<typename R> struct fft_complex_t;
+    template<> struct fft_complex_t<float> { typedef complex4f_t type; };
+# if defined(SSE2) || defined(AVX)
+    template<> struct fft_complex_t<double> { typedef complex2d_t type; };
+# endif
+
+    inline bool fft_pow2(size_t n) { return n && (n & (n - 1)) == 0; }
+
+    // i z
+    template<typename C>
+    inline C fft_mul_i(const C & z)
+    { typedef typename C::simd_t S; return C(S::math_t::xor_packed(S::swap(z.p), S::sign_re())); }
+    template<bool inv, typename C>
+    inline C fft_tw(const C & w) { return inv ? conj(w) : w; }
+
+    // lo = {a0,b0,a1,b1,..} (first half), hi = second half
+    inline void fft_zip(const complex4f_t & a, const complex4f_t & b, complex4f_t & lo, complex4f_t & hi)
+    { lo.p = _mm_movelh_ps(a.p, b.p); hi.p = _mm_movehl_ps(b.p, a.p); }
+# if defined(SSE2) || defined(AVX)
+    inline void fft_zip(const complex2d_t & a, const complex2d_t & b, complex2d_t & lo, complex2d_t & hi)
+    { lo = a; hi = b; }
+# endif
+
+    template<bool inv, typename C>
+    inline void fft_bfly4(const C & a, const C & b, const C & c, const C & d,
+                          const C & w1, const C & w2, const C & w3,
+                          C & y0, C & y1, C & y2, C & y3)
+    {
+        const C apc(a + c), amc(a - c), bpd(b + d), jbmd(fft_mul_i(b - d));
+        y0 = apc + bpd;
+        y1 = fft_tw<inv>(w1) * (inv ? amc + jbmd : amc - jbmd);
+        y2 = fft_tw<inv>(w2) * (apc - bpd);
+        y3 = fft_tw<inv>(w3) * (inv ? amc - jbmd : amc + jbmd);
+    }
+
+    // one radix-4 stage of length L and stride s: x[q + s (p + k m)] ->
+    // y[q + s (4 p + k)], m = L / 4, w = {W^p, W^2p, W^3p} for p < m
+    template<bool inv, typename C, typename R>
+    inline void fft_radix4(const std::complex<R> * x, std::complex<R> * y, size_t L, size_t s,
+                           const std::complex<R> * w)
+    {
+        const size_t m = L / 4;
+        C a, b, c, d, w1, w2, w3, y0, y1, y2, y3;
+        if(s % C::N == 0) {
+            for(size_t p = 0; p < m; ++p) {
+                w1 = C(w[p]); w2 = C(w[m + p]); w3 = C(w[2 * m + p]);
+                const std::complex<R> * xp = x + s * p;
+                std::complex<R> * yp = y + s * 4 * p;
+                for(size_t q = 0; q < s; q += C::N) {
+                    a.loadu(xp + q); b.loadu(xp + s * m + q);
+                    c.loadu(xp + 2 * s * m + q); d.loadu(xp + 3 * s * m + q);
+                    fft_bfly4<inv>(a, b, c, d, w1, w2, w3, y0, y1, y2, y3);
+                    y0.storeu(yp + q); y1.storeu(yp + s + q);
+                    y2.storeu(yp + 2 * s + q); y3.storeu(yp + 3 * s + q);
+                }
+            }
+        } else if(s == 1 && m % C::N == 0) {
+            // N consecutive p per register, the outputs transposed
+            C lo01, hi01, lo23, hi23;
+            for(size_t p = 0; p < m; p += C::N) {
+                w1.loadu(w + p); w2.loadu(w + m + p); w3.loadu(w + 2 * m + p);
+                a.loadu(x + p); b.loadu(x + m + p); c.loadu(x + 2 * m + p); d.loadu(x + 3 * m + p);
+                fft_bfly4<inv>(a, b, c, d, w1, w2, w3, y0, y1, y2, y3);
+                fft_zip(y0, y1, lo01, hi01);
+                fft_zip(y2, y3, lo23, hi23);
+                lo01.storeu(y + 4 * p); lo23.storeu(y + 4 * p + 2);
+                hi01.storeu(y + 4 * p + 4); hi23.storeu(y + 4 * p + 6);
+            }
+        } else {
+            // one number at a time (L = 4 or an odd batch)
+            for(size_t p = 0; p < m; ++p) {
+                w1 = C(w[p]); w2 = C(w[m + p]); w3 = C(w[2 * m + p]);
+                for(size_t q = 0; q < s; ++q) {
+                    const std::complex<R> * xp = x + s * p + q;
+                    std::complex<R> * yp = y + s * 4 * p + q;
+                    a = C(xp[0]); b = C(xp[s * m]); c = C(xp[2 * s * m]); d = C(xp[3 * s * m]);
+                    fft_bfly4<inv>(a, b, c, d, w1, w2, w3, y0, y1, y2, y3);
+                    yp[0] = y0.get(0); yp[s] = y1.get(0); yp[2 * s] = y2.get(0); yp[3 * s] = y3.get(0);
+                }
+            }
+        }
+    }
+
+    // radix-2: x[q + s (p + k m)] -> y[q + s (2 p + k)], m = L / 2
+    template<bool inv, typename C, typename R>
+    inline void fft_radix2(const std::complex<R> * x, std::complex<R> * y, size_t L, size_t s,
+                           const std::complex<R> * w)
+    {
+        const size_t m = L / 2;
+        C a, b, wp, y0, y1;
+        if(s % C::N == 0) {
+            for(size_t p = 0; p < m; ++p) {
+                wp = fft_tw<inv>(C(w[p]));
+                const std::complex<R> * xp = x + s * p;
+                std::complex<R> * yp = y + s * 2 * p;
+                for(size_t q = 0; q < s; q += C::N) {
+                    a.loadu(xp + q); b.loadu(xp + s * m + q);
+                    (a + b).storeu(yp + q);
+                    (wp * (a - b)).storeu(yp + s + q);
+                }
+            }
+        } else if(s == 1 && m % C::N == 0) {
+            C lo, hi;
+            for(size_t p = 0; p < m; p += C::N) {
+                wp.loadu(w + p);
+                a.loadu(x + p); b.loadu(x + m + p);
+                fft_zip(a + b, fft_tw<inv>(wp) * (a - b), lo, hi);
+                lo.storeu(y + 2 * p); hi.storeu(y + 2 * p + 2);
+            }
+        } else {
+            for(size_t p = 0; p < m; ++p) {
+                wp = fft_tw<inv>(C(w[p]));
+                for(size_t q = 0; q < s; ++q) {
+                    a = C(x[s * p + q]); b = C(x[s * (p + m) + q]);
+                    y[s * 2 * p + q] = (a + b).get(0);
+                    y[s * (2 * p + 1) + q] = (wp * (a - b)).get(0);
+                }
+            }
+        }
+    }
+
+    // a * b without the NaN/inf handling of std::complex
+    template<typename R>
+    inline std::complex<R> fft_cmul(const std::complex<R> & a, const std::complex<R> & b)
+    { return std::complex<R>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()); }
+
+} // namespace ipriv
+
+
+template<typename R = float>
+class fft_plan_t
+{
+public:
+    typedef std::complex<R> complex_type;
+
+    explicit fft_plan_t(size_t n, size_t batch = 1)
+        : n_(n), batch_(batch)
+    {
+        if(!ipriv::fft_pow2(n))
+            throw std::invalid_argument("fft_plan_t: the size must be a power of two");
+        if(batch == 0)
+            throw std::invalid_argument("fft_plan_t: the batch must be at least 1");
+        const double pi = 3.14159265358979323846;
+        for(size_t L = n; L > 1; ) {
+            stage_t st;
+            st.radix = L % 4 == 0 ? 4 : 2;
+            st.length = L;
+            st.twiddle = tw_.size();
+            const size_t m = L / st.radix;
+            for(unsigned k = 1; k < st.radix; ++k)
+                for(size_t p = 0; p < m; ++p) {
+                    double phi = -2.0 * pi * double(k * p) / double(L);
+                    tw_.push_back(complex_type(R(std::cos(phi)), R(std::sin(phi))));
+                }
+            stages_.push_back(st);
+            L = m;
+        }
+        work_.resize(n * batch);
+    }
+
+    void forward(const complex_type * in, complex_type * out) { run<false>(in, out); }
+    void inverse(const complex_type * in, complex_type * out) { run<true>(in, out); }
+    void forward_many(const complex_type * in, complex_type * out, size_t count)
+    { for(size_t i = 0; i < count; ++i) run<false>(in + i * n_ * batch_, out + i * n_ * batch_); }
+    void inverse_many(const complex_type * in, complex_type * out, size_t count)
+    { for(size_t i = 0; i < count; ++i) run<true>(in + i * n_ * batch_, out + i * n_ * batch_); }
+
+    size_t size() const { return n_; }
+    size_t batch() const { return batch_; }
+
+private:
+    typedef typename ipriv::fft_complex_t<R>::type C;
+
+    struct stage_t
+    {
+        unsigned radix;
+        size_t length;
+        size_t twiddle;
+    };
+
+    template<bool inv>
+    void run(const complex_type * in, complex_type * out)
+    {
+        const size_t k = stages_.size(), total = n_ * batch_;
+        if(k == 0) {
+            if(in != out) memcpy(out, in, total * sizeof(complex_type));
+            return;
+        }
+        // the last stage writes out, the ones before alternate; no stage
+        // reads and writes the same buffer
+        complex_type * work = &work_[0];
+        const complex_type * src = in;
+        if(in == out && (k - 1) % 2 == 0) {
+            memcpy(work, in, total * sizeof(complex_type));
+            src = work;
+        }
+        size_t s = batch_;
+        for(size_t i = 0; i < k; ++i) {
+            const stage_t & st = stages_[i];
+            complex_type * dst = (k - 1 - i) % 2 == 0 ? out : work;
+            if(st.radix == 4) ipriv::fft_radix4<inv,C>(src, dst, st.length, s, &tw_[st.twiddle]);
+            else ipriv::fft_radix2<inv,C>(src, dst, st.length, s, &tw_[st.twiddle]);
+            src = dst;
+            s *= st.radix;
+        }
+    }
+
+    size_t n_, batch_;
+    std::vector<stage_t> stages_;
+    aligned_vector_t<complex_type> tw_;
+    aligned_vector_t<complex_type> work_;
+};
+
+
+template<typename R = float>
+class fft_real_plan_t
+{
+public:
+    typedef std::complex<R> complex_type;
+
+    explicit fft_real_plan_t(size_t n)
+        : n_(n), half_(check(n) / 2)
+    {
+        const double pi = 3.14159265358979323846;
+        const size_t m = n / 2;
+        tw_.resize(m);
+        for(size_t k = 0; k < m; ++k) {
+            double phi = -2.0 * pi * double(k) / double(n);
+            tw_[k] = complex_type(R(std::cos(phi)), R(std::sin(phi)));
+        }
+        work_.resize(m);
+    }
+
+    // n reals -> n/2 + 1 complex values
+    void forward(const R * in, complex_type * out)
+    {
+        const size_t m = n_ / 2;
+        half_.forward(reinterpret_cast<const complex_type *>(in), out);
+        // even part E = (Z[k] + conj(Z[m-k])) / 2, odd part
+        // O = -i (Z[k] - conj(Z[m-k])) / 2, X[k] = E + W^k O,
+        // X[m-k] = conj(E - W^k O)
+        const complex_type z0 = out[0];
+        out[0] = complex_type(z0.real() + z0.imag(), R(0));
+        out[m] = complex_type(z0.real() - z0.imag(), R(0));
+        for(size_t k = 1; k <= m / 2; ++k) {
+            const complex_type a = out[k], b = std::conj(out[m - k]);
+            const complex_type e = (a + b) * R(0.5);
+            const complex_type d = (a - b) * R(0.5);
+            const complex_type o(d.imag(), -d.real());
+            const complex_type wo = ipriv::fft_cmul(tw_[k], o);
+            out[k] = e + wo;
+            out[m - k] = std::conj(e - wo);
+        }
+    }
+
+    // n/2 + 1 complex values -> n reals (times n)
+    void inverse(const complex_type * in, R * out)
+    {
+        const size_t m = n_ / 2;
+        // Z[k] = E + F, Z[m-k] = conj(E - F) with E = X[k] + conj(X[m-k]),
+        // F = i conj(W^k) (X[k] - conj(X[m-k]))
+        complex_type * z = &work_[0];
+        z[0] = complex_type(in[0].real() + in[m].real(), in[0].real() - in[m].real());
+        for(size_t k = 1; k <= m / 2; ++k) {
+            const complex_type a = in[k], b = std::conj(in[m - k]);
+            const complex_type e = a + b;
+            const complex_type d = ipriv::fft_cmul(std::conj(tw_[k]), a - b);
+            const complex_type f(-d.imag(), d.real());
+            z[k] = e + f;
+            z[m - k] = std::conj(e - f);
+        }
+        half_.inverse(z, reinterpret_cast<complex_type *>(out));
+    }
+
+    size_t size() const { return n_; }
+
+private:
+    static size_t check(size_t n)
+    {
+        if(!ipriv::fft_pow2(n) || n < 2)
+            throw std::invalid_argument("fft_real_plan_t: the size must be a power of two >= 2");
+        return n;
+    }
+
+    size_t n_;
+    fft_plan_t<R> half_;
+    aligned_vector_t<complex_type> tw_;
+    aligned_vector_t<complex_type> work_;
+};
+
+
+template<typename R = float>
+class fft2d_plan_t
+{
+public:
+    typedef std::complex<R> complex_type;
+
+    fft2d_plan_t(size_t rows, size_t cols)
+        : rows_(rows), cols_(cols), row_plan_(cols), col_plan_(rows, cols) {}
+
+    void forward(const complex_type * in, complex_type * out)
+    {
+        row_plan_.forward_many(in, out, rows_);
+        col_plan_.forward(out, out);
+    }
+    void inverse(const complex_type * in, complex_type * out)
+    {
+        row_plan_.inverse_many(in, out, rows_);
+        col_plan_.inverse(out, out);
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+
+private:
+    size_t rows_, cols_;
+    fft_plan_t<R> row_plan_; // one row
+    fft_plan_t<R> col_plan_; // all columns, interleaved
+};
+
+#else
+#error "pfft.h: x86 (SSE/AVX) only for now"
+#endif // defined(PVECF_INTEL)
+
+} // namespace math
+
+#endif // PFFT_H
@@ -0,0 +1,294 @@
+/*******************************************************************************
+ * pgeom.h                                                                     *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PGEOM_H
+#define PGEOM_H
+
+#include <pvecf.h>
+#include <pcompress.h>
+#include <limits>
+
+
+/*
+ray intersection
+----------------
+packet versions of the ray-box slab test and the Moeller-Trumbore ray-triangle
+test, V = vec4f_t (4 lanes) or vec8f_t (8 lanes, AVX); the packets are SoA,
+the single rays, boxes and triangles vec4f_t points {x,y,z,w}:
+
+  ray_packet_t<V>    N rays: origins, directions and the inverse directions
+                     (set_dir() computes them)
+  box_packet_t<V>    N axis aligned boxes (min/max corners)
+  tri_packet_t<V>    N triangles as vertex 0 and the edges v1 - v0, v2 - v0
+                     (set() computes them)
+
+  ray_box(rays, bmin, bmax, tmin, tmax, tnear)          N rays, one box
+  ray_box(origin, inv_dir, boxes, tmin, tmax, tnear)    one ray, N boxes
+  ray_triangle(rays, v0, v1, v2, tmin, tmax, t, u, v)   N rays, one triangle
+  ray_triangle(origin, dir, tris, tmin, tmax, t, u, v)  one ray, N triangles
+
+the packet functions return the hit mask (all bits set in the lanes that hit,
+use mask_bits() of pcompress.h for a bit mask), the distances are written for
+all lanes but only meaningful in the hit lanes:
+  ray_box()       hit: the ray segment [tmin,tmax] overlaps the box, tnear the
+                  entry distance (tmin if the origin is inside)
+  ray_triangle()  hit: tmin <= t <= tmax, t the distance along dir (in units of
+                  |dir|), u and v the barycentric coordinates of v1 and v2;
+                  both sides of the triangles are hit (no culling), rays in the
+                  plane of a triangle and degenerate triangles miss (the
+                  barycentric tests fail for the infinite/NaN coordinates, no
+                  epsilon is needed)
+
+  nearest_hit(mask, t, tnear)   lane of the closest hit (-1 if none)
+
+the hit point of a single ray is eval_line(origin, t, dir)
+
+single ray, single primitive (AoS, using the xyz lanes of vec4f_t; the w lanes
+of the points have to be equal, the one of dir has to be 0):
+
+  ray_box(origin, inv_dir, bmin, bmax, tmin, tmax, tnear)
+  ray_triangle(origin, dir, v0, v1, v2, tmin, tmax, t, u, v)
+
+a zero direction component gives an infinite inverse, so the slab of that
+axis is all or nothing, except for origins exactly on one of its planes
+(0 * inf is NaN), those rays may hit or miss
+*/
+
+// TODO:
+// - ray-sphere, ray-plane
+// - watertight triangle test (Woop et al.) for shared edges
+// - MSVC on ARM
+
+
+namespace math {
+
+namespace ipriv {
+
+    inline vec4f_t geom_min(const vec4f_t & a, const vec4f_t & b) { return vec4f_t::min_(a, b); }
+    inline vec4f_t geom_max(const vec4f_t & a, const vec4f_t & b) { return vec4f_t::max_(a, b); }
+    inline vec4f_t geom_lte(const vec4f_t & a, const vec4f_t & b) { return cmp_lte(a, b); }
+    inline vec4f_t geom_gte(const vec4f_t & a, const vec4f_t & b) { return cmp_gte(a, b); }
+
+#if defined(PVECF_INTEL) && defined(AVX)
+    inline vec8f_t geom_min(const vec8f_t & a, const vec8f_t & b) { return vec8f_t(_mm256_min_ps(a.p, b.p)); }
+    inline vec8f_t geom_max(const vec8f_t & a, const vec8f_t & b) { return vec8f_t(_mm256_max_ps(a.p, b.p)); }
+    inline vec8f_t geom_lte(const vec8f_t & a, const vec8f_t & b) { return vec8f_t(_mm256_cmp_ps(a.p, b.p, _CMP_LE_OQ)); }
+    inline vec8f_t geom_gte(const vec8f_t & a, const vec8f_t & b) { return vec8f_t(_mm256_cmp_ps(a.p, b.p, _CMP_GE_OQ)); }
+#endif
+
+    template<typename V> inline V geom_splat(float s) { return V(V::math_t::set1(s)); }
+
+    // slab test, all operands SoA
+    template<typename V>
+    inline V geom_slab(const V & ox, const V & oy, const V & oz,
+                       const V & idx, const V & idy, const V & idz,
+                       const V & minx, const V & miny, const V & minz,
+                       const V & maxx, const V & maxy, const V & maxz,
+                       const V & tmin, const V & tmax, V & tnear)
+    {
+        V t0 = (minx - ox) * idx, t1 = (maxx - ox) * idx;
+        V tn = geom_max(geom_min(t0, t1), tmin);
+        V tf = geom_min(geom_max(t0, t1), tmax);
+        t0 = (miny - oy) * idy; t1 = (maxy - oy) * idy;
+        tn = geom_max(geom_min(t0, t1), tn);
+        tf = geom_min(geom_max(t0, t1), tf);
+        t0 = (minz - oz) * idz; t1 = (maxz - oz) * idz;
+        tn = geom_max(geom_min(t0, t1), tn);
+        tf = geom_min(geom_max(t0, t1), tf);
+        tnear = tn;
+        return geom_lte(tn, tf);
+    }
+
+    // Moeller-Trumbore, all operands SoA
+    template<typename V>
+    inline V geom_triangle(const V & ox, const V & oy, const V & oz,
+                           const V & dx, const V & dy, const V & dz,
+                           const V & v0x, const V & v0y, const V & v0z,
+                           const V & e1x, const V & e1y, const V & e1z,
+                           const V & e2x, const V & e2y, const V & e2z,
+                           const V & tmin, const V & tmax, V & t, V & u, V & v)
+    {
+        // p = d x e2, det = e1 . p
+        V px = dy * e2z - dz * e2y, py = dz * e2x - dx * e2z, pz = dx * e2y - dy * e2x;
+        V inv = geom_splat<V>(1.0f) / (e1x * px + e1y * py + e1z * pz);
+        // s = o - v0, q = s x e1
+        V sx = ox - v0x, sy = oy - v0y, sz = oz - v0z;
+        V qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+        u = (sx * px + sy * py + sz * pz) * inv;
+        v = (dx * qx + dy * qy + dz * qz) * inv;
+        t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+        V zero = geom_splat<V>(0.0f);
+        return
+            geom_gte(u, zero) & geom_gte(v, zero) & geom_lte(u + v, geom_splat<V>(1.0f)) &
+            geom_gte(t, tmin) & geom_lte(t, tmax);
+    }
+
+} // namespace ipriv
+
+
+template<typename V>
+struct ray_packet_t
+{
+    V ox, oy, oz;
+    V dx, dy, dz;
+    V idx, idy, idz;
+
+    inline void set_origin(const V & x, const V & y, const V & z) { ox = x; oy = y; oz = z; }
+    inline void set_dir(const V & x, const V & y, const V & z)
+    {
+        const V one(ipriv::geom_splat<V>(1.0f));
+        dx = x; dy = y; dz = z;
+        idx = one / x; idy = one / y; idz = one / z;
+    }
+    // lane k from a single ray
+    inline void set(unsigned k, const vec4f_t & origin, const vec4f_t & dir)
+    {
+        ox[k] = origin[0]; oy[k] = origin[1]; oz[k] = origin[2];
+        dx[k] = dir[0]; dy[k] = dir[1]; dz[k] = dir[2];
+        idx[k] = 1.0f / dir[0]; idy[k] = 1.0f / dir[1]; idz[k] = 1.0f / dir[2];
+    }
+};
+
+template<typename V>
+struct box_packet_t
+{
+    V minx, miny, minz;
+    V maxx, maxy, maxz;
+
+    inline void set(unsigned k, const vec4f_t & bmin, const vec4f_t & bmax)
+    {
+        minx[k] = bmin[0]; miny[k] = bmin[1]; minz[k] = bmin[2];
+        maxx[k] = bmax[0]; maxy[k] = bmax[1]; maxz[k] = bmax[2];
+    }
+};
+
+template<typename V>
+struct tri_packet_t
+{
+    V v0x, v0y, v0z;
+    V e1x, e1y, e1z;
+    V e2x, e2y, e2z;
+
+    inline void set(unsigned k, const vec4f_t & v0, const vec4f_t & v1, const vec4f_t & v2)
+    {
+        v0x[k] = v0[0]; v0y[k] = v0[1]; v0z[k] = v0[2];
+        e1x[k] = v1[0] - v0[0]; e1y[k] = v1[1] - v0[1]; e1z[k] = v1[2] - v0[2];
+        e2x[k] = v2[0] - v0[0]; e2y[k] = v2[1] - v0[1]; e2z[k] = v2[2] - v0[2];
+    }
+};
+
+
+// N rays against one box
+template<typename V>
+inline V ray_box(const ray_packet_t<V> & r, const vec4f_t & bmin, const vec4f_t & bmax,
+                 const V & tmin, const V & tmax, V & tnear)
+{
+    using ipriv::geom_splat;
+    return
+        ipriv::geom_slab(
+            r.ox, r.oy, r.oz, r.idx, r.idy, r.idz,
+            geom_splat<V>(bmin[0]), geom_splat<V>(bmin[1]), geom_splat<V>(bmin[2]),
+            geom_splat<V>(bmax[0]), geom_splat<V>(bmax[1]), geom_splat<V>(bmax[2]),
+            tmin, tmax, tnear
+        );
+}
+
+// one ray against N boxes
+template<typename V>
+inline V ray_box(const vec4f_t & origin, const vec4f_t & inv_dir, const box_packet_t<V> & b,
+                 float tmin, float tmax, V & tnear)
+{
+    using ipriv::geom_splat;
+    return
+        ipriv::geom_slab(
+            geom_splat<V>(origin[0]), geom_splat<V>(origin[1]), geom_splat<V>(origin[2]),
+            geom_splat<V>(inv_dir[0]), geom_splat<V>(inv_dir[1]), geom_splat<V>(inv_dir[2]),
+            b.minx, b.miny, b.minz, b.maxx, b.maxy, b.maxz,
+            geom_splat<V>(tmin), geom_splat<V>(tmax), tnear
+        );
+}
+
+// N rays against one triangle
+template<typename V>
+inline V ray_triangle(const ray_packet_t<V> & r, const vec4f_t & v0, const vec4f_t & v1, const vec4f_t & v2,
+                      const V & tmin, const V & tmax, V & t, V & u, V & v)
+{
+    using ipriv::geom_splat;
+    const vec4f_t e1(v1 - v0), e2(v2 - v0);
+    return
+        ipriv::geom_triangle(
+            r.ox, r.oy, r.oz, r.dx, r.dy, r.dz,
+            geom_splat<V>(v0[0]), geom_splat<V>(v0[1]), geom_splat<V>(v0[2]),
+            geom_splat<V>(e1[0]), geom_splat<V>(e1[1]), geom_splat<V>(e1[2]),
+            geom_splat<V>(e2[0]), geom_splat<V>(e2[1]), geom_splat<V>(e2[2]),
+            tmin, tmax, t, u, v
+        );
+}
+
+// one ray against N triangles
+template<typename V>
+inline V ray_triangle(const vec4f_t & origin, const vec4f_t & dir, const tri_packet_t<V> & tri,
+                      float tmin, float tmax, V & t, V & u, V & v)
+{
+    using ipriv::geom_splat;
+    return
+        ipriv::geom_triangle(
+            geom_splat<V>(origin[0]), geom_splat<V>(origin[1]), geom_splat<V>(origin[2]),
+            geom_splat<V>(dir[0]), geom_splat<V>(dir[1]), geom_splat<V>(dir[2]),
+            tri.v0x, tri.v0y, tri.v0z, tri.e1x, tri.e1y, tri.e1z, tri.e2x, tri.e2y, tri.e2z,
+            geom_splat<V>(tmin), geom_splat<V>(tmax), t, u, v
+        );
+}
+
+// lane of the smallest t among the hit lanes, -1 if no lane hit
+template<typename V>
+inline int nearest_hit(const V & mask, const V & t, float & tnear)
+{
+    unsigned bits = mask_bits(mask);
+    int lane = -1;
+    tnear = std::numeric_limits<float>::infinity();
+    for(unsigned k = 0; bits; ++k, bits >>= 1)
+        if((bits & 1) && t[k] < tnear) { tnear = t[k]; lane = int(k); }
+    return lane;
+}
+
+
+// single ray against a single box (the slabs in the xyz lanes)
+inline bool ray_box(const vec4f_t & origin, const vec4f_t & inv_dir, const vec4f_t & bmin, const vec4f_t & bmax,
+                    float tmin, float tmax, float & tnear)
+{
+    vec4f_t t0((bmin - origin) * inv_dir), t1((bmax - origin) * inv_dir);
+    vec4f_t tn(vec4f_t::min_(t0, t1)), tf(vec4f_t::max_(t0, t1));
+    float n = tmin, f = tmax;
+    for(unsigned i = 0; i < 3; ++i) {
+        n = tn[i] > n ? tn[i] : n;
+        f = tf[i] < f ? tf[i] : f;
+    }
+    tnear = n;
+    return n <= f;
+}
+
+// single ray against a single triangle
+inline bool ray_triangle(const vec4f_t & origin, const vec4f_t & dir,
+                         const vec4f_t & v0, const vec4f_t & v1, const vec4f_t & v2,
+                         float tmin, float tmax, float & t, float & u, float & v)
+{
+    const vec4f_t e1(v1 - v0), e2(v2 - v0), s(origin - v0);
+    const vec4f_t p(dir.cross_packed(e2)), q(s.cross_packed(e1));
+    // the dot products are broadcast, one division for all three
+    const vec4f_t inv(vec4f_t(vec4f_t::math_t::set1(1.0f)) / vec4f_t(e1.dot_packed(p)));
+    t = (vec4f_t(e2.dot_packed(q)) * inv)[0];
+    u = (vec4f_t(s.dot_packed(p)) * inv)[0];
+    v = (vec4f_t(dir.dot_packed(q)) * inv)[0];
+    return u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= tmin && t <= tmax;
+}
+
+} // namespace math
+
+#endif // PGEOM_H
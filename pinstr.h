@@ -0,0 +1,292 @@
+/*******************************************************************************
+ * pinstr.h                                                                    *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PINSTR_H
+#define PINSTR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#if defined(PVEC_INSTRUMENT)
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  include <intrin.h>
+#  define PVEC_INSTRUMENT_TSC
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define PVEC_INSTRUMENT_TSC
+#else
+#  include <time.h>
+#endif
+#endif
+
+
+/*
+instrumentation of the hot paths
+--------------------------------
+with PVEC_INSTRUMENT defined the library entry points that tend to dominate
+profiles count their calls, the number of elements processed and the time
+spent inside them:
+
+  - mat_t::inverse(), mat_t::transform_many()
+  - math_t::fast_*() (x86 and NEON)
+  - the *_many() conversions of pcvt.h, evaluate() of pexpr.h
+  - the emulation paths of pveci.h (those with a "performance warning"
+    #pragma message, e.g. min() for int32_t x 4 on SSE2 or the 64 bit
+    compares below SSE4.2), so they show up at run time, not only when
+    compiling
+
+the counters are kept per thread (no contention, no atomic read-modify-write)
+and summed up for the report; the counters of finished threads are kept:
+
+  instr_report();                  // table sorted by time, to stderr
+  std::vector<instr_entry_t> e = instr_snapshot();
+  instr_reset();
+
+the time is measured per rdtsc on x86 (TSC ticks, which run at the nominal
+frequency, not the current one) and per clock_gettime(CLOCK_MONOTONIC) in
+nanoseconds elsewhere, see instr_tick_unit(); it includes the time spent in
+instrumented functions called from inside (e.g. det() from inverse()) and the
+overhead of the measurement itself (~20-40 cycles), which matters for the
+small inline functions
+
+own code can be instrumented the same way:
+
+  void my_kernel(float * p, size_t n)
+  {
+      PVEC_PROBE_N("my_kernel", n);
+      ...
+  }
+
+without PVEC_INSTRUMENT the probes expand to nothing and the report functions
+return empty results, so the calls need no #ifdefs (instr_snapshot() returns
+an empty std::vector<instr_entry_t>); the header then includes no standard
+headers besides <stddef.h>, <stdint.h> and <vector>
+
+the registry of the probes is never destroyed, so probes hit by threads that
+finish during the static destruction (e.g. the workers of a static
+thread_pool_t) still find it
+*/
+
+// TODO:
+// - convert the TSC ticks into cycles (needs the TSC frequency)
+// - hardware counters (perf_event_open) for cache misses per probe
+
+
+namespace math {
+
+struct instr_entry_t
+{
+    const char * name;
+    uint64_t calls;
+    uint64_t elems;
+    uint64_t ticks;
+};
+
+#if defined(PVEC_INSTRUMENT)
+
+namespace ipriv {
+
+    static const unsigned instr_max_probes = 256;
+
+    // written by the owning thread only, atomics for the reports
+    struct instr_counters_t
+    {
+        std::atomic<uint64_t> calls, elems, ticks;
+    };
+    struct instr_block_t
+    {
+        instr_counters_t c[instr_max_probes];
+    };
+
+    struct instr_registry_t
+    {
+        instr_registry_t() : n_probes(0), retired(new instr_block_t()) {}
+
+        std::mutex m;
+        const char * names[instr_max_probes];
+        unsigned n_probes;
+        std::vector<instr_block_t *> live;  // blocks of the running threads
+        instr_block_t * retired;            // sums of the finished threads
+    };
+    // leaked on purpose: the thread blocks report to it from their
+    // thread_local destructors, which may run after the static destruction
+    inline instr_registry_t & instr_registry()
+    { static instr_registry_t * r = new instr_registry_t(); return *r; }
+
+    inline void instr_add(instr_counters_t & dst, const instr_counters_t & src)
+    {
+        dst.calls.fetch_add(src.calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst.elems.fetch_add(src.elems.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst.ticks.fetch_add(src.ticks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    inline void instr_bump(std::atomic<uint64_t> & c, uint64_t v)
+    { c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed); }
+
+    struct instr_thread_t
+    {
+        instr_thread_t() : block(new instr_block_t())
+        {
+            instr_registry_t & r = instr_registry();
+            std::lock_guard<std::mutex> lk(r.m);
+            r.live.push_back(block);
+        }
+        ~instr_thread_t()
+        {
+            instr_registry_t & r = instr_registry();
+            std::lock_guard<std::mutex> lk(r.m);
+            for(unsigned i = 0; i < r.n_probes; ++i)
+                instr_add(r.retired->c[i], block->c[i]);
+            r.live.erase(std::find(r.live.begin(), r.live.end(), block));
+            delete block;
+        }
+        instr_block_t * block;
+    };
+    inline instr_block_t & instr_block()
+    { static thread_local instr_thread_t t; return *t.block; }
+
+    // probe sites with the same name share the counters
+    inline unsigned instr_register(const char * name)
+    {
+        instr_registry_t & r = instr_registry();
+        std::lock_guard<std::mutex> lk(r.m);
+        for(unsigned i = 0; i < r.n_probes; ++i)
+            if(strcmp(r.names[i], name) == 0) return i;
+        if(r.n_probes == instr_max_probes) return instr_max_probes; // ignored
+        r.names[r.n_probes] = name;
+        return r.n_probes++;
+    }
+
+    inline uint64_t instr_ticks()
+    {
+#if defined(PVEC_INSTRUMENT_TSC)
+        return __rdtsc();
+#else
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000u + uint64_t(ts.tv_nsec);
+#endif
+    }
+
+    class instr_probe_t
+    {
+    public:
+        instr_probe_t(unsigned id, uint64_t elems) : id_(id), elems_(elems), t0_(instr_ticks()) {}
+        ~instr_probe_t()
+        {
+            uint64_t t = instr_ticks() - t0_;
+            if(id_ >= instr_max_probes) return;
+            instr_counters_t & c = instr_block().c[id_];
+            instr_bump(c.calls, 1);
+            instr_bump(c.elems, elems_);
+            instr_bump(c.ticks, t);
+        }
+
+    private:
+        instr_probe_t(const instr_probe_t &);
+        instr_probe_t & operator=(const instr_probe_t &);
+
+        unsigned id_;
+        uint64_t elems_;
+        uint64_t t0_;
+    };
+
+} // namespace ipriv
+
+#define PVEC_INSTR_CAT_(a, b) a##b
+#define PVEC_INSTR_CAT(a, b) PVEC_INSTR_CAT_(a, b)
+
+// counts the enclosing scope as one call processing elems elements
+#define PVEC_PROBE_N(name, elems) \
+    static const unsigned PVEC_INSTR_CAT(pvec_probe_id_, __LINE__) = ::math::ipriv::instr_register(name); \
+    ::math::ipriv::instr_probe_t PVEC_INSTR_CAT(pvec_probe_, __LINE__)(PVEC_INSTR_CAT(pvec_probe_id_, __LINE__), (elems))
+#define PVEC_PROBE(name) PVEC_PROBE_N(name, 1)
+
+inline const char * instr_tick_unit()
+{
+#if defined(PVEC_INSTRUMENT_TSC)
+    return "tsc";
+#else
+    return "ns";
+#endif
+}
+
+// sums over all threads, sorted by ticks (descending)
+inline std::vector<instr_entry_t> instr_snapshot()
+{
+    ipriv::instr_registry_t & r = ipriv::instr_registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    std::vector<instr_entry_t> ret;
+    for(unsigned i = 0; i < r.n_probes; ++i) {
+        instr_entry_t e = { r.names[i], 0, 0, 0 };
+        auto add = [&e](const ipriv::instr_counters_t & c) {
+            e.calls += c.calls.load(std::memory_order_relaxed);
+            e.elems += c.elems.load(std::memory_order_relaxed);
+            e.ticks += c.ticks.load(std::memory_order_relaxed);
+        };
+        add(r.retired->c[i]);
+        for(size_t k = 0; k < r.live.size(); ++k)
+            add(r.live[k]->c[i]);
+        if(e.calls) ret.push_back(e);
+    }
+    std::sort(ret.begin(), ret.end(), [](const instr_entry_t & a, const instr_entry_t & b) {
+        return a.ticks > b.ticks; });
+    return ret;
+}
+
+// zeroes the counters (increments of concurrently running probes may be lost)
+inline void instr_reset()
+{
+    ipriv::instr_registry_t & r = ipriv::instr_registry();
+    std::lock_guard<std::mutex> lk(r.m);
+    for(unsigned i = 0; i < r.n_probes; ++i) {
+        ipriv::instr_counters_t & c = r.retired->c[i];
+        c.calls = 0; c.elems = 0; c.ticks = 0;
+        for(size_t k = 0; k < r.live.size(); ++k) {
+            ipriv::instr_counters_t & l = r.live[k]->c[i];
+            l.calls = 0; l.elems = 0; l.ticks = 0;
+        }
+    }
+}
+
+inline void instr_report(FILE * f = stderr)
+{
+    std::vector<instr_entry_t> e = instr_snapshot();
+    if(e.empty()) return;
+    fprintf(f, "%14s %14s %16s %12s %10s  %s (ticks: %s)\n",
+            "calls", "elements", "ticks", "ticks/call", "ticks/elem", "name", instr_tick_unit());
+    for(size_t i = 0; i < e.size(); ++i)
+        fprintf(f, "%14llu %14llu %16llu %12.1f %10.2f  %s\n",
+                (unsigned long long)e[i].calls, (unsigned long long)e[i].elems,
+                (unsigned long long)e[i].ticks,
+                double(e[i].ticks) / double(e[i].calls),
+                e[i].elems ? double(e[i].ticks) / double(e[i].elems) : 0.0,
+                e[i].name);
+}
+
+#else // PVEC_INSTRUMENT
+
+#define PVEC_PROBE_N(name, elems)
+#define PVEC_PROBE(name)
+
+inline const char * instr_tick_unit() { return ""; }
+inline std::vector<instr_entry_t> instr_snapshot() { return std::vector<instr_entry_t>(); }
+inline void instr_reset() {}
+inline void instr_report() {}
+template<typename F> inline void instr_report(F *) {}
+
+#endif // PVEC_INSTRUMENT
+
+} // namespace math
+
+#endif // PINSTR_H
@@ -83,6 +83,8 @@ public:
     static inline vec zeroes() { return vdupq_n_f32(0.0f); /* I'd use VEOR here, but need an operand */ }
     static inline vec ones() { return vdupq_n_f32(1.0f); }
     static inline vec halves() { return vdupq_n_f32(0.5f); }
+    static inline vec sign_mask() { return vreinterpretq_f32_u32(vdupq_n_u32(0x80000000u)); }
+    static inline vec abs_mask() { return vreinterpretq_f32_u32(vdupq_n_u32(0x7FFFFFFFu)); }
 
     static inline vec signs(vec v)
     {
@@ -156,6 +158,16 @@ public:
     { return vget_lane_f32(vmax_f32(vdup_n_f32(a), vdup_n_f32(b)), 0); }
     static inline vec max_packed(vec a, vec b)
     { return vmaxq_f32(a, b); }
+    static inline vec and_packed(vec a, vec b)
+    { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static inline vec or_packed(vec a, vec b)
+    { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static inline vec xor_packed(vec a, vec b)
+    { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static inline vec cmpgt_packed(vec a, vec b)
+    { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    static inline vec cmplt_packed(vec a, vec b)
+    { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
 
     static inline vec dot_packed(vec a, vec b)
     { // [a]     [e]
@@ -167,77 +179,75 @@ public:
       return tmp + zwyx(tmp); // {ae+bf+cg+dh.bf+ae+dh+cg,cg+dh+bf+ae,dh+cg+ae+bf}
     }
 
+    static inline vec mul_add(vec a, vec b, vec c)
+#if defined(__aarch64__) || defined(__ARM_FEATURE_FMA)
+    { return vfmaq_f32(c, a, b); }
+#else
+    { return vmlaq_f32(c, a, b); }
+#endif
+
     static inline vec fast_sin_0(vec angles)
-    { static const float coeffs[] = { -0.16605f, 0.00761f };
-      return angles * (
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_0() float x 4", 4);
+      static constexpr float coeffs[] = { 1.0f, -0.16605f, 0.00761f };
+      return poly_t<float,vec>::horner_odd(angles, coeffs); }
     static inline vec fast_sin_1(vec angles)
-    { static const float coeffs[] = { -0.1666666664f, 0.0083333315f, -0.0001984090f, 0.0000027526f, -0.0000000239f };
-      return angles * (
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, -0.1666666664f, 0.0083333315f,
+        -0.0001984090f, 0.0000027526f, -0.0000000239f
+      };
+      return poly_t<float,vec>::estrin_odd(angles, coeffs); }
     static inline vec fast_cos_0(vec angles)
-    { static const float coeffs[] = { -0.49670f, 0.03705f };
-      return
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_0() float x 4", 4);
+      static constexpr float coeffs[] = { 1.0f, -0.49670f, 0.03705f };
+      return poly_t<float,vec>::horner_even(angles, coeffs); }
     static inline vec fast_cos_1(vec angles)
-    { //static const float coeffs[] = { -0.0000002605f, 0.0000247609f, -0.0013888397f, 0.0416666418f, -0.4999999963f };
-      static const float coeffs[] = { -0.4999999963f, 0.0416666418f, -0.0013888397f, 0.0000247609f, -0.0000002605f };
-      return
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, -0.4999999963f, 0.0416666418f,
+        -0.0013888397f, 0.0000247609f, -0.0000002605f
+      };
+      return poly_t<float,vec>::estrin_even(angles, coeffs); }
     static inline vec fast_tan_0(vec angles)
-    { static const float coeffs[] = {0.20330f, 0.31755f};
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_tan_0() float x 4", 4);
+      static constexpr float coeffs[] = { 1.0f, 0.31755f, 0.20330f };
+      return poly_t<float,vec>::horner_odd(angles, coeffs); }
     static inline vec fast_tan_1(vec angles)
-    { static const float coeffs[] = {
-        0.0095168091f, 0.0029005250f, 0.0245650893f, 0.0533740603f, 0.1333923995f, 0.3333314036f
+    { PVEC_PROBE_N("fast_tan_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, 0.3333314036f, 0.1333923995f, 0.0533740603f,
+        0.0245650893f, 0.0029005250f, 0.0095168091f
       };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(angles*angles, coeffs)
-      ); }
+      return poly_t<float,vec>::estrin_odd(angles, coeffs); }
 
     static inline vec fast_arcsin_0(vec vals)
-    { // arcsin0(x) = pi/2 - sqrt(1-x)(1.5707288 - 0.2121144x + 0.0742610x*x - 0.0187293x*x*x)
-      static const float coeffs[] = {-0.0187293f, 0.0742610f, -0.2121144f};
+    { PVEC_PROBE_N("fast_arcsin_0() float x 4", 4);
+      // arcsin0(x) = pi/2 - sqrt(1-x)(1.5707288 - 0.2121144x + 0.0742610x*x - 0.0187293x*x*x)
+      static constexpr float coeffs[] = { 1.5707288f, -0.2121144f, 0.0742610f, -0.0187293f };
       vec v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(vals, coeffs)
-            + vdupq_n_f32(1.5707288f)
-          ); }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<float,vec>::horner(vals, coeffs); }
     static inline vec fast_arcsin_1(vec vals)
-    { static const float coeffs[] = {
-          -0.0012624911f, 0.0066700901f, -0.01708812556f, 0.0308918810f,
-          -0.0501743046f, 0.0889789874f, -0.21459880160f
+    { PVEC_PROBE_N("fast_arcsin_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.5707963050f, -0.21459880160f, 0.0889789874f, -0.0501743046f,
+        0.0308918810f, -0.01708812556f, 0.0066700901f, -0.0012624911f
       };
       vec v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(vals, coeffs)
-            + vdupq_n_f32(1.5707963050f)
-          );
-    }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<float,vec>::estrin(vals, coeffs); }
     static inline vec fast_arctan_0(vec vals)
-    { static const float coeffs[] = {
-           0.0208351f, -0.0851330f, 0.1801410f,
-          -0.3302995f,  0.9998660f
+    { PVEC_PROBE_N("fast_arctan_0() float x 4", 4);
+      static constexpr float coeffs[] = {
+        0.9998660f, -0.3302995f, 0.1801410f,
+        -0.0851330f, 0.0208351f
       };
-      return horner_odd_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(vals, coeffs);
-    }
+      return poly_t<float,vec>::horner_odd(vals, coeffs); }
     static inline vec fast_arctan_1(vec vals)
-    { static const float coeffs[] = {
-          0.0028662257f, -0.0161657367f, 0.0429096138f, -0.0752896400f,
-          0.1065626393f, -0.1420889944f, 0.1999355085f, -0.3333314528f
+    { PVEC_PROBE_N("fast_arctan_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, -0.3333314528f, 0.1999355085f, -0.1420889944f, 0.1065626393f,
+        -0.0752896400f, 0.0429096138f, -0.0161657367f, 0.0028662257f
       };
-      return vals * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,vec>()(vals, coeffs)
-      );
-    }
+      return poly_t<float,vec>::estrin_odd(vals, coeffs); }
 
 #if 0
     static inline __n128 int32_to_packed(int32_t i)
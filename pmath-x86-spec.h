@@ -16,6 +16,31 @@
 #endif
 
 
+namespace ipriv {
+//
+// bit pattern constants built in registers: all bits set (pcmpeqd)
+// shifted left by L and then right by R in each element, so e.g.
+// 1.0f = 0x3F800000 = (~0 << 25) >> 2 needs neither a memory load
+// nor a guarded static
+//
+#if defined(SSE2) || defined(AVX)
+template<int L, int R> static inline __m128i onebits_epi32()
+{ __m128i z = _mm_setzero_si128();
+  return _mm_srli_epi32(_mm_slli_epi32(_mm_cmpeq_epi32(z, z), L), R); }
+template<int L, int R> static inline __m128i onebits_epi64()
+{ __m128i z = _mm_setzero_si128();
+  return _mm_srli_epi64(_mm_slli_epi64(_mm_cmpeq_epi32(z, z), L), R); }
+#endif // SSE2 || AVX
+#ifdef AVX2
+template<int L, int R> static inline __m256i onebits256_epi32()
+{ __m256i z = _mm256_setzero_si256();
+  return _mm256_srli_epi32(_mm256_slli_epi32(_mm256_cmpeq_epi32(z, z), L), R); }
+template<int L, int R> static inline __m256i onebits256_epi64()
+{ __m256i z = _mm256_setzero_si256();
+  return _mm256_srli_epi64(_mm256_slli_epi64(_mm256_cmpeq_epi32(z, z), L), R); }
+#endif // AVX2
+} // namespace ipriv
+
 //
 // math_t specialization for float{4}/__m128
 //
@@ -40,12 +65,18 @@ public:
     static inline __m128 goldenratio_packed() { return _mm_set_ps1(goldenratio<float>()); }
 
     static inline __m128 zeroes() { return _mm_setzero_ps(); }
-    static inline __m128 ones() {
-        static const __m128 ones_ = { 1.0f, 1.0f, 1.0f, 1.0f }; return ones_;
-    }
-    static inline __m128 halves() {
-        static const __m128 halves_ = { 0.5f, 0.5f, 0.5f, 0.5f }; return halves_;
-    }
+#if defined(SSE2) || defined(AVX)
+    static inline __m128 ones()      { return _mm_castsi128_ps(ipriv::onebits_epi32<25,2>()); }
+    static inline __m128 halves()    { return _mm_castsi128_ps(ipriv::onebits_epi32<26,2>()); }
+    static inline __m128 sign_mask() { return _mm_castsi128_ps(ipriv::onebits_epi32<31,0>()); }
+    static inline __m128 abs_mask()  { return _mm_castsi128_ps(ipriv::onebits_epi32<0,1>()); }
+#else
+    static inline __m128 ones()      { return _mm_set1_ps(1.0f); }
+    static inline __m128 halves()    { return _mm_set1_ps(0.5f); }
+    static inline __m128 sign_mask() { return _mm_set1_ps(-0.0f); }
+    static inline __m128 abs_mask()
+    { __m128 z = zeroes(); return _mm_andnot_ps(sign_mask(), _mm_cmpeq_ps(z, z)); }
+#endif
 
     static inline __m128 signs(__m128 v)
     {
@@ -58,7 +89,7 @@ public:
         #else
         // GCC does not allow operator overloads on __m128 and has the operator&
         // not implemented for __m128 (which makes sense)
-        return _mm_and_ps(_mm_or_ps(_mm_and_ps(v, _mm_set1_ps(-0.0f)), ones()), _mm_cmpneq_ps(v, zeroes()));
+        return _mm_and_ps(_mm_or_ps(_mm_and_ps(v, sign_mask()), ones()), _mm_cmpneq_ps(v, zeroes()));
         #endif
     }
 
@@ -74,9 +105,8 @@ public:
         // F(y) = (1/(y*y)) - x = 0
         // Newton-Raphson:
         // y[n+1] = y[n] - F(y[n]) / F'(y[n]) = 0.5y[n]*(3-y[n]*y[n]*x)
-        static const __m128 threes = { 3.0f, 3.0f, 3.0f, 3.0f };
         __m128 approx = _mm_rsqrt_ps(x);
-        return halves() * approx * (threes - (approx * approx * x));
+        return halves() * approx * (set1(3.0f) - (approx * approx * x));
     }
     static inline __m128 sqrt_packed(__m128 x)
     { return _mm_mul_ps(x, inv_sqrt_packed(x)); }
@@ -97,6 +127,11 @@ public:
     { return _mm_cvtss_f32(_mm_max_ps(_mm_load_ps1(&a), _mm_load_ps1(&b))); }
     static inline __m128 max_packed(__m128 a, __m128 b)
     { return _mm_max_ps(a, b); }
+    static inline __m128 and_packed(__m128 a, __m128 b) { return _mm_and_ps(a, b); }
+    static inline __m128 or_packed(__m128 a, __m128 b) { return _mm_or_ps(a, b); }
+    static inline __m128 xor_packed(__m128 a, __m128 b) { return _mm_xor_ps(a, b); }
+    static inline __m128 cmpgt_packed(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+    static inline __m128 cmplt_packed(__m128 a, __m128 b) { return _mm_cmplt_ps(a, b); }
 
     static inline __m128 dot_packed(__m128 a, __m128 b)
 // TODO: dp_ps() and hadd_ps() are rumored to be slow (too complex which stalls
@@ -119,78 +154,75 @@ public:
     }
 #endif
 
+    static inline __m128 mul_add(__m128 a, __m128 b, __m128 c)
+#if defined(FMA)
+    { return _mm_fmadd_ps(a, b, c); }
+#else
+    { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+
     static inline __m128 fast_sin_0(__m128 angles)
-    { static const float coeffs[] = { -0.16605f, 0.00761f };
-      return angles * (
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_0() float x 4", 4);
+      static constexpr float coeffs[] = { 1.0f, -0.16605f, 0.00761f };
+      return poly_t<float,__m128>::horner_odd(angles, coeffs); }
     static inline __m128 fast_sin_1(__m128 angles)
-    { static const float coeffs[] = { -0.1666666664f, 0.0083333315f, -0.0001984090f, 0.0000027526f, -0.0000000239f };
-      return angles * (
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, -0.1666666664f, 0.0083333315f,
+        -0.0001984090f, 0.0000027526f, -0.0000000239f
+      };
+      return poly_t<float,__m128>::estrin_odd(angles, coeffs); }
     static inline __m128 fast_cos_0(__m128 angles)
-    { static const float coeffs[] = { -0.49670f, 0.03705f };
-      return
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_0() float x 4", 4);
+      static constexpr float coeffs[] = { 1.0f, -0.49670f, 0.03705f };
+      return poly_t<float,__m128>::horner_even(angles, coeffs); }
     static inline __m128 fast_cos_1(__m128 angles)
-    { //static const float coeffs[] = { -0.0000002605f, 0.0000247609f, -0.0013888397f, 0.0416666418f, -0.4999999963f };
-      static const float coeffs[] = { -0.4999999963f, 0.0416666418f, -0.0013888397f, 0.0000247609f, -0.0000002605f };
-      return
-          //ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles*angles, coeffs);
-          ones() + polynomialeval_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, -0.4999999963f, 0.0416666418f,
+        -0.0013888397f, 0.0000247609f, -0.0000002605f
+      };
+      return poly_t<float,__m128>::estrin_even(angles, coeffs); }
     static inline __m128 fast_tan_0(__m128 angles)
-    { static const float coeffs[] = {0.20330f, 0.31755f};
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_tan_0() float x 4", 4);
+      static constexpr float coeffs[] = { 1.0f, 0.31755f, 0.20330f };
+      return poly_t<float,__m128>::horner_odd(angles, coeffs); }
     static inline __m128 fast_tan_1(__m128 angles)
-    { static const float coeffs[] = {
-        0.0095168091f, 0.0029005250f, 0.0245650893f, 0.0533740603f, 0.1333923995f, 0.3333314036f
+    { PVEC_PROBE_N("fast_tan_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, 0.3333314036f, 0.1333923995f, 0.0533740603f,
+        0.0245650893f, 0.0029005250f, 0.0095168091f
       };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(angles*angles, coeffs)
-      ); }
+      return poly_t<float,__m128>::estrin_odd(angles, coeffs); }
 
     static inline __m128 fast_arcsin_0(__m128 vals)
-    { // arcsin0(x) = pi/2 - sqrt(1-x)(1.5707288 - 0.2121144x + 0.0742610x*x - 0.0187293x*x*x)
-      static const float coeffs[] = {-0.0187293f, 0.0742610f, -0.2121144f};
+    { PVEC_PROBE_N("fast_arcsin_0() float x 4", 4);
+      // arcsin0(x) = pi/2 - sqrt(1-x)(1.5707288 - 0.2121144x + 0.0742610x*x - 0.0187293x*x*x)
+      static constexpr float coeffs[] = { 1.5707288f, -0.2121144f, 0.0742610f, -0.0187293f };
       __m128 v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(vals, coeffs)
-            + _mm_set1_ps(1.5707288f)
-          ); }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<float,__m128>::horner(vals, coeffs); }
     static inline __m128 fast_arcsin_1(__m128 vals)
-    { static const float coeffs[] = {
-          -0.0012624911f, 0.0066700901f, -0.01708812556f, 0.0308918810f,
-          -0.0501743046f, 0.0889789874f, -0.21459880160f
+    { PVEC_PROBE_N("fast_arcsin_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.5707963050f, -0.21459880160f, 0.0889789874f, -0.0501743046f,
+        0.0308918810f, -0.01708812556f, 0.0066700901f, -0.0012624911f
       };
       __m128 v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(vals, coeffs)
-            + _mm_set1_ps(1.5707963050f)
-          );
-    }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<float,__m128>::estrin(vals, coeffs); }
     static inline __m128 fast_arctan_0(__m128 vals)
-    { static const float coeffs[] = {
-           0.0208351f, -0.0851330f, 0.1801410f,
-          -0.3302995f,  0.9998660f
+    { PVEC_PROBE_N("fast_arctan_0() float x 4", 4);
+      static constexpr float coeffs[] = {
+        0.9998660f, -0.3302995f, 0.1801410f,
+        -0.0851330f, 0.0208351f
       };
-      return horner_odd_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(vals, coeffs);
-    }
+      return poly_t<float,__m128>::horner_odd(vals, coeffs); }
     static inline __m128 fast_arctan_1(__m128 vals)
-    { static const float coeffs[] = {
-          0.0028662257f, -0.0161657367f, 0.0429096138f, -0.0752896400f,
-          0.1065626393f, -0.1420889944f, 0.1999355085f, -0.3333314528f
+    { PVEC_PROBE_N("fast_arctan_1() float x 4", 4);
+      static constexpr float coeffs[] = {
+        1.0f, -0.3333314528f, 0.1999355085f, -0.1420889944f, 0.1065626393f,
+        -0.0752896400f, 0.0429096138f, -0.0161657367f, 0.0028662257f
       };
-      return vals * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m128>()(vals, coeffs)
-      );
-    }
+      return poly_t<float,__m128>::estrin_odd(vals, coeffs); }
 
     static inline __m128 int32_to_packed(int32_t i)
     { return _mm_cvt_si2ss(zeroes(), i); }
@@ -229,16 +261,10 @@ public:
     static inline __m128d goldenratio_packed() { return _mm_set1_pd(goldenratio<double>()); }
 
     static inline __m128d zeroes() { return _mm_setzero_pd(); }
-    static inline __m128d ones()
-    {
-        static const __m128d ones_ = {1.0, 1.0};
-        return ones_;
-    }
-    static inline __m128d halves()
-    {
-        static const __m128d halves_ = {0.5, 0.5};
-        return halves_;
-    }
+    static inline __m128d ones()      { return _mm_castsi128_pd(ipriv::onebits_epi64<54,2>()); }
+    static inline __m128d halves()    { return _mm_castsi128_pd(ipriv::onebits_epi64<55,2>()); }
+    static inline __m128d sign_mask() { return _mm_castsi128_pd(ipriv::onebits_epi64<63,0>()); }
+    static inline __m128d abs_mask()  { return _mm_castsi128_pd(ipriv::onebits_epi64<0,1>()); }
 
     static inline __m128d signs(__m128d v)
     {
@@ -247,7 +273,7 @@ public:
         #else
         // GCC does not allow operator overloads on __m128 and has the operator&
         // not implemented for __m128 (which makes sense)
-        return _mm_and_pd(_mm_or_pd(_mm_and_pd(v, _mm_set1_pd(-0.0)), ones()), _mm_cmpneq_pd(v, zeroes()));
+        return _mm_and_pd(_mm_or_pd(_mm_and_pd(v, sign_mask()), ones()), _mm_cmpneq_pd(v, zeroes()));
         #endif
     }
 
@@ -278,6 +304,11 @@ public:
     { return _mm_cvtsd_f64(max_packed(_mm_set1_pd(a), _mm_set1_pd(b))); }
     static inline __m128d max_packed(__m128d a, __m128d b)
     { return _mm_max_pd(a, b); }
+    static inline __m128d and_packed(__m128d a, __m128d b) { return _mm_and_pd(a, b); }
+    static inline __m128d or_packed(__m128d a, __m128d b) { return _mm_or_pd(a, b); }
+    static inline __m128d xor_packed(__m128d a, __m128d b) { return _mm_xor_pd(a, b); }
+    static inline __m128d cmpgt_packed(__m128d a, __m128d b) { return _mm_cmpgt_pd(a, b); }
+    static inline __m128d cmplt_packed(__m128d a, __m128d b) { return _mm_cmplt_pd(a, b); }
 
     static inline __m128d dot_packed(__m128d a, __m128d b)
         // TODO: dp_pd() and hadd_pd() are rumored to be slow (too complex which stalls
@@ -290,75 +321,74 @@ public:
     { __m128d tmp = a * b; return tmp + yx(tmp); }
 #endif
 
+    static inline __m128d mul_add(__m128d a, __m128d b, __m128d c)
+#if defined(FMA)
+    { return _mm_fmadd_pd(a, b, c); }
+#else
+    { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+#endif
+
     static inline __m128d fast_sin_0(__m128d angles)
-    { static const double coeffs[] = { 0.00761, -0.16605 };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_0() double x 2", 2);
+      static constexpr double coeffs[] = { 1.0, -0.16605, 0.00761 };
+      return poly_t<double,__m128d>::horner_odd(angles, coeffs); }
     static inline __m128d fast_sin_1(__m128d angles)
-    { static const double coeffs[] = { -0.0000000239, 0.0000027526, -0.0001984090, 0.0083333315, -0.1666666664 };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_1() double x 2", 2);
+      static constexpr double coeffs[] = {
+        1.0, -0.1666666664, 0.0083333315,
+        -0.0001984090, 0.0000027526, -0.0000000239
+      };
+      return poly_t<double,__m128d>::estrin_odd(angles, coeffs); }
     static inline __m128d fast_cos_0(__m128d angles)
-    { static const double coeffs[] = { 0.03705, -0.49670 };
-      return
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(angles*angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_0() double x 2", 2);
+      static constexpr double coeffs[] = { 1.0, -0.49670, 0.03705 };
+      return poly_t<double,__m128d>::horner_even(angles, coeffs); }
     static inline __m128d fast_cos_1(__m128d angles)
-    { static const double coeffs[] = { -0.0000002605, 0.0000247609, -0.0013888397, 0.0416666418, -0.4999999963 };
-      return
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(angles*angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_1() double x 2", 2);
+      static constexpr double coeffs[] = {
+        1.0, -0.4999999963, 0.0416666418,
+        -0.0013888397, 0.0000247609, -0.0000002605
+      };
+      return poly_t<double,__m128d>::estrin_even(angles, coeffs); }
     static inline __m128d fast_tan_0(__m128d angles)
-    { static const double coeffs[] = {0.20330, 0.31755};
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_tan_0() double x 2", 2);
+      static constexpr double coeffs[] = { 1.0, 0.31755, 0.20330 };
+      return poly_t<double,__m128d>::horner_odd(angles, coeffs); }
     static inline __m128d fast_tan_1(__m128d angles)
-    { static const double coeffs[] = {
-        0.0095168091, 0.0029005250, 0.0245650893, 0.0533740603, 0.1333923995, 0.3333314036
+    { PVEC_PROBE_N("fast_tan_1() double x 2", 2);
+      static constexpr double coeffs[] = {
+        1.0, 0.3333314036, 0.1333923995, 0.0533740603,
+        0.0245650893, 0.0029005250, 0.0095168091
       };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(angles*angles, coeffs)
-      ); }
+      return poly_t<double,__m128d>::estrin_odd(angles, coeffs); }
 
     static inline __m128d fast_arcsin_0(__m128d vals)
-    { static const double coeffs[] = {-0.0187293, 0.0742610, -0.2121144};
+    { PVEC_PROBE_N("fast_arcsin_0() double x 2", 2);
+      static constexpr double coeffs[] = { 1.5707288, -0.2121144, 0.0742610, -0.0187293 };
       __m128d v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(vals, coeffs)
-            + _mm_set1_pd(1.5707288)
-          ); }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<double,__m128d>::horner(vals, coeffs); }
     static inline __m128d fast_arcsin_1(__m128d vals)
-    { static const double coeffs[] = {
-          -0.0012624911, 0.0066700901, -0.01708812556, 0.0308918810,
-          -0.0501743046, 0.0889789874, -0.21459880160
+    { PVEC_PROBE_N("fast_arcsin_1() double x 2", 2);
+      static constexpr double coeffs[] = {
+        1.5707963050, -0.21459880160, 0.0889789874, -0.0501743046,
+        0.0308918810, -0.01708812556, 0.0066700901, -0.0012624911
       };
       __m128d v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(vals, coeffs)
-            + _mm_set1_pd(1.5707963050)
-          ); 
-    }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<double,__m128d>::estrin(vals, coeffs); }
     static inline __m128d fast_arctan_0(__m128d vals)
-    { static const double coeffs[] = {
-           0.0208351, -0.0851330, 0.1801410,
-          -0.3302995,  0.9998660
+    { PVEC_PROBE_N("fast_arctan_0() double x 2", 2);
+      static constexpr double coeffs[] = {
+        0.9998660, -0.3302995, 0.1801410,
+        -0.0851330, 0.0208351
       };
-      return horner_odd_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(vals, coeffs);
-    }
+      return poly_t<double,__m128d>::horner_odd(vals, coeffs); }
     static inline __m128d fast_arctan_1(__m128d vals)
-    { static const double coeffs[] = {
-          0.0028662257, -0.0161657367, 0.0429096138, -0.0752896400,
-          0.1065626393, -0.1420889944, 0.1999355085, -0.3333314528
+    { PVEC_PROBE_N("fast_arctan_1() double x 2", 2);
+      static constexpr double coeffs[] = {
+        1.0, -0.3333314528, 0.1999355085, -0.1420889944, 0.1065626393,
+        -0.0752896400, 0.0429096138, -0.0161657367, 0.0028662257
       };
-      return vals * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m128d>()(vals, coeffs)
-      );
-    }
+      return poly_t<double,__m128d>::estrin_odd(vals, coeffs); }
 
     static inline __m128d int32_to_packed(int32_t i)
     { return _mm_cvtsi32_sd(zeroes(), i); }
@@ -382,6 +412,8 @@ public:
     typedef float real_t;
     typedef __m256 packed_t;
 
+    static inline __m256 set1(float scalar) { return _mm256_set1_ps(scalar); }
+
     static inline __m256 pi_packed()          { return _mm256_set1_ps(pi<float>());          }
     static inline __m256 two_pi_packed()      { return _mm256_set1_ps(two_pi<float>());      }
     static inline __m256 half_pi_packed()     { return _mm256_set1_ps(half_pi<float>());     }
@@ -394,27 +426,33 @@ public:
     static inline __m256 goldenratio_packed() { return _mm256_set1_ps(goldenratio<float>()); }
 
     static inline __m256 zeroes() { return _mm256_setzero_ps(); }
-    static inline __m256 ones() {
-        static const __m256 ones_ = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
-        return ones_;
-    }
-    static inline __m256 halves() {
-        static const __m256 halves_ = { 0.5f, 0.5, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f };
-        return halves_;
-    }
+#ifdef AVX2
+    static inline __m256 ones()      { return _mm256_castsi256_ps(ipriv::onebits256_epi32<25,2>()); }
+    static inline __m256 halves()    { return _mm256_castsi256_ps(ipriv::onebits256_epi32<26,2>()); }
+    static inline __m256 sign_mask() { return _mm256_castsi256_ps(ipriv::onebits256_epi32<31,0>()); }
+    static inline __m256 abs_mask()  { return _mm256_castsi256_ps(ipriv::onebits256_epi32<0,1>()); }
+#else
+    // no 256 bit integer shifts before AVX2, broadcast the folded immediates
+    static inline __m256 ones()      { return _mm256_set1_ps(1.0f); }
+    static inline __m256 halves()    { return _mm256_set1_ps(0.5f); }
+    static inline __m256 sign_mask() { return _mm256_set1_ps(-0.0f); }
+    static inline __m256 abs_mask()  { return _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)); }
+#endif
 
     static inline __m256 signs(__m256 v)
-    { /*
-      return
-          _mm256_and_ps(
-              _mm256_or_ps(
-                  _mm256_and_ps(v, _mm256_set1_ps(-0.0f)),
-                  _mm256_set1_ps(1.0f)
-              ),
-              _mm256_cmp_ps(v, zeroes(), _CMP_NEQ_OQ)
-          );
-      */
-      return ((v & -0.0f) | 1.0f) & (v != zeroes());
+    {
+        #ifdef _MSC_VER
+        return ((v & -0.0f) | 1.0f) & (v != zeroes());
+        #else
+        return
+            _mm256_and_ps(
+                _mm256_or_ps(
+                    _mm256_and_ps(v, sign_mask()),
+                    ones()
+                ),
+                _mm256_cmp_ps(v, zeroes(), _CMP_NEQ_OQ)
+            );
+        #endif
     }
 
     static inline __m256 reciprocals(__m256 x) {
@@ -429,12 +467,8 @@ public:
         // F(y) = (1/y*y) - x = 0
         // Newton-Raphson:
         // y[n+1] = y[n] - (F(y[n] / F'(y[n]) = 0.5y[n]*(3-y[n]*y[n]*x)
-        static const __m256 threes = {
-            3.0f, 3.0f, 3.0f, 3.0f,
-            3.0f, 3.0f, 3.0f, 3.0f
-        };
         __m256 approx = _mm256_rsqrt_ps(x);
-        return halves() * approx * (threes - (approx * approx * x));
+        return halves() * approx * (set1(3.0f) - (approx * approx * x));
     }
     static inline __m256 sqrt_packed(__m256 x)
     { return _mm256_mul_ps(x, inv_sqrt_packed(x)); }
@@ -456,6 +490,11 @@ public:
     { return _mm_cvtss_f32(_mm_max_ps(_mm_load_ps1(&a), _mm_load_ps1(&b))); }
     static inline __m256 max_packed(__m256 a, __m256 b)
     { return _mm256_max_ps(a, b); }
+    static inline __m256 and_packed(__m256 a, __m256 b) { return _mm256_and_ps(a, b); }
+    static inline __m256 or_packed(__m256 a, __m256 b) { return _mm256_or_ps(a, b); }
+    static inline __m256 xor_packed(__m256 a, __m256 b) { return _mm256_xor_ps(a, b); }
+    static inline __m256 cmpgt_packed(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline __m256 cmplt_packed(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
 
     static inline __m256 dot_packed(__m256 a, __m256 b)
     { __m256 tmp = _mm256_dp_ps(a, b, 0xFF); // {dot1{4},dot0{4}}
@@ -478,75 +517,74 @@ public:
           ); // {(dot1+dot0){4},dot1+dot0{4}};
     }
 
+    static inline __m256 mul_add(__m256 a, __m256 b, __m256 c)
+#if defined(FMA)
+    { return _mm256_fmadd_ps(a, b, c); }
+#else
+    { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+
     static inline __m256 fast_sin_0(__m256 angles)
-    { static const float coeffs[] = { 0.00761f, -0.16605f };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_0() float x 8", 8);
+      static constexpr float coeffs[] = { 1.0f, -0.16605f, 0.00761f };
+      return poly_t<float,__m256>::horner_odd(angles, coeffs); }
     static inline __m256 fast_sin_1(__m256 angles)
-    { static const float coeffs[] = { -0.0000000239f, 0.0000027526f, -0.0001984090f, 0.0083333315f, -0.1666666664f };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_1() float x 8", 8);
+      static constexpr float coeffs[] = {
+        1.0f, -0.1666666664f, 0.0083333315f,
+        -0.0001984090f, 0.0000027526f, -0.0000000239f
+      };
+      return poly_t<float,__m256>::estrin_odd(angles, coeffs); }
     static inline __m256 fast_cos_0(__m256 angles)
-    { static const float coeffs[] = { 0.03705f, -0.49670f };
-      return
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(angles*angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_0() float x 8", 8);
+      static constexpr float coeffs[] = { 1.0f, -0.49670f, 0.03705f };
+      return poly_t<float,__m256>::horner_even(angles, coeffs); }
     static inline __m256 fast_cos_1(__m256 angles)
-    { static const float coeffs[] = { -0.0000002605f, 0.0000247609f, -0.0013888397f, 0.0416666418f, -0.4999999963f };
-      return
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(angles*angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_1() float x 8", 8);
+      static constexpr float coeffs[] = {
+        1.0f, -0.4999999963f, 0.0416666418f,
+        -0.0013888397f, 0.0000247609f, -0.0000002605f
+      };
+      return poly_t<float,__m256>::estrin_even(angles, coeffs); }
     static inline __m256 fast_tan_0(__m256 angles)
-    { static const float coeffs[] = {0.20330f, 0.31755f};
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_tan_0() float x 8", 8);
+      static constexpr float coeffs[] = { 1.0f, 0.31755f, 0.20330f };
+      return poly_t<float,__m256>::horner_odd(angles, coeffs); }
     static inline __m256 fast_tan_1(__m256 angles)
-    { static const float coeffs[] = {
-        0.0095168091f, 0.0029005250f, 0.0245650893f, 0.0533740603f, 0.1333923995f, 0.3333314036f
+    { PVEC_PROBE_N("fast_tan_1() float x 8", 8);
+      static constexpr float coeffs[] = {
+        1.0f, 0.3333314036f, 0.1333923995f, 0.0533740603f,
+        0.0245650893f, 0.0029005250f, 0.0095168091f
       };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(angles*angles, coeffs)
-      ); }
+      return poly_t<float,__m256>::estrin_odd(angles, coeffs); }
 
     static inline __m256 fast_arcsin_0(__m256 vals)
-    { static const float coeffs[] = {-0.0187293f, 0.0742610f, -0.2121144f};
+    { PVEC_PROBE_N("fast_arcsin_0() float x 8", 8);
+      static constexpr float coeffs[] = { 1.5707288f, -0.2121144f, 0.0742610f, -0.0187293f };
       __m256 v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(vals, coeffs)
-            + _mm256_set1_ps(1.5707288f)
-          ); }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<float,__m256>::horner(vals, coeffs); }
     static inline __m256 fast_arcsin_1(__m256 vals)
-    { static const float coeffs[] = {
-          -0.0012624911f, 0.0066700901f, -0.01708812556f, 0.0308918810f,
-          -0.0501743046f, 0.0889789874f, -0.21459880160f
+    { PVEC_PROBE_N("fast_arcsin_1() float x 8", 8);
+      static constexpr float coeffs[] = {
+        1.5707963050f, -0.21459880160f, 0.0889789874f, -0.0501743046f,
+        0.0308918810f, -0.01708812556f, 0.0066700901f, -0.0012624911f
       };
       __m256 v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(vals, coeffs)
-            + _mm256_set1_ps(1.5707963050f)
-          ); 
-    }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<float,__m256>::estrin(vals, coeffs); }
     static inline __m256 fast_arctan_0(__m256 vals)
-    { static const float coeffs[] = {
-           0.0208351f, -0.0851330f, 0.1801410f,
-          -0.3302995f,  0.9998660f
+    { PVEC_PROBE_N("fast_arctan_0() float x 8", 8);
+      static constexpr float coeffs[] = {
+        0.9998660f, -0.3302995f, 0.1801410f,
+        -0.0851330f, 0.0208351f
       };
-      return horner_odd_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(vals, coeffs);
-    }
+      return poly_t<float,__m256>::horner_odd(vals, coeffs); }
     static inline __m256 fast_arctan_1(__m256 vals)
-    { static const float coeffs[] = {
-          0.0028662257f, -0.0161657367f, 0.0429096138f, -0.0752896400f,
-          0.1065626393f, -0.1420889944f, 0.1999355085f, -0.3333314528f
+    { PVEC_PROBE_N("fast_arctan_1() float x 8", 8);
+      static constexpr float coeffs[] = {
+        1.0f, -0.3333314528f, 0.1999355085f, -0.1420889944f, 0.1065626393f,
+        -0.0752896400f, 0.0429096138f, -0.0161657367f, 0.0028662257f
       };
-      return vals * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),float,__m256>()(vals, coeffs)
-      );
-    }
+      return poly_t<float,__m256>::estrin_odd(vals, coeffs); }
 
     // _not_ similar as math_t<float,__m128>::int32_to_packed()
     // this one returns a vector with all elements set to the
@@ -570,6 +608,8 @@ public:
     typedef double real_t;
     typedef __m256d packed_t;
 
+    static inline __m256d set1(double scalar) { return _mm256_set1_pd(scalar); }
+
     static inline __m256d pi_packed()          { return _mm256_set1_pd(pi<double>());          }
     static inline __m256d two_pi_packed()      { return _mm256_set1_pd(two_pi<double>());      }
     static inline __m256d half_pi_packed()     { return _mm256_set1_pd(half_pi<double>());     }
@@ -582,21 +622,26 @@ public:
     static inline __m256d goldenratio_packed() { return _mm256_set1_pd(goldenratio<double>()); }
 
     static inline __m256d zeroes() { return _mm256_setzero_pd(); }
-    static inline __m256d ones() {
-        static const __m256d ones_ = { 1.0, 1.0, 1.0, 1.0 };
-        return ones_;
-    }
-    static inline __m256d halves() {
-        static const __m256d halves_ = { 0.5, 0.5, 0.5, 0.5 };
-        return halves_;
-    }
+#ifdef AVX2
+    static inline __m256d ones()      { return _mm256_castsi256_pd(ipriv::onebits256_epi64<54,2>()); }
+    static inline __m256d halves()    { return _mm256_castsi256_pd(ipriv::onebits256_epi64<55,2>()); }
+    static inline __m256d sign_mask() { return _mm256_castsi256_pd(ipriv::onebits256_epi64<63,0>()); }
+    static inline __m256d abs_mask()  { return _mm256_castsi256_pd(ipriv::onebits256_epi64<0,1>()); }
+#else
+    // no 256 bit integer shifts before AVX2, broadcast the folded immediates
+    static inline __m256d ones()      { return _mm256_set1_pd(1.0); }
+    static inline __m256d halves()    { return _mm256_set1_pd(0.5); }
+    static inline __m256d sign_mask() { return _mm256_set1_pd(-0.0); }
+    static inline __m256d abs_mask()
+    { return _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL)); }
+#endif
 
     static inline __m256d signs(__m256d v)
     { return
           _mm256_and_pd(
               _mm256_or_pd(
-                  _mm256_and_pd(v, _mm256_set1_pd(-0.0)),
-                  _mm256_set1_pd(1.0f)
+                  _mm256_and_pd(v, sign_mask()),
+                  ones()
               ),
               _mm256_cmp_pd(v, zeroes(), _CMP_NEQ_OQ)
           );
@@ -634,6 +679,11 @@ public:
     { return max_scalar(a, b); }
     static inline __m256d max_packed(__m256d a, __m256d b)
     { return _mm256_max_pd(a, b); }
+    static inline __m256d and_packed(__m256d a, __m256d b) { return _mm256_and_pd(a, b); }
+    static inline __m256d or_packed(__m256d a, __m256d b) { return _mm256_or_pd(a, b); }
+    static inline __m256d xor_packed(__m256d a, __m256d b) { return _mm256_xor_pd(a, b); }
+    static inline __m256d cmpgt_packed(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static inline __m256d cmplt_packed(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
 
     static inline __m256d dot_packed(__m256d a, __m256d b)
     { __m256d tmp = _mm256_mul_pd(a, b); // {w0w1,z0z1,y0y1,x0x1}
@@ -641,75 +691,74 @@ public:
       return _mm256_hadd_pd(tmp, tmp);   // {..,w0w1+z0z1+y0y1+x0x1}
     }
 
+    static inline __m256d mul_add(__m256d a, __m256d b, __m256d c)
+#if defined(FMA)
+    { return _mm256_fmadd_pd(a, b, c); }
+#else
+    { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+
     static inline __m256d fast_sin_0(__m256d angles)
-    { static const double coeffs[] = { 0.00761, -0.16605 };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_0() double x 4", 4);
+      static constexpr double coeffs[] = { 1.0, -0.16605, 0.00761 };
+      return poly_t<double,__m256d>::horner_odd(angles, coeffs); }
     static inline __m256d fast_sin_1(__m256d angles)
-    { static const double coeffs[] = { -0.0000000239, 0.0000027526, -0.0001984090, 0.0083333315, -0.1666666664 };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_sin_1() double x 4", 4);
+      static constexpr double coeffs[] = {
+        1.0, -0.1666666664, 0.0083333315,
+        -0.0001984090, 0.0000027526, -0.0000000239
+      };
+      return poly_t<double,__m256d>::estrin_odd(angles, coeffs); }
     static inline __m256d fast_cos_0(__m256d angles)
-    { static const double coeffs[] = { 0.03705, -0.49670 };
-      return
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(angles*angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_0() double x 4", 4);
+      static constexpr double coeffs[] = { 1.0, -0.49670, 0.03705 };
+      return poly_t<double,__m256d>::horner_even(angles, coeffs); }
     static inline __m256d fast_cos_1(__m256d angles)
-    { static const double coeffs[] = { -0.0000002605, 0.0000247609, -0.0013888397, 0.0416666418, -0.4999999963 };
-      return
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(angles*angles, coeffs);
-    }
+    { PVEC_PROBE_N("fast_cos_1() double x 4", 4);
+      static constexpr double coeffs[] = {
+        1.0, -0.4999999963, 0.0416666418,
+        -0.0013888397, 0.0000247609, -0.0000002605
+      };
+      return poly_t<double,__m256d>::estrin_even(angles, coeffs); }
     static inline __m256d fast_tan_0(__m256d angles)
-    { static const double coeffs[] = {0.20330, 0.31755};
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(angles*angles, coeffs)
-      ); }
+    { PVEC_PROBE_N("fast_tan_0() double x 4", 4);
+      static constexpr double coeffs[] = { 1.0, 0.31755, 0.20330 };
+      return poly_t<double,__m256d>::horner_odd(angles, coeffs); }
     static inline __m256d fast_tan_1(__m256d angles)
-    { static const double coeffs[] = {
-        0.0095168091, 0.0029005250, 0.0245650893, 0.0533740603, 0.1333923995, 0.3333314036
+    { PVEC_PROBE_N("fast_tan_1() double x 4", 4);
+      static constexpr double coeffs[] = {
+        1.0, 0.3333314036, 0.1333923995, 0.0533740603,
+        0.0245650893, 0.0029005250, 0.0095168091
       };
-      return angles * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(angles*angles, coeffs)
-      ); }
+      return poly_t<double,__m256d>::estrin_odd(angles, coeffs); }
 
     static inline __m256d fast_arcsin_0(__m256d vals)
-    { static const double coeffs[] = {-0.0187293, 0.0742610, -0.2121144};
+    { PVEC_PROBE_N("fast_arcsin_0() double x 4", 4);
+      static constexpr double coeffs[] = { 1.5707288, -0.2121144, 0.0742610, -0.0187293 };
       __m256d v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(vals, coeffs)
-            + _mm256_set1_pd(1.5707288)
-          ); }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<double,__m256d>::horner(vals, coeffs); }
     static inline __m256d fast_arcsin_1(__m256d vals)
-    { static const double coeffs[] = {
-          -0.0012624911, 0.0066700901, -0.01708812556, 0.0308918810,
-          -0.0501743046, 0.0889789874, -0.21459880160
+    { PVEC_PROBE_N("fast_arcsin_1() double x 4", 4);
+      static constexpr double coeffs[] = {
+        1.5707963050, -0.21459880160, 0.0889789874, -0.0501743046,
+        0.0308918810, -0.01708812556, 0.0066700901, -0.0012624911
       };
       __m256d v = ones() - vals;
-      return half_pi_packed() -
-          v * inv_sqrt_packed(v) * (
-            horner_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(vals, coeffs)
-            + _mm256_set1_pd(1.5707963050)
-          ); 
-    }
+      return half_pi_packed() - v * inv_sqrt_packed(v) * poly_t<double,__m256d>::estrin(vals, coeffs); }
     static inline __m256d fast_arctan_0(__m256d vals)
-    { static const double coeffs[] = {
-           0.0208351f, -0.0851330f, 0.1801410f,
-          -0.3302995f,  0.9998660f
+    { PVEC_PROBE_N("fast_arctan_0() double x 4", 4);
+      static constexpr double coeffs[] = {
+        0.9998660, -0.3302995, 0.1801410,
+        -0.0851330, 0.0208351
       };
-      return horner_odd_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(vals, coeffs);
-    }
+      return poly_t<double,__m256d>::horner_odd(vals, coeffs); }
     static inline __m256d fast_arctan_1(__m256d vals)
-    { static const double coeffs[] = {
-          0.0028662257, -0.0161657367, 0.0429096138, -0.0752896400,
-          0.1065626393, -0.1420889944, 0.1999355085, -0.3333314528
+    { PVEC_PROBE_N("fast_arctan_1() double x 4", 4);
+      static constexpr double coeffs[] = {
+        1.0, -0.3333314528, 0.1999355085, -0.1420889944, 0.1065626393,
+        -0.0752896400, 0.0429096138, -0.0161657367, 0.0028662257
       };
-      return vals * (
-          ones() + horner_even_packed_t<sizeof(coeffs)/sizeof(coeffs[0]),double,__m256d>()(vals, coeffs)
-      );
-    }
+      return poly_t<double,__m256d>::estrin_odd(vals, coeffs); }
 
     // _not_ similar to math_t<float,__m128>::int32_to_packed()
     // this one returns a vector with all elements set to the
@@ -104,25 +104,33 @@ CMP_OPS_(double,__m128d,_mm_,_pd)
 // packed double4 arithmetic and bitwise logical
 //
 ARITH_OPS_(double,__m256d,_mm256_,_pd)
+#ifdef _MSC_VER
 inline __m256d operator-(__m256d op) { return _mm256_sub_pd(_mm256_setzero_pd(), op); }
+#endif
 
 //
 // packed double4 comparisons
 //
+#ifdef _MSC_VER
 AVX_CMP_OPS_(double,__m256d,_pd)
+#endif
 
 
 //
 // packed float8 arithmetic and bitwise logical
 //
 ARITH_OPS_(float,__m256,_mm256_,_ps)
+#ifdef _MSC_VER
 inline __m256 operator-(__m256 op) { return _mm256_sub_ps(_mm256_setzero_ps(), op); }
+#endif
 
 
 //
 // packed float8 comparisons
 //
+#ifdef _MSC_VER
 AVX_CMP_OPS_(float, __m256, _ps)
+#endif
 
 #endif // AVX
 
@@ -20,10 +20,12 @@
 //   {b.x,b.y,b.z,b.w}
 //-> {b.z,b.w,a.z,a.w}
 
+#include <pconfig.h>
 #include <limits>
 #include <cmath>
 #include <stdint.h>
 #include <type_traits>
+#include <pinstr.h>
 
 
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
@@ -67,39 +69,29 @@
 namespace math {
 
 //
-// TODO: check that the approach here actually works,
-//       as inlined statics may be a problem
-//       the problem is, that if the compiler decides
-//       not to inline these functions it must compile
-//       them into normal functions without external linkage
-//       (static), so each compilation unit not only gets its
-//       own copy of the functions' code but also its own
-//       copy of the static variable
-// if it doesn't work, better calculate the values each
-// time (it may not be as expensive as you think, as
-// the current versions have memory accesses which can
-// be expensive, too)
+// scalar constants, constexpr so they fold into immediates/constant
+// pool loads instead of going through a guarded function-local static
 //
-template<typename real_t> static inline real_t pi()
-{ static const real_t val = static_cast<real_t>(4.0*std::atan(1.0)); return val; }
-template<typename real_t> static inline real_t two_pi()
-{ static const real_t val = static_cast<real_t>(8.0*std::atan(1.0)); return val; }
-template<typename real_t> static inline real_t half_pi()
-{ static const real_t val = static_cast<real_t>(2.0*std::atan(1.0)); return val; }
-template<typename real_t> static inline real_t inv_pi()
-{ static const real_t val = static_cast<real_t>(0.25/std::atan(1.0)); return val; }
-template<typename real_t> static inline real_t inv_two_pi()
-{ static const real_t val = static_cast<real_t>(0.125/std::atan(1.0)); return val; }
-template<typename real_t> static inline real_t deg2rad()
-{ static const real_t val = static_cast<real_t>(4.0*std::atan(1.0)/180.0); return val; }
-template<typename real_t> static inline real_t rad2deg()
-{ static const real_t val = static_cast<real_t>(45.0/std::atan(1.0)); return val; }
-template<typename real_t> static inline real_t euler()
-{ static const real_t val = static_cast<real_t>(std::exp(1.0)); return val; }
-template<typename real_t> static inline real_t sqrt2()
-{ static const real_t val = static_cast<real_t>(std::sqrt(2.0)); return val; }
-template<typename real_t> static inline real_t goldenratio()
-{ static const real_t val = static_cast<real_t>((1.0 + std::sqrt(5.0)) * 0.5); return val; }
+template<typename real_t> static inline constexpr real_t pi()
+{ return static_cast<real_t>(3.14159265358979323846); }
+template<typename real_t> static inline constexpr real_t two_pi()
+{ return static_cast<real_t>(6.28318530717958647693); }
+template<typename real_t> static inline constexpr real_t half_pi()
+{ return static_cast<real_t>(1.57079632679489661923); }
+template<typename real_t> static inline constexpr real_t inv_pi()
+{ return static_cast<real_t>(0.31830988618379067154); }
+template<typename real_t> static inline constexpr real_t inv_two_pi()
+{ return static_cast<real_t>(0.15915494309189533577); }
+template<typename real_t> static inline constexpr real_t deg2rad()
+{ return static_cast<real_t>(0.01745329251994329577); }
+template<typename real_t> static inline constexpr real_t rad2deg()
+{ return static_cast<real_t>(57.2957795130823208768); }
+template<typename real_t> static inline constexpr real_t euler()
+{ return static_cast<real_t>(2.71828182845904523536); }
+template<typename real_t> static inline constexpr real_t sqrt2()
+{ return static_cast<real_t>(1.41421356237309504880); }
+template<typename real_t> static inline constexpr real_t goldenratio()
+{ return static_cast<real_t>(1.61803398874989484820); }
 
 
 //
@@ -130,6 +122,9 @@ public:
     static inline packed_t zeroes();
     static inline packed_t ones();
     static inline packed_t halves();
+    // -0.0 (sign bit only) and its complement in every element
+    static inline packed_t sign_mask();
+    static inline packed_t abs_mask();
 
     static inline packed_t signs(packed_t);
     static inline packed_t reciprocals(packed_t);
@@ -143,9 +138,18 @@ public:
     static inline real_t max_scalar(real_t a, real_t b);
     static inline real_t max_packed(real_t a, real_t b);
     static inline packed_t max_packed(packed_t a, packed_t b);
+    // bitwise logical and comparisons (all bits set where true)
+    static inline packed_t and_packed(packed_t a, packed_t b);
+    static inline packed_t or_packed(packed_t a, packed_t b);
+    static inline packed_t xor_packed(packed_t a, packed_t b);
+    static inline packed_t cmpgt_packed(packed_t a, packed_t b);
+    static inline packed_t cmplt_packed(packed_t a, packed_t b);
     
     static inline packed_t dot_packed(packed_t a, packed_t b);
 
+    // a * b + c (fused if supported)
+    static inline packed_t mul_add(packed_t a, packed_t b, packed_t c);
+
     // angles : [0,pi/2], error: |e(x)| <= 1.7e-4
     static inline packed_t fast_sin_0(packed_t angles);
     // angles : [0,pi/2], error: |e(x)| <= 1.9e-8
@@ -156,7 +160,7 @@ public:
     static inline packed_t fast_cos_1(packed_t angles);
     // angles : [0,pi/4], error: |e(x)| <= 8.1e-4
     static inline packed_t fast_tan_0(packed_t angles);
-    // angles:  [0,pi/2], error: |e(x)| <= 1.9e-8
+    // angles : [0,pi/4], error: |e(x)| <= 1.9e-8
     static inline packed_t fast_tan_1(packed_t angles);
 
     // vals : [0,1], error: |e(x)| <= 6.8e-5
@@ -186,175 +190,115 @@ private:
 
 
 //
-// Horner polynome evaluation (even exponents only, no absolute term)
+// polynomial evaluation
 //
-template<unsigned N, typename real_t> struct horner_even_t {
-    inline real_t operator()(real_t x, const real_t * coeffs) {
-        return x * x * (coeffs[N-1] + horner_even_t<N-1,real_t>()(x, coeffs));
-    }
-};
-template<typename real_t> struct horner_even_t<1,real_t> {
-    inline real_t operator()(real_t x, const real_t * coeffs) {
-        return coeffs[0] * x * x;
-    }
-};
-
-template<unsigned N, typename real_t, typename packed_t> struct horner_even_packed_t
-{
-    inline packed_t operator()(packed_t x, const real_t * coeffs) {
-        return x * x * (coeffs[N-1] + horner_even_packed_t<N-1,real_t,packed_t>()(x, coeffs));
-    }
-};
-template<typename real_t, typename packed_t> struct horner_even_packed_t<1,real_t,packed_t>
-{
-    inline packed_t operator()(packed_t x, const real_t * coeffs) {
-        return coeffs[0] * x * x;
-    }
-};
-
+// poly_t<real_t,packed_t> evaluates polynomials with the coefficients given as
+// arrays (of compile time size N) in ascending order of the exponents:
+//   horner(x, c), estrin(x, c):           c[0] + c[1]*x + ... + c[N-1]*x^(N-1)
+//   horner_even(x, c), estrin_even(x, c): c[0] + c[1]*x^2 + ... + c[N-1]*x^(2N-2)
+//   horner_odd(x, c), estrin_odd(x, c):   c[0]*x + c[1]*x^3 + ... + c[N-1]*x^(2N-1)
 //
-// Horner polynome evaluation (odd exponents only, no absolute term)
+// Horner's scheme needs the least operations (N-1 multiply-adds), but each of
+// them depends on the previous one; Estrin's scheme evaluates pairs of terms
+// independently and combines them per x^2, x^4, ..., which shortens the
+// dependency chain to about log2(N) multiply-adds for about log2(N) additional
+// squarings, i.e. it's faster for longer polynomials unless the pipelines are
+// busy with independent work anyway
 //
-template<unsigned N, typename real_t> struct horner_odd_t
-{
-    inline real_t operator()(real_t x, const real_t * coeffs)
-    {
-        return x * (horner_even_t<N-1,real_t>()(x, coeffs) + coeffs[N-1]);
-    }
-};
-
-template<unsigned N, typename real_t, typename packed_t> struct horner_odd_packed_t
-{
-    inline packed_t operator()(packed_t x, const real_t * coeffs)
-    {
-        return x * (horner_even_packed_t<N-1,real_t,packed_t>()(x,coeffs) + coeffs[N-1]);
-    }
-};
-
-
+// the multiply-adds use math_t::mul_add(), which maps to the FMA instructions
+// if available (define FMA on x86, always on ARMv8)
 //
-// Horner polynome evaluation (odd and even exponents, no absolute term)
+// packed_t == real_t evaluates scalars
 //
-template<unsigned N, typename real_t> struct horner_t {
-    inline real_t operator()(real_t x, const real_t * coeffs) {
-        return x * (coeffs[N-1] + horner_t<N-1,real_t>()(x, coeffs));
-    }
-};
-template<typename real_t> struct horner_t<1,real_t> {
-    inline real_t operator()(real_t x, const real_t * coeffs) {
-        return coeffs[0] * x;
-    }
-};
-
-template<unsigned N, typename real_t, typename packed_t> struct horner_packed_t {
-    inline packed_t operator()(packed_t x, const real_t * coeffs) {
-        return x * (coeffs[N-1] + horner_packed_t<N-1,real_t, packed_t>()(x, coeffs));
-    }
-};
-template <typename real_t, typename packed_t> struct horner_packed_t<1,real_t,packed_t> {
-    inline packed_t operator()(packed_t x, const real_t * coeffs) {
-        return coeffs[0] * x;
-    }
-};
-
-
-// expeval_t
-// returns pow(x,N)
-template<unsigned N, typename real_t> struct expeval_t {
-    inline real_t operator()(real_t x) {
-        return x * expeval_t<N-1,real_t>()(x);
-    }
-};
-template<typename real_t> struct expeval_t<1,real_t> {
-    inline real_t operator()(real_t x) { return x; }
-};
-template<typename real_t> struct expeval_t<0U,real_t> {
-    inline real_t operator()(real_t x) { return real_t(1.0); }
-};
-template<unsigned N, typename real_t, typename packed_t> struct expeval_packed_t {
-    inline packed_t operator()(packed_t x) {
-        return x * expeval_packed_t<N-1,real_t,packed_t>()(x);
-    }
-};
-template<typename real_t, typename packed_t> struct expeval_packed_t<1U,real_t,packed_t> {
-    inline packed_t operator()(packed_t x) { return x; }
-};
-template<typename real_t, typename packed_t> struct expeval_packed_t<0U,real_t,packed_t> {
-    inline packed_t operator()(packed_t x) { return math_t<real_t,packed_t>::ones(); }
-};
+namespace ipriv {
 
-// polynomialeval_t
-// returns sum[0<=i<N](coeffs[i]*pow(x,i))
-template<unsigned N, typename real_t> struct polynomialeval_t
-{
-    inline real_t operator()(real_t x, const real_t * coeffs)
+    template<typename real_t, typename packed_t> struct poly_ops_t
     {
-        return coeffs[N-1] * expeval_t<N-1,real_t>()(x) + polynomialeval_t<N-1,real_t>()(x, coeffs);
-    }
-};
-template<typename real_t> struct polynomialeval_t<1,real_t>
-{
-    inline real_t operator()(real_t x, const real_t * coeffs) { return coeffs[0]; }
-};
-template<unsigned N,typename real_t, typename packed_t> struct polynomialeval_packed_t
-{
-    inline packed_t operator()(packed_t x, const real_t * coeffs)
+        static inline packed_t set1(real_t s) { return math_t<real_t,packed_t>::set1(s); }
+        static inline packed_t mul_add(packed_t a, packed_t b, packed_t c)
+        { return math_t<real_t,packed_t>::mul_add(a, b, c); }
+    };
+    template<typename real_t> struct poly_ops_t<real_t,real_t>
     {
-        return coeffs[N-1] * expeval_packed_t<N-1,real_t,packed_t>()(x) + polynomialeval_packed_t<N-1,real_t,packed_t>()(x, coeffs);
-    }
-};
-template<typename real_t, typename packed_t> struct polynomialeval_packed_t<1,real_t,packed_t>
-{
-    // not optimal but does the conversion independent of instruction set
-    inline packed_t operator()(packed_t x, const real_t * coeffs) { return math_t<real_t,packed_t>::ones() * coeffs[0]; }
-};
+        static inline real_t set1(real_t s) { return s; }
+        static inline real_t mul_add(real_t a, real_t b, real_t c) { return a * b + c; }
+    };
 
-// polynomialeval_even_t
-// returns sum[0<=i<N](coeffs[i]*x^(n*2+2))
-template<unsigned N, typename real_t> struct polynomialeval_even_t
-{
-    inline real_t operator()(real_t x, const real_t * coeffs)
+    // c[0] + x*(c[1] + x*(... + x*c[K-1]))
+    template<unsigned K> struct horner_r
     {
-        return coeffs[N-1] * expeval_t<N*2,real_t>()(x) + polynomialeval_even_t<N-1,real_t>()(x, coeffs);
-    }
-};
-template<typename real_t> struct polynomialeval_even_t<0U,real_t> {
-    inline real_t operator()(real_t x, const real_t *) { return real_t(0.0); }
-};
-template<unsigned N, typename real_t, typename packed_t> struct polynomialeval_even_packed_t
-{
-    inline packed_t operator()(packed_t x, const real_t * coeffs)
+        template<typename ops_t, typename packed_t, typename real_t>
+        static inline packed_t eval(packed_t x, const real_t * c)
+        { return ops_t::mul_add(horner_r<K-1>::template eval<ops_t>(x, c + 1), x, ops_t::set1(c[0])); }
+    };
+    template<> struct horner_r<1>
     {
-        return coeffs[N-1] * expeval_packed_t<N*2,real_t,packed_t>()(x) + polynomialeval_even_packed_t<N-1,real_t,packed_t>()(x, coeffs);
-    }
-};
-template<typename real_t, typename packed_t> struct polynomialeval_even_packed_t<0U,real_t,packed_t>
-{
-    inline packed_t operator()(packed_t, const real_t *) { return math_t<real_t,packed_t>::zeroes(); }
-};
+        template<typename ops_t, typename packed_t, typename real_t>
+        static inline packed_t eval(packed_t, const real_t * c) { return ops_t::set1(c[0]); }
+    };
 
-// polynomialeval_odd_t
-// returns sum[0<=i<N](coeffs[i]*x^(n*2+1))
-template<unsigned N, typename real_t> struct polynomialeval_odd_t
-{
-    inline real_t operator()(real_t x, const real_t * coeffs)
+    // x^(2^L) per L squarings (shared between the calls after inlining)
+    template<unsigned L> struct pow2_r
     {
-        return coeffs[N-1] * expeval_t<N*2-1,real_t>()(x) + polynomialeval_odd_t<N-1,real_t>()(x, coeffs);
-    }
-};
-template<typename real_t> struct polynomialeval_odd_t<0U,real_t>
-{
-    inline real_t operator()(real_t x, const real_t *) { return real_t(0.0); }
-};
-template<unsigned N, typename real_t, typename packed_t> struct polynomialeval_odd_packed_t
-{
-    inline packed_t operator()(packed_t x, const real_t * coeffs) {
-        return coeffs[N-1] * expeval_packed_t<N*2-1,real_t,packed_t>()(x) + polynomialeval_odd_packed_t<N-1,real_t,packed_t>()(x, coeffs);
-    }
-};
-template<typename real_t, typename packed_t> struct polynomialeval_odd_packed_t<0U,real_t,packed_t>
+        template<typename packed_t> static inline packed_t eval(packed_t x)
+        { packed_t y = pow2_r<L-1>::eval(x); return y * y; }
+    };
+    template<> struct pow2_r<0>
+    {
+        template<typename packed_t> static inline packed_t eval(packed_t x) { return x; }
+    };
+
+    // largest power of 2 below k (k >= 2) and its log2
+    constexpr unsigned estrin_split(unsigned k, unsigned m = 1)
+    { return m * 2 < k ? estrin_split(k, m * 2) : m; }
+    constexpr unsigned log2_pow2(unsigned m)
+    { return m <= 1 ? 0 : 1 + log2_pow2(m / 2); }
+
+    // lower M terms + x^M * upper K-M terms, M the largest power of 2 below K,
+    // so the terms are evaluated pairwise, the pairs per x^2, those per x^4, ...
+    template<unsigned K> struct estrin_r
+    {
+        static const unsigned M = estrin_split(K);
+
+        template<typename ops_t, typename packed_t, typename real_t>
+        static inline packed_t eval(packed_t x, const real_t * c)
+        {
+            return
+                ops_t::mul_add(
+                    estrin_r<K - M>::template eval<ops_t>(x, c + M),
+                    pow2_r<log2_pow2(M)>::eval(x),
+                    estrin_r<M>::template eval<ops_t>(x, c)
+                );
+        }
+    };
+    template<> struct estrin_r<1>
+    {
+        template<typename ops_t, typename packed_t, typename real_t>
+        static inline packed_t eval(packed_t, const real_t * c) { return ops_t::set1(c[0]); }
+    };
+
+} // namespace ipriv
+
+template<typename real_t, typename packed_t = real_t>
+struct poly_t
 {
-    inline packed_t operator()(packed_t x, const real_t *) { return math_t<real_t,packed_t>::zeroes(); }
+    typedef ipriv::poly_ops_t<real_t,packed_t> ops_t;
+
+    template<unsigned N> static inline packed_t horner(packed_t x, const real_t (&c)[N])
+    { return ipriv::horner_r<N>::template eval<ops_t>(x, c); }
+
+    template<unsigned N> static inline packed_t estrin(packed_t x, const real_t (&c)[N])
+    { return ipriv::estrin_r<N>::template eval<ops_t>(x, c); }
+
+    template<unsigned N> static inline packed_t horner_even(packed_t x, const real_t (&c)[N])
+    { return horner(x * x, c); }
+    template<unsigned N> static inline packed_t estrin_even(packed_t x, const real_t (&c)[N])
+    { return estrin(x * x, c); }
+
+    template<unsigned N> static inline packed_t horner_odd(packed_t x, const real_t (&c)[N])
+    { return x * horner(x * x, c); }
+    template<unsigned N> static inline packed_t estrin_odd(packed_t x, const real_t (&c)[N])
+    { return x * estrin(x * x, c); }
 };
 
 
@@ -11,9 +11,11 @@
 #define PMATHI_H
 
 
+#include <pconfig.h>
 //#include <limits>
 #include <stdint.h>
 #include <type_traits>
+#include <pinstr.h>
 
 
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
@@ -43,10 +45,42 @@
 #define PMATHI_ARM_GCC
 #endif
 
+// instruction set tier the packed integer operations are compiled for,
+// chosen per the defines of pconfig.h (SSE2 is implied on Intel)
+#if defined(PMATHI_INTEL)
+# if defined(AVX512VL)
+#   define PMATHI_ISA_TIER isa_tier_t::avx512vl
+# elif defined(AVX2)
+#   define PMATHI_ISA_TIER isa_tier_t::avx2
+# elif defined(SSE4_2)
+#   define PMATHI_ISA_TIER isa_tier_t::sse4_2
+# elif defined(SSE4)
+#   define PMATHI_ISA_TIER isa_tier_t::sse4_1
+# elif defined(SSSE3)
+#   define PMATHI_ISA_TIER isa_tier_t::ssse3
+# else
+#   define PMATHI_ISA_TIER isa_tier_t::sse2
+# endif
+#elif defined(PMATHI_ARM)
+# define PMATHI_ISA_TIER isa_tier_t::neon
+#endif
+
 
 
 namespace math {
 
+// instruction set tiers, ordered from lowest to highest for the Intel ones
+enum class isa_tier_t
+{
+    sse2,
+    ssse3,
+    sse4_1,   // pminsb, pminud, pmaxuw, pcmpeqq, ...
+    sse4_2,   // pcmpgtq
+    avx2,
+    avx512vl, // vpminsq, vpminuq, vpabsq, vpcmpuq on 128/256 bit registers
+    neon
+};
+
 //
 // math_t general template
 //
@@ -65,6 +99,9 @@ public:
     static inline packed_t largest_val();
     static inline packed_t smallest_val();
 
+    // instruction set tier the operations on packed_t are implemented for
+    static constexpr isa_tier_t isa_tier();
+
     // returns vector with elements containing masks with Z bits cleared starting from MSB
     // and W-Z bits set starting from LSB with W being the width on bits of the elements
     template<unsigned Z> static inline packed_t mask_zupper();
@@ -88,6 +125,7 @@ class imath_t<int8_t, __m128i>
 public:
     typedef int8_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -125,6 +163,7 @@ class imath_t<uint8_t, __m128i>
 public:
     typedef uint8_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -163,6 +202,7 @@ class imath_t<int16_t, __m128i>
 public:
     typedef int16_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -198,6 +238,7 @@ class imath_t<uint16_t, __m128i>
 public:
     typedef uint16_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -234,6 +275,7 @@ class imath_t<int32_t, __m128i>
 public:
     typedef int32_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -271,6 +313,7 @@ class imath_t<uint32_t, __m128i>
 public:
     typedef uint32_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -307,6 +350,7 @@ class imath_t<int64_t, __m128i>
 public:
     typedef int64_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -343,6 +387,7 @@ class imath_t<uint64_t, __m128i>
 public:
     typedef uint64_t int_t;
     typedef __m128i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __m128i zeroes() { return _mm_setzero_si128(); }
     static inline __m128i onebits() { return _mm_cmpeq_epi32(zeroes(), zeroes()); }
@@ -373,6 +418,316 @@ public:
 };
 
 
+
+
+#if defined(AVX2)
+
+//
+// 256 bit integer vectors (AVX2)
+// constants are synthesized the same way as for __m128i (the shifts operate
+// on both 128 bit lanes identically)
+//
+
+template<>
+class imath_t<int8_t, __m256i>
+{
+public:
+    typedef int8_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() {
+        __m256i tmp = _mm256_slli_epi16(onebits(), 15); // {0x8000}*16
+        return _mm256_or_si256(tmp, _mm256_srli_epi16(tmp, 8)/*{0x0080}*16*/);
+    }
+    static inline __m256i largest_val() { return _mm256_xor_si256(sign_mask(), onebits()); }
+    static inline __m256i smallest_val() { return sign_mask(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        __m256i tmp = _mm256_srli_epi16(onebits(), Z+8);
+        return _mm256_or_si256(tmp, _mm256_slli_epi16(tmp, 8));
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        __m256i tmp = _mm256_slli_epi16(onebits(), Z+8);
+        return _mm256_or_si256(tmp, _mm256_srli_epi16(tmp, 8));
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        __m256i tmp = _mm256_add_epi16(_mm256_srli_epi16(onebits(), bits - B), _mm256_srli_epi16(onebits(), 15));
+        return _mm256_or_si256(tmp, _mm256_srli_epi16(tmp, 8));
+    }
+
+};
+
+template<>
+class imath_t<uint8_t, __m256i>
+{
+public:
+    typedef uint8_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() {
+        __m256i tmp = _mm256_slli_epi16(onebits(), 15); // {0x8000}*16
+        return _mm256_or_si256(tmp, _mm256_srli_epi16(tmp, 8)/*{0x0080}*16*/);
+    }
+    static inline __m256i largest_val() { return onebits(); }
+    static inline __m256i smallest_val() { return zeroes(); }
+    
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        __m256i tmp = _mm256_srli_epi16(onebits(), Z+8);
+        return _mm256_or_si256(tmp, _mm256_slli_epi16(tmp, 8));
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        __m256i tmp = _mm256_slli_epi16(onebits(), Z+8);
+        return _mm256_or_si256(tmp, _mm256_srli_epi16(tmp, 8));
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        __m256i tmp = _mm256_add_epi16(_mm256_srli_epi16(onebits(), bits - B), _mm256_srli_epi16(onebits(), 15));
+        return _mm256_or_si256(tmp, _mm256_srli_epi16(tmp, 8));
+    }
+
+
+};
+
+template<>
+class imath_t<int16_t, __m256i>
+{
+public:
+    typedef int16_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() { return _mm256_slli_epi16(onebits(), 15); /*{0x8000}*16*/ }
+    static inline __m256i largest_val() { return _mm256_srli_epi16(onebits(), 1); }
+    static inline __m256i smallest_val() { return sign_mask(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_srli_epi16(onebits(), Z);
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_slli_epi16(onebits(), Z);
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        return
+            _mm256_add_epi16(
+                B > 0 ? _mm256_srli_epi16(onebits(), bits - B) : zeroes(),
+                _mm256_srli_epi16(onebits(), 15) //(1)*8
+            );
+    }
+
+};
+
+template<>
+class imath_t<uint16_t, __m256i>
+{
+public:
+    typedef uint16_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() { return _mm256_slli_epi16(onebits(), 15); /*{0x8000}*16*/ }
+    
+    static inline __m256i largest_val() { return onebits(); }
+    static inline __m256i smallest_val() { return zeroes(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_srli_epi16(onebits(), Z);
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_slli_epi16(onebits(), Z);
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        return
+            _mm256_add_epi16(
+                B > 0 ? _mm256_srli_epi16(onebits(), bits - B) : zeroes(),
+                _mm256_srli_epi16(onebits(), 15) //(1)*8
+            );
+    }
+
+};
+
+template<>
+class imath_t<int32_t, __m256i>
+{
+public:
+    typedef int32_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() { return _mm256_slli_epi32(onebits(), 31); /*{0x80000000}*8*/ }
+    static inline __m256i largest_val() { return _mm256_srli_epi32(onebits(), 1); }
+    static inline __m256i smallest_val() { return sign_mask(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_srli_epi32(onebits(), Z);
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_slli_epi32(onebits(), Z);
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        return
+            _mm256_add_epi32(
+                B > 0 ? _mm256_srli_epi32(onebits(), bits - B) : zeroes(),
+                _mm256_srli_epi32(onebits(), 31) //(1)*8
+            );
+    }
+
+};
+
+
+
+template<>
+class imath_t<uint32_t, __m256i>
+{
+public:
+    typedef uint32_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() { return _mm256_slli_epi32(onebits(), 31); /*{0x80000000}*8*/ }
+    static inline __m256i largest_val() { return onebits(); }
+    static inline __m256i smallest_val() { return zeroes(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_srli_epi32(onebits(), Z);
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_slli_epi32(onebits(), Z);
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        return
+            _mm256_add_epi32(
+                B > 0 ? _mm256_srli_epi32(onebits(), bits - B) : zeroes(),
+                _mm256_srli_epi32(onebits(), 31) //(1)*8
+            );
+    }
+
+
+};
+
+template<>
+class imath_t<int64_t, __m256i>
+{
+public:
+    typedef int64_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() { return _mm256_slli_epi64(onebits(), 63); /*{0x8000000000000000}*4*/ }
+    static inline __m256i largest_val() { return _mm256_srli_epi64(onebits(), 1); }
+    static inline __m256i smallest_val() { return sign_mask(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_srli_epi64(onebits(), Z);
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Zmust be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_slli_epi64(onebits(), Z);
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        return
+            _mm256_add_epi64(
+                B > 0 ? _mm256_srli_epi64(onebits(), bits - B) : zeroes(),
+                _mm256_srli_epi64(onebits(), 63) //(1)*8
+            );
+    }
+
+
+};
+
+template<>
+class imath_t<uint64_t, __m256i>
+{
+public:
+    typedef uint64_t int_t;
+    typedef __m256i packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
+
+    static inline __m256i zeroes() { return _mm256_setzero_si256(); }
+    static inline __m256i onebits() { return _mm256_cmpeq_epi32(zeroes(), zeroes()); }
+    static inline __m256i sign_mask() { return _mm256_slli_epi64(onebits(), 63); /*{0x8000000000000000}*4*/ }
+    static inline __m256i largest_val() { return onebits(); }
+    static inline __m256i smallest_val() { return zeroes(); }
+
+    template<unsigned Z> static inline packed_t mask_zupper() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_srli_epi64(onebits(), Z);
+    }
+    template<unsigned Z> static inline packed_t mask_zlower() {
+        static_assert(Z > 0, "Z must be > 0, use onebits() for a value with all bits set");
+        static_assert(Z < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        return _mm256_slli_epi64(onebits(), Z);
+    }
+    template<unsigned B> static inline packed_t mask_1bit() {
+        static_assert(B < sizeof(int_t)*8, "Z must be less than the number of bits per element");
+        const unsigned bits = sizeof(int_t)*8;
+        return
+            _mm256_add_epi64(
+                B > 0 ? _mm256_srli_epi64(onebits(), bits - B) : zeroes(),
+                _mm256_srli_epi64(onebits(), 63) //(1)*8
+            );
+    }
+    
+};
+
+#endif // defined(AVX2)
+
 #elif defined(PMATHI_ARM)
 
 #ifdef PMATHI_ARM_GCC
@@ -385,6 +740,7 @@ class imath_t<int8_t, __n128>
 public:
     typedef int8_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_s8(0); }
     static inline __n128 onebits()
@@ -460,6 +816,7 @@ class imath_t<uint8_t, __n128>
 public:
     typedef uint8_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_u8(0); }
 
@@ -512,6 +869,7 @@ class imath_t<int16_t, __n128>
 public:
     typedef int16_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_s16(0); }
     static inline __n128 onebits()
@@ -588,6 +946,7 @@ class imath_t<uint16_t, __n128>
 public:
     typedef uint16_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_u16(0); }
     static inline __n128 onebits()
@@ -638,6 +997,7 @@ class imath_t<int32_t, __n128>
 public:
     typedef int32_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_s32(0); }
     static inline __n128 onebits() { return vreinterpretq_s32_u32(vceqq_s32(zeroes(), zeroes())); }
@@ -704,6 +1064,7 @@ class imath_t<uint32_t, __n128>
 public:
     typedef uint32_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_u32(0); }
     static inline __n128 onebits() { return vceqq_u32(zeroes(), zeroes()); }
@@ -745,6 +1106,7 @@ class imath_t<int64_t, __n128>
 public:
     typedef int64_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_s64(0); }
     static inline __n128 onebits()
@@ -820,6 +1182,7 @@ class imath_t<uint64_t, __n128>
 public:
     typedef uint64_t int_t;
     typedef __n128 packed_t;
+    static constexpr isa_tier_t isa_tier() { return PMATHI_ISA_TIER; }
 
     static inline __n128 zeroes() { return vdupq_n_u64(0); }
     static inline __n128 onebits()
@@ -0,0 +1,455 @@
+/*******************************************************************************
+ * pnoise.h                                                                    *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PNOISE_H
+#define PNOISE_H
+
+#include <pvecf.h>
+#include <pveci.h>
+#include <pcvt.h>
+#include <stdint.h>
+
+
+/*
+gradient noise
+--------------
+packed Perlin ("improved noise", quintic fade) and simplex noise for 2, 3 and
+4 dimensions, evaluated for 4 points per call (vec4f_t) or 8 points (vec8f_t,
+AVX and AVX2); the coordinates are passed as SoA vectors:
+
+  perlin(x, y[, z[, w]][, seed])    gradient noise on the integer lattice
+  simplex(x, y[, z[, w]][, seed])   simplex noise (Gustavson), fewer corners
+                                    (3/4/5 instead of 4/8/16), isotropic
+  fbm(kind, x, y[, z[, w]], octaves[, lacunarity, gain, seed])
+                                    fractal sum of octaves of noise_t::perlin
+                                    or noise_t::simplex, the octave o sampled
+                                    at frequency lacunarity^o with amplitude
+                                    gain^o and seed + o
+  turbulence(kind, ...)             same, summing the absolute values
+
+the noise values lie in [-1,1] (the scale factors are chosen so the extremes
+reach about +-1, Perlin noise rarely exceeds +-0.7), fbm() in [-1,1] and
+turbulence() in [0,1] (the sums are normalized by the sum of the amplitudes);
+the noise is 0 at the lattice points (Perlin) or the simplex corners, the seed
+selects an independent pattern
+
+there's no permutation table: the lattice points are hashed with 32 bit
+integer arithmetic in veci_ui32x4_t (veci_ui32x8_t) lanes (one mul_lo() per
+axis and per corner), and the gradient is picked from the hash bits with
+bitwise selects, so no table lookups (gathers) are needed; the cell index is
+floor() of the coordinate, converted with cvt_i32() (pcvt.h), so the
+coordinates have to stay within +-2^31 (the precision of float limits the
+useful range much earlier)
+*/
+
+// TODO:
+// - derivatives (analytic gradients for normal mapping/erosion)
+// - periodic (tiling) variants
+
+
+namespace math {
+
+enum class noise_t { perlin, simplex };
+
+namespace ipriv {
+
+    static const uint32_t noise_px = 0x8DA6B343u, noise_py = 0xD8163841u;
+    static const uint32_t noise_pz = 0xCB1AB31Fu, noise_pw = 0x9E3779B1u;
+
+    // the unsigned integer vector of the width of F (the hash lanes)
+    template<typename F> struct noise_types_t;
+    template<> struct noise_types_t<vec4f_t> { typedef veci_ui32x4_t uvec_t; };
+#if defined(PVECI_INTEL) && defined(AVX) && defined(AVX2)
+    template<> struct noise_types_t<vec8f_t> { typedef veci_ui32x8_t uvec_t; };
+#endif
+
+    // all elements s
+    template<typename U> inline U noise_splat(uint32_t s) { return U() + s; }
+    template<typename F> inline F noise_fsplat(float s) { return F(F::math_t::set1(s)); }
+
+    template<typename F> inline F noise_mul_add(const F & a, const F & b, const F & c)
+    { return F(F::math_t::mul_add(a.p, b.p, c.p)); }
+
+    // hash of the integer coordinate c (c = floor(c)) on the axis with the
+    // multiplier prime
+    template<typename F>
+    inline typename noise_types_t<F>::uvec_t noise_index(const F & c, uint32_t prime)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        return mul_lo(as_u32(cvt_i32<round_t::trunc>(c)), noise_splat<U>(prime));
+    }
+
+    // hash of a corner from the sum of the axis hashes (ix*px ^ iy*py ..),
+    // the upper bits are the well mixed ones
+    template<typename U> inline U noise_mix(U h, const U & seed)
+    {
+        h ^= seed;
+        h ^= shr_logical<16>(h);
+        h = mul_lo(h, noise_splat<U>(0x7FEB352Du));
+        return h ^ shr_logical<15>(h);
+    }
+
+    // all bits set where bit B of h is set
+    template<unsigned B, typename U> inline U noise_bit(const U & h)
+    { return shr_arith<31>(shl<31-B>(h)); }
+
+    // x negated where bit B of h is set
+    template<unsigned B, typename F, typename U> inline F noise_negate(const F & x, const U & h)
+    { return as_f32(as_u32(x) ^ (shl<31-B>(h) & noise_splat<U>(0x80000000u))); }
+
+    // a where m is set, b elsewhere
+    template<typename F, typename U> inline F noise_select(const U & m, const F & a, const F & b)
+    { return as_f32(as_u32(b) ^ ((as_u32(a) ^ as_u32(b)) & m)); }
+
+    // all bits set where a > b (the sign of b - a, the offsets are small)
+    template<typename F> inline typename noise_types_t<F>::uvec_t noise_gt(const F & a, const F & b)
+    { return shr_arith<31>(as_u32(b - a)); }
+
+    // 1.0 where m is set
+    template<typename F, typename U> inline F noise_one(const U & m)
+    { return as_f32(m & noise_splat<U>(0x3F800000u)); }
+
+    // the hash of the index + 1 where m is set
+    template<typename U> inline U noise_step(const U & h, const U & m, uint32_t prime)
+    { return h + (m & noise_splat<U>(prime)); }
+
+    // gradient . (x, y), the gradients (+-1,+-1)
+    template<typename F, typename U> inline F noise_grad(const U & h, const F & x, const F & y)
+    { return noise_negate<31>(x, h) + noise_negate<30>(y, h); }
+
+    // the 12 edge gradients (+-1,+-1,0), (+-1,0,+-1), (0,+-1,+-1) of improved
+    // noise from 4 hash bits (b3 b2 b1 b0 = bits 31..28):
+    //   u = b3 ? y : x,  v = b3|b2 ? (b3&b2&!b0 ? x : z) : y,  signs b0, b1
+    template<typename F, typename U> inline F noise_grad(const U & h, const F & x, const F & y, const F & z)
+    {
+        U m3 = noise_bit<31>(h), m2 = noise_bit<30>(h);
+        F u = noise_select(m3, y, x);
+        F v = noise_select(m3 | m2, noise_select(m3 & m2, noise_select(noise_bit<28>(h), z, x), z), y);
+        return noise_negate<28>(u, h) + noise_negate<29>(v, h);
+    }
+
+    // the 32 gradients with one coordinate 0 and the others +-1; b4 b3 select
+    // the zero coordinate, b2..b0 the signs of the others
+    template<typename F, typename U>
+    inline F noise_grad(const U & h, const F & x, const F & y, const F & z, const F & w)
+    {
+        U m4 = noise_bit<31>(h), m3 = noise_bit<30>(h);
+        F u = noise_select(m4 | m3, x, y);
+        F v = noise_select(m4, y, z);
+        F t = noise_select(m4 & m3, z, w);
+        return noise_negate<29>(u, h) + noise_negate<28>(v, h) + noise_negate<27>(t, h);
+    }
+
+    // 6t^5 - 15t^4 + 10t^3
+    template<typename F> inline F noise_fade(const F & t)
+    {
+        F p = noise_mul_add(t, noise_fsplat<F>(6.0f), noise_fsplat<F>(-15.0f));
+        p = noise_mul_add(p, t, noise_fsplat<F>(10.0f));
+        return t * t * t * p;
+    }
+
+    template<typename F> inline F noise_lerp(const F & a, const F & b, const F & t)
+    { return noise_mul_add(t, b - a, a); }
+
+    // the hashes of the cell index and of the index + 1, the offsets in the
+    // cell [0,1) and - 1
+    template<typename F, typename U>
+    inline void noise_axis(const F & x, uint32_t prime, U (&h)[2], F (&d)[2])
+    {
+        F c = x.floor();
+        d[0] = x - c;
+        d[1] = d[0] - 1.0f;
+        h[0] = noise_index(c, prime);
+        h[1] = h[0] + prime;
+    }
+
+    template<typename U> inline U noise_seed(uint32_t seed)
+    { return noise_splat<U>(seed * 0x27D4EB2Fu); }
+
+
+    //
+    // Perlin noise
+    //
+    template<typename F> inline F noise_perlin(const F & x, const F & y, uint32_t seed)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        U hx[2], hy[2], sd = noise_seed<U>(seed);
+        F dx[2], dy[2];
+        noise_axis(x, noise_px, hx, dx);
+        noise_axis(y, noise_py, hy, dy);
+        F n[4];
+        for(unsigned c = 0; c < 4; ++c)
+            n[c] = noise_grad(noise_mix(hx[c & 1] ^ hy[c >> 1], sd), dx[c & 1], dy[c >> 1]);
+        F u = noise_fade(dx[0]), v = noise_fade(dy[0]);
+        return noise_lerp(noise_lerp(n[0], n[1], u), noise_lerp(n[2], n[3], u), v);
+    }
+
+    template<typename F> inline F noise_perlin(const F & x, const F & y, const F & z, uint32_t seed)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        U hx[2], hy[2], hz[2], sd = noise_seed<U>(seed);
+        F dx[2], dy[2], dz[2];
+        noise_axis(x, noise_px, hx, dx);
+        noise_axis(y, noise_py, hy, dy);
+        noise_axis(z, noise_pz, hz, dz);
+        F n[8];
+        for(unsigned c = 0; c < 8; ++c) {
+            unsigned i = c & 1, j = (c >> 1) & 1, k = c >> 2;
+            n[c] = noise_grad(noise_mix(hx[i] ^ hy[j] ^ hz[k], sd), dx[i], dy[j], dz[k]);
+        }
+        F u = noise_fade(dx[0]), v = noise_fade(dy[0]), t = noise_fade(dz[0]);
+        for(unsigned c = 0; c < 4; ++c) n[c] = noise_lerp(n[2 * c], n[2 * c + 1], u);
+        for(unsigned c = 0; c < 2; ++c) n[c] = noise_lerp(n[2 * c], n[2 * c + 1], v);
+        return noise_lerp(n[0], n[1], t) * 0.98f;
+    }
+
+    template<typename F> inline F noise_perlin(const F & x, const F & y, const F & z, const F & w, uint32_t seed)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        U hx[2], hy[2], hz[2], hw[2], sd = noise_seed<U>(seed);
+        F dx[2], dy[2], dz[2], dw[2];
+        noise_axis(x, noise_px, hx, dx);
+        noise_axis(y, noise_py, hy, dy);
+        noise_axis(z, noise_pz, hz, dz);
+        noise_axis(w, noise_pw, hw, dw);
+        F n[16];
+        for(unsigned c = 0; c < 16; ++c) {
+            unsigned i = c & 1, j = (c >> 1) & 1, k = (c >> 2) & 1, l = c >> 3;
+            n[c] = noise_grad(noise_mix(hx[i] ^ hy[j] ^ hz[k] ^ hw[l], sd), dx[i], dy[j], dz[k], dw[l]);
+        }
+        F u = noise_fade(dx[0]), v = noise_fade(dy[0]), t = noise_fade(dz[0]), s = noise_fade(dw[0]);
+        for(unsigned c = 0; c < 8; ++c) n[c] = noise_lerp(n[2 * c], n[2 * c + 1], u);
+        for(unsigned c = 0; c < 4; ++c) n[c] = noise_lerp(n[2 * c], n[2 * c + 1], v);
+        for(unsigned c = 0; c < 2; ++c) n[c] = noise_lerp(n[2 * c], n[2 * c + 1], t);
+        return noise_lerp(n[0], n[1], s) * 0.81f;
+    }
+
+
+    //
+    // simplex noise
+    //
+
+    // corner contribution max(0, 1/2 - |d|^2)^4 * gradient . d
+    template<typename F> inline F noise_falloff(const F & d2)
+    {
+        F t = F::max_(0.5f - d2, F());
+        t = t * t;
+        return t * t;
+    }
+
+    template<typename F> inline F noise_simplex(const F & x, const F & y, uint32_t seed)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        const float f2 = 0.366025403784f, g2 = 0.211324865405f; // (sqrt(3) - 1) / 2, (3 - sqrt(3)) / 6
+        U sd = noise_seed<U>(seed);
+
+        // skewed cell, first corner
+        F s = (x + y) * f2;
+        F ci = x + s, cj = y + s;
+        ci.floor(); cj.floor();
+        F t = (ci + cj) * g2;
+        F x0 = x - (ci - t), y0 = y - (cj - t);
+        U hx = noise_index(ci, noise_px), hy = noise_index(cj, noise_py);
+
+        // middle corner: (1,0) in the lower triangle, (0,1) in the upper one
+        U lower = noise_gt(x0, y0);
+        F i1 = noise_one<F>(lower);
+        F x1 = x0 - i1 + g2, y1 = y0 - (1.0f - i1) + g2;
+        F x2 = x0 + (2.0f * g2 - 1.0f), y2 = y0 + (2.0f * g2 - 1.0f);
+        U h1 = noise_step(hx, lower, noise_px) ^ (hy + noise_py - (lower & noise_splat<U>(noise_py)));
+        U h2 = (hx + noise_px) ^ (hy + noise_py);
+
+        F n = noise_falloff(noise_mul_add(x0, x0, y0 * y0)) * noise_grad(noise_mix(hx ^ hy, sd), x0, y0);
+        n = noise_mul_add(noise_falloff(noise_mul_add(x1, x1, y1 * y1)), noise_grad(noise_mix(h1, sd), x1, y1), n);
+        n = noise_mul_add(noise_falloff(noise_mul_add(x2, x2, y2 * y2)), noise_grad(noise_mix(h2, sd), x2, y2), n);
+        return n * 70.0f;
+    }
+
+    template<typename F> inline F noise_simplex(const F & x, const F & y, const F & z, uint32_t seed)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        const float g3 = 1.0f / 6.0f;
+        U sd = noise_seed<U>(seed);
+
+        F s = (x + y + z) * (1.0f / 3.0f);
+        F ci = x + s, cj = y + s, ck = z + s;
+        ci.floor(); cj.floor(); ck.floor();
+        F t = (ci + cj + ck) * g3;
+        F x0 = x - (ci - t), y0 = y - (cj - t), z0 = z - (ck - t);
+        U hx = noise_index(ci, noise_px), hy = noise_index(cj, noise_py), hz = noise_index(ck, noise_pz);
+
+        // the simplex: steps along the largest, then the second largest axis
+        U xy = noise_gt(x0, y0), yz = noise_gt(y0, z0), xz = noise_gt(x0, z0);
+        U yx = ~xy, zy = ~yz, zx = ~xz;
+        U i1 = xy & xz, j1 = yx & yz, k1 = zx & zy;
+        U i2 = xy | xz, j2 = yx | yz, k2 = zx | zy;
+
+        F d[4][3];
+        d[0][0] = x0; d[0][1] = y0; d[0][2] = z0;
+        d[1][0] = x0 - noise_one<F>(i1) + g3;
+        d[1][1] = y0 - noise_one<F>(j1) + g3;
+        d[1][2] = z0 - noise_one<F>(k1) + g3;
+        d[2][0] = x0 - noise_one<F>(i2) + 2.0f * g3;
+        d[2][1] = y0 - noise_one<F>(j2) + 2.0f * g3;
+        d[2][2] = z0 - noise_one<F>(k2) + 2.0f * g3;
+        d[3][0] = x0 + (3.0f * g3 - 1.0f);
+        d[3][1] = y0 + (3.0f * g3 - 1.0f);
+        d[3][2] = z0 + (3.0f * g3 - 1.0f);
+        U h[4];
+        h[0] = hx ^ hy ^ hz;
+        h[1] = noise_step(hx, i1, noise_px) ^ noise_step(hy, j1, noise_py) ^ noise_step(hz, k1, noise_pz);
+        h[2] = noise_step(hx, i2, noise_px) ^ noise_step(hy, j2, noise_py) ^ noise_step(hz, k2, noise_pz);
+        h[3] = (hx + noise_px) ^ (hy + noise_py) ^ (hz + noise_pz);
+
+        F n;
+        for(unsigned c = 0; c < 4; ++c) {
+            F d2 = noise_mul_add(d[c][0], d[c][0], noise_mul_add(d[c][1], d[c][1], d[c][2] * d[c][2]));
+            n = noise_mul_add(noise_falloff(d2), noise_grad(noise_mix(h[c], sd), d[c][0], d[c][1], d[c][2]), n);
+        }
+        return n * 76.0f;
+    }
+
+    template<typename F> inline F noise_simplex(const F & x, const F & y, const F & z, const F & w, uint32_t seed)
+    {
+        typedef typename noise_types_t<F>::uvec_t U;
+        const float f4 = 0.309016994375f, g4 = 0.138196601125f; // (sqrt(5) - 1) / 4, (5 - sqrt(5)) / 20
+        const uint32_t prime[4] = { noise_px, noise_py, noise_pz, noise_pw };
+        U sd = noise_seed<U>(seed);
+
+        F s = (x + y + z + w) * f4;
+        F p[4] = { x, y, z, w }, c[4];
+        for(unsigned a = 0; a < 4; ++a) { c[a] = p[a] + s; c[a].floor(); }
+        F t = (c[0] + c[1] + c[2] + c[3]) * g4;
+        F d0[4];
+        U h0[4];
+        for(unsigned a = 0; a < 4; ++a) {
+            d0[a] = p[a] - (c[a] - t);
+            h0[a] = noise_index(c[a], prime[a]);
+        }
+
+        // rank of every axis (the number of axes with a smaller offset); the
+        // corner k steps along the axes of rank >= 4 - k
+        F rank[4];
+        for(unsigned a = 0; a < 4; ++a)
+            for(unsigned b = a + 1; b < 4; ++b) {
+                F gt = noise_one<F>(noise_gt(d0[a], d0[b]));
+                rank[a] = rank[a] + gt;
+                rank[b] = rank[b] + (1.0f - gt);
+            }
+
+        F n;
+        for(unsigned k = 0; k < 5; ++k) {
+            F d[4];
+            U h;
+            for(unsigned a = 0; a < 4; ++a) {
+                if(k == 0) {
+                    d[a] = d0[a]; h ^= h0[a];
+                } else if(k == 4) {
+                    d[a] = d0[a] + (4.0f * g4 - 1.0f);
+                    h ^= h0[a] + prime[a];
+                } else {
+                    U m = noise_gt(rank[a], noise_fsplat<F>(3.5f - float(k)));
+                    d[a] = d0[a] - noise_one<F>(m) + float(k) * g4;
+                    h ^= noise_step(h0[a], m, prime[a]);
+                }
+            }
+            F d2 = noise_mul_add(d[0], d[0], noise_mul_add(d[1], d[1], noise_mul_add(d[2], d[2], d[3] * d[3])));
+            n = noise_mul_add(noise_falloff(d2), noise_grad(noise_mix(h, sd), d[0], d[1], d[2], d[3]), n);
+        }
+        return n * 62.0f;
+    }
+
+
+    //
+    // fractal sums
+    //
+    template<typename F> inline F noise_eval(noise_t kind, const F & x, const F & y, uint32_t seed)
+    { return kind == noise_t::perlin ? noise_perlin(x, y, seed) : noise_simplex(x, y, seed); }
+    template<typename F> inline F noise_eval(noise_t kind, const F & x, const F & y, const F & z, uint32_t seed)
+    { return kind == noise_t::perlin ? noise_perlin(x, y, z, seed) : noise_simplex(x, y, z, seed); }
+    template<typename F>
+    inline F noise_eval(noise_t kind, const F & x, const F & y, const F & z, const F & w, uint32_t seed)
+    { return kind == noise_t::perlin ? noise_perlin(x, y, z, w, seed) : noise_simplex(x, y, z, w, seed); }
+
+    // sum over the octaves of gain^o * noise(lacunarity^o * p), divided by
+    // the sum of the amplitudes; D the number of coordinates in p
+    template<unsigned D, typename F>
+    inline F noise_fractal(noise_t kind, const F (&p)[D], unsigned octaves,
+                           float lacunarity, float gain, uint32_t seed, bool turbulence)
+    {
+        F sum;
+        float amp = 1.0f, freq = 1.0f, norm = 0.0f;
+        for(unsigned o = 0; o < octaves; ++o) {
+            F q[4];
+            for(unsigned a = 0; a < D; ++a) q[a] = p[a] * freq;
+            F n =
+                D == 2 ? noise_eval(kind, q[0], q[1], seed + o) :
+                D == 3 ? noise_eval(kind, q[0], q[1], q[2], seed + o) :
+                         noise_eval(kind, q[0], q[1], q[2], q[3], seed + o);
+            if(turbulence)
+                n.abs_();
+            sum = noise_mul_add(n, noise_fsplat<F>(amp), sum);
+            norm += amp;
+            amp *= gain;
+            freq *= lacunarity;
+        }
+        return octaves ? sum * (1.0f / norm) : sum;
+    }
+
+} // namespace ipriv
+
+
+#define NOISE_OPS_(V) \
+inline V perlin(const V & x, const V & y, uint32_t seed = 0) \
+{ return ipriv::noise_perlin(x, y, seed); } \
+inline V perlin(const V & x, const V & y, const V & z, uint32_t seed = 0) \
+{ return ipriv::noise_perlin(x, y, z, seed); } \
+inline V perlin(const V & x, const V & y, const V & z, const V & w, uint32_t seed = 0) \
+{ return ipriv::noise_perlin(x, y, z, w, seed); } \
+inline V simplex(const V & x, const V & y, uint32_t seed = 0) \
+{ return ipriv::noise_simplex(x, y, seed); } \
+inline V simplex(const V & x, const V & y, const V & z, uint32_t seed = 0) \
+{ return ipriv::noise_simplex(x, y, z, seed); } \
+inline V simplex(const V & x, const V & y, const V & z, const V & w, uint32_t seed = 0) \
+{ return ipriv::noise_simplex(x, y, z, w, seed); } \
+inline V fbm(noise_t kind, const V & x, const V & y, unsigned octaves, \
+             float lacunarity = 2.0f, float gain = 0.5f, uint32_t seed = 0) \
+{ const V p[2] = { x, y }; \
+  return ipriv::noise_fractal(kind, p, octaves, lacunarity, gain, seed, false); } \
+inline V fbm(noise_t kind, const V & x, const V & y, const V & z, unsigned octaves, \
+             float lacunarity = 2.0f, float gain = 0.5f, uint32_t seed = 0) \
+{ const V p[3] = { x, y, z }; \
+  return ipriv::noise_fractal(kind, p, octaves, lacunarity, gain, seed, false); } \
+inline V fbm(noise_t kind, const V & x, const V & y, const V & z, const V & w, unsigned octaves, \
+             float lacunarity = 2.0f, float gain = 0.5f, uint32_t seed = 0) \
+{ const V p[4] = { x, y, z, w }; \
+  return ipriv::noise_fractal(kind, p, octaves, lacunarity, gain, seed, false); } \
+inline V turbulence(noise_t kind, const V & x, const V & y, unsigned octaves, \
+                    float lacunarity = 2.0f, float gain = 0.5f, uint32_t seed = 0) \
+{ const V p[2] = { x, y }; \
+  return ipriv::noise_fractal(kind, p, octaves, lacunarity, gain, seed, true); } \
+inline V turbulence(noise_t kind, const V & x, const V & y, const V & z, unsigned octaves, \
+                    float lacunarity = 2.0f, float gain = 0.5f, uint32_t seed = 0) \
+{ const V p[3] = { x, y, z }; \
+  return ipriv::noise_fractal(kind, p, octaves, lacunarity, gain, seed, true); } \
+inline V turbulence(noise_t kind, const V & x, const V & y, const V & z, const V & w, unsigned octaves, \
+                    float lacunarity = 2.0f, float gain = 0.5f, uint32_t seed = 0) \
+{ const V p[4] = { x, y, z, w }; \
+  return ipriv::noise_fractal(kind, p, octaves, lacunarity, gain, seed, true); }
+
+NOISE_OPS_(vec4f_t)
+#if defined(PVECI_INTEL) && defined(AVX) && defined(AVX2)
+NOISE_OPS_(vec8f_t)
+#endif
+
+#undef NOISE_OPS_
+
+} // namespace math
+
+#endif // PNOISE_H
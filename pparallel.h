@@ -0,0 +1,340 @@
+/*******************************************************************************
+ * pparallel.h                                                                 *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PPARALLEL_H
+#define PPARALLEL_H
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+/*
+multi-threaded execution of array kernels
+-----------------------------------------
+the vector types work on a single register in the calling thread; the
+array-level kernels (the *_many() functions, transforms, reductions) are
+bandwidth bound for large inputs and only saturate the memory interface if
+they run on several cores, so they are split into chunks here and executed on
+a thread pool:
+
+  parallel_for(n, grain, f)                 f(begin, end) for every chunk
+  parallel_transform(dst, src, n, kernel)   kernel(dst+begin, src+begin, count)
+  parallel_reduce(n, grain, init, f, comb)  comb(...comb(init, f(chunk0))..., f(chunkN))
+
+chunking:
+  the chunks are grain elements large (the last one may be shorter), the
+  default grain is chunk_elems<T>() = 32 KiB worth of elements, so a chunk of
+  the source fits into L1 and the chunk boundaries are multiples of the
+  vector widths (the *_many() tails only occur in the last chunk)
+
+determinism:
+  the chunks do not depend on the number of threads and the partial results
+  of parallel_reduce() are combined in chunk order on the calling thread, so
+  the result is bitwise identical for any pool size (and for the inline
+  fallback), also for non-associative combines like float additions
+
+scheduling:
+  the chunk indices are distributed evenly across the workers as contiguous
+  ranges, each worker takes chunks from the front of its own range and steals
+  single chunks from the back of the others' ranges when its range is empty
+  (work stealing); the calling thread takes part as worker 0
+
+inline fallback:
+  inputs with a single chunk, pools without worker threads and calls from
+  inside a pool task (nested parallelism) run inline in the calling thread
+
+affinity:
+  affinity_t::compact pins worker i to CPU i (Linux only, ignored elsewhere),
+  the calling thread is not pinned
+
+exceptions thrown by a task are rethrown in the calling thread (the first one
+wins, the remaining chunks are skipped)
+*/
+
+// TODO:
+// - affinity on Windows (SetThreadAffinityMask, without dragging windows.h
+//   into every user of the library)
+// - NUMA aware placement of the chunks
+
+
+namespace math {
+
+enum class affinity_t
+{
+    none,
+    compact // worker i on CPU i
+};
+
+// number of elements of type T used as default chunk size
+template<typename T> inline size_t chunk_elems()
+{ return (size_t(32) * 1024) / sizeof(T); }
+
+namespace ipriv {
+
+    inline bool & in_pool_task()
+    { static thread_local bool flag = false; return flag; }
+
+    inline void pin_thread(std::thread & t, unsigned cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu % CPU_SETSIZE, &set);
+        pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+        (void)t; (void)cpu;
+#endif
+    }
+
+} // namespace ipriv
+
+
+class thread_pool_t
+{
+public:
+    // threads: total number of threads including the calling one,
+    // 0 uses std::thread::hardware_concurrency()
+    explicit thread_pool_t(unsigned threads = 0, affinity_t affinity = affinity_t::none)
+        : job_(nullptr), gen_(0), stop_(false)
+    {
+        if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned i = 0; i < threads; ++i)
+            slots_.push_back(std::unique_ptr<slot_t>(new slot_t));
+        for(unsigned i = 1; i < threads; ++i) {
+            workers_.push_back(std::thread(&thread_pool_t::worker_main, this, i));
+            if(affinity == affinity_t::compact)
+                ipriv::pin_thread(workers_.back(), i);
+        }
+    }
+    ~thread_pool_t()
+    {
+        { std::lock_guard<std::mutex> lk(m_); stop_ = true; }
+        wake_cv_.notify_all();
+        for(size_t i = 0; i < workers_.size(); ++i)
+            workers_[i].join();
+    }
+    thread_pool_t(const thread_pool_t &) = delete;
+    thread_pool_t & operator=(const thread_pool_t &) = delete;
+
+    // total number of threads (workers + calling thread)
+    unsigned size() const { return unsigned(slots_.size()); }
+
+    // shared pool with one thread per hardware thread
+    static thread_pool_t & global()
+    { static thread_pool_t pool; return pool; }
+
+    // calls f(i) for i in [0, n_tasks) and returns when all calls are done
+    template<typename F> void run(size_t n_tasks, F f)
+    {
+        if(n_tasks == 0) return;
+        if(n_tasks == 1 || workers_.empty() || ipriv::in_pool_task()) {
+            for(size_t i = 0; i < n_tasks; ++i) f(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> serialize(run_m_);
+        job_t job(&invoke<F>, &f, n_tasks);
+        size_t n = slots_.size(), begin = 0;
+        for(size_t i = 0; i < n; ++i) {
+            size_t end = begin + n_tasks / n + (i < n_tasks % n ? 1 : 0);
+            slots_[i]->begin = begin;
+            slots_[i]->end = end;
+            begin = end;
+        }
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            job_ = &job;
+            ++gen_;
+        }
+        wake_cv_.notify_all();
+
+        ipriv::in_pool_task() = true;
+        work(0, job);
+        ipriv::in_pool_task() = false;
+
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            done_cv_.wait(lk, [&job] { return job.remaining.load() == 0 && job.active == 0; });
+            job_ = nullptr;
+        }
+        if(job.error) std::rethrow_exception(job.error);
+    }
+
+private:
+    struct slot_t
+    {
+        slot_t() : begin(0), end(0) {}
+        std::mutex m;
+        size_t begin, end;
+    };
+
+    struct job_t
+    {
+        job_t(void (*fn_)(void *, size_t), void * ctx_, size_t n)
+            : fn(fn_), ctx(ctx_), remaining(n), active(0), failed(false) {}
+        void (*fn)(void *, size_t);
+        void * ctx;
+        std::atomic<size_t> remaining;
+        unsigned active;             // workers inside work(), guarded by m_
+        std::atomic<bool> failed;
+        std::mutex error_m;
+        std::exception_ptr error;
+    };
+
+    template<typename F> static void invoke(void * ctx, size_t i)
+    { (*static_cast<F *>(ctx))(i); }
+
+    bool pop(size_t id, size_t & task)
+    {
+        slot_t & s = *slots_[id];
+        std::lock_guard<std::mutex> lk(s.m);
+        if(s.begin == s.end) return false;
+        task = s.begin++;
+        return true;
+    }
+    bool steal(size_t id, size_t & task)
+    {
+        size_t n = slots_.size();
+        for(size_t k = 1; k < n; ++k) {
+            slot_t & s = *slots_[(id + k) % n];
+            std::lock_guard<std::mutex> lk(s.m);
+            if(s.begin != s.end) { task = --s.end; return true; }
+        }
+        return false;
+    }
+
+    void work(size_t id, job_t & job)
+    {
+        size_t task;
+        while(pop(id, task) || steal(id, task)) {
+            if(!job.failed.load(std::memory_order_relaxed)) {
+                try {
+                    job.fn(job.ctx, task);
+                } catch(...) {
+                    std::lock_guard<std::mutex> lk(job.error_m);
+                    if(!job.error) job.error = std::current_exception();
+                    job.failed = true;
+                }
+            }
+            job.remaining.fetch_sub(1);
+        }
+    }
+
+    void worker_main(size_t id)
+    {
+        ipriv::in_pool_task() = true;
+        unsigned long long seen = 0;
+        for(;;) {
+            job_t * job;
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                wake_cv_.wait(lk, [&] { return stop_ || (job_ && gen_ != seen); });
+                if(stop_) return;
+                seen = gen_;
+                job = job_;
+                ++job->active;
+            }
+            work(id, *job);
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                --job->active;
+            }
+            done_cv_.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<slot_t> > slots_;
+    std::vector<std::thread> workers_;
+    std::mutex run_m_;               // one job at a time
+    std::mutex m_;                   // guards job_, gen_, stop_, job_t::active
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    job_t * job_;
+    unsigned long long gen_;
+    bool stop_;
+};
+
+
+//
+// f(begin, end) for the chunks [k*grain, min(n, (k+1)*grain))
+//
+template<typename F>
+inline void parallel_for(thread_pool_t & pool, size_t n, size_t grain, F f)
+{
+    if(n == 0) return;
+    if(grain == 0) grain = 1;
+    size_t chunks = (n + grain - 1) / grain;
+    pool.run(chunks, [&](size_t c) {
+        size_t begin = c * grain;
+        f(begin, std::min(n, begin + grain));
+    });
+}
+template<typename F>
+inline void parallel_for(size_t n, size_t grain, F f)
+{ parallel_for(thread_pool_t::global(), n, grain, f); }
+
+//
+// kernel(dst + begin, src + begin, count) per chunk, for the *_many()
+// array kernels, e.g.
+//   parallel_transform(dst, src, n, [](float * d, const int32_t * s, size_t k) {
+//       cvt_f32_many(d, s, k); });
+//
+template<typename TD, typename TS, typename K>
+inline void parallel_transform(thread_pool_t & pool, TD * dst, const TS * src, size_t n,
+                               K kernel, size_t grain = chunk_elems<TS>())
+{
+    parallel_for(pool, n, grain, [&](size_t begin, size_t end) {
+        kernel(dst + begin, src + begin, end - begin);
+    });
+}
+template<typename TD, typename TS, typename K>
+inline void parallel_transform(TD * dst, const TS * src, size_t n,
+                               K kernel, size_t grain = chunk_elems<TS>())
+{ parallel_transform(thread_pool_t::global(), dst, src, n, kernel, grain); }
+
+//
+// deterministic reduction: partial = f(begin, end) per chunk, the partials
+// are combined in chunk order, independent of the number of threads
+//
+template<typename T, typename F, typename C>
+inline T parallel_reduce(thread_pool_t & pool, size_t n, size_t grain, T init, F f, C combine)
+{
+    if(n == 0) return init;
+    if(grain == 0) grain = 1;
+    size_t chunks = (n + grain - 1) / grain;
+    if(chunks == 1) return combine(init, f(size_t(0), n));
+
+    std::vector<T> partial(chunks);
+    pool.run(chunks, [&](size_t c) {
+        size_t begin = c * grain;
+        partial[c] = f(begin, std::min(n, begin + grain));
+    });
+    T acc = init;
+    for(size_t c = 0; c < chunks; ++c)
+        acc = combine(acc, partial[c]);
+    return acc;
+}
+template<typename T, typename F, typename C>
+inline T parallel_reduce(size_t n, size_t grain, T init, F f, C combine)
+{ return parallel_reduce(thread_pool_t::global(), n, grain, init, f, combine); }
+
+} // namespace math
+
+#endif // PPARALLEL_H
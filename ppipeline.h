@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * ppipeline.h                                                                 *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PPIPELINE_H
+#define PPIPELINE_H
+
+#include <pvecf.h>
+#include <pveci.h>
+#include <palloc.h>
+#include <pcompress.h>
+#include <stddef.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/*
+fused tiled pipelines
+---------------------
+chaining array kernels (transform -> cull -> compact -> convert) makes one
+pass over memory per kernel; a pipeline runs all stages on one tile of the
+input before moving on to the next tile, so the intermediates stay in L1/L2
+and only the input and the final output go through memory:
+
+  auto p = make_pipeline(
+      map_stage<vec4f_t>([](vec4f_t v) { return v * scale; }),
+      filter_stage<vec4f_t>([](vec4f_t v) { return cmp_gt(v, zero); }),
+      convert_stage<float, int32_t>([](int32_t * d, const float * s, size_t n) {
+          cvt_i32_many<round_t::nearest_even>(d, s, n); }));
+  size_t m = p.run(src, n, dst);   // m <= n elements written to dst
+
+stages (in_t/out_t are the element types):
+  map_stage<V>(f)           V f(V), element-wise on whole vectors
+  filter_stage<V>(pred)     V pred(V) returns a lane mask (all bits set keeps
+                            the element), the kept elements are compacted
+                            per compress_store() (pcompress.h)
+  convert_stage<TS,TD>(k)   k(TD * dst, const TS * src, size_t n), e.g. the
+                            *_many() conversions of pcvt.h
+  custom_stage<TI,TO>(f)    size_t f(const TI * in, size_t n, TO * out),
+                            returns the number of elements written (<= n)
+
+tiles:
+  the default tile holds 8 KiB of the widest element type of the pipeline
+  (two tile buffers are used alternately, so both fit into L1), the tile
+  size is always a multiple of 64 elements; the stages read whole vectors,
+  the buffers are padded accordingly and a short last tile of the input is
+  copied into a zero padded buffer first, so the input needs no padding
+
+the stages may keep state (e.g. counters), they are called in tile order
+*/
+
+
+namespace math {
+
+namespace ipriv {
+
+    template<typename... S> struct max_elem_size;
+    template<> struct max_elem_size<> { static const size_t value = 0; };
+    template<typename S0, typename... S> struct max_elem_size<S0, S...>
+    {
+        static const size_t a = sizeof(typename S0::in_t) > sizeof(typename S0::out_t) ?
+                                sizeof(typename S0::in_t) : sizeof(typename S0::out_t);
+        static const size_t b = max_elem_size<S...>::value;
+        static const size_t value = a > b ? a : b;
+    };
+
+} // namespace ipriv
+
+
+template<typename V, typename F>
+struct map_stage_t
+{
+    typedef typename ipriv::vec_elem<V>::type in_t;
+    typedef in_t out_t;
+    F f;
+
+    size_t operator()(const in_t * in, size_t n, out_t * out)
+    {
+        for(size_t i = 0; i < n; i += V::N) {
+            V v;
+            v.loadu(in + i);
+            V r(f(v));
+            r.storeu(out + i);
+        }
+        return n;
+    }
+};
+
+template<typename V, typename P>
+struct filter_stage_t
+{
+    typedef typename ipriv::vec_elem<V>::type in_t;
+    typedef in_t out_t;
+    P pred;
+
+    size_t operator()(const in_t * in, size_t n, out_t * out)
+    {
+        size_t k = 0;
+        for(size_t i = 0; i < n; i += V::N) {
+            V v;
+            v.loadu(in + i);
+            unsigned bits = mask_bits(V(pred(v)));
+            if(n - i < V::N) bits &= (1u << (n - i)) - 1;
+            k += compress_store(bits, v, out + k);
+        }
+        return k;
+    }
+};
+
+template<typename TS, typename TD, typename K>
+struct convert_stage_t
+{
+    typedef TS in_t;
+    typedef TD out_t;
+    K kernel;
+
+    size_t operator()(const in_t * in, size_t n, out_t * out)
+    { kernel(out, in, n); return n; }
+};
+
+template<typename TI, typename TO, typename F>
+struct custom_stage_t
+{
+    typedef TI in_t;
+    typedef TO out_t;
+    F f;
+
+    size_t operator()(const in_t * in, size_t n, out_t * out)
+    { return f(in, n, out); }
+};
+
+template<typename V, typename F> inline map_stage_t<V,F> map_stage(F f)
+{ map_stage_t<V,F> s = { f }; return s; }
+template<typename V, typename P> inline filter_stage_t<V,P> filter_stage(P pred)
+{ filter_stage_t<V,P> s = { pred }; return s; }
+template<typename TS, typename TD, typename K> inline convert_stage_t<TS,TD,K> convert_stage(K kernel)
+{ convert_stage_t<TS,TD,K> s = { kernel }; return s; }
+template<typename TI, typename TO, typename F> inline custom_stage_t<TI,TO,F> custom_stage(F f)
+{ custom_stage_t<TI,TO,F> s = { f }; return s; }
+
+
+template<typename... S>
+class pipeline_t
+{
+    static_assert(sizeof...(S) > 0, "pipeline_t: no stages");
+    typedef std::tuple<S...> stages_t;
+    static const size_t n_stages = sizeof...(S);
+
+public:
+    typedef typename std::tuple_element<0, stages_t>::type::in_t in_t;
+    typedef typename std::tuple_element<n_stages - 1, stages_t>::type::out_t out_t;
+    static const size_t max_elem_size = ipriv::max_elem_size<S...>::value;
+
+    explicit pipeline_t(S... stages) : stages_(stages...), tile_(0) {}
+
+    // elements per tile, 0: default (8 KiB of the widest element type)
+    size_t tile() const
+    { return tile_ ? tile_ : ipriv::round_up(8192 / max_elem_size, 64); }
+    void set_tile(size_t elems) { tile_ = elems ? ipriv::round_up(elems, 64) : 0; }
+
+    // sink(const out_t * p, size_t n) per tile
+    template<typename Sink> void run(const in_t * src, size_t n, Sink sink)
+    {
+        const size_t t = tile();
+        reserve(t);
+        char * bufs[2] = { &buf_[0], &buf_[buf_.size() / 2] };
+        for(size_t i = 0; i < n; i += t) {
+            size_t m = n - i < t ? n - i : t;
+            const in_t * in = src + i;
+            if(m < t && m % 64 != 0) {
+                // short last tile: zero padded copy, stage 0 writes bufs[0]
+                in_t * pad = reinterpret_cast<in_t *>(bufs[1]);
+                memcpy(pad, in, m * sizeof(in_t));
+                memset(pad + m, 0, (ipriv::round_up(m, 64) - m) * sizeof(in_t));
+                in = pad;
+            }
+            const out_t * out;
+            size_t k = step<0>(in, m, out, bufs);
+            if(k) sink(out, k);
+        }
+    }
+
+    // appends the results to dst, returns the number of elements written
+    size_t run(const in_t * src, size_t n, out_t * dst)
+    {
+        size_t written = 0;
+        run(src, n, [&](const out_t * p, size_t k) {
+            memcpy(dst + written, p, k * sizeof(out_t));
+            written += k;
+        });
+        return written;
+    }
+
+    template<size_t I> typename std::tuple_element<I, stages_t>::type & stage()
+    { return std::get<I>(stages_); }
+
+private:
+    void reserve(size_t t)
+    {
+        // round_up(n, 64) elements readable in every buffer
+        size_t bytes = ipriv::round_up(t * max_elem_size, cache_line_size);
+        if(buf_.size() < 2 * bytes) buf_.assign(2 * bytes, 0);
+    }
+
+    template<size_t I, typename In>
+    typename std::enable_if<I == n_stages, size_t>::type
+    step(const In * in, size_t n, const out_t * & result, char **)
+    { result = in; return n; }
+
+    template<size_t I, typename In>
+    typename std::enable_if<(I < n_stages), size_t>::type
+    step(const In * in, size_t n, const out_t * & result, char ** bufs)
+    {
+        typedef typename std::tuple_element<I, stages_t>::type stage_t;
+        typedef typename stage_t::out_t o_t;
+        static_assert(std::is_same<In, typename stage_t::in_t>::value,
+                      "pipeline_t: element type mismatch between stages");
+        o_t * out = reinterpret_cast<o_t *>(bufs[I % 2]);
+        size_t m = std::get<I>(stages_)(in, n, out);
+        return step<I + 1>(static_cast<const o_t *>(out), m, result, bufs);
+    }
+
+    stages_t stages_;
+    size_t tile_;
+    aligned_vector_t<char> buf_;
+};
+
+template<typename... S> inline pipeline_t<S...> make_pipeline(S... stages)
+{ return pipeline_t<S...>(stages...); }
+
+} // namespace math
+
+#endif // PPIPELINE_H
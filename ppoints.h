@@ -0,0 +1,325 @@
+/*******************************************************************************
+ * ppoints.h                                                                   *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PPOINTS_H
+#define PPOINTS_H
+
+#include <pvecf.h>
+#include <stddef.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+/*
+point cloud statistics
+----------------------
+point_stats() computes the bounding box, the centroid and the covariance matrix
+of n points in one pass, the points are given as
+
+  point_stats(pts, n)            vec4f_t {x,y,z,w} (w ignored)
+  point_stats(xyz, n)            packed floats x0,y0,z0,x1,y1,z1,..
+  point_stats(x, y, z, n)        SoA arrays
+
+all three layouts are processed as SoA blocks of four points (the AoS ones
+transposed by the swizzles), every lane of the min/max and sum accumulators
+collects its own partial results; the moments are taken relative to the first
+point and summed in float over blocks of 4096 points, then in double, so
+clouds far from the origin and with tens of millions of points keep their
+precision
+
+sym3_eigen(a, values, axes) eigen decomposition of a symmetric 3x3 matrix
+(Jacobi rotations in double), the eigenvalues in descending order, the axes
+orthonormal and right handed (axes[2] = axes[0] x axes[1])
+
+point_obb() oriented bounding box along the principal axes of the covariance
+(a second pass over the points for the extents along the axes), same layouts
+as point_stats()
+
+the covariance is the population covariance (divided by n); for n = 0 the
+bounds are empty (min = +inf, max = -inf) and centroid and covariance zero
+*/
+
+// TODO:
+// - parallel versions (merge the partial results of pparallel.h tasks)
+// - minimum volume boxes (rotating calipers on the hull)
+
+
+namespace math {
+
+struct point_stats_t
+{
+    size_t count;
+    vec4f_t bmin, bmax; // w = 0
+    vec4f_t centroid;   // w = 0
+    float cov[3][3];
+};
+
+struct obb_t
+{
+    vec4f_t center;  // w = 0
+    vec4f_t axis[3]; // orthonormal, right handed, w = 0
+    vec4f_t half;    // half extents along the axes, w = 0
+};
+
+
+// eigenvalues (descending) and orthonormal, right handed eigenvectors of the
+// symmetric matrix a
+inline void sym3_eigen(const float a[3][3], float values[3], vec4f_t axes[3])
+{
+    double m[3][3], v[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+    for(unsigned r = 0; r < 3; ++r)
+        for(unsigned c = 0; c < 3; ++c) m[r][c] = 0.5 * (double(a[r][c]) + double(a[c][r]));
+
+    // cyclic Jacobi, converges quadratically, a few sweeps for 3x3
+    for(unsigned sweep = 0; sweep < 32; ++sweep) {
+        double off = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+        double diag = m[0][0] * m[0][0] + m[1][1] * m[1][1] + m[2][2] * m[2][2];
+        if(off <= 1e-30 * diag || off == 0.0) break;
+        for(unsigned p = 0; p < 2; ++p)
+            for(unsigned q = p + 1; q < 3; ++q) {
+                if(m[p][q] == 0.0) continue;
+                double theta = (m[q][q] - m[p][p]) / (2.0 * m[p][q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                for(unsigned k = 0; k < 3; ++k) {
+                    double mkp = m[k][p], mkq = m[k][q];
+                    m[k][p] = c * mkp - s * mkq;
+                    m[k][q] = s * mkp + c * mkq;
+                }
+                for(unsigned k = 0; k < 3; ++k) {
+                    double mpk = m[p][k], mqk = m[q][k];
+                    m[p][k] = c * mpk - s * mqk;
+                    m[q][k] = s * mpk + c * mqk;
+                }
+                for(unsigned k = 0; k < 3; ++k) {
+                    double vkp = v[k][p], vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+    }
+
+    unsigned order[3] = { 0, 1, 2 };
+    for(unsigned i = 0; i < 3; ++i)
+        for(unsigned j = i + 1; j < 3; ++j)
+            if(m[order[j]][order[j]] > m[order[i]][order[i]]) std::swap(order[i], order[j]);
+    for(unsigned k = 0; k < 3; ++k) {
+        unsigned c = order[k];
+        values[k] = float(m[c][c]);
+        axes[k] = vec4f_t(float(v[0][c]), float(v[1][c]), float(v[2][c]), 0.0f);
+    }
+    axes[2] = vec4f_t(axes[0].cross_packed(axes[1]));
+}
+
+
+namespace ipriv {
+
+    static const size_t points_block = 4096;
+
+    // SoA blocks of four points, the lanes past the end are set to pad
+    struct points_aos_t
+    {
+        const vec4f_t * pts;
+        void block(size_t i, vec4f_t & x, vec4f_t & y, vec4f_t & z) const
+        {
+#if defined(PVECF_INTEL)
+            // transposed as in mat4f_t::transpose()
+            __m128 t0 = xyxy(pts[i].p, pts[i + 1].p); // {x0,y0,x1,y1}
+            __m128 t1 = xyxy(pts[i + 2].p, pts[i + 3].p); // {x2,y2,x3,y3}
+            __m128 t2 = zwzw(pts[i].p, pts[i + 1].p); // {z0,w0,z1,w1}
+            __m128 t3 = zwzw(pts[i + 2].p, pts[i + 3].p); // {z2,w2,z3,w3}
+            x.p = xzxz(t0, t1); y.p = ywyw(t0, t1); z.p = xzxz(t2, t3);
+#else
+            for(unsigned l = 0; l < 4; ++l) {
+                x[l] = pts[i + l][0]; y[l] = pts[i + l][1]; z[l] = pts[i + l][2];
+            }
+#endif
+        }
+        void point(size_t i, float * p) const { p[0] = pts[i][0]; p[1] = pts[i][1]; p[2] = pts[i][2]; }
+    };
+
+    struct points_xyz_t
+    {
+        const float * xyz;
+        void block(size_t i, vec4f_t & x, vec4f_t & y, vec4f_t & z) const
+        {
+            vec4f_t a, b, c;
+            a.loadu(xyz + 3 * i);     // {x0,y0,z0,x1}
+            b.loadu(xyz + 3 * i + 4); // {y1,z1,x2,y2}
+            c.loadu(xyz + 3 * i + 8); // {z2,x3,y3,z3}
+#if defined(PVECF_INTEL)
+            x.p = xwxz(a.p, zzyy(b.p, c.p)); // {x0,x1} {x2,x2,x3,x3}
+            y.p = xzxz(yyxx(a.p, b.p), wwzz(b.p, c.p)); // {y0,y0,y1,y1} {y2,y2,y3,y3}
+            z.p = xzxz(zzyy(a.p, b.p), xxww(c.p, c.p)); // {z0,z0,z1,z1} {z2,z2,z3,z3}
+#else
+            x = vec4f_t(a[0], a[3], b[2], c[1]);
+            y = vec4f_t(a[1], b[0], b[3], c[2]);
+            z = vec4f_t(a[2], b[1], c[0], c[3]);
+#endif
+        }
+        void point(size_t i, float * p) const { p[0] = xyz[3 * i]; p[1] = xyz[3 * i + 1]; p[2] = xyz[3 * i + 2]; }
+    };
+
+    struct points_soa_t
+    {
+        const float * x;
+        const float * y;
+        const float * z;
+        void block(size_t i, vec4f_t & vx, vec4f_t & vy, vec4f_t & vz) const
+        { vx.loadu(x + i); vy.loadu(y + i); vz.loadu(z + i); }
+        void point(size_t i, float * p) const { p[0] = x[i]; p[1] = y[i]; p[2] = z[i]; }
+    };
+
+    // f(x, y, z) for the blocks of four points, the tail padded with pad
+    template<typename L, typename F>
+    inline void points_for_each(const L & src, size_t n, const float * pad, F f)
+    {
+        vec4f_t x, y, z;
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            src.block(i, x, y, z);
+            f(x, y, z);
+        }
+        if(i < n) {
+            float t[4][3];
+            for(unsigned l = 0; l < 4; ++l) {
+                if(i + l < n) src.point(i + l, t[l]);
+                else { t[l][0] = pad[0]; t[l][1] = pad[1]; t[l][2] = pad[2]; }
+            }
+            x = vec4f_t(t[0][0], t[1][0], t[2][0], t[3][0]);
+            y = vec4f_t(t[0][1], t[1][1], t[2][1], t[3][1]);
+            z = vec4f_t(t[0][2], t[1][2], t[2][2], t[3][2]);
+            f(x, y, z);
+        }
+    }
+
+    inline double points_hsum(const vec4f_t & v) { return double(v[0]) + double(v[1]) + double(v[2]) + double(v[3]); }
+    inline float points_hmin(const vec4f_t & v) { return std::min(std::min(v[0], v[1]), std::min(v[2], v[3])); }
+    inline float points_hmax(const vec4f_t & v) { return std::max(std::max(v[0], v[1]), std::max(v[2], v[3])); }
+
+    template<typename L>
+    inline point_stats_t points_stats(const L & src, size_t n)
+    {
+        point_stats_t s;
+        const float inf = std::numeric_limits<float>::infinity();
+        s.count = n;
+        s.bmin = vec4f_t(inf, inf, inf, 0.0f);
+        s.bmax = vec4f_t(-inf, -inf, -inf, 0.0f);
+        s.centroid = vec4f_t(0.0f, 0.0f, 0.0f, 0.0f);
+        for(unsigned r = 0; r < 3; ++r)
+            for(unsigned c = 0; c < 3; ++c) s.cov[r][c] = 0.0f;
+        if(n == 0) return s;
+
+        // the tail is padded with the reference point: no effect on the
+        // bounds, zero in the moments
+        float ref[3];
+        src.point(0, ref);
+        const vec4f_t rx(ref[0], ref[0], ref[0], ref[0]), ry(ref[1], ref[1], ref[1], ref[1]), rz(ref[2], ref[2], ref[2], ref[2]);
+        const vec4f_t zero(0.0f, 0.0f, 0.0f, 0.0f);
+        vec4f_t lx(rx), ly(ry), lz(rz), hx(rx), hy(ry), hz(rz);
+        vec4f_t sx(zero), sy(zero), sz(zero), sxx(zero), syy(zero), szz(zero), sxy(zero), sxz(zero), syz(zero);
+        double m[9] = { 0.0 }; // x y z xx yy zz xy xz yz
+        size_t k = 0;
+        auto flush = [&]() {
+            m[0] += points_hsum(sx); m[1] += points_hsum(sy); m[2] += points_hsum(sz);
+            m[3] += points_hsum(sxx); m[4] += points_hsum(syy); m[5] += points_hsum(szz);
+            m[6] += points_hsum(sxy); m[7] += points_hsum(sxz); m[8] += points_hsum(syz);
+            sx = sy = sz = sxx = syy = szz = sxy = sxz = syz = zero;
+        };
+        points_for_each(src, n, ref, [&](const vec4f_t & x, const vec4f_t & y, const vec4f_t & z) {
+            lx = vec4f_t::min_(lx, x); ly = vec4f_t::min_(ly, y); lz = vec4f_t::min_(lz, z);
+            hx = vec4f_t::max_(hx, x); hy = vec4f_t::max_(hy, y); hz = vec4f_t::max_(hz, z);
+            const vec4f_t dx(x - rx), dy(y - ry), dz(z - rz);
+            sx += dx; sy += dy; sz += dz;
+            sxx += dx * dx; syy += dy * dy; szz += dz * dz;
+            sxy += dx * dy; sxz += dx * dz; syz += dy * dz;
+            if((k += 4) == points_block) { flush(); k = 0; }
+        });
+        flush();
+
+        s.bmin = vec4f_t(points_hmin(lx), points_hmin(ly), points_hmin(lz), 0.0f);
+        s.bmax = vec4f_t(points_hmax(hx), points_hmax(hy), points_hmax(hz), 0.0f);
+        const double inv = 1.0 / double(n);
+        const double mx = m[0] * inv, my = m[1] * inv, mz = m[2] * inv;
+        s.centroid = vec4f_t(float(ref[0] + mx), float(ref[1] + my), float(ref[2] + mz), 0.0f);
+        s.cov[0][0] = float(m[3] * inv - mx * mx);
+        s.cov[1][1] = float(m[4] * inv - my * my);
+        s.cov[2][2] = float(m[5] * inv - mz * mz);
+        s.cov[0][1] = s.cov[1][0] = float(m[6] * inv - mx * my);
+        s.cov[0][2] = s.cov[2][0] = float(m[7] * inv - mx * mz);
+        s.cov[1][2] = s.cov[2][1] = float(m[8] * inv - my * mz);
+        return s;
+    }
+
+    template<typename L>
+    inline obb_t points_obb(const L & src, size_t n)
+    {
+        const point_stats_t s(points_stats(src, n));
+        obb_t box;
+        float values[3];
+        sym3_eigen(s.cov, values, box.axis);
+        if(n == 0) {
+            box.center = box.half = vec4f_t(0.0f, 0.0f, 0.0f, 0.0f);
+            return box;
+        }
+
+        // extents along the axes, relative to the centroid
+        float pad[3] = { s.centroid[0], s.centroid[1], s.centroid[2] };
+        const vec4f_t cx(pad[0], pad[0], pad[0], pad[0]), cy(pad[1], pad[1], pad[1], pad[1]), cz(pad[2], pad[2], pad[2], pad[2]);
+        vec4f_t a[3][3], lo[3], hi[3];
+        for(unsigned k = 0; k < 3; ++k) {
+            for(unsigned j = 0; j < 3; ++j) {
+                float c = box.axis[k][j];
+                a[k][j] = vec4f_t(c, c, c, c);
+            }
+            lo[k] = hi[k] = vec4f_t(0.0f, 0.0f, 0.0f, 0.0f);
+        }
+        points_for_each(src, n, pad, [&](const vec4f_t & x, const vec4f_t & y, const vec4f_t & z) {
+            const vec4f_t dx(x - cx), dy(y - cy), dz(z - cz);
+            for(unsigned k = 0; k < 3; ++k) {
+                vec4f_t d(a[k][0] * dx + a[k][1] * dy + a[k][2] * dz);
+                lo[k] = vec4f_t::min_(lo[k], d);
+                hi[k] = vec4f_t::max_(hi[k], d);
+            }
+        });
+
+        float mid[3], half[3];
+        for(unsigned k = 0; k < 3; ++k) {
+            float l = points_hmin(lo[k]), h = points_hmax(hi[k]);
+            mid[k] = 0.5f * (l + h);
+            half[k] = 0.5f * (h - l);
+        }
+        box.center = s.centroid;
+        for(unsigned j = 0; j < 3; ++j)
+            box.center[j] += box.axis[0][j] * mid[0] + box.axis[1][j] * mid[1] + box.axis[2][j] * mid[2];
+        box.half = vec4f_t(half[0], half[1], half[2], 0.0f);
+        return box;
+    }
+
+} // namespace ipriv
+
+
+inline point_stats_t point_stats(const vec4f_t * pts, size_t n)
+{ ipriv::points_aos_t src = { pts }; return ipriv::points_stats(src, n); }
+inline point_stats_t point_stats(const float * xyz, size_t n)
+{ ipriv::points_xyz_t src = { xyz }; return ipriv::points_stats(src, n); }
+inline point_stats_t point_stats(const float * x, const float * y, const float * z, size_t n)
+{ ipriv::points_soa_t src = { x, y, z }; return ipriv::points_stats(src, n); }
+
+inline obb_t point_obb(const vec4f_t * pts, size_t n)
+{ ipriv::points_aos_t src = { pts }; return ipriv::points_obb(src, n); }
+inline obb_t point_obb(const float * xyz, size_t n)
+{ ipriv::points_xyz_t src = { xyz }; return ipriv::points_obb(src, n); }
+inline obb_t point_obb(const float * x, const float * y, const float * z, size_t n)
+{ ipriv::points_soa_t src = { x, y, z }; return ipriv::points_obb(src, n); }
+
+} // namespace math
+
+#endif // PPOINTS_H
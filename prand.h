@@ -0,0 +1,588 @@
+/*******************************************************************************
+ * prand.h                                                                     *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PRAND_H
+#define PRAND_H
+
+#include <pvecf.h>
+#include <pveci.h>
+#include <pcvt.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/*
+random number generators
+------------------------
+std::mt19937 produces one 32 bit value per call from 2.5 KiB of state; the
+generators here keep the state in vector registers and produce one value per
+lane and call (4 with veci_ui32x4_t, 8 with veci_ui32x8_t on AVX2), each lane
+being an independent stream:
+
+  xoshiro128p_t<U>   xoshiro128+ (Blackman/Vigna), 128 bit state per lane,
+                     the fastest; the lowest bits are weak (linear), the
+                     distributions below use the upper bits only
+  pcg32_t<U>         PCG-XSH-RR 64/32 (O'Neill), 64 bit LCG state per lane
+                     (emulated with 32 bit multiplications), every lane an own
+                     PCG stream (increment); lane k of pcg32_t(seed, s) is
+                     identical to the reference pcg32_srandom(seed, s*N + k)
+  philox4x32_t<U>    Philox4x32-10 (Salmon et al.), counter based: the values
+                     are a function of (key, counter) only, seek() is random
+                     access; one evaluation yields 4 vectors (the 4 words of
+                     the blocks counter..counter+N-1, lane k holds block
+                     counter+k)
+
+  U is veci_ui32x4_t (default) or veci_ui32x8_t (AVX2)
+
+  G g(seed, stream)   seeds the generator; different streams of one seed
+                      don't overlap (xoshiro128+: 2^96 values apart, PCG: own
+                      increment, Philox: own counter range), e.g. one stream
+                      per thread (the thread index of pparallel.h)
+  g.next()            the next vector of raw 32 bit values (uvec_t)
+  g.jump()            xoshiro128+: advances by 2^96 values, the next stream
+  g.discard(n)        pcg32_t/philox4x32_t: skips n calls of next() (O(log n)
+                      and O(1), respectively)
+  g.seek(block)       philox4x32_t: sets the block counter
+
+distributions (V = vec4f_t, or vec8f_t for veci_ui32x8_t, AVX only):
+  uniform01(g)                  [0,1), 24 bit resolution (multiples of 2^-24)
+  uniform(g, lo, hi)            lo + (hi - lo) * uniform01(g)
+  uniform_uint(g, n)            [0,n) per multiply-high (the bias is below
+                                n/2^32, no rejection)
+  uniform_int(g, lo, hi)        [lo,hi] (veci_i32x4_t/veci_i32x8_t)
+  normal(g[, mean, sigma])      Gaussian, Box-Muller with a packed log and
+  normal2(g, z0, z1)            fast_sin_1()/fast_cos_1(); normal2() returns
+                                both values of the transform (twice the
+                                throughput of normal())
+  unit_sphere(g, x, y, z)       uniform directions (SoA), z = 1 - 2u
+  unit_hemisphere(g, x, y, z)   uniform around +z (z > 0)
+  cosine_hemisphere(g, x, y, z) cosine weighted around +z (pdf cos(theta)/pi)
+
+  next_many(g, uint32_t * dst, n), uniform01_many(g, float * dst, n),
+  normal_many(g, float * dst, n[, mean, sigma]) fill whole arrays
+
+the Gaussian values are accurate to about 1e-6 (relative, the accuracy of the
+polynomial approximations); the Box-Muller radius is limited to
+sqrt(-2 ln 2^-24) ~ 5.77, so values beyond 5.77 sigma don't occur (probability
+~8e-9)
+
+the generators and distributions are written against veci_t/vecf_t: the
+element-wise shifts and rotations and the 32 bit multiplications of pveci.h,
+the reinterpretations and conversions of pcvt.h and math_t for the packed
+sqrt/sin/cos/mul_add; masks and selections are done with the integer operations
+on the bits of the floats
+*/
+
+// TODO:
+// - 64 bit generators (xoshiro256+) and double distributions
+// - AVX-512 (16 lanes, vprold/vprorvd for the rotations)
+
+
+namespace math {
+
+namespace ipriv {
+
+    // scalar seeding helper (Steele/Lea/Flood, the seeding recommended for xoshiro)
+    inline uint64_t splitmix64(uint64_t & x)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // signed and float vectors of the width of the generator vectors U
+    template<typename U> struct rand_types_t;
+    template<> struct rand_types_t<veci_ui32x4_t>
+    {
+        typedef veci_i32x4_t ivec_t;
+        typedef vec4f_t fvec_t;
+    };
+#if defined(PVECI_INTEL) && defined(AVX2)
+    template<> struct rand_types_t<veci_ui32x8_t>
+    {
+        typedef veci_i32x8_t ivec_t;
+# if defined(AVX)
+        typedef vec8f_t fvec_t;
+# endif
+    };
+#endif
+
+    // all elements s
+    template<typename U> inline U rand_splat(typename U::type_t s) { return U() + s; }
+    template<typename F> inline F rand_fsplat(float s) { return F(F::math_t::set1(s)); }
+
+    template<typename F> inline F rand_mul_add(const F & a, const F & b, const F & c)
+    { return F(F::math_t::mul_add(a.p, b.p, c.p)); }
+
+    // carry bits (0 or 1) of the sums s = a + b
+    template<typename U> inline U rand_carry(const U & a, const U & b, const U & s)
+    { return shr_logical<31>((a & b) | ((a | b) & ~s)); }
+
+    // sqrt(x) of x >= 0 per x * 1/sqrt(x), the maximum with the smallest
+    // normal float avoids 0 * inf for x == 0
+    template<typename F> inline F rand_sqrt(const F & x)
+    {
+        typedef typename F::math_t M;
+        return x * F(M::inv_sqrt_packed(M::max_packed(x.p, M::set1(1.17549435e-38f))));
+    }
+
+    // 0, 1, .., N-1
+    template<typename U> inline U rand_iota()
+    {
+        typename U::type_t i[U::N];
+        for(unsigned k = 0; k < U::N; ++k) i[k] = typename U::type_t(k);
+        U v;
+        v.loadu(i);
+        return v;
+    }
+
+
+    //
+    // xoshiro128+ (scalar, for the seeding and the lane spacing)
+    //
+    inline uint32_t xoshiro128_next(uint32_t (&s)[4])
+    {
+        uint32_t r = s[0] + s[3];
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = (s[3] << 11) | (s[3] >> 21);
+        return r;
+    }
+    // s = poly(T) s, T the state transition (x^(2^64), x^(2^96) mod the
+    // characteristic polynomial of T)
+    inline void xoshiro128_jump(uint32_t (&s)[4], const uint32_t (&poly)[4])
+    {
+        uint32_t acc[4] = { 0, 0, 0, 0 };
+        for(unsigned w = 0; w < 4; ++w)
+            for(unsigned b = 0; b < 32; ++b) {
+                if(poly[w] & (1u << b))
+                    for(unsigned i = 0; i < 4; ++i) acc[i] ^= s[i];
+                xoshiro128_next(s);
+            }
+        for(unsigned i = 0; i < 4; ++i) s[i] = acc[i];
+    }
+    static const uint32_t xoshiro128_jump64[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    static const uint32_t xoshiro128_jump96[4] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+    //
+    // PCG32 (scalar, for the seeding and discard())
+    //
+    static const uint64_t pcg32_mult = 6364136223846793005ull;
+
+    // state after delta steps (Brown, "Random Number Generation with
+    // Arbitrary Strides")
+    inline uint64_t pcg32_advance(uint64_t state, uint64_t delta, uint64_t inc)
+    {
+        uint64_t acc_mult = 1, acc_plus = 0, cur_mult = pcg32_mult, cur_plus = inc;
+        for(; delta; delta >>= 1) {
+            if(delta & 1) {
+                acc_mult *= cur_mult;
+                acc_plus = acc_plus * cur_mult + cur_plus;
+            }
+            cur_plus = (cur_mult + 1) * cur_plus;
+            cur_mult *= cur_mult;
+        }
+        return acc_mult * state + acc_plus;
+    }
+
+    //
+    // Philox4x32-10 constants
+    //
+    static const uint32_t philox_m0 = 0xD2511F53, philox_m1 = 0xCD9E8D57;
+    static const uint32_t philox_w0 = 0x9E3779B9, philox_w1 = 0xBB67AE85;
+
+} // namespace ipriv
+
+
+//
+// generators
+//
+template<typename U = veci_ui32x4_t>
+class xoshiro128p_t
+{
+public:
+    typedef U uvec_t;
+    typedef ipriv::rand_types_t<U> types_t;
+    static const unsigned N = U::N;
+
+    // lane k starts k * 2^64 values after lane 0, stream s s * 2^96 values
+    // after stream 0
+    explicit xoshiro128p_t(uint64_t seed = 0, uint64_t stream = 0)
+    {
+        uint64_t x = seed;
+        uint64_t a = ipriv::splitmix64(x), b = ipriv::splitmix64(x);
+        uint32_t s[4] = { uint32_t(a), uint32_t(a >> 32), uint32_t(b), uint32_t(b >> 32) };
+        for(uint64_t i = 0; i < stream; ++i)
+            ipriv::xoshiro128_jump(s, ipriv::xoshiro128_jump96);
+        for(unsigned k = 0; k < N; ++k) {
+            for(unsigned i = 0; i < 4; ++i) s_[i][k] = s[i];
+            ipriv::xoshiro128_jump(s, ipriv::xoshiro128_jump64);
+        }
+    }
+
+    inline U next()
+    {
+        U r = s_[0] + s_[3];
+        U t = shl<9>(s_[1]);
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl<11>(s_[3]);
+        return r;
+    }
+
+    // advances every lane by 2^96 values (to the next stream)
+    void jump()
+    {
+        U acc[4];
+        for(unsigned w = 0; w < 4; ++w)
+            for(unsigned b = 0; b < 32; ++b) {
+                if(ipriv::xoshiro128_jump96[w] & (1u << b))
+                    for(unsigned i = 0; i < 4; ++i) acc[i] ^= s_[i];
+                next();
+            }
+        for(unsigned i = 0; i < 4; ++i) s_[i] = acc[i];
+    }
+
+private:
+    U s_[4];
+};
+
+
+template<typename U = veci_ui32x4_t>
+class pcg32_t
+{
+public:
+    typedef U uvec_t;
+    typedef ipriv::rand_types_t<U> types_t;
+    static const unsigned N = U::N;
+
+    // lane k: pcg32_srandom(seed, stream * N + k) of the reference implementation
+    explicit pcg32_t(uint64_t seed = 0, uint64_t stream = 0)
+    {
+        uint64_t state[N], inc[N];
+        for(unsigned k = 0; k < N; ++k) {
+            inc[k] = ((stream * N + k) << 1) | 1u;
+            state[k] = ipriv::pcg32_advance(ipriv::pcg32_advance(0, 1, inc[k]) + seed, 1, inc[k]);
+        }
+        set(state, inc);
+    }
+
+    inline U next()
+    {
+        const U old_lo = lo_, old_hi = hi_;
+
+        // state = state * mult + inc (mod 2^64) in 32 bit halves
+        const U ml = ipriv::rand_splat<U>(uint32_t(ipriv::pcg32_mult));
+        const U mh = ipriv::rand_splat<U>(uint32_t(ipriv::pcg32_mult >> 32));
+        U plo, phi;
+        mul_wide(old_lo, ml, plo, phi);
+        phi += mul_lo(old_hi, ml) + mul_lo(old_lo, mh);
+        lo_ = plo + inc_lo_;
+        hi_ = phi + inc_hi_ + ipriv::rand_carry(plo, inc_lo_, lo_);
+
+        // output: rotr(uint32((old ^ (old >> 18)) >> 27), old >> 59)
+        U x_lo = old_lo ^ (shr_logical<18>(old_lo) | shl<14>(old_hi));
+        U x_hi = old_hi ^ shr_logical<18>(old_hi);
+        return rotr(shr_logical<27>(x_lo) | shl<5>(x_hi), shr_logical<27>(old_hi));
+    }
+
+    // skips n values (per lane)
+    void discard(uint64_t n)
+    {
+        uint64_t state[N], inc[N];
+        get(state, inc);
+        for(unsigned k = 0; k < N; ++k)
+            state[k] = ipriv::pcg32_advance(state[k], n, inc[k]);
+        set(state, inc);
+    }
+
+private:
+    void set(const uint64_t * state, const uint64_t * inc)
+    {
+        for(unsigned k = 0; k < N; ++k) {
+            lo_[k] = uint32_t(state[k]); hi_[k] = uint32_t(state[k] >> 32);
+            inc_lo_[k] = uint32_t(inc[k]); inc_hi_[k] = uint32_t(inc[k] >> 32);
+        }
+    }
+    void get(uint64_t * state, uint64_t * inc) const
+    {
+        for(unsigned k = 0; k < N; ++k) {
+            state[k] = (uint64_t(hi_[k]) << 32) | lo_[k];
+            inc[k] = (uint64_t(inc_hi_[k]) << 32) | inc_lo_[k];
+        }
+    }
+
+    U lo_, hi_;
+    U inc_lo_, inc_hi_;
+};
+
+
+template<typename U = veci_ui32x4_t>
+class philox4x32_t
+{
+public:
+    typedef U uvec_t;
+    typedef ipriv::rand_types_t<U> types_t;
+    static const unsigned N = U::N;
+
+    // key: seed, counter words 2 and 3: stream, words 0 and 1: the block index
+    explicit philox4x32_t(uint64_t seed = 0, uint64_t stream = 0)
+        : key_(seed), stream_(stream), ctr_(0), idx_(4)
+    {}
+
+    inline U next()
+    {
+        if(idx_ == 4) refill();
+        return out_[idx_++];
+    }
+
+    // sets the block counter (the next call of next() returns word 0 of the
+    // blocks block..block+N-1)
+    void seek(uint64_t block) { ctr_ = block; idx_ = 4; }
+
+    // skips n calls of next()
+    void discard(uint64_t n)
+    {
+        if(n < 4u - idx_) { idx_ += unsigned(n); return; }
+        n -= 4u - idx_;
+        ctr_ += (n / 4) * N;
+        idx_ = 4;
+        if(n % 4) { refill(); idx_ = unsigned(n % 4); }
+    }
+
+private:
+    void refill()
+    {
+        const U iota = ipriv::rand_iota<U>();
+        const U base = ipriv::rand_splat<U>(uint32_t(ctr_));
+        U c0 = base + iota;
+        U c1 = ipriv::rand_splat<U>(uint32_t(ctr_ >> 32)) + ipriv::rand_carry(base, iota, c0);
+        U c2 = ipriv::rand_splat<U>(uint32_t(stream_));
+        U c3 = ipriv::rand_splat<U>(uint32_t(stream_ >> 32));
+        uint32_t k0 = uint32_t(key_), k1 = uint32_t(key_ >> 32);
+        const U m0 = ipriv::rand_splat<U>(ipriv::philox_m0), m1 = ipriv::rand_splat<U>(ipriv::philox_m1);
+        for(unsigned r = 0; r < 10; ++r) {
+            U lo0, hi0, lo1, hi1;
+            mul_wide(c0, m0, lo0, hi0);
+            mul_wide(c2, m1, lo1, hi1);
+            c0 = hi1 ^ c1 ^ ipriv::rand_splat<U>(k0);
+            c2 = hi0 ^ c3 ^ ipriv::rand_splat<U>(k1);
+            c1 = lo1;
+            c3 = lo0;
+            k0 += ipriv::philox_w0;
+            k1 += ipriv::philox_w1;
+        }
+        out_[0] = c0; out_[1] = c1; out_[2] = c2; out_[3] = c3;
+        ctr_ += N;
+        idx_ = 0;
+    }
+
+    U out_[4];
+    uint64_t key_;
+    uint64_t stream_;
+    uint64_t ctr_;
+    unsigned idx_;
+};
+
+
+namespace ipriv {
+
+    // the upper 24 bits convert exactly
+    template<typename G> inline typename G::types_t::fvec_t rand_uniform01(G & g)
+    { return cvt_f32(as_i32(shr_logical<8>(g.next()))) * (1.0f / 16777216.0f); }
+
+    // ln(x) for normal x > 0 (Cephes logf, ~1e-7 relative error), U the
+    // unsigned vector of the width of F
+    template<typename U, typename F> inline F rand_log(const F & x)
+    {
+        static constexpr float coeffs[] = {
+            3.3333331174e-1f, -2.4999993993e-1f, 2.0000714765e-1f,
+            -1.6668057665e-1f, 1.4249322787e-1f, -1.2420140846e-1f,
+            1.1676998740e-1f, -1.1514610310e-1f, 7.0376836292e-2f
+        };
+        U i = as_u32(x);
+        // exponent: float(2^23 + biased exponent) - (2^23 + 127)
+        F e = as_f32(shr_logical<23>(i) | rand_splat<U>(0x4B000000u)) - 8388735.0f;
+        // mantissa in [1,2) -> [sqrt(1/2),sqrt(2)): halved above sqrt(2) (the
+        // bits of positive floats compare like the values)
+        U m = (i & rand_splat<U>(0x007FFFFFu)) | rand_splat<U>(0x3F800000u);
+        U big = shr_arith<31>(rand_splat<U>(0x3FB504F3u) - m);
+        m -= big & rand_splat<U>(0x00800000u);
+        e = e + as_f32(big & rand_splat<U>(0x3F800000u)); // + 1.0f
+        F f = as_f32(m) - 1.0f;
+        F z = f * f;
+        F y = F(poly_t<float,typename F::packed_t>::horner(f.p, coeffs)) * f * z;
+        y = rand_mul_add(e, rand_fsplat<F>(-2.12194440e-4f), y);
+        y = rand_mul_add(z, rand_fsplat<F>(-0.5f), y);
+        return rand_mul_add(e, rand_fsplat<F>(0.693359375f), f + y);
+    }
+
+    // sin/cos(2 pi u) of u = bits / 2^32: the upper 2 bits select the
+    // quadrant, the next 22 bits the angle inside of it
+    template<typename U, typename F> inline void rand_sincos_2pi(const U & bits, F & s, F & c)
+    {
+        F a = cvt_f32(as_i32(shr_logical<10>(shl<2>(bits)))) * (1.57079632679f / 4194304.0f); // [0,pi/2)
+        U sa = as_u32(F(F::math_t::fast_sin_1(a.p)));
+        U ca = as_u32(F(F::math_t::fast_cos_1(a.p)));
+        // quadrant q: (sin, cos) = (s, c), (c, -s), (-s, -c), (-c, s)
+        U odd = shr_arith<31>(shl<1>(bits));
+        U swap = (sa ^ ca) & odd;
+        U sign = rand_splat<U>(0x80000000u);
+        s = as_f32(sa ^ swap ^ (bits & sign));
+        c = as_f32(ca ^ swap ^ ((bits ^ shl<1>(bits)) & sign));
+    }
+
+    template<typename G>
+    inline void rand_normal2(G & g, typename G::types_t::fvec_t & z0, typename G::types_t::fvec_t & z1)
+    {
+        typedef typename G::types_t::fvec_t F;
+        F u = 1.0f - rand_uniform01(g); // (0,1]
+        F r = rand_sqrt(rand_log<typename G::uvec_t>(u) * -2.0f);
+        F s, c;
+        rand_sincos_2pi(g.next(), s, c);
+        z0 = r * c;
+        z1 = r * s;
+    }
+
+    // direction from z and the azimuth bits
+    template<typename G>
+    inline void rand_direction(G & g, const typename G::types_t::fvec_t & z,
+                               typename G::types_t::fvec_t & x, typename G::types_t::fvec_t & y)
+    {
+        typedef typename G::types_t::fvec_t F;
+        F r = rand_sqrt(F::max_(1.0f - z * z, F()));
+        F s, c;
+        rand_sincos_2pi(g.next(), s, c);
+        x = r * c;
+        y = r * s;
+    }
+
+} // namespace ipriv
+
+
+//
+// distributions
+//
+template<typename G> inline typename G::types_t::fvec_t uniform01(G & g)
+{ return ipriv::rand_uniform01(g); }
+
+template<typename G> inline typename G::types_t::fvec_t uniform(G & g, float lo, float hi)
+{
+    typedef typename G::types_t::fvec_t F;
+    return ipriv::rand_mul_add(ipriv::rand_uniform01(g), ipriv::rand_fsplat<F>(hi - lo), ipriv::rand_fsplat<F>(lo));
+}
+
+// [0,n), n > 0
+template<typename G> inline typename G::uvec_t uniform_uint(G & g, uint32_t n)
+{ return mul_hi(g.next(), ipriv::rand_splat<typename G::uvec_t>(n)); }
+
+// [lo,hi]
+template<typename G> inline typename G::types_t::ivec_t uniform_int(G & g, int32_t lo, int32_t hi)
+{
+    typedef typename G::uvec_t U;
+    uint32_t range = uint32_t(hi) - uint32_t(lo) + 1u; // 0: the full range
+    U x = g.next();
+    if(range)
+        x = mul_hi(x, ipriv::rand_splat<U>(range));
+    return as_i32(x + uint32_t(lo));
+}
+
+template<typename G>
+inline void normal2(G & g, typename G::types_t::fvec_t & z0, typename G::types_t::fvec_t & z1)
+{ ipriv::rand_normal2(g, z0, z1); }
+
+template<typename G> inline typename G::types_t::fvec_t normal(G & g, float mean = 0.0f, float sigma = 1.0f)
+{
+    typedef typename G::types_t::fvec_t F;
+    F z0, z1;
+    ipriv::rand_normal2(g, z0, z1);
+    return ipriv::rand_mul_add(z0, ipriv::rand_fsplat<F>(sigma), ipriv::rand_fsplat<F>(mean));
+}
+
+template<typename G>
+inline void unit_sphere(G & g, typename G::types_t::fvec_t & x, typename G::types_t::fvec_t & y, typename G::types_t::fvec_t & z)
+{
+    z = 1.0f - ipriv::rand_uniform01(g) * 2.0f; // (-1,1]
+    ipriv::rand_direction(g, z, x, y);
+}
+
+template<typename G>
+inline void unit_hemisphere(G & g, typename G::types_t::fvec_t & x, typename G::types_t::fvec_t & y, typename G::types_t::fvec_t & z)
+{
+    z = 1.0f - ipriv::rand_uniform01(g); // (0,1]
+    ipriv::rand_direction(g, z, x, y);
+}
+
+// z = sqrt(1 - u), r = sqrt(u) (Malley's method)
+template<typename G>
+inline void cosine_hemisphere(G & g, typename G::types_t::fvec_t & x, typename G::types_t::fvec_t & y, typename G::types_t::fvec_t & z)
+{
+    z = ipriv::rand_sqrt(1.0f - ipriv::rand_uniform01(g)); // (0,1]
+    ipriv::rand_direction(g, z, x, y);
+}
+
+
+//
+// arrays
+//
+template<typename G> inline void next_many(G & g, uint32_t * dst, size_t n)
+{
+    size_t i = 0;
+    for(; i + G::N <= n; i += G::N)
+        g.next().storeu(dst + i);
+    if(i < n) {
+        uint32_t tmp[G::N];
+        g.next().storeu(tmp);
+        memcpy(dst + i, tmp, (n - i) * sizeof(uint32_t));
+    }
+}
+
+template<typename G> inline void uniform01_many(G & g, float * dst, size_t n)
+{
+    size_t i = 0;
+    for(; i + G::N <= n; i += G::N)
+        ipriv::rand_uniform01(g).storeu(dst + i);
+    if(i < n) {
+        float tmp[G::N];
+        ipriv::rand_uniform01(g).storeu(tmp);
+        memcpy(dst + i, tmp, (n - i) * sizeof(float));
+    }
+}
+
+template<typename G> inline void normal_many(G & g, float * dst, size_t n, float mean = 0.0f, float sigma = 1.0f)
+{
+    typedef typename G::types_t::fvec_t F;
+    const F m = ipriv::rand_fsplat<F>(mean), sd = ipriv::rand_fsplat<F>(sigma);
+    size_t i = 0;
+    for(; i < n; i += 2 * G::N) {
+        F z0, z1;
+        ipriv::rand_normal2(g, z0, z1);
+        z0 = ipriv::rand_mul_add(z0, sd, m);
+        z1 = ipriv::rand_mul_add(z1, sd, m);
+        if(i + 2 * G::N <= n) {
+            z0.storeu(dst + i);
+            z1.storeu(dst + i + G::N);
+        } else {
+            float tmp[2 * G::N];
+            z0.storeu(tmp);
+            z1.storeu(tmp + G::N);
+            memcpy(dst + i, tmp, (n - i) * sizeof(float));
+        }
+    }
+}
+
+} // namespace math
+
+#endif // PRAND_H
@@ -44,6 +44,197 @@ namespace fpriv {
     template<typename T> struct enable_if<true,T> { typedef T type; };
 } // namespace fpriv
 
+// rounding modes (of the float -> integer conversions in pcvt.h, of the
+// floating point environment in pfenv.h, of the vecf_t rounding members)
+enum class round_t
+{
+    nearest_even,
+    trunc,
+    floor,
+    ceil
+};
+
+//
+// rounding to integral values
+//
+// roundps/roundpd (SSE4.1, AVX) and vrnd*q_f32 (ARMv8) round directly; elsewhere
+// (x + 2^23) - 2^23 (2^52 for doubles) with the sign of x rounds per the
+// current rounding mode (nearest even by default, see pfenv.h), the result is
+// corrected towards the requested mode per comparison with x; values with
+// |x| >= 2^23 (2^52) are integral already and returned as they are, so the
+// results are correct for the whole range (unlike conversions to int32_t and
+// back), NaNs and infinities are passed through and the sign of zero results
+// is kept
+//
+namespace fpriv {
+
+#if defined(PVECF_INTEL)
+
+    template<round_t R> inline __m128 round_ps(__m128 x)
+    {
+# if defined(SSE4) || defined(AVX) || defined(AVX2)
+        return
+            _mm_round_ps(
+                x,
+                (R == round_t::nearest_even ? _MM_FROUND_TO_NEAREST_INT :
+                 R == round_t::trunc ? _MM_FROUND_TO_ZERO :
+                 R == round_t::floor ? _MM_FROUND_TO_NEG_INF : _MM_FROUND_TO_POS_INF) | _MM_FROUND_NO_EXC
+            );
+# else
+        __m128 two23 = _mm_set1_ps(8388608.0f);
+        __m128 sgn = _mm_and_ps(x, math_t<float,__m128>::sign_mask());
+        __m128 ax = _mm_xor_ps(x, sgn);
+        __m128 m = _mm_or_ps(two23, sgn);
+        __m128 r = _mm_sub_ps(_mm_add_ps(x, m), m);
+        __m128 one = math_t<float,__m128>::ones();
+        if(R == round_t::floor)
+            r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, x), one));
+        else if(R == round_t::ceil)
+            r = _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(r, x), one));
+        else if(R == round_t::trunc)
+            r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(_mm_xor_ps(r, sgn), ax), _mm_or_ps(one, sgn)));
+        __m128 small = _mm_cmplt_ps(ax, two23);
+        return _mm_or_ps(_mm_and_ps(small, _mm_or_ps(r, sgn)), _mm_andnot_ps(small, x));
+# endif
+    }
+
+    // round half away from zero: trunc(x) + sign(x) if |x - trunc(x)| >= 0.5,
+    // the sign is or-ed in again for -0 results (-0 + 0 is +0)
+    inline __m128 round_away_ps(__m128 x)
+    {
+        __m128 t = round_ps<round_t::trunc>(x);
+        __m128 sgn = _mm_and_ps(x, math_t<float,__m128>::sign_mask());
+        __m128 d = _mm_andnot_ps(math_t<float,__m128>::sign_mask(), _mm_sub_ps(x, t));
+        __m128 up = _mm_cmpge_ps(d, math_t<float,__m128>::halves());
+        return _mm_or_ps(_mm_add_ps(t, _mm_and_ps(up, _mm_or_ps(math_t<float,__m128>::ones(), sgn))), sgn);
+    }
+
+# if defined(SSE2) || defined(AVX)
+    template<round_t R> inline __m128d round_pd(__m128d x)
+    {
+#   if defined(SSE4) || defined(AVX) || defined(AVX2)
+        return
+            _mm_round_pd(
+                x,
+                (R == round_t::nearest_even ? _MM_FROUND_TO_NEAREST_INT :
+                 R == round_t::trunc ? _MM_FROUND_TO_ZERO :
+                 R == round_t::floor ? _MM_FROUND_TO_NEG_INF : _MM_FROUND_TO_POS_INF) | _MM_FROUND_NO_EXC
+            );
+#   else
+        __m128d two52 = _mm_set1_pd(4503599627370496.0);
+        __m128d sgn = _mm_and_pd(x, math_t<double,__m128d>::sign_mask());
+        __m128d ax = _mm_xor_pd(x, sgn);
+        __m128d m = _mm_or_pd(two52, sgn);
+        __m128d r = _mm_sub_pd(_mm_add_pd(x, m), m);
+        __m128d one = math_t<double,__m128d>::ones();
+        if(R == round_t::floor)
+            r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, x), one));
+        else if(R == round_t::ceil)
+            r = _mm_add_pd(r, _mm_and_pd(_mm_cmplt_pd(r, x), one));
+        else if(R == round_t::trunc)
+            r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(_mm_xor_pd(r, sgn), ax), _mm_or_pd(one, sgn)));
+        __m128d small = _mm_cmplt_pd(ax, two52);
+        return _mm_or_pd(_mm_and_pd(small, _mm_or_pd(r, sgn)), _mm_andnot_pd(small, x));
+#   endif
+    }
+
+    inline __m128d round_away_pd(__m128d x)
+    {
+        __m128d t = round_pd<round_t::trunc>(x);
+        __m128d sgn = _mm_and_pd(x, math_t<double,__m128d>::sign_mask());
+        __m128d d = _mm_andnot_pd(math_t<double,__m128d>::sign_mask(), _mm_sub_pd(x, t));
+        __m128d up = _mm_cmpge_pd(d, math_t<double,__m128d>::halves());
+        return _mm_or_pd(_mm_add_pd(t, _mm_and_pd(up, _mm_or_pd(math_t<double,__m128d>::ones(), sgn))), sgn);
+    }
+# endif // SSE2 || AVX
+
+# if defined(AVX)
+    template<round_t R> inline __m256 round_ps(__m256 x)
+    {
+        return
+            _mm256_round_ps(
+                x,
+                (R == round_t::nearest_even ? _MM_FROUND_TO_NEAREST_INT :
+                 R == round_t::trunc ? _MM_FROUND_TO_ZERO :
+                 R == round_t::floor ? _MM_FROUND_TO_NEG_INF : _MM_FROUND_TO_POS_INF) | _MM_FROUND_NO_EXC
+            );
+    }
+    inline __m256 round_away_ps(__m256 x)
+    {
+        __m256 t = round_ps<round_t::trunc>(x);
+        __m256 sgn = _mm256_and_ps(x, math_t<float,__m256>::sign_mask());
+        __m256 d = _mm256_andnot_ps(math_t<float,__m256>::sign_mask(), _mm256_sub_ps(x, t));
+        __m256 half = math_t<float,__m256>::halves();
+        __m256 up = _mm256_cmp_ps(d, half, _CMP_GE_OQ);
+        return _mm256_or_ps(_mm256_add_ps(t, _mm256_and_ps(up, _mm256_or_ps(math_t<float,__m256>::ones(), sgn))), sgn);
+    }
+
+    template<round_t R> inline __m256d round_pd(__m256d x)
+    {
+        return
+            _mm256_round_pd(
+                x,
+                (R == round_t::nearest_even ? _MM_FROUND_TO_NEAREST_INT :
+                 R == round_t::trunc ? _MM_FROUND_TO_ZERO :
+                 R == round_t::floor ? _MM_FROUND_TO_NEG_INF : _MM_FROUND_TO_POS_INF) | _MM_FROUND_NO_EXC
+            );
+    }
+    inline __m256d round_away_pd(__m256d x)
+    {
+        __m256d t = round_pd<round_t::trunc>(x);
+        __m256d sgn = _mm256_and_pd(x, math_t<double,__m256d>::sign_mask());
+        __m256d d = _mm256_andnot_pd(math_t<double,__m256d>::sign_mask(), _mm256_sub_pd(x, t));
+        __m256d half = math_t<double,__m256d>::halves();
+        __m256d up = _mm256_cmp_pd(d, half, _CMP_GE_OQ);
+        return _mm256_or_pd(_mm256_add_pd(t, _mm256_and_pd(up, _mm256_or_pd(math_t<double,__m256d>::ones(), sgn))), sgn);
+    }
+# endif // AVX
+
+#elif defined(PVECF_ARM)
+
+    template<round_t R> inline float32x4_t round_ps(float32x4_t x)
+    {
+# if defined(__aarch64__)
+        return
+            R == round_t::nearest_even ? vrndnq_f32(x) :
+            R == round_t::trunc ? vrndq_f32(x) :
+            R == round_t::floor ? vrndmq_f32(x) : vrndpq_f32(x);
+# else
+        // NEON arithmetic always rounds to nearest even
+        uint32x4_t sgn = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000u));
+        float32x4_t two23 = vdupq_n_f32(8388608.0f);
+        float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(two23), sgn));
+        float32x4_t r = vsubq_f32(vaddq_f32(x, m), m);
+        uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+        if(R == round_t::floor)
+            r = vsubq_f32(r, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(r, x), one)));
+        else if(R == round_t::ceil)
+            r = vaddq_f32(r, vreinterpretq_f32_u32(vandq_u32(vcltq_f32(r, x), one)));
+        else if(R == round_t::trunc)
+            r = vsubq_f32(r, vreinterpretq_f32_u32(vandq_u32(vcagtq_f32(r, x), vorrq_u32(one, sgn))));
+        r = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r), sgn));
+        return vbslq_f32(vcaltq_f32(x, two23), r, x);
+# endif
+    }
+
+    inline float32x4_t round_away_ps(float32x4_t x)
+    {
+# if defined(__aarch64__)
+        return vrndaq_f32(x);
+# else
+        float32x4_t t = round_ps<round_t::trunc>(x);
+        uint32x4_t sgn = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000u));
+        uint32x4_t up = vcageq_f32(vsubq_f32(x, t), vdupq_n_f32(0.5f));
+        uint32x4_t one = vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(1.0f)), sgn);
+        float32x4_t r = vaddq_f32(t, vreinterpretq_f32_u32(vandq_u32(up, one)));
+        return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r), sgn));
+# endif
+    }
+
+#endif
+
+} // namespace fpriv
+
 //
 // vecf_t general template
 //
@@ -202,8 +393,20 @@ public:
     void frac();
     vecf_t frac() const;
 
-    //void round_even();
-    //vec4f_t round_even() const;
+    // to nearest, ties to even (without SSE4.1/ARMv8 per the current
+    // rounding mode, which is nearest even unless changed, see pfenv.h)
+    void round_even();
+    vecf_t round_even() const;
+
+    // to nearest, ties away from zero (like std::round())
+    void round_nearest_away();
+    vecf_t round_nearest_away() const;
+
+    // to the nearest multiple of m (round_even(x / m) * m), e.g. grid snapping
+    void round_to_multiple(t_real m);
+    vecf_t round_to_multiple(t_real m) const;
+    void round_to_multiple(const vecf_t & m);
+    vecf_t round_to_multiple(const vecf_t & m) const;
 
     vecf_t isnan() const;
     bool isnan_all() const;
@@ -290,6 +493,28 @@ inline vecf_t<scalar,N,packed> operator op(packed v1, const vecf_t<scalar,N,pack
     FREE_BIT_OP_(&,scalar,N,packed,prefix,and,postfix) \
     FREE_BIT_OP_(|,scalar,N,packed,prefix,or ,postfix) \
     FREE_BIT_OP_(^,scalar,N,packed,prefix,xor,postfix)
+#define MEMBER_ROUND_OP_(name,scalar,N,packed,expr) \
+template<> inline void vecf_t<scalar,N,packed>::name() { p = expr; } \
+template<> inline vecf_t<scalar,N,packed> vecf_t<scalar,N,packed>::name() const { \
+    vecf_t<scalar,N,packed> ret(p); ret.name(); return ret; }
+#define MEMBER_ROUND_OPS_(scalar,N,packed,postfix) \
+    MEMBER_ROUND_OP_(trunc,scalar,N,packed,fpriv::round##postfix<round_t::trunc>(p)) \
+    MEMBER_ROUND_OP_(floor,scalar,N,packed,fpriv::round##postfix<round_t::floor>(p)) \
+    MEMBER_ROUND_OP_(ceil,scalar,N,packed,fpriv::round##postfix<round_t::ceil>(p)) \
+    MEMBER_ROUND_OP_(round_even,scalar,N,packed,fpriv::round##postfix<round_t::nearest_even>(p)) \
+    MEMBER_ROUND_OP_(round_nearest_away,scalar,N,packed,fpriv::round_away##postfix(p)) \
+template<> inline void vecf_t<scalar,N,packed>::frac() { \
+    vecf_t<scalar,N,packed> f(p); f.floor(); *this -= f; } \
+template<> inline vecf_t<scalar,N,packed> vecf_t<scalar,N,packed>::frac() const { \
+    vecf_t<scalar,N,packed> ret(p); ret.frac(); return ret; } \
+template<> inline void vecf_t<scalar,N,packed>::round_to_multiple(scalar m) { \
+    *this /= m; round_even(); *this *= m; } \
+template<> inline vecf_t<scalar,N,packed> vecf_t<scalar,N,packed>::round_to_multiple(scalar m) const { \
+    vecf_t<scalar,N,packed> ret(p); ret.round_to_multiple(m); return ret; } \
+template<> inline void vecf_t<scalar,N,packed>::round_to_multiple(const vecf_t<scalar,N,packed> & m) { \
+    *this /= m; round_even(); *this *= m; } \
+template<> inline vecf_t<scalar,N,packed> vecf_t<scalar,N,packed>::round_to_multiple(const vecf_t<scalar,N,packed> & m) const { \
+    vecf_t<scalar,N,packed> ret(p); ret.round_to_multiple(m); return ret; }
 
 #define FREE_ARITHBIT_OP_NAMED_(opname,scalar,N,packed,prefix,intrinop,postfix) \
 inline vecf_t<scalar,N,packed> opname(const vecf_t<scalar,N,packed> & v1, const vecf_t<scalar,N,packed> & v2) { \
@@ -915,7 +1140,7 @@ template<> inline vec4f_t vec4f_t::max_(const vec4f_t & v0, const vec4f_t & v1)
 }
 
 template<> inline void vec4f_t::abs_()
-{ p = notAandB_(math_t::set1(-0.0f), p); }
+{ p = notAandB_(math_t::sign_mask(), p); }
 template<> inline vec4f_t vec4f_t::abs_() const
 { vec4f_t ret(p); ret.abs_(); return ret; }
 
@@ -927,7 +1152,7 @@ template<> template<unsigned IDX> inline vec4f_t vec4f_t::elemAbs() const
 template<> template<unsigned IDX> inline void vec4f_t::elemAbs()
 {
     static_assert(IDX <= 3, "IDX out of range");
-    packed_t masks(math_t::set1(-0.0f));
+    packed_t masks(math_t::sign_mask());
     packed_t zeroes(math_t::zeroes());
     packed_t val = xxxx(masks, zeroes); // {-0,-0,0,0}
     switch(IDX) {
@@ -954,136 +1179,13 @@ template<> template<unsigned IDX> inline void vec4f_t::elemAbs()
 
 
 
-template<> inline void vec4f_t::trunc()
-{
-#if defined(PVECF_INTEL)
-    // vector conversion to integers and back is supported starting with SSE2;
-    // for SSE have to go through GP registers and in a scalar way
-    // TODO: add this restriction to the documentation (performance warning)
-#  if !defined(SSE2) && !defined(SSE3) && !defined(SSSE3) && !defined(SSE4) && !defined(SSE4_2) && !defined(AVX)
-    int i[4] = {
-        _mm_cvtt_ss2si(xxxx(p)), _mm_cvtt_ss2si(yyyy(p)),
-        _mm_cvtt_ss2si(zzzz(p)), _mm_cvtt_ss2si(wwww(p))
-    };
-    __m128 x, y, z, w;
-    x = _mm_cvt_si2ss(x, i[0]);
-    y = _mm_cvt_si2ss(y, i[1]);
-    z = _mm_cvt_si2ss(z, i[2]);
-    w = _mm_cvt_si2ss(w, i[3]);
-    p = xzxz(xxxx(x, y), xxxx(z, w));
-#  elif defined(SSE4)
-    p = _mm_round_ps(p, _MM_FROUND_TRUNC);
-#  else
-    p = _mm_cvtepi32_ps(_mm_cvttps_epi32(p));
-#  endif
-#elif defined(PVECF_ARM)
-    p = vcvtq_f32_s32(vcvtq_s32_f32(p));
-#endif
-}
-template<> inline vec4f_t vec4f_t::trunc() const
-{ vec4f_t ret(p); ret.trunc(); return ret; }
-
-
-template<> inline void vec4f_t::floor()
-{
-#if defined(PVECF_INTEL)
-    // SSE4 (aka SSE4.1) has rounding instruction
-#  if defined(SSE4)
-    p = _mm_floor_ps(p);
-    return;
-#  else
-    __m128 orig = p;
-    trunc();
-    __m128 tmp = orig - p;
-    __m128 submask = _mm_cmplt_ps(tmp, math_t::zeroes());
-    p = _mm_or_ps(notAandB_(submask, p), _mm_and_ps(p-math_t::ones(), submask));
-#  endif
-#elif defined(PVECF_ARM)
-    __n128 orig = p;
-    trunc();
-    __n128 tmp = orig - p;
-    __n128 submask = vreinterpretq_f32_u32(vcltq_f32(tmp, math_t::zeroes()));
-    p =
-        vreinterpretq_f32_u32(
-            vorrq_u32(
-                vreinterpretq_u32_f32(notAandB_(submask, p)),
-                vandq_u32(
-                    vreinterpretq_u32_f32(vsubq_f32(p, math_t::ones())),
-                    vreinterpretq_u32_f32(submask)
-                )
-            )
-        );
-#endif
-}
-template<> inline vec4f_t vec4f_t::floor() const
-{ vec4f_t ret(p); ret.floor(); return ret; }
-
-
-template<> inline void vec4f_t::ceil()
-{
-#if defined(PVECF_INTEL)
-    // SSE4 (aka SSE4.1) has rounding instruction
-#  if defined(SSE4)
-    p = _mm_ceil_ps(p);
-    return;
-#  else
-    __m128 orig = p;
-    trunc();
-    __m128 tmp = orig - p;
-    __m128 addmask = _mm_cmpgt_ps(tmp, math_t::zeroes());
-    p = _mm_or_ps(notAandB_(addmask, p), _mm_and_ps(p+math_t::ones(), addmask));
-#  endif
-#elif defined(PVECF_ARM)
-    __n128 orig = p;
-    trunc();
-    __n128 tmp = orig - p;
-    __n128 addmask = vreinterpretq_f32_u32(vcgtq_f32(tmp, math_t::zeroes()));
-    p =
-        vreinterpretq_f32_u32(
-            vorrq_u32(
-                vreinterpretq_u32_f32(notAandB_(addmask, p)),
-                vandq_u32(
-                    vreinterpretq_u32_f32(vaddq_f32(p, math_t::ones())),
-                    vreinterpretq_u32_f32(addmask)
-                )
-            )
-        );
-#endif
-}
-template<> inline vec4f_t vec4f_t::ceil() const
-{ vec4f_t ret(p); ret.ceil(); return ret; }
-
-
-template<> inline void vec4f_t::frac()
-{ packed_t orig = p; floor(); p = orig - p; }
-template<> inline vec4f_t vec4f_t::frac() const
-{ vec4f_t ret(p); ret.frac(); return ret; }
-
-/*
-template<> inline void vec4f_t::round_even()
-{
+// trunc(), floor(), ceil(), frac(), round_even(), round_nearest_away(),
+// round_to_multiple(), see fpriv::round_ps()
 #if defined(PVECF_INTEL)
-    // SSE4 (aka SSE4.1) has rounding instruction
-#  if defined(SSE4)
-    p = _mm_round_ps(p, _MM_FROUND_NINT);
-    return;
-#  else
-    __m128 orig = p;
-    trunc();
-    __m128 tmp = orig - p;
-    __m128 addmask = _mm_cmpgt_ps(tmp, math_t::zeroes());
-#  endif
+MEMBER_ROUND_OPS_(float,4,__m128,_ps)
 #elif defined(PVECF_ARM)
-    __n128 orig = p;
-    trunc();
-    __n128 tmp = orig - p;
-    __n128 addmask = vcgtq_f32(tmp, math_t::zeroes());
+MEMBER_ROUND_OPS_(float,4,__n128,_ps)
 #endif
-    p = notAandB_(addmask, p) | ((p+math_t::ones()) & addmask);
-}
-template<> inline vec4f_t vec4f_t::round_even() const
-{ vec4f_t ret(p); ret.round_even(); return ret; }
-*/
 
 template<> inline vec4f_t vec4f_t::isnan() const
 {
@@ -1117,8 +1219,7 @@ template<> inline void vec4f_t::loadu(const float * ptr)
     p = _mm_loadu_ps(ptr);
     //p = *reinterpret_cast<const packed_t *>(ptr);
 #elif defined(PVECF_ARM)
-    // this may not even be supported (or maybe it is supported per VLDx)
-    p = *reinterpret_cast<const packed_t *>(ptr);
+    p = vld1q_f32(ptr);
 #endif
 }
 
@@ -1134,8 +1235,7 @@ template<> inline void vec4f_t::storeu(float * ptr)
 #if defined(PVECF_INTEL)
     _mm_storeu_ps(ptr, p);
 #elif defined(PVECF_ARM)
-    // this may not even be supported (or maybe it is supported per VSTx)
-    p = *reinterpret_cast<const packed_t *>(ptr);
+    vst1q_f32(ptr, p);
 #endif
 }
 
@@ -1200,7 +1300,7 @@ template<> inline void vec2d_t::normalize()
 { double sqlen_ = sqlen(); __m128d x = _mm_set1_pd(sqlen_);
   p = _mm_mul_pd(p, math_t::inv_sqrt_packed(x)); }
 template<> inline vec2d_t & vec2d_t::normalize_packed()
-{ p = _mm_mul_pd(p, math_t::inv_sqrt_packed(sqlen_packed())); }
+{ p = _mm_mul_pd(p, math_t::inv_sqrt_packed(sqlen_packed())); return *this; }
 template<> inline void vec2d_t::clamp_0_1()
 { p = _mm_max_pd(math_t::zeroes(), _mm_min_pd(p, math_t::ones())); }
 // these ignore the second vector
@@ -1250,10 +1350,12 @@ template<> inline vec2d_t vec2d_t::max_(const vec2d_t & v0, const vec2d_t & v1)
 { return vec2d_t(_mm_max_pd(v0.p, v1.p)); }
 
 template<> inline void vec2d_t::abs_()
-{ p = notAandB_(math_t::set1(-0.0), p); }
+{ p = _mm_and_pd(math_t::abs_mask(), p); }
 template<> inline vec2d_t vec2d_t::abs_() const
 { vec2d_t ret(p); ret.abs_(); return ret; }
 
+MEMBER_ROUND_OPS_(double,2,__m128d,_pd)
+
 
 template<> template<unsigned IDX> inline vec2d_t vec2d_t::elemAbs() const
 { vec2d_t ret(p); ret.elemAbs<IDX>(); return ret; }
@@ -1261,11 +1363,11 @@ template<> template<unsigned IDX> inline vec2d_t vec2d_t::elemAbs() const
 template<> template<unsigned IDX> inline void vec2d_t::elemAbs()
 {
     static_assert(IDX <= 1, "IDX out of range");
-    packed_t masks(math_t::set1(-0.0));
+    packed_t masks(math_t::sign_mask());
     packed_t zeroes(math_t::zeroes());
     packed_t val =
         IDX == 0 ? xx(masks, zeroes)/*{-0,0}*/ : xx(zeroes, masks)/*{0,-0}*/;
-    p = p ^ val;
+    p = _mm_xor_pd(p, val);
 }
 
 
@@ -1280,6 +1382,19 @@ template<> inline vec2d_t vec2d_t::isnan() const
 template<> inline bool vec2d_t::isnan_all() const
 { return _mm_movemask_pd(_mm_cmpeq_pd(_mm_cmpeq_pd(p, p), vec2d_t::math_t::zeroes())) == 0x3; }
 
+// load aligned
+template<> inline void vec2d_t::loada(const double * ptr)
+{ p = _mm_load_pd(ptr); }
+// load unaligned
+template<> inline void vec2d_t::loadu(const double * ptr)
+{ p = _mm_loadu_pd(ptr); }
+// store aligned
+template<> inline void vec2d_t::storea(double * ptr)
+{ _mm_store_pd(ptr, p); }
+// store unaligned
+template<> inline void vec2d_t::storeu(double * ptr)
+{ _mm_storeu_pd(ptr, p); }
+
 
 #undef vec2d_t
 
@@ -1287,6 +1402,8 @@ template<> inline bool vec2d_t::isnan_all() const
 
 
 #ifdef AVX
+#define vec4d_t vecf_t<double,4,__m256d>
+#define vec8f_t vecf_t<float,8,__m256>
 //
 // vec4d_t implementation
 //
@@ -1298,7 +1415,7 @@ template<> template<> inline vec4d_t::vecf_t(double v0, double v1, double v2, do
 
 template<> inline vec4d_t & vec4d_t::operator=(double v) { p = _mm256_set1_pd(v); return *this; }
 
-MEMBER_ARITH_OPS_(vec4d_t,__m256d,_mm256_,_pd)
+MEMBER_ARITH_OPS_(double,4,__m256d,_mm256_,_pd)
 
 template<> inline vec4d_t & vec4d_t::operator+=(double v)
 { p = _mm256_add_pd(p, _mm256_set1_pd(v)); return *this; }
@@ -1311,12 +1428,12 @@ template<> inline vec4d_t & vec4d_t::operator*=(double v)
 template<> inline vec4d_t & vec4d_t::operator/=(double s)
 { p = _mm256_div_pd(p, _mm256_set1_pd(s)); return *this; }
 
-MEMBER_CMP_OPS_(vec4d_t,__m256d,_mm256_,_pd,0xF)
+MEMBER_CMP_OPS_(double,4,__m256d,_mm256_,_pd,0xF)
 
-template<> inline double vec4d_t::dot(const vec4d_t & op2) const
-{ return _mm_cvtsd_f64(_mm256_castpd256_pd128(dot_packed(op2))); }
 template<> inline __m256d vec4d_t::dot_packed(const vec4d_t & op2) const
 { return math_t::dot_packed(p, op2.p); }
+template<> inline double vec4d_t::dot(const vec4d_t & op2) const
+{ return _mm_cvtsd_f64(_mm256_castpd256_pd128(dot_packed(op2))); }
 template<> inline double vec4d_t::sqlen() const { return dot(*this); }
 template<> inline __m256d vec4d_t::sqlen_packed() const { return dot_packed(*this); }
 template<> inline double vec4d_t::len() const { return math_t::sqrt(dot(*this)); }
@@ -1325,14 +1442,23 @@ template<> inline void vec4d_t::normalize() {
     double sqlen_ = sqlen(); __m256d x = _mm256_set1_pd(sqlen_);
     p = _mm256_mul_pd(p, math_t::inv_sqrt_packed(x));
 }
-template<> inline void vec4d_t::normalize_packed()
-{ p = _mm256_mul_pd(p, math_t::inv_sqrt_packed(sqlen_packed())); }
+template<> inline vec4d_t & vec4d_t::normalize_packed()
+{ p = _mm256_mul_pd(p, math_t::inv_sqrt_packed(sqlen_packed())); return *this; }
 template<> inline void vec4d_t::clamp_0_1()
 { p = _mm256_max_pd(math_t::zeroes(), _mm256_min_pd(p, math_t::ones())); }
-template<> inline vec4d_t vec4d_t::cross(const vec4d_t & v2) const
-{ return vec4d_t(cross_packed(v2)); }
+template<> inline vec4d_t vec4d_t::min_(const vec4d_t & v0, const vec4d_t & v1)
+{ return vec4d_t(_mm256_min_pd(v0.p, v1.p)); }
+template<> inline vec4d_t vec4d_t::max_(const vec4d_t & v0, const vec4d_t & v1)
+{ return vec4d_t(_mm256_max_pd(v0.p, v1.p)); }
+template<> inline void vec4d_t::abs_()
+{ p = _mm256_and_pd(math_t::abs_mask(), p); }
+template<> inline vec4d_t vec4d_t::abs_() const
+{ vec4d_t ret(p); ret.abs_(); return ret; }
+MEMBER_ROUND_OPS_(double,4,__m256d,_pd)
 template<> inline __m256d vec4d_t::cross_packed(const vec4d_t & v2) const
 { return wxzy(p) * wyxz(v2.p) - wyxz(p) * wxzy(v2.p); }
+template<> inline vec4d_t vec4d_t::cross(const vec4d_t & v2) const
+{ return vec4d_t(cross_packed(v2)); }
 /*
 template<> inline __m256d vec4d_t::cross_packed(const vec4d_t & v2) const
 { // this = {w0,z0,y0,x0}, v2 = {w1,z1,y1,x1}
@@ -1352,15 +1478,15 @@ template<> inline __m256d vec4d_t::cross_packed(const vec4d_t & v2) const
       ); // (a) - (b) = {0,x0y1-x1y0,x1z0-x0z1,y0z1-y1z0}
 }
 */
-template<> inline vec4d_t vec4d_t::unit_cross(const vec4d_t & v2) const
-{ return vec4d_t(unit_cross_packed(v2)); }
 template<> inline __m256d vec4d_t::unit_cross_packed(const vec4d_t & v2) const
 { __m256d cross = cross_packed(v2);
   return _mm256_mul_pd(cross, math_t::inv_sqrt_packed(math_t::dot_packed(cross, cross))); }
+template<> inline vec4d_t vec4d_t::unit_cross(const vec4d_t & v2) const
+{ return vec4d_t(unit_cross_packed(v2)); }
 
-FREE_ARITH_OPS_(vec4d_t,__m256d,float,_mm256_,_pd)
+FREE_ARITH_OPS_(double,4,__m256d,_mm256_,_pd)
 
-FREE_BIT_OPS_(vec4d_t,__m256d,_mm256_,_pd)
+FREE_BIT_OPS_(double,4,__m256d,_mm256_,_pd)
 
 // unary minus
 inline vec4d_t operator-(const vec4d_t & v)
@@ -1399,23 +1525,37 @@ inline vec4d_t eval_line(const vec4d_t & origin, double t, const vec4d_t & dir)
 inline vec4d_t eval_line_packed(const vec4d_t & origin, __m256d t, const vec4d_t & dir)
 { return vec4d_t(origin + (t * dir)); }
 
+// load aligned
+template<> inline void vec4d_t::loada(const double * ptr)
+{ p = _mm256_load_pd(ptr); }
+// load unaligned
+template<> inline void vec4d_t::loadu(const double * ptr)
+{ p = _mm256_loadu_pd(ptr); }
+// store aligned
+template<> inline void vec4d_t::storea(double * ptr)
+{ _mm256_store_pd(ptr, p); }
+// store unaligned
+template<> inline void vec4d_t::storeu(double * ptr)
+{ _mm256_storeu_pd(ptr, p); }
+
 
 //
 // vec8f_t implementation
 //
 template<> inline vec8f_t::vecf_t() { p = math_t::zeroes(); }
-template<> inline vec8f_t::vecf_t(float v0) { v[0] = v0; v[1] = v[2] = v[3] = 0.0f; }
-template<> inline vec8f_t::vecf_t(float v0, float v1) { v[0] = v0; v[1] = v1; v[2] = v[3] = 0.0f; }
-template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2) { v[0] = v0; v[1] = v1; v[2] = v2; v[3] = 0.0f; }
-template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3) { v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
-template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4) { v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; v[4] = v4; }
-template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4, float v5) { v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; v[4] = v4; v[5] = v5; }
-template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4, float v5, float v6) { v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; v[4] = v4; v[5] = v5; v[6] = v6; }
+// the elements not given are 0
+template<> inline vec8f_t::vecf_t(float v0) { p = _mm256_setr_ps(v0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f); }
+template<> inline vec8f_t::vecf_t(float v0, float v1) { p = _mm256_setr_ps(v0, v1, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f); }
+template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2) { p = _mm256_setr_ps(v0, v1, v2, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f); }
+template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3) { p = _mm256_setr_ps(v0, v1, v2, v3, 0.0f, 0.0f, 0.0f, 0.0f); }
+template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4) { p = _mm256_setr_ps(v0, v1, v2, v3, v4, 0.0f, 0.0f, 0.0f); }
+template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4, float v5) { p = _mm256_setr_ps(v0, v1, v2, v3, v4, v5, 0.0f, 0.0f); }
+template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4, float v5, float v6) { p = _mm256_setr_ps(v0, v1, v2, v3, v4, v5, v6, 0.0f); }
 template<> template<> inline vec8f_t::vecf_t(float v0, float v1, float v2, float v3, float v4, float v5, float v6, float v7) { v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7; }
 
 template<> inline vec8f_t & vec8f_t::operator=(float v) { p = _mm256_set1_ps(v); return *this; }
 
-MEMBER_ARITH_OPS_(vec8f_t, __m256, _mm256_, _ps)
+MEMBER_ARITH_OPS_(float,8,__m256,_mm256_,_ps)
 
 template<> inline vec8f_t & vec8f_t::operator+=(float v)
 { p = _mm256_add_ps(p, _mm256_set1_ps(v)); return *this; }
@@ -1428,12 +1568,12 @@ template<> inline vec8f_t & vec8f_t::operator*=(float v)
 template<> inline vec8f_t & vec8f_t::operator/=(float v)
 { p = _mm256_div_ps(p, _mm256_set1_ps(v)); return *this; }
 
-MEMBER_CMP_OPS_(vec8f_t, __m256, _mm256_, _ps, 0xFF)
+MEMBER_CMP_OPS_(float,8,__m256,_mm256_,_ps,0xFF)
 
-template<> inline float vec8f_t::dot(const vec8f_t & op2) const
-{ return _mm_cvtss_f32(_mm256_castps256_ps128(dot_packed(op2))); }
 template<> inline __m256 vec8f_t::dot_packed(const vec8f_t & op2) const
 { return math_t::dot_packed(p, op2.p); }
+template<> inline float vec8f_t::dot(const vec8f_t & op2) const
+{ return _mm_cvtss_f32(_mm256_castps256_ps128(dot_packed(op2))); }
 template<> inline float vec8f_t::sqlen() const { return dot(*this); }
 template<> inline __m256 vec8f_t::sqlen_packed() const { return dot_packed(*this); }
 template<> inline float vec8f_t::len() const { return math_t::sqrt(dot(*this)); }
@@ -1442,10 +1582,19 @@ template<> inline void vec8f_t::normalize() {
     float sqlen_ = sqlen(); __m256 x = _mm256_set1_ps(sqlen_);
     p = _mm256_mul_ps(p, math_t::inv_sqrt_packed(x));
 }
-template<> inline void vec8f_t::normalize_packed()
-{ p = _mm256_mul_ps(p, math_t::inv_sqrt_packed(sqlen_packed())); }
+template<> inline vec8f_t & vec8f_t::normalize_packed()
+{ p = _mm256_mul_ps(p, math_t::inv_sqrt_packed(sqlen_packed())); return *this; }
 template<> inline void vec8f_t::clamp_0_1()
 { p = _mm256_max_ps(math_t::zeroes(), _mm256_min_ps(p, math_t::ones())); }
+template<> inline vec8f_t vec8f_t::min_(const vec8f_t & v0, const vec8f_t & v1)
+{ return vec8f_t(_mm256_min_ps(v0.p, v1.p)); }
+template<> inline vec8f_t vec8f_t::max_(const vec8f_t & v0, const vec8f_t & v1)
+{ return vec8f_t(_mm256_max_ps(v0.p, v1.p)); }
+template<> inline void vec8f_t::abs_()
+{ p = _mm256_and_ps(math_t::abs_mask(), p); }
+template<> inline vec8f_t vec8f_t::abs_() const
+{ vec8f_t ret(p); ret.abs_(); return ret; }
+MEMBER_ROUND_OPS_(float,8,__m256,_ps)
 /*
 template<> inline vec8f_t vec8f_t::cross(const vec8f_t &) const;
 template<> inline __m256 vec8f_t::cross_packed(const vec8f_t &) const;
@@ -1453,9 +1602,9 @@ template<> inline vec8f_t vec8f_t::unit_cross(const vec8f_t &) const;
 template<> inline __m256 vec8f_t::unit_cross_packed(const vec8f_t &) const;
 */
 
-FREE_ARITH_OPS_(vec8f_t,__m256,float,_mm256_,_ps)
+FREE_ARITH_OPS_(float,8,__m256,_mm256_,_ps)
 
-FREE_BIT_OPS_(vec8f_t,__m256,_mm256_,_ps)
+FREE_BIT_OPS_(float,8,__m256,_mm256_,_ps)
 
 // unary minus
 inline vec8f_t operator-(const vec8f_t & v)
@@ -1492,7 +1641,7 @@ inline __m256 dot_packed_4(const vec8f_t & v00, const vec8f_t & v01,
     return
         _mm256_insertf128_ps(
             _mm256_insertf128_ps(
-                math_t<float,__m256>::zeroes(),
+                _mm256_setzero_ps(),
                 tmp0_128,
                 0
             ), // {0,0,0,0,d3,d2,d1,d0}
@@ -1540,7 +1689,7 @@ inline __m256 dot_packed_8(const vec8f_t & v00, const vec8f_t & v01,
     return
         _mm256_insertf128_ps(
             _mm256_insertf128_ps(
-                math_t<float,__m256>::zeroes(),
+                _mm256_setzero_ps(),
                 _mm_shuffle_ps(
                     _mm256_extractf128_ps(tmp0, 0), // {d1{2},d0{2}}
                     _mm256_extractf128_ps(tmp0, 1), // {d3{2},d2{2}}
@@ -1563,6 +1712,22 @@ inline vec8f_t eval_line(const vec8f_t & origin, float t, const vec8f_t & dir)
 inline vec8f_t eval_line_packed(const vec8f_t & origin, __m256 t, const vec8f_t & dir)
 { return vec8f_t(origin + (t * dir)); }
 
+// load aligned
+template<> inline void vec8f_t::loada(const float * ptr)
+{ p = _mm256_load_ps(ptr); }
+// load unaligned
+template<> inline void vec8f_t::loadu(const float * ptr)
+{ p = _mm256_loadu_ps(ptr); }
+// store aligned
+template<> inline void vec8f_t::storea(float * ptr)
+{ _mm256_store_ps(ptr, p); }
+// store unaligned
+template<> inline void vec8f_t::storeu(float * ptr)
+{ _mm256_storeu_ps(ptr, p); }
+
+#undef vec4d_t
+#undef vec8f_t
+
 #endif // AVX
 
 #endif // defined(PVECF_INTEL)
@@ -1587,21 +1752,22 @@ typedef vecf_t<float,4,__n128> PVECF_ALIGN(8) vec4f_t;
 // packed double precision floating point calculations are supported starting
 // with SSE2
 #if defined(SSE2) || defined(AVX)
-typedef vecf_t<double,2,__m128d> __declspec(align(16)) vec2d_t;
+typedef vecf_t<double,2,__m128d> PVECF_ALIGN(16) vec2d_t;
 #endif
 
 ////typedef vecf_t<double,3,__m128d> vec3d_t;
-// TODO: add a complex_2d_t class with operators defined otherwise
-//       (elementwise-add, -sub, multiplication, division)
-// then: do the same for float, use __m128 there but just ignore the upper
-//       two floats in all operations
-// this needs to be coupled with a nicer interface specifically designed for
-// complex numbers (e.g. a conj() operation, etc.)
+// complex numbers (complex2d_t, complex4f_t, complex8f_t): see pcomplex.h
 #ifdef AVX
-typedef vecf_t<float,8,__m256> __declspec(align(32)) vec8f_t;
-typedef vecf_t<double,4,__m256d> __declspec(align(32)) vec4d_t;
+typedef vecf_t<float,8,__m256> PVECF_ALIGN(32) vec8f_t;
+typedef vecf_t<double,4,__m256d> PVECF_ALIGN(32) vec4d_t;
 #endif // AVX
 
+namespace ipriv {
+    // element type of a vector type, veci_t in pveci.h
+    template<typename V> struct vec_elem;
+    template<typename R, unsigned N, typename P> struct vec_elem<vecf_t<R,N,P> > { typedef R type; };
+}
+
 
 // packed double precision floating point calculations are supported starting
 // with SSE2
@@ -1782,6 +1948,7 @@ public:
     inline vecf_t transform(const vecf_t & vec) const;
     inline void transform_many(vecf_t * vecs, size_t count) const
     {
+        PVEC_PROBE_N("mat_t::transform_many()", count);
         for(unsigned i = 0; i < count; ++i) {
             transform(vecs[i]);
         }
@@ -1826,22 +1993,19 @@ template<> inline vec4f_t mat4f_t::row(size_t row) const
 { return vec4f_t(m[row]); }
 template<> inline void mat4f_t::set_identity()
 {
-    m[0] = m[1] = m[2] = m[3] = math_t::zeroes();
-    vec4f_t row_(row(0));
-    row_[0] = 1.0f;
-    set_row(0, row_);
-
-    row_ = row(1);
-    row_[1] = 1.0f;
-    set_row(1, row_);
-
-    row_ = row(2);
-    row_[2] = 1.0f;
-    set_row(2, row_);
-
-    row_ = row(3);
-    row_[3] = 1.0f;
-    set_row(3, row_);
+#if defined(PVECF_INTEL)
+    // {1,0,0,0} moved into place by shuffles, no memory round trip
+    packed_t e0 = _mm_move_ss(math_t::zeroes(), math_t::ones());
+    m[0] = e0;
+    m[1] = _mm_shuffle_ps(e0, e0, _MM_SHUFFLE(1,1,0,1));
+    m[2] = _mm_shuffle_ps(e0, e0, _MM_SHUFFLE(1,0,1,1));
+    m[3] = _mm_shuffle_ps(e0, e0, _MM_SHUFFLE(0,1,1,1));
+#elif defined(PVECF_ARM)
+    m[0] = vsetq_lane_f32(1.0f, math_t::zeroes(), 0);
+    m[1] = vsetq_lane_f32(1.0f, math_t::zeroes(), 1);
+    m[2] = vsetq_lane_f32(1.0f, math_t::zeroes(), 2);
+    m[3] = vsetq_lane_f32(1.0f, math_t::zeroes(), 3);
+#endif
 }
 template<> inline mat4f_t mat4f_t::identity()
 {
@@ -2467,11 +2631,13 @@ inline mat4f_t operator*(float s, const mat4f_t & m)
 { return mat4f_t(m) *= s; }
 
 template<> inline mat4f_t mat4f_t::inverse() const
-{ float det_ = det();
+{ PVEC_PROBE("mat4f_t::inverse()");
+  float det_ = det();
   if(almost_equal(det_, 0.0f)) return mat4f_t(); // no inverse -> zero matrix
   return (1.0f / det_) * adjugate(); }
 template<> inline void mat4f_t::inverse()
-{ float det_ = det();
+{ PVEC_PROBE("mat4f_t::inverse()");
+  float det_ = det();
   if(almost_equal(det_, 0.0f)) m[0] = m[1] = m[2] = m[3] = math_t::zeroes();
   adjugate();
   float inv = 1.0f / det_;
@@ -2518,12 +2684,12 @@ inline vec4f_t operator*(const mat4f_t & m, const vec4f_t & vec) { return m.tran
 //
 template<> inline mat2d_t::mat_t()
 { m[0] = m[1] = math_t::zeroes(); }
+template<> inline void mat2d_t::set_identity()
+{ m[0] = _mm_move_sd(math_t::zeroes(), math_t::ones());   // {1,0}
+  m[1] = _mm_move_sd(math_t::ones(), math_t::zeroes()); } // {0,1}
 template<> inline mat2d_t mat2d_t::identity()
-{ static const __m128d rows[] = {{1.0, 0.0}, {0.0, 1.0}}; return mat2d_t(rows); }
+{ mat2d_t ret; ret.set_identity(); return ret; }
 template<> inline mat2d_t mat2d_t::zero() { return mat2d_t(); }
-template<> inline void mat2d_t::set_identity()
-{ static const __m128d rows[] = {{1.0, 0.0}, {0.0, 1.0}};
-  m[0] = rows[0]; m[1] = rows[1]; }
 template<> inline vec2d_t mat2d_t::row(size_t row) const
 { return vec2d_t(m[row]);  }
 template<> inline vec2d_t mat2d_t::col(size_t col) const
@@ -2619,11 +2785,13 @@ template<> inline void mat2d_t::adjugate()
 inline mat2d_t operator*(double s, const mat2d_t & m) { return s * m; }
 
 template<> inline mat2d_t mat2d_t::inverse() const
-{ double det_ = det();
+{ PVEC_PROBE("mat2d_t::inverse()");
+  double det_ = det();
   if(almost_equal(det_, 0.0)) return mat2d_t(); // no inverse -> zero matrix
   return (1.0 / det_) * adjugate(); }
 template<> inline void mat2d_t::inverse()
-{ double det_ = det();
+{ PVEC_PROBE("mat2d_t::inverse()");
+  double det_ = det();
   if(almost_equal(det_, 0.0)) m[0] = m[1] = math_t::zeroes();
   adjugate();
   double inv = 1.0 / det_;
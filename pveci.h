@@ -34,12 +34,9 @@
 // - free-standing operator{*,/} for all types (standard multi (no high/low, no widening))
 // - shuffle operations for [u]int32x4_t and [u]int64x2_t (for [u]int8_t and [u]int16_t elements
 //   the number of combos is too large)
-// - shift operations
-//   * element-wise
-//   * full register shifts (identical impl for all types)
-// - rotation operations
-//   * element-wise
-//   * full register rotation (identical impl for all types)
+// - element-wise shifts with per-element counts as public shl/shr overloads (the
+//   vpsllv*/vpsrlv* paths exist inside rotl(v, vn)/rotr(v, vn))
+// - full register rotation (identical impl for all types)
 
 // - add C++03 compatibility (or even C++98 but low pri)
 
@@ -66,8 +63,7 @@ constants above have to be generated:
 // TODO:
 // - get rid of the operator overloads for packed_t by providing a conversion
 //   operator t_packed t_packed() const { return p; }
-// - shift ops
-// - rotate ops (XOP has instructions, AMD only)
+// - rotate ops per XOP (AMD only)
 // - ...
 
 namespace math {
@@ -78,6 +74,57 @@ namespace ipriv {
     // ...
     template<bool cond, typename T = void> struct enable_if {};
     template<typename T> struct enable_if<true,T> { typedef T type; };
+
+#if defined(PVECI_INTEL)
+    // 64 bit element comparisons returning per element masks; emulated per
+    // 32 bit comparisons below SSE4.1 (pcmpeqq) and SSE4.2 (pcmpgtq)
+    inline __m128i cmpeq_epi64(__m128i a, __m128i b)
+    {
+# if defined(SSE4)
+        return _mm_cmpeq_epi64(a, b);
+# else
+        PVEC_PROBE_N("cmpeq_epi64() [u]int64_t x 2 (emulation below SSE4.1)", 2);
+        __m128i eq = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2,3,0,1)));
+# endif
+    }
+
+    inline __m128i cmpgt_epi64(__m128i a, __m128i b)
+    {
+# if defined(SSE4_2)
+        return _mm_cmpgt_epi64(a, b);
+# else
+#   pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1 do not provide comparison operations for packed [u]int64_t x 2")
+        PVEC_PROBE_N("cmpgt_epi64() [u]int64_t x 2 (emulation below SSE4.2)", 2);
+        // signed comparison of the upper dwords, unsigned one of the lower dwords:
+        // gt = gt(upper) | (eq(upper) & gt(lower)), then broadcast the upper result
+        __m128i bias = _mm_srli_epi64(imath_t<int64_t,__m128i>::sign_mask(), 32); // {0x0000000080000000}*2
+        __m128i gt = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+        __m128i eq = _mm_cmpeq_epi32(a, b);
+        return
+            _mm_shuffle_epi32(
+                _mm_or_si128(gt, _mm_and_si128(eq, _mm_slli_epi64(gt, 32))),
+                _MM_SHUFFLE(3,3,1,1)
+            );
+# endif
+    }
+
+    inline __m128i cmpgt_epu64(__m128i a, __m128i b)
+    {
+        __m128i mask = imath_t<uint64_t,__m128i>::sign_mask();
+        return cmpgt_epi64(_mm_xor_si128(a, mask), _mm_xor_si128(b, mask));
+    }
+
+    // selects the bytes of b where the mask bytes have their MSB set, those of a otherwise
+    inline __m128i blendv_epi8(__m128i a, __m128i b, __m128i mask)
+    {
+# if defined(SSE4)
+        return _mm_blendv_epi8(a, b, mask);
+# else
+        return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+# endif
+    }
+#endif // defined(PVECI_INTEL)
 } // namespace ipriv
 
 
@@ -173,6 +220,7 @@ public:
         t_type v8, t_type v9, t_type va, t_type vb, t_type vc, t_type vd, t_type ve, t_type vf
     );
     // remaining overloads for AVX/AVX2 (t_type==uint8_t, N==32) considered impractical
+    // (use the initializer list or the pointer constructor)
     // remaining overloads for AVX512 considered impractical
 
     inline veci_t(const t_type * p) { for(unsigned i = 0; i < N; ++i) v[i] = p[i]; }
@@ -256,8 +304,8 @@ public:
 #if defined(PVECI_INTEL)
     inline veci_t operator~() const
     {
-        // TODO: this impl is SSE2, not AVX/AVX2 (128 bits wide vectors only)
-        return veci_t(_mm_xor_si128(p, math_t::onebits()));
+        // (SSE2 and AVX2 alike)
+        return veci_t(p) ^= math_t::onebits();
     }
 #elif defined(PVECI_ARM)
     inline veci_t operator~() const;
@@ -608,12 +656,11 @@ template<> inline veci_i8x16_t veci_i8x16_t::min_(packed_t p1, packed_t p2)
 #   if defined(SSE4)
     return veci_i8x16_t(_mm_min_epi8(p1, p2));
 #   else
-#   pragma message("performance warning: SSE2 does not provide min() for packed int8_t x 16")
-    veci_i8x16_t ret, v1(p1), v2(p2);
-    for(int i = 0; i < 16; ++i)
-        ret[i] = (std::min)(v1[i], v2[i]);
-    return ret;
-#endif
+    PVEC_PROBE_N("min() int8_t x 16 (SSE2 emulation)", 16);
+    // unsigned min of the values with flipped sign bits
+    __m128i mask = math_t::sign_mask();
+    return veci_i8x16_t(_mm_xor_si128(_mm_min_epu8(_mm_xor_si128(p1, mask), _mm_xor_si128(p2, mask)), mask));
+#   endif
 #elif defined(PVECI_ARM)
     return veci_i8x16_t(vminq_s8(p1, p2));
 #endif
@@ -628,12 +675,11 @@ template<> inline veci_i8x16_t veci_i8x16_t::max_(packed_t p1, packed_t p2)
 #   if defined(SSE4)
     return veci_i8x16_t(_mm_max_epi8(p1, p2));
 #   else
-#   pragma message("performance warning: SSE2 does not provide min() for packed int8_t x 16")
-    veci_i8x16_t ret, v1(p1), v2(p2);
-    for(int i = 0; i < 16; ++i)
-        ret[i] = (std::max)(v1[i], v2[i]);
-    return ret;
-#endif
+    PVEC_PROBE_N("max() int8_t x 16 (SSE2 emulation)", 16);
+    // unsigned max of the values with flipped sign bits
+    __m128i mask = math_t::sign_mask();
+    return veci_i8x16_t(_mm_xor_si128(_mm_max_epu8(_mm_xor_si128(p1, mask), _mm_xor_si128(p2, mask)), mask));
+#   endif
 #elif defined(PVECI_ARM)
     return veci_i8x16_t(vmaxq_s8(p1, p2));
 #endif
@@ -678,6 +724,7 @@ template<> template<> inline void veci_i8x16_t::abs_()
     p = _mm_abs_epi8(p);
 # else
 #   pragma message("performance warning: SSE2 does not provide abs() for packed int8_t x 16")
+    PVEC_PROBE_N("abs() int8_t x 16 (SSE2 emulation)", 16);
     __m128i negmask = _mm_cmplt_epi8(p, _mm_setzero_si128()); // v>=0 -> 0x00, v<0 -> 0xFF
     p = 
         _mm_sub_epi8(
@@ -1140,6 +1187,7 @@ template<> inline veci_ui8x16_t & veci_ui8x16_t::operator^=(const veci_ui8x16_t
 
 
 // packed vector comparisons
+// unsigned comparisons per max(), all(a <= b) <=> all(max(a,b) == b)
 // (impl postponed for ARM NEON)
 #ifdef PVECI_INTEL
 template<> inline bool veci_ui8x16_t::operator==(packed_t v2) const
@@ -1163,14 +1211,7 @@ template<> inline bool veci_ui8x16_t::operator!=(packed_t v2) const
 template<> inline bool veci_ui8x16_t::operator<(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-#pragma message("performance warning: SSE2 does not provide comparison operations for packed uint8_t x 16")
-    return
-        _mm_movemask_epi8(
-            _mm_cmplt_epi8(
-                _mm_xor_si128(p, math_t::sign_mask()),
-                _mm_xor_si128(v2, math_t::sign_mask())
-            )
-        ) == 0xFFFF;
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(p, v2), p)) == 0x0000;
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -1179,15 +1220,7 @@ template<> inline bool veci_ui8x16_t::operator<(packed_t v2) const
 template<> inline bool veci_ui8x16_t::operator<=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-#pragma message("performance warning: SSE2 does not provide comparison operations for packed uint8_t x 16")
-    //static_assert(false, "not implemented yet");
-    return
-        _mm_movemask_epi8(
-            _mm_cmpgt_epi8(
-                _mm_xor_si128(p, math_t::sign_mask()),
-                _mm_xor_si128(v2, math_t::sign_mask())
-            )
-        ) == 0x0000;
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(p, v2), v2)) == 0xFFFF;
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -1196,14 +1229,7 @@ template<> inline bool veci_ui8x16_t::operator<=(packed_t v2) const
 template<> inline bool veci_ui8x16_t::operator>(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-#pragma message("performance warning: SSE2 does not provide comparison operations for packed uint8_t x 16")
-    return
-        _mm_movemask_epi8(
-            _mm_cmpgt_epi8(
-                _mm_xor_si128(p, math_t::sign_mask()),
-                _mm_xor_si128(v2, math_t::sign_mask())
-            )
-        ) == 0xFFFF;
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(p, v2), v2)) == 0x0000;
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -1212,14 +1238,7 @@ template<> inline bool veci_ui8x16_t::operator>(packed_t v2) const
 template<> inline bool veci_ui8x16_t::operator>=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-#pragma message("performance warning: SSE2 does not provide comparison operations for packed uint8_t x 16")
-    return
-        _mm_movemask_epi8(
-            _mm_cmplt_epi8(
-                _mm_xor_si128(p, math_t::sign_mask()),
-                _mm_xor_si128(v2, math_t::sign_mask())
-            )
-        ) == 0x0000;
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(p, v2), p)) == 0xFFFF;
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -1803,6 +1822,7 @@ template<> template<> inline void veci_i16x8_t::abs_()
     p = _mm_abs_epi16(p);
 # else
 #   pragma message("performance warning: SSE2 does not provide abs() for packed int16_t x 8")
+    PVEC_PROBE_N("abs() int16_t x 8 (SSE2 emulation)", 8);
     __m128i mask = _mm_srai_epi16(p, 15); // (...SSSS,...) -> 0 for positive, -1 for negative
     // result = S==0 ? x-0 : ~x-(-1)
     p = 
@@ -2167,6 +2187,7 @@ template<> inline veci_ui16x8_t & veci_ui16x8_t::operator^=(const veci_ui16x8_t
 
 
 // packed vector comparisons
+// unsigned comparisons per max() for SSE4.1, all(a <= b) <=> all(max(a,b) == b)
 // (impl postponed for ARM NEON)
 #ifdef PVECI_INTEL
 template<> inline bool veci_ui16x8_t::operator==(packed_t v2) const
@@ -2188,6 +2209,9 @@ template<> inline bool veci_ui16x8_t::operator!=(packed_t v2) const
 template<> inline bool veci_ui16x8_t::operator<(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_max_epu16(p, v2), p)) == 0x0000;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmplt_epi16(
@@ -2195,6 +2219,7 @@ template<> inline bool veci_ui16x8_t::operator<(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0xFFFF;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -2202,6 +2227,9 @@ template<> inline bool veci_ui16x8_t::operator<(packed_t v2) const
 template<> inline bool veci_ui16x8_t::operator<=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_max_epu16(p, v2), v2)) == 0xFFFF;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmpgt_epi16(
@@ -2209,6 +2237,7 @@ template<> inline bool veci_ui16x8_t::operator<=(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0x0000;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -2216,6 +2245,9 @@ template<> inline bool veci_ui16x8_t::operator<=(packed_t v2) const
 template<> inline bool veci_ui16x8_t::operator>(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_max_epu16(p, v2), v2)) == 0x0000;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmpgt_epi16(
@@ -2223,6 +2255,7 @@ template<> inline bool veci_ui16x8_t::operator>(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0xFFFF;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -2230,6 +2263,9 @@ template<> inline bool veci_ui16x8_t::operator>(packed_t v2) const
 template<> inline bool veci_ui16x8_t::operator>=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_max_epu16(p, v2), p)) == 0xFFFF;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmplt_epi16(
@@ -2237,6 +2273,7 @@ template<> inline bool veci_ui16x8_t::operator>=(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0x0000;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -2283,22 +2320,8 @@ template<> inline veci_ui16x8_t veci_ui16x8_t::min_(packed_t p1, packed_t p2)
 # if defined(SSE4)
     return veci_ui16x8_t(_mm_min_epu16(p1, p2));
 # else
-#   pragma message("performance warning: SSE2 does not provide min() for packed uint16_t x 8")
-#   if 1
-    veci_ui16x8_t ret, v1(p1), v2(p2);
-    for(int i = 0; i < 8; ++i) ret[i] = (std::min)(v1[i], v2[i]);
-    return ret;
-#   else
-    // TODO: this may be wrong because _mm_cmplt_epi16() does a signed comparison
-    __m128i mask = _mm_cmplt_epi16(p1, p2); // p1[i]<p[2]->0xFFFF, p1[i]>=p2[i]->0x0000
-    return
-        uivec16x8_t(
-            _mm_or_si128(
-                _mm_and_si128(mask, p1),    // mask[i]==0x0000->0, mask[i]==0xFFFF->p1[i]
-                _mm_andnot_si128(mask, p2)  // mask[i]==0x0000->p2[i], mask[i]==0xFFFF->0
-            )
-        );
-#   endif
+    // min(a,b) = a - sat(a - b)
+    return veci_ui16x8_t(_mm_sub_epi16(p1, _mm_subs_epu16(p1, p2)));
 # endif
 #elif defined(PVECI_ARM)
     return veci_ui16x8_t(vminq_u16(p1, p2));
@@ -2313,22 +2336,8 @@ template<> inline veci_ui16x8_t veci_ui16x8_t::max_(packed_t p1, packed_t p2)
 # if defined(SSE4)
     return veci_ui16x8_t(_mm_max_epu16(p1, p2));
 # else
-#   pragma message("performance warning: SSE2 does not provide max() for packed uint16_t x 8")
-#   if 1
-    veci_ui16x8_t ret, v1(p1), v2(p2);
-    for(int i = 0; i < 8; ++i) ret[i] = (std::max)(v1[i], v2[i]);
-    return ret;
-#   else
-    // TODO: this may be wrong because _mm_cmpgt_epi16() does a signed comparison
-    __m128i mask = _mm_cmpgt_epi16(p1, p2); // p1[i]>p[2]->0xFFFF, p1[i]<=p2[i]->0x0000
-    return
-        uivec16x8_t(
-            _mm_or_si128(
-                _mm_and_si128(mask, p1),    // mask[i]==0x0000->0, mask[i]==0xFFFF->p1[i]
-                _mm_andnot_si128(mask, p2)  // mask[i]==0x0000->p2[i], mask[i]==0xFFFF->0
-            )
-        );
-#   endif
+    // max(a,b) = b + sat(a - b)
+    return veci_ui16x8_t(_mm_add_epi16(p2, _mm_subs_epu16(p1, p2)));
 # endif
 #elif defined(PVECI_ARM)
     return veci_ui16x8_t(vmaxq_u16(p1, p2));
@@ -2759,6 +2768,7 @@ template<> inline veci_i32x4_t veci_i32x4_t::min_(packed_t p1, packed_t p2)
     return veci_i32x4_t(_mm_min_epi32(p1, p2));
 # else
 #   pragma message("performance warning: SSE2 does not provide min() for packed int32_t x 4")
+    PVEC_PROBE_N("min() int32_t x 4 (SSE2 emulation)", 4);
     __m128i mask = _mm_cmplt_epi32(p1, p2); // p1[i]>=p2[i]->mask[i]=0x00, p1[i]<p2[i]->mask[i]=0xFF..
     return
         veci_i32x4_t(
@@ -2782,6 +2792,7 @@ template<> inline veci_i32x4_t veci_i32x4_t::max_(packed_t p1, packed_t p2)
     return veci_i32x4_t(_mm_max_epi32(p1, p2));
 # else
 #   pragma message("performance warning: SSE2 does not provide max() for packed int32_t x 4")
+    PVEC_PROBE_N("max() int32_t x 4 (SSE2 emulation)", 4);
     __m128i mask = _mm_cmpgt_epi32(p1, p2); // p1[i]>p2[i]->mask[i]=0xFF.., p1[i]<=p2[i]->mask[i]=0x00
     return
         veci_i32x4_t(
@@ -2807,6 +2818,7 @@ template<> template<> inline void veci_i32x4_t::abs_()
     p = _mm_abs_epi32(p);
 # else
 #   pragma message("performance warning: SSE2 does not provide abs() for packed int32_t x 4")
+    PVEC_PROBE_N("abs() int32_t x 4 (SSE2 emulation)", 4);
     __m128i mask = _mm_srai_epi32(p, 31); // extract sign bit into all elem bits
     p = _mm_sub_epi32(_mm_xor_si128(p, mask), mask); // subtract 0 if positive, invert an subtract -1 if negative
 # endif
@@ -3930,6 +3942,7 @@ template<> inline veci_ui32x4_t & veci_ui32x4_t::operator^=(const veci_ui32x4_t
 
 
 // packed vector comparisons
+// unsigned comparisons per max() for SSE4.1, all(a <= b) <=> all(max(a,b) == b)
 // (impl postponed for ARM NEON)
 #ifdef PVECI_INTEL
 template<> inline bool veci_ui32x4_t::operator==(packed_t v2) const
@@ -3951,6 +3964,9 @@ template<> inline bool veci_ui32x4_t::operator!=(packed_t v2) const
 template<> inline bool veci_ui32x4_t::operator<(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_max_epu32(p, v2), p)) == 0x0000;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmplt_epi32(
@@ -3958,6 +3974,7 @@ template<> inline bool veci_ui32x4_t::operator<(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0xFFFF;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -3965,6 +3982,9 @@ template<> inline bool veci_ui32x4_t::operator<(packed_t v2) const
 template<> inline bool veci_ui32x4_t::operator<=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_max_epu32(p, v2), v2)) == 0xFFFF;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmpgt_epi32(
@@ -3972,6 +3992,7 @@ template<> inline bool veci_ui32x4_t::operator<=(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0x0000;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -3979,6 +4000,9 @@ template<> inline bool veci_ui32x4_t::operator<=(packed_t v2) const
 template<> inline bool veci_ui32x4_t::operator>(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_max_epu32(p, v2), v2)) == 0x0000;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmpgt_epi32(
@@ -3986,6 +4010,7 @@ template<> inline bool veci_ui32x4_t::operator>(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0xFFFF;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -3993,6 +4018,9 @@ template<> inline bool veci_ui32x4_t::operator>(packed_t v2) const
 template<> inline bool veci_ui32x4_t::operator>=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
+# if defined(SSE4)
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_max_epu32(p, v2), p)) == 0xFFFF;
+# else
     return
         _mm_movemask_epi8(
             _mm_cmplt_epi32(
@@ -4000,6 +4028,7 @@ template<> inline bool veci_ui32x4_t::operator>=(packed_t v2) const
                 _mm_xor_si128(v2, math_t::sign_mask())
             )
         ) == 0x0000;
+# endif
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -4047,11 +4076,13 @@ template<> inline veci_ui32x4_t veci_ui32x4_t::min_(packed_t p1, packed_t p2)
 # if defined(SSE4)
     return veci_ui32x4_t(_mm_min_epu32(p1, p2));
 # else
-#   pragma message("performance warning: SSE2 does not provide min() for packed uint32_t x 4")
-    veci_ui32x4_t ret, v1(p1), v2(p2);
-    for(int i = 0; i < 4; ++i)
-        ret[i] = (std::min)(v1[i], v2[i]);
-    return ret;
+    PVEC_PROBE_N("min() uint32_t x 4 (SSE2 emulation)", 4);
+    __m128i mask = // p1[i]>p2[i]->mask[i]=0xFF.., p1[i]<=p2[i]->mask[i]=0x00
+        _mm_cmpgt_epi32(
+            _mm_xor_si128(p1, math_t::sign_mask()),
+            _mm_xor_si128(p2, math_t::sign_mask())
+        );
+    return veci_ui32x4_t(ipriv::blendv_epi8(p1, p2, mask));
 # endif
 #elif defined(PVECI_ARM)
     return veci_ui32x4_t(vminq_u32(p1, p2));
@@ -4066,11 +4097,13 @@ template<> inline veci_ui32x4_t veci_ui32x4_t::max_(packed_t p1, packed_t p2)
 # if defined(SSE4)
     return veci_ui32x4_t(_mm_max_epu32(p1, p2));
 # else
-#   pragma message("performance warning: SSE2 does not provide max() for packed uint32_t x 4")
-    veci_ui32x4_t ret, v1(p1), v2(p2);
-    for(int i = 0; i < 4; ++i)
-        ret[i] = (std::max)(v1[i], v2[i]);
-    return ret;
+    PVEC_PROBE_N("max() uint32_t x 4 (SSE2 emulation)", 4);
+    __m128i mask = // p1[i]>p2[i]->mask[i]=0xFF.., p1[i]<=p2[i]->mask[i]=0x00
+        _mm_cmpgt_epi32(
+            _mm_xor_si128(p1, math_t::sign_mask()),
+            _mm_xor_si128(p2, math_t::sign_mask())
+        );
+    return veci_ui32x4_t(ipriv::blendv_epi8(p2, p1, mask));
 # endif
 #elif defined(PVECI_ARM)
     return veci_ui32x4_t(vmaxq_u32(p1, p2));
@@ -5194,20 +5227,16 @@ template<> inline veci_i64x2_t & veci_i64x2_t::operator^=(const veci_i64x2_t & v
 
 
 // packed vector comparisons
-// SSE2 doesn't provide 64bit comparisons; operators ==,!=,neq_one() are
-// implemented per other sized comparisons as only (un-)identical bit patterns
-// are relevant
+// SSE2 doesn't provide 64bit comparisons; the tiers are AVX-512VL (vpcmpq
+// into mask registers), SSE4.2 (pcmpgtq) and the 32 bit comparison based
+// emulation in ipriv::cmp{eq,gt}_epi64() for anything below
 
 // (impl postponed for ARM NEON)
 #ifdef PVECI_INTEL
 template<> inline bool veci_i64x2_t::operator==(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4)
-    return _mm_movemask_epi8(_mm_cmpeq_epi64(p, v2)) == 0xFFFF;
-# else
-    return _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2)) == 0xFFFF;
-# endif
+    return _mm_movemask_epi8(ipriv::cmpeq_epi64(p, v2)) == 0xFFFF;
 #elif defined(PVECI_ARM)
 
 #endif
@@ -5215,11 +5244,7 @@ template<> inline bool veci_i64x2_t::operator==(packed_t v2) const
 template<> inline bool veci_i64x2_t::operator!=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4)
-    return _mm_movemask_epi8(_mm_cmpeq_epi64(p, v2)) == 0x0000;
-# else
-    return _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2)) == 0x0000;
-# endif
+    return _mm_movemask_epi8(ipriv::cmpeq_epi64(p, v2)) == 0x0000;
 #elif defined(PVECI_ARM)
 
 #endif
@@ -5227,14 +5252,10 @@ template<> inline bool veci_i64x2_t::operator!=(packed_t v2) const
 template<> inline bool veci_i64x2_t::operator<(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4_2)
-#   pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide this comparison operation for packed int64_t x 2")
-    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi64(p, v2), _mm_cmpgt_epi64(p, v2))) == 0x0000;
+# if defined(AVX512VL)
+    return _mm_cmplt_epi64_mask(p, v2) == 0x3;
 # else
-#   pragma message("performance warning: SSE2 does not provide comparison operations for packed int64_t x 2")
-    int lt = _mm_movemask_epi8(_mm_cmplt_epi32(p, v2));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    return (lt & 0xF0F0) || ((eq & 0xF0F0) && (lt & 0x0F0F));
+    return _mm_movemask_epi8(ipriv::cmpgt_epi64(v2, p)) == 0xFFFF;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5243,13 +5264,10 @@ template<> inline bool veci_i64x2_t::operator<(packed_t v2) const
 template<> inline bool veci_i64x2_t::operator<=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4_2)
-    return _mm_movemask_epi8(_mm_cmpgt_epi64(p, v2)) == 0x0000;
+# if defined(AVX512VL)
+    return _mm_cmple_epi64_mask(p, v2) == 0x3;
 # else
-#   pragma message("performance warning: SSE2 does not provide comparison operations for packed int64_t x 2")
-    int lt = _mm_movemask_epi8(_mm_cmplt_epi32(p, v2));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    return (lt & 0xF0F0) || ((eq & 0xF0F0) && ((lt & 0x0F0F) || (eq & 0x0F0F)));
+    return _mm_movemask_epi8(ipriv::cmpgt_epi64(p, v2)) == 0x0000;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5258,13 +5276,10 @@ template<> inline bool veci_i64x2_t::operator<=(packed_t v2) const
 template<> inline bool veci_i64x2_t::operator>(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4_2)
-    return _mm_movemask_epi8(_mm_cmpgt_epi64(p, v2)) == 0xFFFF;
+# if defined(AVX512VL)
+    return _mm_cmpgt_epi64_mask(p, v2) == 0x3;
 # else
-#   pragma message("performance warning: SSE2 does not provide comparison operations for packed int64_t x 2")
-    int gt = _mm_movemask_epi8(_mm_cmpgt_epi32(p, v2));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    return (gt & 0xF0F0) || ((eq & 0xF0F0) && (gt & 0x0F0F));
+    return _mm_movemask_epi8(ipriv::cmpgt_epi64(p, v2)) == 0xFFFF;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5273,13 +5288,10 @@ template<> inline bool veci_i64x2_t::operator>(packed_t v2) const
 template<> inline bool veci_i64x2_t::operator>=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4_2)
-    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi64(p, v2), _mm_cmpgt_epi64(p, v2)) == 0xFFFF;
+# if defined(AVX512VL)
+    return _mm_cmpge_epi64_mask(p, v2) == 0x3;
 # else
-#   pragma message("performance warning: SSE2 does not provide comparison operations for packed int64_t x 2")
-    int gt = _mm_movemask_epi8(_mm_cmpgt_epi32(p, v2));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    return (gt & 0xF0F0) || ((eq & 0xF0F0) && ((gt & 0x0F0F) || (eq & 0x0F0F)));
+    return _mm_movemask_epi8(ipriv::cmpgt_epi64(v2, p)) == 0x0000;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5289,11 +5301,7 @@ template<> inline bool veci_i64x2_t::operator>=(packed_t v2) const
 template<> inline bool veci_i64x2_t::neq_one(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4)
-    return _mm_movemask_epi8(_mm_cmpeq_epi64(p, v2)) != 0xFFFF;
-# else
-    return _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2)) != 0xFFFF;
-# endif
+    return _mm_movemask_epi8(ipriv::cmpeq_epi64(p, v2)) != 0xFFFF;
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -5327,32 +5335,16 @@ template<> inline bool veci_i64x2_t::neq_one(const veci_i64x2_t & v2) const
 template<> inline veci_i64x2_t veci_i64x2_t::min_(packed_t p1, packed_t p2)
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4/SSE4.1 do not provide min() for packed int64_t x 2")
-    // destroy the larger value and or that with the other
-    //unsigned mask2 = ((val1 - val2) >> 63) - 1, mask1 = ~mask2;
-    //return (val1 & mask1) | (val2 & mask2);
-    __m128i mask =
-        _mm_shuffle_epi32(
-            _mm_cmpeq_epi32(
-                _mm_srli_epi64(
-                    _mm_sub_epi64(p1, p2),  // v1 - v2
-                    63
-                ),                          // shift sign bit
-                _mm_setzero_si128()         // convert to mask (cmpeq_epi64() would be better)
-            ),
-            0xA0
-        );                                  // get rid of high dword comparison results
-    return
-        veci_i64x2_t(
-            _mm_or_si128(
-                _mm_andnot_si128(mask, p1), // destroys larger value or keeps it
-                _mm_and_si128(mask, p2)     // dito
-            )
-        );
+# if defined(AVX512VL)
+    return veci_i64x2_t(_mm_min_epi64(p1, p2));
+# else
+    return veci_i64x2_t(ipriv::blendv_epi8(p1, p2, ipriv::cmpgt_epi64(p1, p2)));
+# endif
 #elif defined(PVECI_ARM)
 #if 1
     // implemented in scalar code for now
 # pragma message("performance warning: NEON does not provide min() for packed int64_t x 2, scalar code is used")
+    PVEC_PROBE_N("min() int64_t x 2 (NEON, scalar)", 2);
     veci_i64x2_t ret, v1(p1), v2(p2);
     ret[0] = (std::min)(v1[0], v2[0]);
     ret[1] = (std::min)(v1[1], v2[1]);
@@ -5410,30 +5402,16 @@ template<> inline veci_i64x2_t veci_i64x2_t::min_(const veci_i64x2_t & v1, const
 template<> inline veci_i64x2_t veci_i64x2_t::max_(packed_t p1, packed_t p2)
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4/SSE4.1 do not provide max() for packed int64_t x 2")
-    // destroy the smaller value and or that with the other
-    __m128i mask =
-        _mm_shuffle_epi32(
-            _mm_cmpeq_epi32(
-                _mm_srli_epi64(
-                    _mm_sub_epi64(p1, p2), // v1 - v2
-                    63
-                ),                         // shift sign bit
-                _mm_setzero_si128()        // convert to mask (cmpeq_epi64() would be better)
-            ),
-            0xA0
-        );                                 // get rid of high dword comparison results
-    return
-        veci_i64x2_t(
-            _mm_or_si128(
-                _mm_and_si128(mask, p1),   // destroys smaller value or keeps it
-                _mm_andnot_si128(mask, p2) // dito
-            )
-        );
+# if defined(AVX512VL)
+    return veci_i64x2_t(_mm_max_epi64(p1, p2));
+# else
+    return veci_i64x2_t(ipriv::blendv_epi8(p2, p1, ipriv::cmpgt_epi64(p1, p2)));
+# endif
 #elif defined(PVECI_ARM)
 #if 1
     // implemented in scalar code for now
 # pragma message("performance warning: NEON does not provide max() for packed int64_t x 2, scalar code is used")
+    PVEC_PROBE_N("max() int64_t x 2 (NEON, scalar)", 2);
     /**/
     veci_i64x2_t ret, v1(p1), v2(p2);
     ret[0] = (std::max)(v1[0], v2[0]);
@@ -5477,12 +5455,16 @@ template<> inline veci_i64x2_t veci_i64x2_t::max_(const veci_i64x2_t & v1, const
 template<> template<> inline void veci_i64x2_t::abs_()
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2 does not provide abs() for packed int64_t x 2")
-    __m128i tmp = _mm_cmplt_epi32(p, math_t::zeroes());
-    __m128i mask = _mm_unpackhi_epi64(_mm_unpacklo_epi32(tmp, tmp), _mm_unpackhi_epi32(tmp, tmp));
+# if defined(AVX512VL)
+    p = _mm_abs_epi64(p);
+# else
+    // broadcast the sign bits of the upper dwords
+    __m128i mask = _mm_shuffle_epi32(_mm_srai_epi32(p, 31), _MM_SHUFFLE(3,3,1,1));
     p = _mm_sub_epi64(_mm_xor_si128(p, mask), mask);
+# endif
 #elif defined(PVECI_ARM)
 # pragma message("performance warning: NEON does not provide abs() for packed int64_t x 2")
+    PVEC_PROBE_N("abs() int64_t x 2 (NEON emulation)", 2);
     uint32x4_t tmp =
         vceqq_u32(
             vreinterpretq_u32_s64(p),
@@ -5881,16 +5863,14 @@ template<> inline veci_ui64x2_t & veci_ui64x2_t::operator^=(const veci_ui64x2_t
 
 
 // packed vector comparisons
+// unsigned tiers: AVX-512VL (vpcmpuq), SSE4.2 (pcmpgtq on values with flipped
+// sign bits), emulation per ipriv::cmpgt_epu64() below
 // (impl postponed for ARM NEON)
 #ifdef PVECI_INTEL
 template<> inline bool veci_ui64x2_t::operator==(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4)
-    return _mm_movemask_epi8(_mm_cmpeq_epi64(p, v2)) == 0xFFFF;
-# else
-    return _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2)) == 0xFFFF;
-# endif
+    return _mm_movemask_epi8(ipriv::cmpeq_epi64(p, v2)) == 0xFFFF;
 #elif defined(PVECI_ARM)
     XXX
 #endif
@@ -5899,11 +5879,7 @@ template<> inline bool veci_ui64x2_t::operator==(packed_t v2) const
 template<> inline bool veci_ui64x2_t::operator!=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4)
-    return _mm_movemask_epi8(_mm_cmpeq_epi64(p, v2)) == 0x0000;
-# else
-    return _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2)) == 0x0000;
-# endif
+    return _mm_movemask_epi8(ipriv::cmpeq_epi64(p, v2)) == 0x0000;
 #elif defined(PVECI_ARM)
 
 #endif
@@ -5912,24 +5888,10 @@ template<> inline bool veci_ui64x2_t::operator!=(packed_t v2) const
 template<> inline bool veci_ui64x2_t::operator<(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide this comparison operation for packed uint64_t x 2")
-# if defined(SSE4_2)
-    return
-        _mm_movemask_epi8(
-            _mm_or_si128(
-                _mm_cmpeq_epi64(p, v2),
-                _mm_cmpgt_epi64(
-                    _mm_xor_si128(p, math_t::sign_mask()),
-                    _mm_xor_si128(v2, math_t::sign_mask())
-                )
-            )
-        ) == 0x0000;
+# if defined(AVX512VL)
+    return _mm_cmplt_epu64_mask(p, v2) == 0x3;
 # else
-    __m128i mask = imath_t<uint32_t,__m128i>::sign_mask();
-    int lt = _mm_movemask_epi8(_mm_cmplt_epi32(_mm_xor_si128(p, mask), _mm_xor_si128(v2, mask)));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    // (upper(a) < upper(b)) | ((upper(a) == upper(b)) && (lower(a) < lower(b))
-    return (lt & 0xFF00) || ((eq & 0xFF00) && (lt & 0x00FF));
+    return _mm_movemask_epi8(ipriv::cmpgt_epu64(v2, p)) == 0xFFFF;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5939,20 +5901,10 @@ template<> inline bool veci_ui64x2_t::operator<(packed_t v2) const
 template<> inline bool veci_ui64x2_t::operator<=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide this comparison operation for packed uint64_t x 2")
-# if defined(SSE4_2)
-    return
-        _mm_movemask_epi8(
-            _mm_cmpgt_epi64(
-                _mm_xor_si128(p, math_t::sign_mask()),
-                _mm_xor_si128(v2, math_t::sign_mask())
-            )
-        ) == 0x0000;
+# if defined(AVX512VL)
+    return _mm_cmple_epu64_mask(p, v2) == 0x3;
 # else
-    __m128i mask = imath_t<uint32_t,__m128i>::sign_mask();
-    int lt = _mm_movemask_epi8(_mm_cmplt_epi32(_mm_xor_si128(p, mask), _mm_xor_si128(v2, mask)));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    return (lt & 0xF0F0) || ((eq & 0xF0F0) && ((lt & 0x0F0F) || (eq & 0x0F0F)));
+    return _mm_movemask_epi8(ipriv::cmpgt_epu64(p, v2)) == 0x0000;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5962,21 +5914,10 @@ template<> inline bool veci_ui64x2_t::operator<=(packed_t v2) const
 template<> inline bool veci_ui64x2_t::operator>(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide this comparison operation for packed uint64_t x 2")
-# if defined(SSE4_2)
-    return
-        _mm_movemask_epi8(
-            _mm_cmpgt_epi64(
-                _mm_xor_si128(p, math_t::sign_mask()),
-                _mm_xor_si128(v2, math_t::sign_mask())
-            )
-        ) == 0xFFFF;
+# if defined(AVX512VL)
+    return _mm_cmpgt_epu64_mask(p, v2) == 0x3;
 # else
-    __m128i mask = imath_t<uint32_t,__m128i>::sign_mask();
-    int gt = _mm_movemask_epi8(_mm_cmpgt_epi32(_mm_xor_si128(p, mask), _mm_xor_si128(v2, mask)));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    // (upper(a) > upper(b)) | ((upper(a) == upper(b)) && (lower(a) > lower(b))
-    return (gt & 0xF0F0) || ((eq & 0xF0F0) && (gt & 0x0F0F));
+    return _mm_movemask_epi8(ipriv::cmpgt_epu64(p, v2)) == 0xFFFF;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -5986,23 +5927,10 @@ template<> inline bool veci_ui64x2_t::operator>(packed_t v2) const
 template<> inline bool veci_ui64x2_t::operator>=(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide this comparison operation for packed uint64_t x 2")
-# if defined(SSE4_2)
-    return
-        _mm_movemask_epi8(
-            _mm_or_si128(
-                _mm_cmpeq_epi64(p, v2),
-                _mm_cmpgt_epi64(
-                    _mm_xor_si128(p, math_t::sign_mask()),
-                    _mm_xor_si128(v2, math_t::sign_mask())
-                )
-            )
-        ) == 0xFFFF;
+# if defined(AVX512VL)
+    return _mm_cmpge_epu64_mask(p, v2) == 0x3;
 # else
-    __m128i mask = imath_t<uint32_t,__m128i>::sign_mask();
-    int gt = _mm_movemask_epi8(_mm_cmpgt_epi32(_mm_xor_si128(p, mask), _mm_xor_si128(v2, mask)));
-    int eq = _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2));
-    return (gt & 0xF0F0) || ((eq & 0xF0F0) && ((gt & 0x0F0F) || (eq & 0x0F0F)));
+    return _mm_movemask_epi8(ipriv::cmpgt_epu64(v2, p)) == 0x0000;
 # endif
 #elif defined(PVECI_ARM)
     XXX
@@ -6013,20 +5941,13 @@ template<> inline bool veci_ui64x2_t::operator>=(packed_t v2) const
 template<> inline bool veci_ui64x2_t::neq_one(packed_t v2) const
 {
 #if defined(PVECI_INTEL)
-# if defined(SSE4)
-    return _mm_movemask_epi8(_mm_cmpeq_epi64(p, v2)) != 0xFFFF;
-# else
-    return _mm_movemask_epi8(_mm_cmpeq_epi32(p, v2)) != 0xFFFF;
-# endif
+    return _mm_movemask_epi8(ipriv::cmpeq_epi64(p, v2)) != 0xFFFF;
 #elif defined(PVECI_ARM)
     XXX
 #endif
 }
 
 // vector comparisons
-// SSE2 doesn't provide 64bit comparisons; operators ==,!=,neq_one() is
-// implemented per other sized comparisons as only (un-)identical bit patterns
-// are relevant
 template<> inline bool veci_ui64x2_t::operator==(const veci_ui64x2_t & v2) const
 { return operator==(v2.p); }
 
@@ -6060,18 +5981,22 @@ template<> inline bool veci_ui64x2_t::neq_one(const veci_ui64x2_t & v2) const
 template<> inline veci_ui64x2_t veci_ui64x2_t::min_(packed_t p1, packed_t p2)
 {
 #if defined(PVECI_INTEL)
-#   pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide min() for packed uint64_t x 2")
-    __m128i mask =_mm_shuffle_epi32(_mm_cmpeq_epi32(_mm_srli_epi64(_mm_sub_epi64(p1, p2), 63), _mm_setzero_si128()), 0xA0);
-    return veci_ui64x2_t(_mm_or_si128(_mm_andnot_si128(mask, p1), _mm_and_si128(mask, p2)));
+# if defined(AVX512VL)
+    return veci_ui64x2_t(_mm_min_epu64(p1, p2));
+# else
+    return veci_ui64x2_t(ipriv::blendv_epi8(p1, p2, ipriv::cmpgt_epu64(p1, p2)));
+# endif
 #elif defined(PVECI_ARM)
 #if 1
 # pragma message("performance warning: NEON does not provide min() for packed uint64_t x 2, scalar code is used")
+    PVEC_PROBE_N("min() uint64_t x 2 (NEON, scalar)", 2);
     veci_ui64x2_t ret, v1(p1), v2(p2);
     ret[0] = (std::min)(v1[0], v2[0]);
     ret[1] = (std::min)(v1[1], v2[1]);
     return ret;
 #else
 #   pragma message("performance warning: NEON does not provide min() for packed uint64_t x 2")
+    PVEC_PROBE_N("min() uint64_t x 2 (NEON emulation)", 2);
     uint32x4_t tmp =
         vceqq_u32(
             vreinterpretq_u32_u64(
@@ -6107,18 +6032,22 @@ template<> inline veci_ui64x2_t veci_ui64x2_t::min_(const veci_ui64x2_t & v1, co
 template<> inline veci_ui64x2_t veci_ui64x2_t::max_(packed_t p1, packed_t p2)
 {
 #if defined(PVECI_INTEL)
-#   pragma message("performance warning: SSE2/SSE3/SSSE3/SSE4.1/SSE4.2 do not provide max() for packed uint64_t x 2")
-    __m128i mask =_mm_shuffle_epi32(_mm_cmpeq_epi32(_mm_srli_epi64(_mm_sub_epi64(p1, p2), 63), _mm_setzero_si128()), 0xA0);
-    return veci_ui64x2_t(_mm_or_si128(_mm_and_si128(mask, p1), _mm_andnot_si128(mask, p2)));
+# if defined(AVX512VL)
+    return veci_ui64x2_t(_mm_max_epu64(p1, p2));
+# else
+    return veci_ui64x2_t(ipriv::blendv_epi8(p2, p1, ipriv::cmpgt_epu64(p1, p2)));
+# endif
 #elif defined(PVECI_ARM)
 #if 1
 # pragma message("performance warning: NEON does not provide max() for packed uint64_t x 2, scalar code is used")
+    PVEC_PROBE_N("max() uint64_t x 2 (NEON, scalar)", 2);
     veci_ui64x2_t ret, v1(p1), v2(p2);
     ret[0] = (std::max)(v1[0], v2[0]);
     ret[1] = (std::max)(v1[1], v2[1]);
     return ret;
 #else
 # pragma message("performance warning: NEON does not provide max() for packed uint64_t x 2")
+    PVEC_PROBE_N("max() uint64_t x 2 (NEON emulation)", 2);
     uint32x4_t tmp =
         vceqq_u32(
             vreinterpretq_u32_u64(
@@ -6413,53 +6342,2383 @@ inline veci_ui64x2_t yy(const veci_ui64x2_t & v1, const veci_ui64x2_t & v2)
 
 
 
-#if defined(_MSC_VER)
-#define PVECI_ALIGN(x) __declspec(align(x))
-#elif defined(__GNUC__)
-#define PVECI_ALIGN(x) __attribute__((aligned (x)))
-#endif
-
-#if defined(PVECI_INTEL)
-
-typedef veci_t<int8_t,16,__m128i> PVECI_ALIGN(16) veci_i8x16_t;
-typedef veci_t<int16_t,8,__m128i> PVECI_ALIGN(16) veci_i16x8_t;
-typedef veci_t<int32_t,4,__m128i> PVECI_ALIGN(16) veci_i32x4_t;
-typedef veci_t<int64_t,2,__m128i> PVECI_ALIGN(16) veci_i64x2_t;
-
-typedef veci_t<uint8_t,16,__m128i> PVECI_ALIGN(16) veci_ui8x16_t;
-typedef veci_t<uint16_t,8,__m128i> PVECI_ALIGN(16) veci_ui16x8_t;
-typedef veci_t<uint32_t,4,__m128i> PVECI_ALIGN(16) veci_ui32x4_t;
-typedef veci_t<uint64_t,2,__m128i> PVECI_ALIGN(16) veci_ui64x2_t;
-
-#elif defined(PVECI_ARM)
-
-#ifndef PVECI_ARM_GCC
-
-typedef veci_t<int8_t,16,__n128> PVECI_ALIGN(8) veci_i8x16_t;
-typedef veci_t<int16_t,8,__n128> PVECI_ALIGN(8) veci_i16x8_t;
-typedef veci_t<int32_t,4,__n128> PVECI_ALIGN(8) veci_i32x4_t;
-typedef veci_t<int64_t,2,__n128> PVECI_ALIGN(8) veci_i64x2_t;
-
-typedef veci_t<uint8_t,16,__n128> PVECI_ALIGN(8) veci_ui8x16_t;
-typedef veci_t<uint16_t,8,__n128> PVECI_ALIGN(8) veci_ui16x8_t;
-typedef veci_t<uint32_t,4,__n128> PVECI_ALIGN(8) veci_ui32x4_t;
-typedef veci_t<uint64_t,2,__n128> PVECI_ALIGN(8) veci_ui64x2_t;
-
-#else
-
-typedef veci_t<int8_t,16,int8x16_t> PVECI_ALIGN(8) veci_i8x16_t;
-typedef veci_t<int16_t,8,int16x8_t> PVECI_ALIGN(8) veci_i16x8_t;
-typedef veci_t<int32_t,4,int32x4_t> PVECI_ALIGN(8) veci_i32x4_t;
-typedef veci_t<int64_t,2,int64x2_t> PVECI_ALIGN(8) veci_i64x2_t;
+#if defined(PVECI_INTEL) && defined(AVX2)
 
-typedef veci_t<uint8_t,16,uint8x16_t> PVECI_ALIGN(8) veci_ui8x16_t;
-typedef veci_t<uint16_t,8,uint16x8_t> PVECI_ALIGN(8) veci_ui16x8_t;
-typedef veci_t<uint32_t,4,uint32x4_t> PVECI_ALIGN(8) veci_ui32x4_t;
-typedef veci_t<uint64_t,2,uint64x2_t> PVECI_ALIGN(8) veci_ui64x2_t;
+/*
+256 bit integer vectors (AVX2)
+------------------------------
+all element-wise operations (arithmetic, saturation, comparisons, min/max, abs,
+logic, element shifts) work across the full 32 bytes
+
+most AVX2 operations that move data between elements however work on the two
+128 bit lanes independently ("in-lane"): the lanes behave like two __m128i side
+by side, nothing crosses from bytes 0..15 to 16..31 or vice versa:
+  bslli<B>(v), bsrli<B>(v)  shift each 128 bit lane by B bytes
+  alignr<B>(hi, lo)         per 128 bit lane: bytes B..B+15 of {lo.lane,hi.lane}
+crossing lanes requires vperm2i128/vpermq (_mm256_permute2x128_si256(),
+_mm256_permute4x64_epi64())
+*/
 
-#endif
+/*****************************************************************************
+ *                                                                           *
+ * veci_i8x32_t implementation                                               *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_i8x32_t veci_t<int8_t,32,__m256i>
 
-#endif
+template<> inline veci_i8x32_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_i8x32_t::veci_t(int8_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_i8x32_t::veci_t(int8_t v0, int8_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> template<> inline veci_i8x32_t::veci_t(int8_t v0, int8_t v1, int8_t v2)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; }
+template<> template<> inline veci_i8x32_t::veci_t(int8_t v0, int8_t v1, int8_t v2, int8_t v3)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9, int8_t va
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9, int8_t va, int8_t vb
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9, int8_t va, int8_t vb,
+        int8_t vc
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9, int8_t va, int8_t vb,
+        int8_t vc, int8_t vd
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; v[13] = vd; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9, int8_t va, int8_t vb,
+        int8_t vc, int8_t vd, int8_t ve
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; v[13] = vd; v[14] = ve; }
+template<> template<> inline veci_i8x32_t::veci_t(
+        int8_t v0, int8_t v1, int8_t v2, int8_t v3,
+        int8_t v4, int8_t v5, int8_t v6, int8_t v7,
+        int8_t v8, int8_t v9, int8_t va, int8_t vb,
+        int8_t vc, int8_t vd, int8_t ve, int8_t vf
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; v[13] = vd; v[14] = ve; v[15] = vf; }
+template<> inline veci_i8x32_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 32 ? l.size() : 32);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_i8x32_t & veci_i8x32_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi8(p, v2); return *this; }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi8(p, v2); return *this; }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_i8x32_t & veci_i8x32_t::operator+=(const veci_i8x32_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator-=(const veci_i8x32_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator&=(const veci_i8x32_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator|=(const veci_i8x32_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_i8x32_t & veci_i8x32_t::operator^=(const veci_i8x32_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+template<> inline bool veci_i8x32_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, v2)) == -1; }
+template<> inline bool veci_i8x32_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, v2)) == 0; }
+template<> inline bool veci_i8x32_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi8(v2, p)) == -1; }
+template<> inline bool veci_i8x32_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi8(p, v2)) == 0; }
+template<> inline bool veci_i8x32_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi8(p, v2)) == -1; }
+template<> inline bool veci_i8x32_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi8(v2, p)) == 0; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_i8x32_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_i8x32_t::operator==(const veci_i8x32_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_i8x32_t::operator!=(const veci_i8x32_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_i8x32_t::operator<(const veci_i8x32_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_i8x32_t::operator<=(const veci_i8x32_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_i8x32_t::operator>(const veci_i8x32_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_i8x32_t::operator>=(const veci_i8x32_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_i8x32_t::neq_one(const veci_i8x32_t & v2) const
+{ return neq_one(v2.p); }
+
+
+template<> inline veci_i8x32_t veci_i8x32_t::min_(packed_t p1, packed_t p2)
+{ return veci_i8x32_t(_mm256_min_epi8(p1, p2)); }
+template<> inline veci_i8x32_t veci_i8x32_t::min_(const veci_i8x32_t & v1, const veci_i8x32_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_i8x32_t veci_i8x32_t::max_(packed_t p1, packed_t p2)
+{ return veci_i8x32_t(_mm256_max_epi8(p1, p2)); }
+template<> inline veci_i8x32_t veci_i8x32_t::max_(const veci_i8x32_t & v1, const veci_i8x32_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+// saturated adds and subs
+template<> template<> inline veci_i8x32_t & veci_i8x32_t::add_sat(packed_t v2)
+{ p = _mm256_adds_epi8(p, v2); return *this; }
+template<> template<> inline veci_i8x32_t & veci_i8x32_t::sub_sat(packed_t v2)
+{ p = _mm256_subs_epi8(p, v2); return *this; }
+template<> template<> inline veci_i8x32_t & veci_i8x32_t::add_sat(const veci_i8x32_t & v2)
+{ return add_sat(v2.p); }
+template<> template<> inline veci_i8x32_t & veci_i8x32_t::sub_sat(const veci_i8x32_t & v2)
+{ return sub_sat(v2.p); }
+
+
+template<> template<> inline void veci_i8x32_t::abs_()
+{ p = _mm256_abs_epi8(p); }
+template<> template<> inline veci_i8x32_t veci_i8x32_t::abs_() const
+{ veci_i8x32_t ret(p); ret.abs_(); return ret; }
+
+
+// unary minus
+inline veci_i8x32_t operator-(const veci_i8x32_t & v)
+{ return veci_i8x32_t(math::imath_t<int8_t,__m256i>::zeroes()) -= v; }
+
+
+// load aligned
+template<> inline void veci_i8x32_t::loada(const int8_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_i8x32_t::loadu(const int8_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_i8x32_t::storeu(int8_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_i8x32_t operator+(const veci_i8x32_t & v1, const veci_i8x32_t & v2)
+{ return veci_i8x32_t(_mm256_add_epi8(v1.p, v2.p)); }
+inline veci_i8x32_t operator+(const veci_i8x32_t & v, int8_t s)
+{ return veci_i8x32_t(_mm256_add_epi8(v.p, _mm256_set1_epi8(char(s)))); }
+inline veci_i8x32_t operator+(int8_t s, const veci_i8x32_t & v)
+{ return veci_i8x32_t(_mm256_add_epi8(_mm256_set1_epi8(char(s)), v.p)); }
+inline veci_i8x32_t operator+(const veci_i8x32_t & v1, veci_i8x32_t::packed_t v2)
+{ return veci_i8x32_t(_mm256_add_epi8(v1.p, v2)); }
+inline veci_i8x32_t operator+(veci_i8x32_t::packed_t v1, const veci_i8x32_t & v2)
+{ return veci_i8x32_t(_mm256_add_epi8(v1, v2.p)); }
+
+inline veci_i8x32_t operator-(const veci_i8x32_t & v1, const veci_i8x32_t & v2)
+{ return veci_i8x32_t(_mm256_sub_epi8(v1.p, v2.p)); }
+inline veci_i8x32_t operator-(const veci_i8x32_t & v, int8_t s)
+{ return veci_i8x32_t(_mm256_sub_epi8(v.p, _mm256_set1_epi8(char(s)))); }
+inline veci_i8x32_t operator-(int8_t s, const veci_i8x32_t & v)
+{ return veci_i8x32_t(_mm256_sub_epi8(_mm256_set1_epi8(char(s)), v.p)); }
+inline veci_i8x32_t operator-(const veci_i8x32_t & v1, veci_i8x32_t::packed_t v2)
+{ return veci_i8x32_t(_mm256_sub_epi8(v1.p, v2)); }
+inline veci_i8x32_t operator-(veci_i8x32_t::packed_t v1, const veci_i8x32_t & v2)
+{ return veci_i8x32_t(_mm256_sub_epi8(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_i8x32_t operator&(veci_i8x32_t op1, veci_i8x32_t op2)
+{ return veci_i8x32_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_i8x32_t operator&(veci_i8x32_t::packed_t op1, veci_i8x32_t op2)
+{ return veci_i8x32_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_i8x32_t operator&(veci_i8x32_t op1, veci_i8x32_t::packed_t op2)
+{ return veci_i8x32_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_i8x32_t operator|(veci_i8x32_t op1, veci_i8x32_t op2)
+{ return veci_i8x32_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_i8x32_t operator|(veci_i8x32_t::packed_t op1, veci_i8x32_t op2)
+{ return veci_i8x32_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_i8x32_t operator|(veci_i8x32_t op1, veci_i8x32_t::packed_t op2)
+{ return veci_i8x32_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_i8x32_t operator^(veci_i8x32_t op1, veci_i8x32_t op2)
+{ return veci_i8x32_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_i8x32_t operator^(veci_i8x32_t::packed_t op1, veci_i8x32_t op2)
+{ return veci_i8x32_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_i8x32_t operator^(veci_i8x32_t op1, veci_i8x32_t::packed_t op2)
+{ return veci_i8x32_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_i8x32_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_ui8x32_t implementation                                              *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_ui8x32_t veci_t<uint8_t,32,__m256i>
+
+template<> inline veci_ui8x32_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_ui8x32_t::veci_t(uint8_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_ui8x32_t::veci_t(uint8_t v0, uint8_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> template<> inline veci_ui8x32_t::veci_t(uint8_t v0, uint8_t v1, uint8_t v2)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; }
+template<> template<> inline veci_ui8x32_t::veci_t(uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t va
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t va, uint8_t vb
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t va, uint8_t vb,
+        uint8_t vc
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t va, uint8_t vb,
+        uint8_t vc, uint8_t vd
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; v[13] = vd; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t va, uint8_t vb,
+        uint8_t vc, uint8_t vd, uint8_t ve
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; v[13] = vd; v[14] = ve; }
+template<> template<> inline veci_ui8x32_t::veci_t(
+        uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+        uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+        uint8_t v8, uint8_t v9, uint8_t va, uint8_t vb,
+        uint8_t vc, uint8_t vd, uint8_t ve, uint8_t vf
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7;
+  v[8] = v8; v[9] = v9; v[10] = va; v[11] = vb;
+  v[12] = vc; v[13] = vd; v[14] = ve; v[15] = vf; }
+template<> inline veci_ui8x32_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 32 ? l.size() : 32);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi8(p, v2); return *this; }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi8(p, v2); return *this; }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator+=(const veci_ui8x32_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator-=(const veci_ui8x32_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator&=(const veci_ui8x32_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator|=(const veci_ui8x32_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_ui8x32_t & veci_ui8x32_t::operator^=(const veci_ui8x32_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+// unsigned comparisons per max(), all(a <= b) <=> all(max(a,b) == b)
+template<> inline bool veci_ui8x32_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, v2)) == -1; }
+template<> inline bool veci_ui8x32_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, v2)) == 0; }
+template<> inline bool veci_ui8x32_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(p, v2), p)) == 0; }
+template<> inline bool veci_ui8x32_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(p, v2), v2)) == -1; }
+template<> inline bool veci_ui8x32_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(p, v2), v2)) == 0; }
+template<> inline bool veci_ui8x32_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(p, v2), p)) == -1; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_ui8x32_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_ui8x32_t::operator==(const veci_ui8x32_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_ui8x32_t::operator!=(const veci_ui8x32_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_ui8x32_t::operator<(const veci_ui8x32_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_ui8x32_t::operator<=(const veci_ui8x32_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_ui8x32_t::operator>(const veci_ui8x32_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_ui8x32_t::operator>=(const veci_ui8x32_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_ui8x32_t::neq_one(const veci_ui8x32_t & v2) const
+{ return neq_one(v2.p); }
+
+
+template<> inline veci_ui8x32_t veci_ui8x32_t::min_(packed_t p1, packed_t p2)
+{ return veci_ui8x32_t(_mm256_min_epu8(p1, p2)); }
+template<> inline veci_ui8x32_t veci_ui8x32_t::min_(const veci_ui8x32_t & v1, const veci_ui8x32_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_ui8x32_t veci_ui8x32_t::max_(packed_t p1, packed_t p2)
+{ return veci_ui8x32_t(_mm256_max_epu8(p1, p2)); }
+template<> inline veci_ui8x32_t veci_ui8x32_t::max_(const veci_ui8x32_t & v1, const veci_ui8x32_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+// saturated adds and subs
+template<> template<> inline veci_ui8x32_t & veci_ui8x32_t::add_sat(packed_t v2)
+{ p = _mm256_adds_epu8(p, v2); return *this; }
+template<> template<> inline veci_ui8x32_t & veci_ui8x32_t::sub_sat(packed_t v2)
+{ p = _mm256_subs_epu8(p, v2); return *this; }
+template<> template<> inline veci_ui8x32_t & veci_ui8x32_t::add_sat(const veci_ui8x32_t & v2)
+{ return add_sat(v2.p); }
+template<> template<> inline veci_ui8x32_t & veci_ui8x32_t::sub_sat(const veci_ui8x32_t & v2)
+{ return sub_sat(v2.p); }
+
+
+// load aligned
+template<> inline void veci_ui8x32_t::loada(const uint8_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_ui8x32_t::loadu(const uint8_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_ui8x32_t::storeu(uint8_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_ui8x32_t operator+(const veci_ui8x32_t & v1, const veci_ui8x32_t & v2)
+{ return veci_ui8x32_t(_mm256_add_epi8(v1.p, v2.p)); }
+inline veci_ui8x32_t operator+(const veci_ui8x32_t & v, uint8_t s)
+{ return veci_ui8x32_t(_mm256_add_epi8(v.p, _mm256_set1_epi8(char(s)))); }
+inline veci_ui8x32_t operator+(uint8_t s, const veci_ui8x32_t & v)
+{ return veci_ui8x32_t(_mm256_add_epi8(_mm256_set1_epi8(char(s)), v.p)); }
+inline veci_ui8x32_t operator+(const veci_ui8x32_t & v1, veci_ui8x32_t::packed_t v2)
+{ return veci_ui8x32_t(_mm256_add_epi8(v1.p, v2)); }
+inline veci_ui8x32_t operator+(veci_ui8x32_t::packed_t v1, const veci_ui8x32_t & v2)
+{ return veci_ui8x32_t(_mm256_add_epi8(v1, v2.p)); }
+
+inline veci_ui8x32_t operator-(const veci_ui8x32_t & v1, const veci_ui8x32_t & v2)
+{ return veci_ui8x32_t(_mm256_sub_epi8(v1.p, v2.p)); }
+inline veci_ui8x32_t operator-(const veci_ui8x32_t & v, uint8_t s)
+{ return veci_ui8x32_t(_mm256_sub_epi8(v.p, _mm256_set1_epi8(char(s)))); }
+inline veci_ui8x32_t operator-(uint8_t s, const veci_ui8x32_t & v)
+{ return veci_ui8x32_t(_mm256_sub_epi8(_mm256_set1_epi8(char(s)), v.p)); }
+inline veci_ui8x32_t operator-(const veci_ui8x32_t & v1, veci_ui8x32_t::packed_t v2)
+{ return veci_ui8x32_t(_mm256_sub_epi8(v1.p, v2)); }
+inline veci_ui8x32_t operator-(veci_ui8x32_t::packed_t v1, const veci_ui8x32_t & v2)
+{ return veci_ui8x32_t(_mm256_sub_epi8(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_ui8x32_t operator&(veci_ui8x32_t op1, veci_ui8x32_t op2)
+{ return veci_ui8x32_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_ui8x32_t operator&(veci_ui8x32_t::packed_t op1, veci_ui8x32_t op2)
+{ return veci_ui8x32_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_ui8x32_t operator&(veci_ui8x32_t op1, veci_ui8x32_t::packed_t op2)
+{ return veci_ui8x32_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_ui8x32_t operator|(veci_ui8x32_t op1, veci_ui8x32_t op2)
+{ return veci_ui8x32_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_ui8x32_t operator|(veci_ui8x32_t::packed_t op1, veci_ui8x32_t op2)
+{ return veci_ui8x32_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_ui8x32_t operator|(veci_ui8x32_t op1, veci_ui8x32_t::packed_t op2)
+{ return veci_ui8x32_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_ui8x32_t operator^(veci_ui8x32_t op1, veci_ui8x32_t op2)
+{ return veci_ui8x32_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_ui8x32_t operator^(veci_ui8x32_t::packed_t op1, veci_ui8x32_t op2)
+{ return veci_ui8x32_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_ui8x32_t operator^(veci_ui8x32_t op1, veci_ui8x32_t::packed_t op2)
+{ return veci_ui8x32_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_ui8x32_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_i16x16_t implementation                                              *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_i16x16_t veci_t<int16_t,16,__m256i>
+
+template<> inline veci_i16x16_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_i16x16_t::veci_t(int16_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_i16x16_t::veci_t(int16_t v0, int16_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> template<> inline veci_i16x16_t::veci_t(int16_t v0, int16_t v1, int16_t v2)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; }
+template<> template<> inline veci_i16x16_t::veci_t(int16_t v0, int16_t v1, int16_t v2, int16_t v3)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
+template<> template<> inline veci_i16x16_t::veci_t(
+        int16_t v0, int16_t v1, int16_t v2, int16_t v3,
+        int16_t v4
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; }
+template<> template<> inline veci_i16x16_t::veci_t(
+        int16_t v0, int16_t v1, int16_t v2, int16_t v3,
+        int16_t v4, int16_t v5
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; }
+template<> template<> inline veci_i16x16_t::veci_t(
+        int16_t v0, int16_t v1, int16_t v2, int16_t v3,
+        int16_t v4, int16_t v5, int16_t v6
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; }
+template<> template<> inline veci_i16x16_t::veci_t(
+        int16_t v0, int16_t v1, int16_t v2, int16_t v3,
+        int16_t v4, int16_t v5, int16_t v6, int16_t v7
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7; }
+template<> inline veci_i16x16_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 16 ? l.size() : 16);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_i16x16_t & veci_i16x16_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi16(p, v2); return *this; }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi16(p, v2); return *this; }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_i16x16_t & veci_i16x16_t::operator+=(const veci_i16x16_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator-=(const veci_i16x16_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator&=(const veci_i16x16_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator|=(const veci_i16x16_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_i16x16_t & veci_i16x16_t::operator^=(const veci_i16x16_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+template<> inline bool veci_i16x16_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(p, v2)) == -1; }
+template<> inline bool veci_i16x16_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(p, v2)) == 0; }
+template<> inline bool veci_i16x16_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi16(v2, p)) == -1; }
+template<> inline bool veci_i16x16_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi16(p, v2)) == 0; }
+template<> inline bool veci_i16x16_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi16(p, v2)) == -1; }
+template<> inline bool veci_i16x16_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi16(v2, p)) == 0; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_i16x16_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_i16x16_t::operator==(const veci_i16x16_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_i16x16_t::operator!=(const veci_i16x16_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_i16x16_t::operator<(const veci_i16x16_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_i16x16_t::operator<=(const veci_i16x16_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_i16x16_t::operator>(const veci_i16x16_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_i16x16_t::operator>=(const veci_i16x16_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_i16x16_t::neq_one(const veci_i16x16_t & v2) const
+{ return neq_one(v2.p); }
+
+
+template<> inline veci_i16x16_t veci_i16x16_t::min_(packed_t p1, packed_t p2)
+{ return veci_i16x16_t(_mm256_min_epi16(p1, p2)); }
+template<> inline veci_i16x16_t veci_i16x16_t::min_(const veci_i16x16_t & v1, const veci_i16x16_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_i16x16_t veci_i16x16_t::max_(packed_t p1, packed_t p2)
+{ return veci_i16x16_t(_mm256_max_epi16(p1, p2)); }
+template<> inline veci_i16x16_t veci_i16x16_t::max_(const veci_i16x16_t & v1, const veci_i16x16_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+// saturated adds and subs
+template<> template<> inline veci_i16x16_t & veci_i16x16_t::add_sat(packed_t v2)
+{ p = _mm256_adds_epi16(p, v2); return *this; }
+template<> template<> inline veci_i16x16_t & veci_i16x16_t::sub_sat(packed_t v2)
+{ p = _mm256_subs_epi16(p, v2); return *this; }
+template<> template<> inline veci_i16x16_t & veci_i16x16_t::add_sat(const veci_i16x16_t & v2)
+{ return add_sat(v2.p); }
+template<> template<> inline veci_i16x16_t & veci_i16x16_t::sub_sat(const veci_i16x16_t & v2)
+{ return sub_sat(v2.p); }
+
+
+template<> template<> inline void veci_i16x16_t::abs_()
+{ p = _mm256_abs_epi16(p); }
+template<> template<> inline veci_i16x16_t veci_i16x16_t::abs_() const
+{ veci_i16x16_t ret(p); ret.abs_(); return ret; }
+
+
+// unary minus
+inline veci_i16x16_t operator-(const veci_i16x16_t & v)
+{ return veci_i16x16_t(math::imath_t<int16_t,__m256i>::zeroes()) -= v; }
+
+
+// load aligned
+template<> inline void veci_i16x16_t::loada(const int16_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_i16x16_t::loadu(const int16_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_i16x16_t::storeu(int16_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_i16x16_t operator+(const veci_i16x16_t & v1, const veci_i16x16_t & v2)
+{ return veci_i16x16_t(_mm256_add_epi16(v1.p, v2.p)); }
+inline veci_i16x16_t operator+(const veci_i16x16_t & v, int16_t s)
+{ return veci_i16x16_t(_mm256_add_epi16(v.p, _mm256_set1_epi16(short(s)))); }
+inline veci_i16x16_t operator+(int16_t s, const veci_i16x16_t & v)
+{ return veci_i16x16_t(_mm256_add_epi16(_mm256_set1_epi16(short(s)), v.p)); }
+inline veci_i16x16_t operator+(const veci_i16x16_t & v1, veci_i16x16_t::packed_t v2)
+{ return veci_i16x16_t(_mm256_add_epi16(v1.p, v2)); }
+inline veci_i16x16_t operator+(veci_i16x16_t::packed_t v1, const veci_i16x16_t & v2)
+{ return veci_i16x16_t(_mm256_add_epi16(v1, v2.p)); }
+
+inline veci_i16x16_t operator-(const veci_i16x16_t & v1, const veci_i16x16_t & v2)
+{ return veci_i16x16_t(_mm256_sub_epi16(v1.p, v2.p)); }
+inline veci_i16x16_t operator-(const veci_i16x16_t & v, int16_t s)
+{ return veci_i16x16_t(_mm256_sub_epi16(v.p, _mm256_set1_epi16(short(s)))); }
+inline veci_i16x16_t operator-(int16_t s, const veci_i16x16_t & v)
+{ return veci_i16x16_t(_mm256_sub_epi16(_mm256_set1_epi16(short(s)), v.p)); }
+inline veci_i16x16_t operator-(const veci_i16x16_t & v1, veci_i16x16_t::packed_t v2)
+{ return veci_i16x16_t(_mm256_sub_epi16(v1.p, v2)); }
+inline veci_i16x16_t operator-(veci_i16x16_t::packed_t v1, const veci_i16x16_t & v2)
+{ return veci_i16x16_t(_mm256_sub_epi16(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_i16x16_t operator&(veci_i16x16_t op1, veci_i16x16_t op2)
+{ return veci_i16x16_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_i16x16_t operator&(veci_i16x16_t::packed_t op1, veci_i16x16_t op2)
+{ return veci_i16x16_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_i16x16_t operator&(veci_i16x16_t op1, veci_i16x16_t::packed_t op2)
+{ return veci_i16x16_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_i16x16_t operator|(veci_i16x16_t op1, veci_i16x16_t op2)
+{ return veci_i16x16_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_i16x16_t operator|(veci_i16x16_t::packed_t op1, veci_i16x16_t op2)
+{ return veci_i16x16_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_i16x16_t operator|(veci_i16x16_t op1, veci_i16x16_t::packed_t op2)
+{ return veci_i16x16_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_i16x16_t operator^(veci_i16x16_t op1, veci_i16x16_t op2)
+{ return veci_i16x16_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_i16x16_t operator^(veci_i16x16_t::packed_t op1, veci_i16x16_t op2)
+{ return veci_i16x16_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_i16x16_t operator^(veci_i16x16_t op1, veci_i16x16_t::packed_t op2)
+{ return veci_i16x16_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_i16x16_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_ui16x16_t implementation                                             *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_ui16x16_t veci_t<uint16_t,16,__m256i>
+
+template<> inline veci_ui16x16_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_ui16x16_t::veci_t(uint16_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_ui16x16_t::veci_t(uint16_t v0, uint16_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> template<> inline veci_ui16x16_t::veci_t(uint16_t v0, uint16_t v1, uint16_t v2)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; }
+template<> template<> inline veci_ui16x16_t::veci_t(uint16_t v0, uint16_t v1, uint16_t v2, uint16_t v3)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
+template<> template<> inline veci_ui16x16_t::veci_t(
+        uint16_t v0, uint16_t v1, uint16_t v2, uint16_t v3,
+        uint16_t v4
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; }
+template<> template<> inline veci_ui16x16_t::veci_t(
+        uint16_t v0, uint16_t v1, uint16_t v2, uint16_t v3,
+        uint16_t v4, uint16_t v5
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; }
+template<> template<> inline veci_ui16x16_t::veci_t(
+        uint16_t v0, uint16_t v1, uint16_t v2, uint16_t v3,
+        uint16_t v4, uint16_t v5, uint16_t v6
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; }
+template<> template<> inline veci_ui16x16_t::veci_t(
+        uint16_t v0, uint16_t v1, uint16_t v2, uint16_t v3,
+        uint16_t v4, uint16_t v5, uint16_t v6, uint16_t v7
+)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+  v[4] = v4; v[5] = v5; v[6] = v6; v[7] = v7; }
+template<> inline veci_ui16x16_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 16 ? l.size() : 16);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi16(p, v2); return *this; }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi16(p, v2); return *this; }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator+=(const veci_ui16x16_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator-=(const veci_ui16x16_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator&=(const veci_ui16x16_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator|=(const veci_ui16x16_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_ui16x16_t & veci_ui16x16_t::operator^=(const veci_ui16x16_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+// unsigned comparisons per max(), all(a <= b) <=> all(max(a,b) == b)
+template<> inline bool veci_ui16x16_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(p, v2)) == -1; }
+template<> inline bool veci_ui16x16_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(p, v2)) == 0; }
+template<> inline bool veci_ui16x16_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_max_epu16(p, v2), p)) == 0; }
+template<> inline bool veci_ui16x16_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_max_epu16(p, v2), v2)) == -1; }
+template<> inline bool veci_ui16x16_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_max_epu16(p, v2), v2)) == 0; }
+template<> inline bool veci_ui16x16_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_max_epu16(p, v2), p)) == -1; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_ui16x16_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi16(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_ui16x16_t::operator==(const veci_ui16x16_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_ui16x16_t::operator!=(const veci_ui16x16_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_ui16x16_t::operator<(const veci_ui16x16_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_ui16x16_t::operator<=(const veci_ui16x16_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_ui16x16_t::operator>(const veci_ui16x16_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_ui16x16_t::operator>=(const veci_ui16x16_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_ui16x16_t::neq_one(const veci_ui16x16_t & v2) const
+{ return neq_one(v2.p); }
+
+
+template<> inline veci_ui16x16_t veci_ui16x16_t::min_(packed_t p1, packed_t p2)
+{ return veci_ui16x16_t(_mm256_min_epu16(p1, p2)); }
+template<> inline veci_ui16x16_t veci_ui16x16_t::min_(const veci_ui16x16_t & v1, const veci_ui16x16_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_ui16x16_t veci_ui16x16_t::max_(packed_t p1, packed_t p2)
+{ return veci_ui16x16_t(_mm256_max_epu16(p1, p2)); }
+template<> inline veci_ui16x16_t veci_ui16x16_t::max_(const veci_ui16x16_t & v1, const veci_ui16x16_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+// saturated adds and subs
+template<> template<> inline veci_ui16x16_t & veci_ui16x16_t::add_sat(packed_t v2)
+{ p = _mm256_adds_epu16(p, v2); return *this; }
+template<> template<> inline veci_ui16x16_t & veci_ui16x16_t::sub_sat(packed_t v2)
+{ p = _mm256_subs_epu16(p, v2); return *this; }
+template<> template<> inline veci_ui16x16_t & veci_ui16x16_t::add_sat(const veci_ui16x16_t & v2)
+{ return add_sat(v2.p); }
+template<> template<> inline veci_ui16x16_t & veci_ui16x16_t::sub_sat(const veci_ui16x16_t & v2)
+{ return sub_sat(v2.p); }
+
+
+// load aligned
+template<> inline void veci_ui16x16_t::loada(const uint16_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_ui16x16_t::loadu(const uint16_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_ui16x16_t::storeu(uint16_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_ui16x16_t operator+(const veci_ui16x16_t & v1, const veci_ui16x16_t & v2)
+{ return veci_ui16x16_t(_mm256_add_epi16(v1.p, v2.p)); }
+inline veci_ui16x16_t operator+(const veci_ui16x16_t & v, uint16_t s)
+{ return veci_ui16x16_t(_mm256_add_epi16(v.p, _mm256_set1_epi16(short(s)))); }
+inline veci_ui16x16_t operator+(uint16_t s, const veci_ui16x16_t & v)
+{ return veci_ui16x16_t(_mm256_add_epi16(_mm256_set1_epi16(short(s)), v.p)); }
+inline veci_ui16x16_t operator+(const veci_ui16x16_t & v1, veci_ui16x16_t::packed_t v2)
+{ return veci_ui16x16_t(_mm256_add_epi16(v1.p, v2)); }
+inline veci_ui16x16_t operator+(veci_ui16x16_t::packed_t v1, const veci_ui16x16_t & v2)
+{ return veci_ui16x16_t(_mm256_add_epi16(v1, v2.p)); }
+
+inline veci_ui16x16_t operator-(const veci_ui16x16_t & v1, const veci_ui16x16_t & v2)
+{ return veci_ui16x16_t(_mm256_sub_epi16(v1.p, v2.p)); }
+inline veci_ui16x16_t operator-(const veci_ui16x16_t & v, uint16_t s)
+{ return veci_ui16x16_t(_mm256_sub_epi16(v.p, _mm256_set1_epi16(short(s)))); }
+inline veci_ui16x16_t operator-(uint16_t s, const veci_ui16x16_t & v)
+{ return veci_ui16x16_t(_mm256_sub_epi16(_mm256_set1_epi16(short(s)), v.p)); }
+inline veci_ui16x16_t operator-(const veci_ui16x16_t & v1, veci_ui16x16_t::packed_t v2)
+{ return veci_ui16x16_t(_mm256_sub_epi16(v1.p, v2)); }
+inline veci_ui16x16_t operator-(veci_ui16x16_t::packed_t v1, const veci_ui16x16_t & v2)
+{ return veci_ui16x16_t(_mm256_sub_epi16(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_ui16x16_t operator&(veci_ui16x16_t op1, veci_ui16x16_t op2)
+{ return veci_ui16x16_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_ui16x16_t operator&(veci_ui16x16_t::packed_t op1, veci_ui16x16_t op2)
+{ return veci_ui16x16_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_ui16x16_t operator&(veci_ui16x16_t op1, veci_ui16x16_t::packed_t op2)
+{ return veci_ui16x16_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_ui16x16_t operator|(veci_ui16x16_t op1, veci_ui16x16_t op2)
+{ return veci_ui16x16_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_ui16x16_t operator|(veci_ui16x16_t::packed_t op1, veci_ui16x16_t op2)
+{ return veci_ui16x16_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_ui16x16_t operator|(veci_ui16x16_t op1, veci_ui16x16_t::packed_t op2)
+{ return veci_ui16x16_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_ui16x16_t operator^(veci_ui16x16_t op1, veci_ui16x16_t op2)
+{ return veci_ui16x16_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_ui16x16_t operator^(veci_ui16x16_t::packed_t op1, veci_ui16x16_t op2)
+{ return veci_ui16x16_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_ui16x16_t operator^(veci_ui16x16_t op1, veci_ui16x16_t::packed_t op2)
+{ return veci_ui16x16_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_ui16x16_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_i32x8_t implementation                                               *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_i32x8_t veci_t<int32_t,8,__m256i>
+
+template<> inline veci_i32x8_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_i32x8_t::veci_t(int32_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_i32x8_t::veci_t(int32_t v0, int32_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> template<> inline veci_i32x8_t::veci_t(int32_t v0, int32_t v1, int32_t v2)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; }
+template<> template<> inline veci_i32x8_t::veci_t(int32_t v0, int32_t v1, int32_t v2, int32_t v3)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
+template<> inline veci_i32x8_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 8 ? l.size() : 8);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_i32x8_t & veci_i32x8_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi32(p, v2); return *this; }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi32(p, v2); return *this; }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_i32x8_t & veci_i32x8_t::operator+=(const veci_i32x8_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator-=(const veci_i32x8_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator&=(const veci_i32x8_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator|=(const veci_i32x8_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_i32x8_t & veci_i32x8_t::operator^=(const veci_i32x8_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+template<> inline bool veci_i32x8_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(p, v2)) == -1; }
+template<> inline bool veci_i32x8_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(p, v2)) == 0; }
+template<> inline bool veci_i32x8_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi32(v2, p)) == -1; }
+template<> inline bool veci_i32x8_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi32(p, v2)) == 0; }
+template<> inline bool veci_i32x8_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi32(p, v2)) == -1; }
+template<> inline bool veci_i32x8_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi32(v2, p)) == 0; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_i32x8_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_i32x8_t::operator==(const veci_i32x8_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_i32x8_t::operator!=(const veci_i32x8_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_i32x8_t::operator<(const veci_i32x8_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_i32x8_t::operator<=(const veci_i32x8_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_i32x8_t::operator>(const veci_i32x8_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_i32x8_t::operator>=(const veci_i32x8_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_i32x8_t::neq_one(const veci_i32x8_t & v2) const
+{ return neq_one(v2.p); }
+
+
+template<> inline veci_i32x8_t veci_i32x8_t::min_(packed_t p1, packed_t p2)
+{ return veci_i32x8_t(_mm256_min_epi32(p1, p2)); }
+template<> inline veci_i32x8_t veci_i32x8_t::min_(const veci_i32x8_t & v1, const veci_i32x8_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_i32x8_t veci_i32x8_t::max_(packed_t p1, packed_t p2)
+{ return veci_i32x8_t(_mm256_max_epi32(p1, p2)); }
+template<> inline veci_i32x8_t veci_i32x8_t::max_(const veci_i32x8_t & v1, const veci_i32x8_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+template<> template<> inline void veci_i32x8_t::abs_()
+{ p = _mm256_abs_epi32(p); }
+template<> template<> inline veci_i32x8_t veci_i32x8_t::abs_() const
+{ veci_i32x8_t ret(p); ret.abs_(); return ret; }
+
+
+// unary minus
+inline veci_i32x8_t operator-(const veci_i32x8_t & v)
+{ return veci_i32x8_t(math::imath_t<int32_t,__m256i>::zeroes()) -= v; }
+
+
+// load aligned
+template<> inline void veci_i32x8_t::loada(const int32_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_i32x8_t::loadu(const int32_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_i32x8_t::storeu(int32_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_i32x8_t operator+(const veci_i32x8_t & v1, const veci_i32x8_t & v2)
+{ return veci_i32x8_t(_mm256_add_epi32(v1.p, v2.p)); }
+inline veci_i32x8_t operator+(const veci_i32x8_t & v, int32_t s)
+{ return veci_i32x8_t(_mm256_add_epi32(v.p, _mm256_set1_epi32(int(s)))); }
+inline veci_i32x8_t operator+(int32_t s, const veci_i32x8_t & v)
+{ return veci_i32x8_t(_mm256_add_epi32(_mm256_set1_epi32(int(s)), v.p)); }
+inline veci_i32x8_t operator+(const veci_i32x8_t & v1, veci_i32x8_t::packed_t v2)
+{ return veci_i32x8_t(_mm256_add_epi32(v1.p, v2)); }
+inline veci_i32x8_t operator+(veci_i32x8_t::packed_t v1, const veci_i32x8_t & v2)
+{ return veci_i32x8_t(_mm256_add_epi32(v1, v2.p)); }
+
+inline veci_i32x8_t operator-(const veci_i32x8_t & v1, const veci_i32x8_t & v2)
+{ return veci_i32x8_t(_mm256_sub_epi32(v1.p, v2.p)); }
+inline veci_i32x8_t operator-(const veci_i32x8_t & v, int32_t s)
+{ return veci_i32x8_t(_mm256_sub_epi32(v.p, _mm256_set1_epi32(int(s)))); }
+inline veci_i32x8_t operator-(int32_t s, const veci_i32x8_t & v)
+{ return veci_i32x8_t(_mm256_sub_epi32(_mm256_set1_epi32(int(s)), v.p)); }
+inline veci_i32x8_t operator-(const veci_i32x8_t & v1, veci_i32x8_t::packed_t v2)
+{ return veci_i32x8_t(_mm256_sub_epi32(v1.p, v2)); }
+inline veci_i32x8_t operator-(veci_i32x8_t::packed_t v1, const veci_i32x8_t & v2)
+{ return veci_i32x8_t(_mm256_sub_epi32(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_i32x8_t operator&(veci_i32x8_t op1, veci_i32x8_t op2)
+{ return veci_i32x8_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_i32x8_t operator&(veci_i32x8_t::packed_t op1, veci_i32x8_t op2)
+{ return veci_i32x8_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_i32x8_t operator&(veci_i32x8_t op1, veci_i32x8_t::packed_t op2)
+{ return veci_i32x8_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_i32x8_t operator|(veci_i32x8_t op1, veci_i32x8_t op2)
+{ return veci_i32x8_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_i32x8_t operator|(veci_i32x8_t::packed_t op1, veci_i32x8_t op2)
+{ return veci_i32x8_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_i32x8_t operator|(veci_i32x8_t op1, veci_i32x8_t::packed_t op2)
+{ return veci_i32x8_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_i32x8_t operator^(veci_i32x8_t op1, veci_i32x8_t op2)
+{ return veci_i32x8_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_i32x8_t operator^(veci_i32x8_t::packed_t op1, veci_i32x8_t op2)
+{ return veci_i32x8_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_i32x8_t operator^(veci_i32x8_t op1, veci_i32x8_t::packed_t op2)
+{ return veci_i32x8_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_i32x8_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_ui32x8_t implementation                                              *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_ui32x8_t veci_t<uint32_t,8,__m256i>
+
+template<> inline veci_ui32x8_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_ui32x8_t::veci_t(uint32_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_ui32x8_t::veci_t(uint32_t v0, uint32_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> template<> inline veci_ui32x8_t::veci_t(uint32_t v0, uint32_t v1, uint32_t v2)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; }
+template<> template<> inline veci_ui32x8_t::veci_t(uint32_t v0, uint32_t v1, uint32_t v2, uint32_t v3)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3; }
+template<> inline veci_ui32x8_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 8 ? l.size() : 8);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi32(p, v2); return *this; }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi32(p, v2); return *this; }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator+=(const veci_ui32x8_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator-=(const veci_ui32x8_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator&=(const veci_ui32x8_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator|=(const veci_ui32x8_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_ui32x8_t & veci_ui32x8_t::operator^=(const veci_ui32x8_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+// unsigned comparisons per max(), all(a <= b) <=> all(max(a,b) == b)
+template<> inline bool veci_ui32x8_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(p, v2)) == -1; }
+template<> inline bool veci_ui32x8_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(p, v2)) == 0; }
+template<> inline bool veci_ui32x8_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_max_epu32(p, v2), p)) == 0; }
+template<> inline bool veci_ui32x8_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_max_epu32(p, v2), v2)) == -1; }
+template<> inline bool veci_ui32x8_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_max_epu32(p, v2), v2)) == 0; }
+template<> inline bool veci_ui32x8_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_max_epu32(p, v2), p)) == -1; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_ui32x8_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi32(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_ui32x8_t::operator==(const veci_ui32x8_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_ui32x8_t::operator!=(const veci_ui32x8_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_ui32x8_t::operator<(const veci_ui32x8_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_ui32x8_t::operator<=(const veci_ui32x8_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_ui32x8_t::operator>(const veci_ui32x8_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_ui32x8_t::operator>=(const veci_ui32x8_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_ui32x8_t::neq_one(const veci_ui32x8_t & v2) const
+{ return neq_one(v2.p); }
+
+
+template<> inline veci_ui32x8_t veci_ui32x8_t::min_(packed_t p1, packed_t p2)
+{ return veci_ui32x8_t(_mm256_min_epu32(p1, p2)); }
+template<> inline veci_ui32x8_t veci_ui32x8_t::min_(const veci_ui32x8_t & v1, const veci_ui32x8_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_ui32x8_t veci_ui32x8_t::max_(packed_t p1, packed_t p2)
+{ return veci_ui32x8_t(_mm256_max_epu32(p1, p2)); }
+template<> inline veci_ui32x8_t veci_ui32x8_t::max_(const veci_ui32x8_t & v1, const veci_ui32x8_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+// load aligned
+template<> inline void veci_ui32x8_t::loada(const uint32_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_ui32x8_t::loadu(const uint32_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_ui32x8_t::storeu(uint32_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_ui32x8_t operator+(const veci_ui32x8_t & v1, const veci_ui32x8_t & v2)
+{ return veci_ui32x8_t(_mm256_add_epi32(v1.p, v2.p)); }
+inline veci_ui32x8_t operator+(const veci_ui32x8_t & v, uint32_t s)
+{ return veci_ui32x8_t(_mm256_add_epi32(v.p, _mm256_set1_epi32(int(s)))); }
+inline veci_ui32x8_t operator+(uint32_t s, const veci_ui32x8_t & v)
+{ return veci_ui32x8_t(_mm256_add_epi32(_mm256_set1_epi32(int(s)), v.p)); }
+inline veci_ui32x8_t operator+(const veci_ui32x8_t & v1, veci_ui32x8_t::packed_t v2)
+{ return veci_ui32x8_t(_mm256_add_epi32(v1.p, v2)); }
+inline veci_ui32x8_t operator+(veci_ui32x8_t::packed_t v1, const veci_ui32x8_t & v2)
+{ return veci_ui32x8_t(_mm256_add_epi32(v1, v2.p)); }
+
+inline veci_ui32x8_t operator-(const veci_ui32x8_t & v1, const veci_ui32x8_t & v2)
+{ return veci_ui32x8_t(_mm256_sub_epi32(v1.p, v2.p)); }
+inline veci_ui32x8_t operator-(const veci_ui32x8_t & v, uint32_t s)
+{ return veci_ui32x8_t(_mm256_sub_epi32(v.p, _mm256_set1_epi32(int(s)))); }
+inline veci_ui32x8_t operator-(uint32_t s, const veci_ui32x8_t & v)
+{ return veci_ui32x8_t(_mm256_sub_epi32(_mm256_set1_epi32(int(s)), v.p)); }
+inline veci_ui32x8_t operator-(const veci_ui32x8_t & v1, veci_ui32x8_t::packed_t v2)
+{ return veci_ui32x8_t(_mm256_sub_epi32(v1.p, v2)); }
+inline veci_ui32x8_t operator-(veci_ui32x8_t::packed_t v1, const veci_ui32x8_t & v2)
+{ return veci_ui32x8_t(_mm256_sub_epi32(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_ui32x8_t operator&(veci_ui32x8_t op1, veci_ui32x8_t op2)
+{ return veci_ui32x8_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_ui32x8_t operator&(veci_ui32x8_t::packed_t op1, veci_ui32x8_t op2)
+{ return veci_ui32x8_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_ui32x8_t operator&(veci_ui32x8_t op1, veci_ui32x8_t::packed_t op2)
+{ return veci_ui32x8_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_ui32x8_t operator|(veci_ui32x8_t op1, veci_ui32x8_t op2)
+{ return veci_ui32x8_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_ui32x8_t operator|(veci_ui32x8_t::packed_t op1, veci_ui32x8_t op2)
+{ return veci_ui32x8_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_ui32x8_t operator|(veci_ui32x8_t op1, veci_ui32x8_t::packed_t op2)
+{ return veci_ui32x8_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_ui32x8_t operator^(veci_ui32x8_t op1, veci_ui32x8_t op2)
+{ return veci_ui32x8_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_ui32x8_t operator^(veci_ui32x8_t::packed_t op1, veci_ui32x8_t op2)
+{ return veci_ui32x8_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_ui32x8_t operator^(veci_ui32x8_t op1, veci_ui32x8_t::packed_t op2)
+{ return veci_ui32x8_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_ui32x8_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_i64x4_t implementation                                               *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_i64x4_t veci_t<int64_t,4,__m256i>
+
+template<> inline veci_i64x4_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_i64x4_t::veci_t(int64_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_i64x4_t::veci_t(int64_t v0, int64_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> inline veci_i64x4_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 4 ? l.size() : 4);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_i64x4_t & veci_i64x4_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi64(p, v2); return *this; }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi64(p, v2); return *this; }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_i64x4_t & veci_i64x4_t::operator+=(const veci_i64x4_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator-=(const veci_i64x4_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator&=(const veci_i64x4_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator|=(const veci_i64x4_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_i64x4_t & veci_i64x4_t::operator^=(const veci_i64x4_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+template<> inline bool veci_i64x4_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi64(p, v2)) == -1; }
+template<> inline bool veci_i64x4_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi64(p, v2)) == 0; }
+template<> inline bool veci_i64x4_t::operator<(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi64(v2, p)) == -1; }
+template<> inline bool veci_i64x4_t::operator<=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi64(p, v2)) == 0; }
+template<> inline bool veci_i64x4_t::operator>(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi64(p, v2)) == -1; }
+template<> inline bool veci_i64x4_t::operator>=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpgt_epi64(v2, p)) == 0; }
+// returns true if at least one value pair is unequal
+template<> inline bool veci_i64x4_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi64(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_i64x4_t::operator==(const veci_i64x4_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_i64x4_t::operator!=(const veci_i64x4_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_i64x4_t::operator<(const veci_i64x4_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_i64x4_t::operator<=(const veci_i64x4_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_i64x4_t::operator>(const veci_i64x4_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_i64x4_t::operator>=(const veci_i64x4_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_i64x4_t::neq_one(const veci_i64x4_t & v2) const
+{ return neq_one(v2.p); }
+
+
+// AVX2 provides no 64 bit min/max (AVX-512VL does), compare + blend instead
+template<> inline veci_i64x4_t veci_i64x4_t::min_(packed_t p1, packed_t p2)
+{
+#if defined(AVX512VL)
+    return veci_i64x4_t(_mm256_min_epi64(p1, p2));
+#else
+    return veci_i64x4_t(_mm256_blendv_epi8(p1, p2, _mm256_cmpgt_epi64(p1, p2)));
+#endif
+}
+template<> inline veci_i64x4_t veci_i64x4_t::min_(const veci_i64x4_t & v1, const veci_i64x4_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_i64x4_t veci_i64x4_t::max_(packed_t p1, packed_t p2)
+{
+#if defined(AVX512VL)
+    return veci_i64x4_t(_mm256_max_epi64(p1, p2));
+#else
+    return veci_i64x4_t(_mm256_blendv_epi8(p2, p1, _mm256_cmpgt_epi64(p1, p2)));
+#endif
+}
+template<> inline veci_i64x4_t veci_i64x4_t::max_(const veci_i64x4_t & v1, const veci_i64x4_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+template<> template<> inline void veci_i64x4_t::abs_()
+{
+#if defined(AVX512VL)
+    p = _mm256_abs_epi64(p);
+#else
+    // no vpabsq before AVX-512VL
+    __m256i negmask = _mm256_cmpgt_epi64(math_t::zeroes(), p);
+    p = _mm256_sub_epi64(_mm256_xor_si256(p, negmask), negmask);
+#endif
+}
+template<> template<> inline veci_i64x4_t veci_i64x4_t::abs_() const
+{ veci_i64x4_t ret(p); ret.abs_(); return ret; }
+
+
+// unary minus
+inline veci_i64x4_t operator-(const veci_i64x4_t & v)
+{ return veci_i64x4_t(math::imath_t<int64_t,__m256i>::zeroes()) -= v; }
+
+
+// load aligned
+template<> inline void veci_i64x4_t::loada(const int64_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_i64x4_t::loadu(const int64_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_i64x4_t::storeu(int64_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_i64x4_t operator+(const veci_i64x4_t & v1, const veci_i64x4_t & v2)
+{ return veci_i64x4_t(_mm256_add_epi64(v1.p, v2.p)); }
+inline veci_i64x4_t operator+(const veci_i64x4_t & v, int64_t s)
+{ return veci_i64x4_t(_mm256_add_epi64(v.p, _mm256_set1_epi64x(int64_t(s)))); }
+inline veci_i64x4_t operator+(int64_t s, const veci_i64x4_t & v)
+{ return veci_i64x4_t(_mm256_add_epi64(_mm256_set1_epi64x(int64_t(s)), v.p)); }
+inline veci_i64x4_t operator+(const veci_i64x4_t & v1, veci_i64x4_t::packed_t v2)
+{ return veci_i64x4_t(_mm256_add_epi64(v1.p, v2)); }
+inline veci_i64x4_t operator+(veci_i64x4_t::packed_t v1, const veci_i64x4_t & v2)
+{ return veci_i64x4_t(_mm256_add_epi64(v1, v2.p)); }
+
+inline veci_i64x4_t operator-(const veci_i64x4_t & v1, const veci_i64x4_t & v2)
+{ return veci_i64x4_t(_mm256_sub_epi64(v1.p, v2.p)); }
+inline veci_i64x4_t operator-(const veci_i64x4_t & v, int64_t s)
+{ return veci_i64x4_t(_mm256_sub_epi64(v.p, _mm256_set1_epi64x(int64_t(s)))); }
+inline veci_i64x4_t operator-(int64_t s, const veci_i64x4_t & v)
+{ return veci_i64x4_t(_mm256_sub_epi64(_mm256_set1_epi64x(int64_t(s)), v.p)); }
+inline veci_i64x4_t operator-(const veci_i64x4_t & v1, veci_i64x4_t::packed_t v2)
+{ return veci_i64x4_t(_mm256_sub_epi64(v1.p, v2)); }
+inline veci_i64x4_t operator-(veci_i64x4_t::packed_t v1, const veci_i64x4_t & v2)
+{ return veci_i64x4_t(_mm256_sub_epi64(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_i64x4_t operator&(veci_i64x4_t op1, veci_i64x4_t op2)
+{ return veci_i64x4_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_i64x4_t operator&(veci_i64x4_t::packed_t op1, veci_i64x4_t op2)
+{ return veci_i64x4_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_i64x4_t operator&(veci_i64x4_t op1, veci_i64x4_t::packed_t op2)
+{ return veci_i64x4_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_i64x4_t operator|(veci_i64x4_t op1, veci_i64x4_t op2)
+{ return veci_i64x4_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_i64x4_t operator|(veci_i64x4_t::packed_t op1, veci_i64x4_t op2)
+{ return veci_i64x4_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_i64x4_t operator|(veci_i64x4_t op1, veci_i64x4_t::packed_t op2)
+{ return veci_i64x4_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_i64x4_t operator^(veci_i64x4_t op1, veci_i64x4_t op2)
+{ return veci_i64x4_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_i64x4_t operator^(veci_i64x4_t::packed_t op1, veci_i64x4_t op2)
+{ return veci_i64x4_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_i64x4_t operator^(veci_i64x4_t op1, veci_i64x4_t::packed_t op2)
+{ return veci_i64x4_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_i64x4_t
+
+
+/*****************************************************************************
+ *                                                                           *
+ * veci_ui64x4_t implementation                                              *
+ *                                                                           *
+ *****************************************************************************/
+#define veci_ui64x4_t veci_t<uint64_t,4,__m256i>
+
+template<> inline veci_ui64x4_t::veci_t()
+{ p = math_t::zeroes(); }
+template<> inline veci_ui64x4_t::veci_t(uint64_t v0)
+{ p = math_t::zeroes();
+  v[0] = v0; }
+template<> inline veci_ui64x4_t::veci_t(uint64_t v0, uint64_t v1)
+{ p = math_t::zeroes();
+  v[0] = v0; v[1] = v1; }
+template<> inline veci_ui64x4_t::veci_t(std::initializer_list<type_t> l)
+{
+    p = math_t::zeroes();
+    int count = int(l.size() <= 4 ? l.size() : 4);
+    int i = 0; for(auto it = l.begin(); i < count; ++i, ++it) v[i] = *it;
+}
+
+
+// vector addition, subtraction (not saturated)
+// and logical operations
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator+=(packed_t v2)
+{ p = _mm256_add_epi64(p, v2); return *this; }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator-=(packed_t v2)
+{ p = _mm256_sub_epi64(p, v2); return *this; }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator&=(packed_t v2)
+{ p = _mm256_and_si256(p, v2); return *this; }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator|=(packed_t v2)
+{ p = _mm256_or_si256(p, v2); return *this; }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator^=(packed_t v2)
+{ p = _mm256_xor_si256(p, v2); return *this; }
+
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator+=(const veci_ui64x4_t & v2)
+{ return operator+=(v2.p); }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator-=(const veci_ui64x4_t & v2)
+{ return operator-=(v2.p); }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator&=(const veci_ui64x4_t & v2)
+{ return operator&=(v2.p); }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator|=(const veci_ui64x4_t & v2)
+{ return operator|=(v2.p); }
+template<> inline veci_ui64x4_t & veci_ui64x4_t::operator^=(const veci_ui64x4_t & v2)
+{ return operator^=(v2.p); }
+
+
+// packed vector comparisons
+// (true if the comparison holds for all element pairs)
+// unsigned comparisons per signed comparison of the values with flipped sign bits
+template<> inline bool veci_ui64x4_t::operator==(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi64(p, v2)) == -1; }
+template<> inline bool veci_ui64x4_t::operator!=(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi64(p, v2)) == 0; }
+template<> inline bool veci_ui64x4_t::operator<(packed_t v2) const
+{
+#if defined(AVX512VL)
+    return _mm256_cmplt_epu64_mask(p, v2) == 0xF;
+#else
+    return _mm256_movemask_epi8(_mm256_cmpgt_epi64(_mm256_xor_si256(v2, math_t::sign_mask()), _mm256_xor_si256(p, math_t::sign_mask()))) == -1;
+#endif
+}
+template<> inline bool veci_ui64x4_t::operator<=(packed_t v2) const
+{
+#if defined(AVX512VL)
+    return _mm256_cmple_epu64_mask(p, v2) == 0xF;
+#else
+    return _mm256_movemask_epi8(_mm256_cmpgt_epi64(_mm256_xor_si256(p, math_t::sign_mask()), _mm256_xor_si256(v2, math_t::sign_mask()))) == 0;
+#endif
+}
+template<> inline bool veci_ui64x4_t::operator>(packed_t v2) const
+{
+#if defined(AVX512VL)
+    return _mm256_cmpgt_epu64_mask(p, v2) == 0xF;
+#else
+    return _mm256_movemask_epi8(_mm256_cmpgt_epi64(_mm256_xor_si256(p, math_t::sign_mask()), _mm256_xor_si256(v2, math_t::sign_mask()))) == -1;
+#endif
+}
+template<> inline bool veci_ui64x4_t::operator>=(packed_t v2) const
+{
+#if defined(AVX512VL)
+    return _mm256_cmpge_epu64_mask(p, v2) == 0xF;
+#else
+    return _mm256_movemask_epi8(_mm256_cmpgt_epi64(_mm256_xor_si256(v2, math_t::sign_mask()), _mm256_xor_si256(p, math_t::sign_mask()))) == 0;
+#endif
+}
+// returns true if at least one value pair is unequal
+template<> inline bool veci_ui64x4_t::neq_one(packed_t v2) const
+{ return _mm256_movemask_epi8(_mm256_cmpeq_epi64(p, v2)) != -1; }
+
+// vector comparisons
+template<> inline bool veci_ui64x4_t::operator==(const veci_ui64x4_t & v2) const
+{ return operator==(v2.p); }
+template<> inline bool veci_ui64x4_t::operator!=(const veci_ui64x4_t & v2) const
+{ return operator!=(v2.p); }
+template<> inline bool veci_ui64x4_t::operator<(const veci_ui64x4_t & v2) const
+{ return operator<(v2.p); }
+template<> inline bool veci_ui64x4_t::operator<=(const veci_ui64x4_t & v2) const
+{ return operator<=(v2.p); }
+template<> inline bool veci_ui64x4_t::operator>(const veci_ui64x4_t & v2) const
+{ return operator>(v2.p); }
+template<> inline bool veci_ui64x4_t::operator>=(const veci_ui64x4_t & v2) const
+{ return operator>=(v2.p); }
+template<> inline bool veci_ui64x4_t::neq_one(const veci_ui64x4_t & v2) const
+{ return neq_one(v2.p); }
+
+
+// AVX2 provides no 64 bit min/max (AVX-512VL does), compare + blend instead
+template<> inline veci_ui64x4_t veci_ui64x4_t::min_(packed_t p1, packed_t p2)
+{
+#if defined(AVX512VL)
+    return veci_ui64x4_t(_mm256_min_epu64(p1, p2));
+#else
+    return veci_ui64x4_t(_mm256_blendv_epi8(p1, p2, _mm256_cmpgt_epi64(_mm256_xor_si256(p1, math_t::sign_mask()), _mm256_xor_si256(p2, math_t::sign_mask()))));
+#endif
+}
+template<> inline veci_ui64x4_t veci_ui64x4_t::min_(const veci_ui64x4_t & v1, const veci_ui64x4_t & v2)
+{ return min_(v1.p, v2.p); }
+template<> inline veci_ui64x4_t veci_ui64x4_t::max_(packed_t p1, packed_t p2)
+{
+#if defined(AVX512VL)
+    return veci_ui64x4_t(_mm256_max_epu64(p1, p2));
+#else
+    return veci_ui64x4_t(_mm256_blendv_epi8(p2, p1, _mm256_cmpgt_epi64(_mm256_xor_si256(p1, math_t::sign_mask()), _mm256_xor_si256(p2, math_t::sign_mask()))));
+#endif
+}
+template<> inline veci_ui64x4_t veci_ui64x4_t::max_(const veci_ui64x4_t & v1, const veci_ui64x4_t & v2)
+{ return max_(v1.p, v2.p); }
+
+
+// load aligned
+template<> inline void veci_ui64x4_t::loada(const uint64_t * ptr)
+{ p = _mm256_load_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// load unaligned
+template<> inline void veci_ui64x4_t::loadu(const uint64_t * ptr)
+{ p = _mm256_loadu_si256(reinterpret_cast<const packed_t *>(ptr)); }
+// store unaligned
+template<> inline void veci_ui64x4_t::storeu(uint64_t * ptr)
+{ _mm256_storeu_si256(reinterpret_cast<packed_t *>(ptr), p); }
+
+
+// free-standing arithmetic operations (element-wise)
+inline veci_ui64x4_t operator+(const veci_ui64x4_t & v1, const veci_ui64x4_t & v2)
+{ return veci_ui64x4_t(_mm256_add_epi64(v1.p, v2.p)); }
+inline veci_ui64x4_t operator+(const veci_ui64x4_t & v, uint64_t s)
+{ return veci_ui64x4_t(_mm256_add_epi64(v.p, _mm256_set1_epi64x(int64_t(s)))); }
+inline veci_ui64x4_t operator+(uint64_t s, const veci_ui64x4_t & v)
+{ return veci_ui64x4_t(_mm256_add_epi64(_mm256_set1_epi64x(int64_t(s)), v.p)); }
+inline veci_ui64x4_t operator+(const veci_ui64x4_t & v1, veci_ui64x4_t::packed_t v2)
+{ return veci_ui64x4_t(_mm256_add_epi64(v1.p, v2)); }
+inline veci_ui64x4_t operator+(veci_ui64x4_t::packed_t v1, const veci_ui64x4_t & v2)
+{ return veci_ui64x4_t(_mm256_add_epi64(v1, v2.p)); }
+
+inline veci_ui64x4_t operator-(const veci_ui64x4_t & v1, const veci_ui64x4_t & v2)
+{ return veci_ui64x4_t(_mm256_sub_epi64(v1.p, v2.p)); }
+inline veci_ui64x4_t operator-(const veci_ui64x4_t & v, uint64_t s)
+{ return veci_ui64x4_t(_mm256_sub_epi64(v.p, _mm256_set1_epi64x(int64_t(s)))); }
+inline veci_ui64x4_t operator-(uint64_t s, const veci_ui64x4_t & v)
+{ return veci_ui64x4_t(_mm256_sub_epi64(_mm256_set1_epi64x(int64_t(s)), v.p)); }
+inline veci_ui64x4_t operator-(const veci_ui64x4_t & v1, veci_ui64x4_t::packed_t v2)
+{ return veci_ui64x4_t(_mm256_sub_epi64(v1.p, v2)); }
+inline veci_ui64x4_t operator-(veci_ui64x4_t::packed_t v1, const veci_ui64x4_t & v2)
+{ return veci_ui64x4_t(_mm256_sub_epi64(v1, v2.p)); }
+
+
+// free-standing bit-wise logical operations
+inline veci_ui64x4_t operator&(veci_ui64x4_t op1, veci_ui64x4_t op2)
+{ return veci_ui64x4_t(_mm256_and_si256(op1.p, op2.p)); }
+inline veci_ui64x4_t operator&(veci_ui64x4_t::packed_t op1, veci_ui64x4_t op2)
+{ return veci_ui64x4_t(_mm256_and_si256(op1, op2.p)); }
+inline veci_ui64x4_t operator&(veci_ui64x4_t op1, veci_ui64x4_t::packed_t op2)
+{ return veci_ui64x4_t(_mm256_and_si256(op1.p, op2)); }
+inline veci_ui64x4_t operator|(veci_ui64x4_t op1, veci_ui64x4_t op2)
+{ return veci_ui64x4_t(_mm256_or_si256(op1.p, op2.p)); }
+inline veci_ui64x4_t operator|(veci_ui64x4_t::packed_t op1, veci_ui64x4_t op2)
+{ return veci_ui64x4_t(_mm256_or_si256(op1, op2.p)); }
+inline veci_ui64x4_t operator|(veci_ui64x4_t op1, veci_ui64x4_t::packed_t op2)
+{ return veci_ui64x4_t(_mm256_or_si256(op1.p, op2)); }
+inline veci_ui64x4_t operator^(veci_ui64x4_t op1, veci_ui64x4_t op2)
+{ return veci_ui64x4_t(_mm256_xor_si256(op1.p, op2.p)); }
+inline veci_ui64x4_t operator^(veci_ui64x4_t::packed_t op1, veci_ui64x4_t op2)
+{ return veci_ui64x4_t(_mm256_xor_si256(op1, op2.p)); }
+inline veci_ui64x4_t operator^(veci_ui64x4_t op1, veci_ui64x4_t::packed_t op2)
+{ return veci_ui64x4_t(_mm256_xor_si256(op1.p, op2)); }
+
+
+#undef veci_ui64x4_t
+
+
+#endif // defined(PVECI_INTEL) && defined(AVX2)
+
+
+
+#if defined(_MSC_VER)
+#define PVECI_ALIGN(x) __declspec(align(x))
+#elif defined(__GNUC__)
+#define PVECI_ALIGN(x) __attribute__((aligned (x)))
+#endif
+
+#if defined(PVECI_INTEL)
+
+typedef veci_t<int8_t,16,__m128i> PVECI_ALIGN(16) veci_i8x16_t;
+typedef veci_t<int16_t,8,__m128i> PVECI_ALIGN(16) veci_i16x8_t;
+typedef veci_t<int32_t,4,__m128i> PVECI_ALIGN(16) veci_i32x4_t;
+typedef veci_t<int64_t,2,__m128i> PVECI_ALIGN(16) veci_i64x2_t;
+
+typedef veci_t<uint8_t,16,__m128i> PVECI_ALIGN(16) veci_ui8x16_t;
+typedef veci_t<uint16_t,8,__m128i> PVECI_ALIGN(16) veci_ui16x8_t;
+typedef veci_t<uint32_t,4,__m128i> PVECI_ALIGN(16) veci_ui32x4_t;
+typedef veci_t<uint64_t,2,__m128i> PVECI_ALIGN(16) veci_ui64x2_t;
+
+#if defined(AVX2)
+typedef veci_t<int8_t,32,__m256i> PVECI_ALIGN(32) veci_i8x32_t;
+typedef veci_t<int16_t,16,__m256i> PVECI_ALIGN(32) veci_i16x16_t;
+typedef veci_t<int32_t,8,__m256i> PVECI_ALIGN(32) veci_i32x8_t;
+typedef veci_t<int64_t,4,__m256i> PVECI_ALIGN(32) veci_i64x4_t;
+
+typedef veci_t<uint8_t,32,__m256i> PVECI_ALIGN(32) veci_ui8x32_t;
+typedef veci_t<uint16_t,16,__m256i> PVECI_ALIGN(32) veci_ui16x16_t;
+typedef veci_t<uint32_t,8,__m256i> PVECI_ALIGN(32) veci_ui32x8_t;
+typedef veci_t<uint64_t,4,__m256i> PVECI_ALIGN(32) veci_ui64x4_t;
+#endif // defined(AVX2)
+
+#elif defined(PVECI_ARM)
+
+#ifndef PVECI_ARM_GCC
+
+typedef veci_t<int8_t,16,__n128> PVECI_ALIGN(8) veci_i8x16_t;
+typedef veci_t<int16_t,8,__n128> PVECI_ALIGN(8) veci_i16x8_t;
+typedef veci_t<int32_t,4,__n128> PVECI_ALIGN(8) veci_i32x4_t;
+typedef veci_t<int64_t,2,__n128> PVECI_ALIGN(8) veci_i64x2_t;
+
+typedef veci_t<uint8_t,16,__n128> PVECI_ALIGN(8) veci_ui8x16_t;
+typedef veci_t<uint16_t,8,__n128> PVECI_ALIGN(8) veci_ui16x8_t;
+typedef veci_t<uint32_t,4,__n128> PVECI_ALIGN(8) veci_ui32x4_t;
+typedef veci_t<uint64_t,2,__n128> PVECI_ALIGN(8) veci_ui64x2_t;
+
+#else
+
+typedef veci_t<int8_t,16,int8x16_t> PVECI_ALIGN(8) veci_i8x16_t;
+typedef veci_t<int16_t,8,int16x8_t> PVECI_ALIGN(8) veci_i16x8_t;
+typedef veci_t<int32_t,4,int32x4_t> PVECI_ALIGN(8) veci_i32x4_t;
+typedef veci_t<int64_t,2,int64x2_t> PVECI_ALIGN(8) veci_i64x2_t;
+
+typedef veci_t<uint8_t,16,uint8x16_t> PVECI_ALIGN(8) veci_ui8x16_t;
+typedef veci_t<uint16_t,8,uint16x8_t> PVECI_ALIGN(8) veci_ui16x8_t;
+typedef veci_t<uint32_t,4,uint32x4_t> PVECI_ALIGN(8) veci_ui32x4_t;
+typedef veci_t<uint64_t,2,uint64x2_t> PVECI_ALIGN(8) veci_ui64x2_t;
+
+#endif
+
+#endif
+
+namespace ipriv {
+    // element type of a vector type, vecf_t in pvecf.h
+    template<typename V> struct vec_elem;
+    template<typename T, unsigned N, typename P> struct vec_elem<veci_t<T,N,P> > { typedef T type; };
+}
+
+
+/*****************************************************************************
+ *                                                                           *
+ * shift and rotate operations (all veci_t types)                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+element-wise shifts and rotations
+---------------------------------
+  shl<S>(v), shl(v, n)                 logical shift left
+  shr_logical<S>(v), shr_logical(v, n) logical shift right (zeroes shifted in)
+  shr_arith<S>(v), shr_arith(v, n)     arithmetic shift right (sign bit shifted in)
+  rotl<S>(v), rotl(v, n)               rotate left
+  rotr<S>(v), rotr(v, n)               rotate right
+  rotl(v, vn), rotr(v, vn)             rotate each element by the count of the
+                                       same element of the veci_t vn
+
+the shift operations are defined by the element width only, so shr_logical() and
+shr_arith() are available for signed and unsigned element types
+immediate counts S have to be less than the element width, runtime counts n
+greater or equal the element width result in 0 (shl, shr_logical) or all sign
+bits (shr_arith); rotation counts are taken modulo the element width
+
+SSE2 has no 8 bit shifts (done per 16 bit shift + mask) and no 64 bit arithmetic
+right shift (done per logical shift + replicated sign); the per element rotations
+are done per conditional rotations by w/2, .., 2, 1 selected by the bits of the
+counts, AVX2 has them for 32/64 bit elements (vpsllv/vpsrlv), NEON for uint32_t
+(vshl by register)
+
+full register shifts (bytes, identical for all element types)
+--------------------------------------------------------------
+  bslli<B>(v)         shift left by B bytes (towards higher element indices)
+  bsrli<B>(v)         shift right by B bytes (towards lower element indices)
+  alignr<B>(hi, lo)   bytes B..B+15 of the 32 byte concatenation {lo,hi}
+(for 256 bit vectors these work per 128 bit lane, see the AVX2 section above)
+*/
+
+namespace ipriv {
+
+template<typename t_type, typename t_packed> struct shift_t;
+
+#if defined(PVECI_INTEL)
+
+template<unsigned W> struct shift128_t;
+
+template<> struct shift128_t<8>
+{
+    typedef imath_t<uint8_t,__m128i> math_t;
+
+    template<unsigned S> static inline __m128i shli(__m128i v)
+    { return S == 0 ? v : _mm_and_si128(_mm_slli_epi16(v, S), math_t::mask_zlower<S ? S : 1>()); }
+    template<unsigned S> static inline __m128i srli(__m128i v)
+    { return S == 0 ? v : _mm_and_si128(_mm_srli_epi16(v, S), math_t::mask_zupper<S ? S : 1>()); }
+    template<unsigned S> static inline __m128i srai(__m128i v)
+    {
+        // odd bytes: shifted in place, even bytes: moved to the upper half first
+        __m128i hi = _mm_srai_epi16(v, S);
+        __m128i lo = _mm_srai_epi16(_mm_slli_epi16(v, 8), S);
+        return _mm_or_si128(_mm_and_si128(hi, _mm_slli_epi16(math_t::onebits(), 8)), _mm_srli_epi16(lo, 8));
+    }
+    static inline __m128i sll(__m128i v, unsigned n)
+    {
+        n = n > 8 ? 8 : n;
+        return _mm_and_si128(_mm_sll_epi16(v, _mm_cvtsi32_si128(int(n))), _mm_set1_epi8(char((0xFFu << n) & 0xFF)));
+    }
+    static inline __m128i srl(__m128i v, unsigned n)
+    {
+        n = n > 8 ? 8 : n;
+        return _mm_and_si128(_mm_srl_epi16(v, _mm_cvtsi32_si128(int(n))), _mm_set1_epi8(char(0xFFu >> n)));
+    }
+    static inline __m128i sra(__m128i v, unsigned n)
+    {
+        __m128i cnt = _mm_cvtsi32_si128(int(n > 7 ? 7 : n));
+        __m128i hi = _mm_sra_epi16(v, cnt);
+        __m128i lo = _mm_sra_epi16(_mm_slli_epi16(v, 8), cnt);
+        return _mm_or_si128(_mm_and_si128(hi, _mm_slli_epi16(math_t::onebits(), 8)), _mm_srli_epi16(lo, 8));
+    }
+    template<unsigned S> static inline __m128i roli(__m128i v)
+    { return _mm_or_si128(shli<S>(v), srli<(8 - S) % 8>(v)); }
+};
+
+template<> struct shift128_t<16>
+{
+    template<unsigned S> static inline __m128i shli(__m128i v) { return _mm_slli_epi16(v, S); }
+    template<unsigned S> static inline __m128i srli(__m128i v) { return _mm_srli_epi16(v, S); }
+    template<unsigned S> static inline __m128i srai(__m128i v) { return _mm_srai_epi16(v, S); }
+    static inline __m128i sll(__m128i v, unsigned n) { return _mm_sll_epi16(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m128i srl(__m128i v, unsigned n) { return _mm_srl_epi16(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m128i sra(__m128i v, unsigned n) { return _mm_sra_epi16(v, _mm_cvtsi32_si128(int(n))); }
+    template<unsigned S> static inline __m128i roli(__m128i v)
+    { return _mm_or_si128(_mm_slli_epi16(v, S), _mm_srli_epi16(v, (16 - S) % 16)); }
+};
+
+template<> struct shift128_t<32>
+{
+    template<unsigned S> static inline __m128i shli(__m128i v) { return _mm_slli_epi32(v, S); }
+    template<unsigned S> static inline __m128i srli(__m128i v) { return _mm_srli_epi32(v, S); }
+    template<unsigned S> static inline __m128i srai(__m128i v) { return _mm_srai_epi32(v, S); }
+    static inline __m128i sll(__m128i v, unsigned n) { return _mm_sll_epi32(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m128i srl(__m128i v, unsigned n) { return _mm_srl_epi32(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m128i sra(__m128i v, unsigned n) { return _mm_sra_epi32(v, _mm_cvtsi32_si128(int(n))); }
+    template<unsigned S> static inline __m128i roli(__m128i v)
+    {
+        if(S == 16) // swap the 16 bit halves (single shuffle per half)
+            return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_or_si128(_mm_slli_epi32(v, S), _mm_srli_epi32(v, (32 - S) % 32));
+    }
+};
+
+template<> struct shift128_t<64>
+{
+    // {sign(e0)*2,sign(e1)*2} (each 32 bit half filled with the sign bit of the 64 bit element)
+    static inline __m128i sign64(__m128i v)
+    { return _mm_srai_epi32(_mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 1, 1)), 31); }
+
+    template<unsigned S> static inline __m128i shli(__m128i v) { return _mm_slli_epi64(v, S); }
+    template<unsigned S> static inline __m128i srli(__m128i v) { return _mm_srli_epi64(v, S); }
+    template<unsigned S> static inline __m128i srai(__m128i v)
+    {
+        // shift count 64 yields 0 (needed for S == 0)
+        return _mm_or_si128(_mm_srli_epi64(v, S), _mm_slli_epi64(sign64(v), 64 - S));
+    }
+    static inline __m128i sll(__m128i v, unsigned n) { return _mm_sll_epi64(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m128i srl(__m128i v, unsigned n) { return _mm_srl_epi64(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m128i sra(__m128i v, unsigned n)
+    {
+        n = n > 63 ? 63 : n;
+        return
+            _mm_or_si128(
+                _mm_srl_epi64(v, _mm_cvtsi32_si128(int(n))),
+                _mm_sll_epi64(sign64(v), _mm_cvtsi32_si128(int(64 - n)))
+            );
+    }
+    template<unsigned S> static inline __m128i roli(__m128i v)
+    {
+        if(S == 32) // swap the 32 bit halves
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_or_si128(_mm_slli_epi64(v, S), _mm_srli_epi64(v, (64 - S) % 64));
+    }
+};
+
+template<typename t_type> struct shift_t<t_type,__m128i> : shift128_t<sizeof(t_type)*8>
+{
+    template<unsigned B> static inline __m128i bslli(__m128i v) { return _mm_slli_si128(v, B); }
+    template<unsigned B> static inline __m128i bsrli(__m128i v) { return _mm_srli_si128(v, B); }
+    template<unsigned B> static inline __m128i alignr(__m128i hi, __m128i lo)
+    {
+# if defined(SSSE3)
+        return _mm_alignr_epi8(hi, lo, B);
+# else
+        return B == 0 ? lo : _mm_or_si128(_mm_srli_si128(lo, B), _mm_slli_si128(hi, (16 - B) % 16));
+# endif
+    }
+};
+
+#if defined(AVX2)
+
+// 256 bit vectors: same as above, the element shifts are not affected by the
+// 128 bit lanes
+template<unsigned W> struct shift256_t;
+
+template<> struct shift256_t<8>
+{
+    typedef imath_t<uint8_t,__m256i> math_t;
+
+    template<unsigned S> static inline __m256i shli(__m256i v)
+    { return S == 0 ? v : _mm256_and_si256(_mm256_slli_epi16(v, S), math_t::mask_zlower<S ? S : 1>()); }
+    template<unsigned S> static inline __m256i srli(__m256i v)
+    { return S == 0 ? v : _mm256_and_si256(_mm256_srli_epi16(v, S), math_t::mask_zupper<S ? S : 1>()); }
+    template<unsigned S> static inline __m256i srai(__m256i v)
+    {
+        // odd bytes: shifted in place, even bytes: moved to the upper half first
+        __m256i hi = _mm256_srai_epi16(v, S);
+        __m256i lo = _mm256_srai_epi16(_mm256_slli_epi16(v, 8), S);
+        return _mm256_or_si256(_mm256_and_si256(hi, _mm256_slli_epi16(math_t::onebits(), 8)), _mm256_srli_epi16(lo, 8));
+    }
+    static inline __m256i sll(__m256i v, unsigned n)
+    {
+        n = n > 8 ? 8 : n;
+        return _mm256_and_si256(_mm256_sll_epi16(v, _mm_cvtsi32_si128(int(n))), _mm256_set1_epi8(char((0xFFu << n) & 0xFF)));
+    }
+    static inline __m256i srl(__m256i v, unsigned n)
+    {
+        n = n > 8 ? 8 : n;
+        return _mm256_and_si256(_mm256_srl_epi16(v, _mm_cvtsi32_si128(int(n))), _mm256_set1_epi8(char(0xFFu >> n)));
+    }
+    static inline __m256i sra(__m256i v, unsigned n)
+    {
+        __m128i cnt = _mm_cvtsi32_si128(int(n > 7 ? 7 : n));
+        __m256i hi = _mm256_sra_epi16(v, cnt);
+        __m256i lo = _mm256_sra_epi16(_mm256_slli_epi16(v, 8), cnt);
+        return _mm256_or_si256(_mm256_and_si256(hi, _mm256_slli_epi16(math_t::onebits(), 8)), _mm256_srli_epi16(lo, 8));
+    }
+    template<unsigned S> static inline __m256i roli(__m256i v)
+    { return _mm256_or_si256(shli<S>(v), srli<(8 - S) % 8>(v)); }
+};
+
+template<> struct shift256_t<16>
+{
+    template<unsigned S> static inline __m256i shli(__m256i v) { return _mm256_slli_epi16(v, S); }
+    template<unsigned S> static inline __m256i srli(__m256i v) { return _mm256_srli_epi16(v, S); }
+    template<unsigned S> static inline __m256i srai(__m256i v) { return _mm256_srai_epi16(v, S); }
+    static inline __m256i sll(__m256i v, unsigned n) { return _mm256_sll_epi16(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m256i srl(__m256i v, unsigned n) { return _mm256_srl_epi16(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m256i sra(__m256i v, unsigned n) { return _mm256_sra_epi16(v, _mm_cvtsi32_si128(int(n))); }
+    template<unsigned S> static inline __m256i roli(__m256i v)
+    { return _mm256_or_si256(_mm256_slli_epi16(v, S), _mm256_srli_epi16(v, (16 - S) % 16)); }
+};
+
+template<> struct shift256_t<32>
+{
+    template<unsigned S> static inline __m256i shli(__m256i v) { return _mm256_slli_epi32(v, S); }
+    template<unsigned S> static inline __m256i srli(__m256i v) { return _mm256_srli_epi32(v, S); }
+    template<unsigned S> static inline __m256i srai(__m256i v) { return _mm256_srai_epi32(v, S); }
+    static inline __m256i sll(__m256i v, unsigned n) { return _mm256_sll_epi32(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m256i srl(__m256i v, unsigned n) { return _mm256_srl_epi32(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m256i sra(__m256i v, unsigned n) { return _mm256_sra_epi32(v, _mm_cvtsi32_si128(int(n))); }
+    template<unsigned S> static inline __m256i roli(__m256i v)
+    {
+        if(S == 16) // swap the 16 bit halves (single shuffle per half)
+            return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm256_or_si256(_mm256_slli_epi32(v, S), _mm256_srli_epi32(v, (32 - S) % 32));
+    }
+};
+
+template<> struct shift256_t<64>
+{
+    // {sign(e0)*2,sign(e1)*2} (each 32 bit half filled with the sign bit of the 64 bit element)
+    static inline __m256i sign64(__m256i v)
+    { return _mm256_srai_epi32(_mm256_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 1, 1)), 31); }
+
+    template<unsigned S> static inline __m256i shli(__m256i v) { return _mm256_slli_epi64(v, S); }
+    template<unsigned S> static inline __m256i srli(__m256i v) { return _mm256_srli_epi64(v, S); }
+    template<unsigned S> static inline __m256i srai(__m256i v)
+    {
+        // shift count 64 yields 0 (needed for S == 0)
+        return _mm256_or_si256(_mm256_srli_epi64(v, S), _mm256_slli_epi64(sign64(v), 64 - S));
+    }
+    static inline __m256i sll(__m256i v, unsigned n) { return _mm256_sll_epi64(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m256i srl(__m256i v, unsigned n) { return _mm256_srl_epi64(v, _mm_cvtsi32_si128(int(n))); }
+    static inline __m256i sra(__m256i v, unsigned n)
+    {
+        n = n > 63 ? 63 : n;
+        return
+            _mm256_or_si256(
+                _mm256_srl_epi64(v, _mm_cvtsi32_si128(int(n))),
+                _mm256_sll_epi64(sign64(v), _mm_cvtsi32_si128(int(64 - n)))
+            );
+    }
+    template<unsigned S> static inline __m256i roli(__m256i v)
+    {
+        if(S == 32) // swap the 32 bit halves
+            return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm256_or_si256(_mm256_slli_epi64(v, S), _mm256_srli_epi64(v, (64 - S) % 64));
+    }
+};
+
+template<typename t_type> struct shift_t<t_type,__m256i> : shift256_t<sizeof(t_type)*8>
+{
+    // the byte shifts work per 128 bit lane (no bytes cross between the lanes)
+    template<unsigned B> static inline __m256i bslli(__m256i v) { return _mm256_slli_si256(v, B); }
+    template<unsigned B> static inline __m256i bsrli(__m256i v) { return _mm256_srli_si256(v, B); }
+    template<unsigned B> static inline __m256i alignr(__m256i hi, __m256i lo) { return _mm256_alignr_epi8(hi, lo, B); }
+};
+
+#endif // defined(AVX2)
+
+#elif defined(PVECI_ARM)
+
+#define PVECI_ID_(v) (v)
+
+// NEON has shifts for all element widths, right shifts by register are done
+// per left shift with negative count, rotations per shift + shift-right-insert
+#define PVECI_SHIFT_NEON_(t_type, w, usfx, ssfx, s_type, to_u, from_u, to_s, from_s, to_u8, from_u8) \
+template<typename t_packed> struct shift_t<t_type,t_packed>                                          \
+{                                                                                                     \
+    template<unsigned S> static inline t_packed shli(t_packed v)                                      \
+    { return from_u(vshlq_n_##usfx(to_u(v), S)); }                                                    \
+    template<unsigned S> static inline t_packed srli(t_packed v)                                      \
+    { return S == 0 ? v : from_u(vshrq_n_##usfx(to_u(v), S ? S : 1)); }                               \
+    template<unsigned S> static inline t_packed srai(t_packed v)                                      \
+    { return S == 0 ? v : from_s(vshrq_n_##ssfx(to_s(v), S ? S : 1)); }                               \
+    static inline t_packed sll(t_packed v, unsigned n)                                                \
+    { return from_u(vshlq_##usfx(to_u(v), vdupq_n_##ssfx(s_type(n > w ? w : n)))); }                  \
+    static inline t_packed srl(t_packed v, unsigned n)                                                \
+    { return from_u(vshlq_##usfx(to_u(v), vdupq_n_##ssfx(s_type(-int(n > w ? w : n))))); }            \
+    static inline t_packed sra(t_packed v, unsigned n)                                                \
+    { return from_s(vshlq_##ssfx(to_s(v), vdupq_n_##ssfx(s_type(-int(n > w ? w : n))))); }            \
+    template<unsigned S> static inline t_packed roli(t_packed v)                                      \
+    { return from_u(vsriq_n_##usfx(vshlq_n_##usfx(to_u(v), S), to_u(v), w - S)); }                    \
+    template<unsigned B> static inline t_packed bslli(t_packed v)                                     \
+    { return B == 0 ? v : from_u8(vextq_u8(vdupq_n_u8(0), to_u8(v), (16 - B) % 16)); }                \
+    template<unsigned B> static inline t_packed bsrli(t_packed v)                                     \
+    { return B == 0 ? v : from_u8(B >= 16 ? vdupq_n_u8(0) : vextq_u8(to_u8(v), vdupq_n_u8(0), B % 16)); } \
+    template<unsigned B> static inline t_packed alignr(t_packed hi, t_packed lo)                      \
+    { return from_u8(vextq_u8(to_u8(lo), to_u8(hi), B)); }                                            \
+};
+
+#ifndef PVECI_ARM_GCC
+// MSVC: all vector types are __n128 (no reinterpretation needed)
+PVECI_SHIFT_NEON_(int8_t,    8, u8,  s8,  int8_t,  PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(uint8_t,   8, u8,  s8,  int8_t,  PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(int16_t,  16, u16, s16, int16_t, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(uint16_t, 16, u16, s16, int16_t, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(int32_t,  32, u32, s32, int32_t, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(uint32_t, 32, u32, s32, int32_t, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(int64_t,  64, u64, s64, int64_t, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+PVECI_SHIFT_NEON_(uint64_t, 64, u64, s64, int64_t, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_, PVECI_ID_)
+#else
+PVECI_SHIFT_NEON_(int8_t,    8, u8,  s8,  int8_t,  vreinterpretq_u8_s8,   vreinterpretq_s8_u8,   PVECI_ID_,             PVECI_ID_,             vreinterpretq_u8_s8,  vreinterpretq_s8_u8)
+PVECI_SHIFT_NEON_(uint8_t,   8, u8,  s8,  int8_t,  PVECI_ID_,             PVECI_ID_,             vreinterpretq_s8_u8,   vreinterpretq_u8_s8,   PVECI_ID_,            PVECI_ID_)
+PVECI_SHIFT_NEON_(int16_t,  16, u16, s16, int16_t, vreinterpretq_u16_s16, vreinterpretq_s16_u16, PVECI_ID_,             PVECI_ID_,             vreinterpretq_u8_s16, vreinterpretq_s16_u8)
+PVECI_SHIFT_NEON_(uint16_t, 16, u16, s16, int16_t, PVECI_ID_,             PVECI_ID_,             vreinterpretq_s16_u16, vreinterpretq_u16_s16, vreinterpretq_u8_u16, vreinterpretq_u16_u8)
+PVECI_SHIFT_NEON_(int32_t,  32, u32, s32, int32_t, vreinterpretq_u32_s32, vreinterpretq_s32_u32, PVECI_ID_,             PVECI_ID_,             vreinterpretq_u8_s32, vreinterpretq_s32_u8)
+PVECI_SHIFT_NEON_(uint32_t, 32, u32, s32, int32_t, PVECI_ID_,             PVECI_ID_,             vreinterpretq_s32_u32, vreinterpretq_u32_s32, vreinterpretq_u8_u32, vreinterpretq_u32_u8)
+PVECI_SHIFT_NEON_(int64_t,  64, u64, s64, int64_t, vreinterpretq_u64_s64, vreinterpretq_s64_u64, PVECI_ID_,             PVECI_ID_,             vreinterpretq_u8_s64, vreinterpretq_s64_u8)
+PVECI_SHIFT_NEON_(uint64_t, 64, u64, s64, int64_t, PVECI_ID_,             PVECI_ID_,             vreinterpretq_s64_u64, vreinterpretq_u64_s64, vreinterpretq_u8_u64, vreinterpretq_u64_u8)
+#endif
+
+#undef PVECI_SHIFT_NEON_
+#undef PVECI_ID_
+
+#endif
+
+} // namespace ipriv
+
+
+// element-wise shifts, immediate count
+template<unsigned S, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> shl(const veci_t<t_type,t_n,t_packed> & v)
+{
+    static_assert(S < sizeof(t_type)*8, "shl: shift count must be less than the element width");
+    return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::template shli<S>(v.p));
+}
+template<unsigned S, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> shr_logical(const veci_t<t_type,t_n,t_packed> & v)
+{
+    static_assert(S < sizeof(t_type)*8, "shr_logical: shift count must be less than the element width");
+    return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::template srli<S>(v.p));
+}
+template<unsigned S, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> shr_arith(const veci_t<t_type,t_n,t_packed> & v)
+{
+    static_assert(S < sizeof(t_type)*8, "shr_arith: shift count must be less than the element width");
+    return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::template srai<S>(v.p));
+}
+template<unsigned S, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> rotl(const veci_t<t_type,t_n,t_packed> & v)
+{
+    return
+        veci_t<t_type,t_n,t_packed>(
+            ipriv::shift_t<t_type,t_packed>::template roli<S % (sizeof(t_type)*8)>(v.p)
+        );
+}
+template<unsigned S, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> rotr(const veci_t<t_type,t_n,t_packed> & v)
+{
+    return
+        veci_t<t_type,t_n,t_packed>(
+            ipriv::shift_t<t_type,t_packed>::template roli<(sizeof(t_type)*8 - S % (sizeof(t_type)*8)) % (sizeof(t_type)*8)>(v.p)
+        );
+}
+
+// element-wise shifts, runtime count (identical for all elements)
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> shl(const veci_t<t_type,t_n,t_packed> & v, unsigned n)
+{ return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::sll(v.p, n)); }
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> shr_logical(const veci_t<t_type,t_n,t_packed> & v, unsigned n)
+{ return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::srl(v.p, n)); }
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> shr_arith(const veci_t<t_type,t_n,t_packed> & v, unsigned n)
+{ return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::sra(v.p, n)); }
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> rotl(const veci_t<t_type,t_n,t_packed> & v, unsigned n)
+{
+    typedef ipriv::shift_t<t_type,t_packed> shift_t;
+    const unsigned w = sizeof(t_type)*8;
+    n %= w;
+    // n == 0: the right shift by w yields 0
+    return veci_t<t_type,t_n,t_packed>(shift_t::sll(v.p, n)) |= shift_t::srl(v.p, w - n);
+}
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> rotr(const veci_t<t_type,t_n,t_packed> & v, unsigned n)
+{ return rotl(v, sizeof(t_type)*8 - n % (sizeof(t_type)*8)); }
+
+// full register shifts (bytes)
+template<unsigned B, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> bslli(const veci_t<t_type,t_n,t_packed> & v)
+{
+    static_assert(B <= 16, "bslli: byte count must not exceed the (lane) width of 16 bytes");
+    return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::template bslli<B>(v.p));
+}
+template<unsigned B, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> bsrli(const veci_t<t_type,t_n,t_packed> & v)
+{
+    static_assert(B <= 16, "bsrli: byte count must not exceed the (lane) width of 16 bytes");
+    return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::template bsrli<B>(v.p));
+}
+template<unsigned B, typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> alignr(const veci_t<t_type,t_n,t_packed> & hi, const veci_t<t_type,t_n,t_packed> & lo)
+{
+    static_assert(B < 16, "alignr: byte count must be less than the (lane) width of 16 bytes");
+    return veci_t<t_type,t_n,t_packed>(ipriv::shift_t<t_type,t_packed>::template alignr<B>(hi.p, lo.p));
+}
+
+
+namespace ipriv {
+
+// per element rotations: conditional rotations by 2^B, .., 2, 1 where bit B, ..,
+// 1, 0 of the count is set (the bits above are ignored, the count is taken
+// modulo the element width)
+template<typename V, unsigned B> struct rotv_ladder_t
+{
+    static inline V rolv(V v, const V & n)
+    {
+        const unsigned w = sizeof(typename V::type_t)*8;
+        // all bits set in the elements with bit B of the count set
+        V m = shr_arith<w - 1>(shl<w - 1 - B>(n));
+        v ^= (v ^ rotl<(1u << B)>(v)) & m;
+        return rotv_ladder_t<V,B - 1>::rolv(v, n);
+    }
+};
+template<typename V> struct rotv_ladder_t<V,0u>
+{
+    static inline V rolv(V v, const V & n)
+    {
+        const unsigned w = sizeof(typename V::type_t)*8;
+        V m = shr_arith<w - 1>(shl<w - 1>(n));
+        return v ^= (v ^ rotl<1>(v)) & m;
+    }
+};
+
+template<typename t_type, typename t_packed, unsigned W = sizeof(t_type)*8> struct rotv_t
+{
+    typedef veci_t<t_type,sizeof(t_packed)/sizeof(t_type),t_packed> vec_t;
+    static inline t_packed rolv(t_packed v, t_packed n)
+    {
+        return rotv_ladder_t<vec_t,(W == 8 ? 2 : W == 16 ? 3 : W == 32 ? 4 : 5)>::rolv(vec_t(v), vec_t(n)).p;
+    }
+};
+
+#if defined(PVECI_INTEL) && defined(AVX2)
+
+template<typename t_type> struct rotv_t<t_type,__m128i,32>
+{
+    static inline __m128i rolv(__m128i v, __m128i n)
+    {
+        n = _mm_and_si128(n, _mm_set1_epi32(31));
+        // count 32 of the right shift (n == 0) yields 0
+        return _mm_or_si128(_mm_sllv_epi32(v, n), _mm_srlv_epi32(v, _mm_sub_epi32(_mm_set1_epi32(32), n)));
+    }
+};
+template<typename t_type> struct rotv_t<t_type,__m128i,64>
+{
+    static inline __m128i rolv(__m128i v, __m128i n)
+    {
+        n = _mm_and_si128(n, _mm_set1_epi64x(63));
+        return _mm_or_si128(_mm_sllv_epi64(v, n), _mm_srlv_epi64(v, _mm_sub_epi64(_mm_set1_epi64x(64), n)));
+    }
+};
+template<typename t_type> struct rotv_t<t_type,__m256i,32>
+{
+    static inline __m256i rolv(__m256i v, __m256i n)
+    {
+        n = _mm256_and_si256(n, _mm256_set1_epi32(31));
+        return _mm256_or_si256(_mm256_sllv_epi32(v, n), _mm256_srlv_epi32(v, _mm256_sub_epi32(_mm256_set1_epi32(32), n)));
+    }
+};
+template<typename t_type> struct rotv_t<t_type,__m256i,64>
+{
+    static inline __m256i rolv(__m256i v, __m256i n)
+    {
+        n = _mm256_and_si256(n, _mm256_set1_epi64x(63));
+        return _mm256_or_si256(_mm256_sllv_epi64(v, n), _mm256_srlv_epi64(v, _mm256_sub_epi64(_mm256_set1_epi64x(64), n)));
+    }
+};
+
+#elif defined(PVECI_ARM)
+
+// vshl by register shifts right for negative counts, counts of 32 yield 0
+template<typename t_packed> struct rotv_t<uint32_t,t_packed,32>
+{
+    static inline t_packed rolv(t_packed v, t_packed n)
+    {
+        int32x4_t c = vreinterpretq_s32_u32(vandq_u32(n, vdupq_n_u32(31)));
+        return vorrq_u32(vshlq_u32(v, c), vshlq_u32(v, vsubq_s32(c, vdupq_n_s32(32))));
+    }
+};
+
+#endif
+
+} // namespace ipriv
+
+
+// element-wise rotations, per element counts
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> rotl(const veci_t<t_type,t_n,t_packed> & v, const veci_t<t_type,t_n,t_packed> & n)
+{ return veci_t<t_type,t_n,t_packed>(ipriv::rotv_t<t_type,t_packed>::rolv(v.p, n.p)); }
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> rotr(const veci_t<t_type,t_n,t_packed> & v, const veci_t<t_type,t_n,t_packed> & n)
+{
+    // rotr by n == rotl by -n (modulo the element width)
+    return veci_t<t_type,t_n,t_packed>(ipriv::rotv_t<t_type,t_packed>::rolv(v.p, (veci_t<t_type,t_n,t_packed>() - n).p));
+}
+
+
+/*****************************************************************************
+ *                                                                           *
+ * 32 bit multiplication (veci_[u]i32x4_t, veci_[u]i32x8_t)                  *
+ *                                                                           *
+ *****************************************************************************/
+
+/*
+  mul_lo(a, b)            lower 32 bits of the products (signed and unsigned)
+  mul_hi(a, b)            upper 32 bits of the unsigned 64 bit products
+  mul_wide(a, b, lo, hi)  both halves of the unsigned 64 bit products
+
+SSE2 has no 32 bit multiplication (pmulld is SSE4), the products are done per
+pmuludq of the even and of the odd elements (also the upper halves on all
+tiers); NEON per vmull of the lower and upper two elements
+*/
+
+namespace ipriv {
+
+template<typename t_packed> struct mul32_t;
+
+#if defined(PVECI_INTEL)
+
+template<> struct mul32_t<__m128i>
+{
+    static inline void wide(__m128i a, __m128i b, __m128i & lo, __m128i & hi)
+    {
+        __m128i even = _mm_mul_epu32(a, b);                                        // {l0,h0,l2,h2}
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)); // {l1,h1,l3,h3}
+        lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))); // {l0,l1,l2,l3}
+        hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)),
+                                _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1))); // {h0,h1,h2,h3}
+    }
+    static inline __m128i mullo(__m128i a, __m128i b)
+    {
+# if defined(SSE4)
+        return _mm_mullo_epi32(a, b);
+# else
+        __m128i lo, hi;
+        wide(a, b, lo, hi);
+        return lo;
+# endif
+    }
+};
+
+# if defined(AVX2)
+// same as above, per 128 bit lane
+template<> struct mul32_t<__m256i>
+{
+    static inline void wide(__m256i a, __m256i b, __m256i & lo, __m256i & hi)
+    {
+        __m256i even = _mm256_mul_epu32(a, b);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        lo = _mm256_unpacklo_epi32(_mm256_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                   _mm256_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        hi = _mm256_unpacklo_epi32(_mm256_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)),
+                                   _mm256_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+    }
+    static inline __m256i mullo(__m256i a, __m256i b) { return _mm256_mullo_epi32(a, b); }
+};
+# endif
+
+#elif defined(PVECI_ARM)
+
+template<> struct mul32_t<uint32x4_t>
+{
+    static inline void wide(uint32x4_t a, uint32x4_t b, uint32x4_t & lo, uint32x4_t & hi)
+    {
+        uint64x2_t l = vmull_u32(vget_low_u32(a), vget_low_u32(b));
+        uint64x2_t h = vmull_u32(vget_high_u32(a), vget_high_u32(b));
+        lo = vcombine_u32(vmovn_u64(l), vmovn_u64(h));
+        hi = vcombine_u32(vshrn_n_u64(l, 32), vshrn_n_u64(h, 32));
+    }
+    static inline uint32x4_t mullo(uint32x4_t a, uint32x4_t b) { return vmulq_u32(a, b); }
+};
+# if defined(PVECI_ARM_GCC)
+template<> struct mul32_t<int32x4_t>
+{
+    static inline int32x4_t mullo(int32x4_t a, int32x4_t b) { return vmulq_s32(a, b); }
+};
+# endif
+
+#endif
+
+} // namespace ipriv
+
+
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> mul_lo(const veci_t<t_type,t_n,t_packed> & a, const veci_t<t_type,t_n,t_packed> & b)
+{
+    static_assert(sizeof(t_type) == 4, "mul_lo: supports 32 bit elements only");
+    return veci_t<t_type,t_n,t_packed>(ipriv::mul32_t<t_packed>::mullo(a.p, b.p));
+}
+template<typename t_type, unsigned t_n, typename t_packed>
+inline void mul_wide(
+    const veci_t<t_type,t_n,t_packed> & a, const veci_t<t_type,t_n,t_packed> & b,
+    veci_t<t_type,t_n,t_packed> & lo, veci_t<t_type,t_n,t_packed> & hi)
+{
+    static_assert(sizeof(t_type) == 4 && !std::is_signed<t_type>::value, "mul_wide: supports uint32_t elements only");
+    ipriv::mul32_t<t_packed>::wide(a.p, b.p, lo.p, hi.p);
+}
+template<typename t_type, unsigned t_n, typename t_packed>
+inline veci_t<t_type,t_n,t_packed> mul_hi(const veci_t<t_type,t_n,t_packed> & a, const veci_t<t_type,t_n,t_packed> & b)
+{
+    veci_t<t_type,t_n,t_packed> lo, hi;
+    mul_wide(a, b, lo, hi);
+    return hi;
+}
 
 
 } // namespace math
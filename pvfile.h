@@ -0,0 +1,469 @@
+/*******************************************************************************
+ * pvfile.h                                                                    *
+ *                                                                             *
+ * Copyright (c) 2015-2018 Ronny Press                                         *
+ *                                                                             *
+ * rpress@soprero.de                                                           *
+ *                                                                             *
+ * All rights reserved.                                                        *
+ *******************************************************************************/
+#ifndef PVFILE_H
+#define PVFILE_H
+
+#include <pvecf.h>
+#include <pveci.h>
+#include <palloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define PVFILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32) && defined(PVFILE_USE_WINMAP)
+#define PVFILE_WINMAP
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+
+/*
+vector data files
+-----------------
+a simple on-disk format for streams of vector data (points, vertices, ...)
+that is mapped into memory and used by the vector types directly, without
+parsing or copying:
+
+  offset 0:             header (64 bytes)
+  offset 64*k:          section data, every stream starts on a 64 byte boundary
+  header.table_offset:  section table, one 64 byte entry per section
+
+  section:  name, element type (float, double, half, [u]int8..64), element
+            count, number of components (e.g. 3 for x,y,z) and the layout:
+    aos     one stream with the components interleaved (count*components elements)
+    soa     one stream per component (count elements each), the streams
+            follow each other
+
+  every stream is zero padded to a multiple of 64 bytes, so the vector views
+  may load the last (partial) vector with full aligned loads
+
+all values are little endian (the reader rejects files with another byte
+order), half floats are stored as uint16_t bit patterns
+
+reading:
+  vfile_t maps the file (mmap on POSIX systems, MapViewOfFile on Windows
+  with PVFILE_USE_WINMAP defined, which includes windows.h with NOMINMAX;
+  elsewhere the file is read into a cache line aligned buffer), stream<T>()
+  returns the elements of a stream, view<V>() a view returning vectors of
+  type V (vec4f_t, vec8f_t, veci_t, ...) per aligned load; views over aos
+  sections run over the interleaved elements
+
+writing:
+  vfile_writer_t streams the sections to disk, so batch kernels can write
+  their output chunk by chunk:
+    w.begin_section("pos", vf_type_t::f32, vf_layout_t::soa, 3, n);
+    w.write(x, n); w.write(y, n); w.write(z, n);  // or in smaller chunks
+    w.end_section();
+  soa streams are written one after the other, the writer inserts the
+  padding between them
+
+errors (file not found, malformed file, wrong number of elements written)
+are reported per return value; the reader checks all sizes and offsets of
+the header and the section table against the file size before any access,
+so malformed or hostile files are rejected by open()
+*/
+
+// TODO:
+// - half float -> float conversions (F16C vcvtph2ps, NEON vcvt_f32_f16)
+
+
+namespace math {
+
+enum class vf_type_t : uint32_t
+{
+    f32 = 1, f64, f16,
+    i8, u8, i16, u16, i32, u32, i64, u64
+};
+
+enum class vf_layout_t : uint32_t
+{
+    aos = 1,
+    soa = 2
+};
+
+struct vf_header_t
+{
+    char     magic[4];        // "PVEC"
+    uint32_t version;
+    uint32_t byte_order;      // 0x01020304
+    uint32_t sections;
+    uint64_t table_offset;
+    uint64_t file_size;
+    uint8_t  reserved[32];
+};
+
+struct vf_section_t
+{
+    char     name[24];        // zero terminated
+    uint32_t type;            // vf_type_t
+    uint32_t layout;          // vf_layout_t
+    uint32_t components;
+    uint32_t reserved;
+    uint64_t count;           // elements per component
+    uint64_t offset;          // of the first stream
+    uint64_t stream_bytes;    // per stream, multiple of 64
+
+    vf_type_t elem_type() const { return vf_type_t(type); }
+    vf_layout_t elem_layout() const { return vf_layout_t(layout); }
+    unsigned streams() const { return elem_layout() == vf_layout_t::soa ? components : 1; }
+    // elements in one stream
+    uint64_t stream_elems() const
+    { return elem_layout() == vf_layout_t::soa ? count : count * components; }
+};
+
+static_assert(sizeof(vf_header_t) == 64, "vf_header_t must be 64 bytes");
+static_assert(sizeof(vf_section_t) == 64, "vf_section_t must be 64 bytes");
+
+namespace ipriv {
+
+    static const uint32_t vf_version = 1;
+    static const uint32_t vf_byte_order = 0x01020304;
+    static const size_t vf_align = 64;
+
+    inline size_t vf_type_size(vf_type_t t)
+    {
+        switch(t) {
+        case vf_type_t::i8:  case vf_type_t::u8:  return 1;
+        case vf_type_t::f16: case vf_type_t::i16: case vf_type_t::u16: return 2;
+        case vf_type_t::f32: case vf_type_t::i32: case vf_type_t::u32: return 4;
+        case vf_type_t::f64: case vf_type_t::i64: case vf_type_t::u64: return 8;
+        }
+        return 0;
+    }
+
+    // stream types accepted for an element type, half floats as uint16_t
+    template<typename T> inline bool vf_is_type(vf_type_t t);
+    template<> inline bool vf_is_type<float>(vf_type_t t)    { return t == vf_type_t::f32; }
+    template<> inline bool vf_is_type<double>(vf_type_t t)   { return t == vf_type_t::f64; }
+    template<> inline bool vf_is_type<int8_t>(vf_type_t t)   { return t == vf_type_t::i8;  }
+    template<> inline bool vf_is_type<uint8_t>(vf_type_t t)  { return t == vf_type_t::u8;  }
+    template<> inline bool vf_is_type<int16_t>(vf_type_t t)  { return t == vf_type_t::i16; }
+    template<> inline bool vf_is_type<uint16_t>(vf_type_t t) { return t == vf_type_t::u16 || t == vf_type_t::f16; }
+    template<> inline bool vf_is_type<int32_t>(vf_type_t t)  { return t == vf_type_t::i32; }
+    template<> inline bool vf_is_type<uint32_t>(vf_type_t t) { return t == vf_type_t::u32; }
+    template<> inline bool vf_is_type<int64_t>(vf_type_t t)  { return t == vf_type_t::i64; }
+    template<> inline bool vf_is_type<uint64_t>(vf_type_t t) { return t == vf_type_t::u64; }
+
+} // namespace ipriv
+
+
+//
+// vectors of type V over a stream, V(i) holds the elements [i*N, i*N+N),
+// the last vector contains the zero padding if the stream length is not a
+// multiple of N
+//
+template<typename V>
+class vview_t
+{
+public:
+    typedef typename ipriv::vec_elem<V>::type elem_t;
+
+    vview_t() : p_(nullptr), n_(0) {}
+    vview_t(const elem_t * p, size_t n) : p_(p), n_(n) {}
+
+    // number of vectors (including a partial last one)
+    size_t size() const { return (n_ + V::N - 1) / V::N; }
+    size_t elements() const { return n_; }
+    const elem_t * data() const { return p_; }
+    bool empty() const { return n_ == 0; }
+
+    V operator[](size_t i) const
+    { V v; v.loada(p_ + i * V::N); return v; }
+
+private:
+    const elem_t * p_;
+    size_t n_;
+};
+
+
+class vfile_t
+{
+public:
+    vfile_t() : base_(nullptr), size_(0), mapped_(false) {}
+    ~vfile_t() { close(); }
+    vfile_t(const vfile_t &) = delete;
+    vfile_t & operator=(const vfile_t &) = delete;
+
+    bool open(const char * path)
+    {
+        close();
+        if(!map(path)) return false;
+        if(!validate()) { close(); return false; }
+        return true;
+    }
+    void close()
+    {
+        if(!base_) return;
+#if defined(PVFILE_MMAP)
+        if(mapped_) munmap(base_, size_);
+        else
+#elif defined(PVFILE_WINMAP)
+        if(mapped_) UnmapViewOfFile(base_);
+        else
+#endif
+        ipriv::aligned_free(base_);
+        base_ = nullptr;
+        size_ = 0;
+        mapped_ = false;
+    }
+    bool is_open() const { return base_ != nullptr; }
+
+    size_t sections() const { return size_t(header().sections); }
+    const vf_section_t & section(size_t i) const { return table()[i]; }
+    const vf_section_t * find(const char * name) const
+    {
+        for(size_t i = 0; i < sections(); ++i)
+            if(strncmp(table()[i].name, name, sizeof(table()[i].name)) == 0)
+                return &table()[i];
+        return nullptr;
+    }
+
+    // elements of stream 'component' (soa) or the interleaved elements (aos,
+    // component 0); nullptr for a wrong type or component
+    template<typename T> const T * stream(const vf_section_t & s, unsigned component = 0) const
+    {
+        if(!ipriv::vf_is_type<T>(s.elem_type()) || component >= s.streams()) return nullptr;
+        return reinterpret_cast<const T *>(
+            static_cast<const char *>(base_) + s.offset + component * s.stream_bytes);
+    }
+
+    template<typename V> vview_t<V> view(const vf_section_t & s, unsigned component = 0) const
+    {
+        typedef typename vview_t<V>::elem_t elem_t;
+        static_assert(sizeof(V) <= ipriv::vf_align, "vector type larger than the stream padding");
+        const elem_t * p = stream<elem_t>(s, component);
+        return p ? vview_t<V>(p, size_t(s.stream_elems())) : vview_t<V>();
+    }
+
+private:
+    const vf_header_t & header() const { return *static_cast<const vf_header_t *>(base_); }
+    const vf_section_t * table() const
+    {
+        return reinterpret_cast<const vf_section_t *>(
+            static_cast<const char *>(base_) + header().table_offset);
+    }
+
+    bool map(const char * path)
+    {
+#if defined(PVFILE_MMAP)
+        int fd = ::open(path, O_RDONLY);
+        if(fd < 0) return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(vf_header_t)) ||
+           uint64_t(st.st_size) > SIZE_MAX) { ::close(fd); return false; }
+        void * p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED) return false;
+        base_ = p;
+        size_ = size_t(st.st_size);
+        mapped_ = true;
+        return true;
+#elif defined(PVFILE_WINMAP)
+        HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(f == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(f, &size) || size.QuadPart < LONGLONG(sizeof(vf_header_t)) ||
+           uint64_t(size.QuadPart) > SIZE_MAX) { CloseHandle(f); return false; }
+        // the view keeps the mapping and the file open
+        HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(f);
+        if(!m) return false;
+        void * p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(m);
+        if(!p) return false;
+        base_ = p;
+        size_ = size_t(size.QuadPart);
+        mapped_ = true;
+        return true;
+#else
+        FILE * f = fopen(path, "rb");
+        if(!f) return false;
+        bool ok = fseek(f, 0, SEEK_END) == 0;
+        long size = ok ? ftell(f) : -1;
+        ok = ok && size >= long(sizeof(vf_header_t)) && fseek(f, 0, SEEK_SET) == 0;
+        if(ok) {
+            base_ = ipriv::aligned_malloc(size_t(size), ipriv::vf_align);
+            ok = base_ && fread(base_, 1, size_t(size), f) == size_t(size);
+            size_ = size_t(size);
+        }
+        fclose(f);
+        if(!ok) close();
+        return ok;
+#endif
+    }
+
+    bool validate() const
+    {
+        const vf_header_t & h = header();
+        if(memcmp(h.magic, "PVEC", 4) != 0 || h.version != ipriv::vf_version ||
+           h.byte_order != ipriv::vf_byte_order || h.file_size != size_)
+            return false;
+        if(h.table_offset % ipriv::vf_align != 0 || h.table_offset > size_ ||
+           uint64_t(h.sections) > (size_ - h.table_offset) / sizeof(vf_section_t))
+            return false;
+        for(size_t i = 0; i < sections(); ++i) {
+            const vf_section_t & s = table()[i];
+            size_t es = ipriv::vf_type_size(s.elem_type());
+            if(es == 0 || s.components == 0 || s.name[sizeof(s.name) - 1] != 0 ||
+               (s.layout != uint32_t(vf_layout_t::aos) && s.layout != uint32_t(vf_layout_t::soa)))
+                return false;
+            if(s.offset % ipriv::vf_align != 0 || s.offset > size_)
+                return false;
+            // bound the counts by the bytes available before multiplying, a
+            // hostile count must not wrap the stream size
+            const uint64_t avail = size_ - s.offset;
+            if(s.count > avail / es / s.components ||
+               s.stream_bytes != ipriv::round_up(size_t(s.stream_elems() * es), ipriv::vf_align) ||
+               (s.stream_bytes != 0 && s.streams() > avail / s.stream_bytes))
+                return false;
+        }
+        return true;
+    }
+
+    void * base_;
+    size_t size_;
+    bool mapped_;
+};
+
+
+class vfile_writer_t
+{
+public:
+    vfile_writer_t() : f_(nullptr), offset_(0), open_section_(false) {}
+    ~vfile_writer_t() { close(); }
+    vfile_writer_t(const vfile_writer_t &) = delete;
+    vfile_writer_t & operator=(const vfile_writer_t &) = delete;
+
+    bool open(const char * path)
+    {
+        close();
+        f_ = fopen(path, "wb");
+        if(!f_) return false;
+        table_.clear();
+        offset_ = 0;
+        open_section_ = false;
+        vf_header_t h;
+        memset(&h, 0, sizeof(h));
+        return put(&h, sizeof(h));   // rewritten by close()
+    }
+
+    bool begin_section(const char * name, vf_type_t type, vf_layout_t layout,
+                       unsigned components, uint64_t count)
+    {
+        size_t es = ipriv::vf_type_size(type);
+        if(!f_ || open_section_ || es == 0 || components == 0 ||
+           strlen(name) >= sizeof(cur_.name))
+            return false;
+        // a failed section may have left a partial stream behind
+        if(!pad()) return false;
+        memset(&cur_, 0, sizeof(cur_));
+        strcpy(cur_.name, name);
+        cur_.type = uint32_t(type);
+        cur_.layout = uint32_t(layout);
+        cur_.components = components;
+        cur_.count = count;
+        cur_.offset = offset_;
+        cur_.stream_bytes = ipriv::round_up(size_t(cur_.stream_elems() * es), ipriv::vf_align);
+        stream_ = 0;
+        stream_written_ = 0;
+        open_section_ = true;
+        return true;
+    }
+
+    // appends n elements, crossing into the next stream of a soa section
+    // when the current one is complete
+    template<typename T> bool write(const T * data, size_t n)
+    {
+        if(!open_section_ || !ipriv::vf_is_type<T>(cur_.elem_type())) return false;
+        const uint64_t elems = cur_.stream_elems();
+        while(n > 0) {
+            if(stream_ >= cur_.streams()) return false; // more elements than announced
+            uint64_t k = elems - stream_written_;
+            if(k > n) k = n;
+            if(!put(data, size_t(k) * sizeof(T))) return false;
+            data += k;
+            n -= size_t(k);
+            stream_written_ += k;
+            if(stream_written_ == elems) {
+                if(!pad()) return false;
+                ++stream_;
+                stream_written_ = 0;
+            }
+        }
+        return true;
+    }
+
+    bool end_section()
+    {
+        if(!open_section_) return false;
+        open_section_ = false;
+        // empty streams of a soa section are complete without a write()
+        while(stream_ < cur_.streams() && cur_.stream_elems() == 0) ++stream_;
+        if(stream_ != cur_.streams()) return false;
+        table_.push_back(cur_);
+        return true;
+    }
+
+    // writes the section table and the header
+    bool close()
+    {
+        if(!f_) return false;
+        bool ok = !open_section_ && pad();
+        vf_header_t h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, "PVEC", 4);
+        h.version = ipriv::vf_version;
+        h.byte_order = ipriv::vf_byte_order;
+        h.sections = uint32_t(table_.size());
+        h.table_offset = offset_;
+        if(ok && !table_.empty())
+            ok = put(&table_[0], table_.size() * sizeof(vf_section_t));
+        h.file_size = offset_;
+        ok = ok && fseek(f_, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f_) == 1;
+        ok = fclose(f_) == 0 && ok;
+        f_ = nullptr;
+        return ok;
+    }
+
+private:
+    bool put(const void * p, size_t bytes)
+    {
+        if(bytes && fwrite(p, 1, bytes, f_) != bytes) return false;
+        offset_ += bytes;
+        return true;
+    }
+    // zeroes up to the next 64 byte boundary
+    bool pad()
+    {
+        static const char zeroes[ipriv::vf_align] = {};
+        return put(zeroes, size_t(ipriv::round_up(size_t(offset_), ipriv::vf_align) - offset_));
+    }
+
+    FILE * f_;
+    uint64_t offset_;
+    std::vector<vf_section_t> table_;
+    vf_section_t cur_;
+    unsigned stream_;
+    uint64_t stream_written_;
+    bool open_section_;
+};
+
+} // namespace math
+
+#endif // PVFILE_H
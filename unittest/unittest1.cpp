@@ -112,6 +112,47 @@ TEST_CASE("Mat4f identity inverse == identity", "TestMat4fIdentityInverse")
     }
 }
 
+TEST_CASE("Math constants", "TestMathConstants")
+{
+    using namespace math;
+    static_assert(pi<float>() > 3.14f && pi<float>() < 3.15f, "pi<>() must be constexpr");
+    REQUIRE(pi<double>() == 4.0*std::atan(1.0));
+    REQUIRE(pi<float>() == static_cast<float>(4.0*std::atan(1.0)));
+    REQUIRE(almost_equal(rad2deg<double>() * deg2rad<double>(), 1.0));
+    REQUIRE(almost_equal(goldenratio<double>(), (1.0 + std::sqrt(5.0)) * 0.5));
+
+    typedef vec4f_t::math_t math4f_t;
+    vec4f_t ones(math4f_t::ones()), halves(math4f_t::halves()), signs(math4f_t::sign_mask());
+    vec4f_t absv(-1.5f, 2.0f, -0.0f, -3.0f);
+    absv.abs_();
+    for(int i = 0; i < 4; ++i) {
+        REQUIRE(ones[i] == 1.0f);
+        REQUIRE(halves[i] == 0.5f);
+        REQUIRE((signs[i] == 0.0f && std::signbit(signs[i])));
+        REQUIRE(!std::signbit(absv[i]));
+    }
+    REQUIRE(absv[0] == 1.5f);
+    REQUIRE(absv[3] == 3.0f);
+
+    mat4f_t mat4(mat4f_t::identity());
+    for(int i = 0; i < 16; ++i)
+        REQUIRE(mat4.v[i] == ((i & 0x3) == (i >> 2) ? 1.0f : 0.0f));
+
+#if defined(PVECF_INTEL) && (defined(SSE2) || defined(AVX))
+    typedef vec2d_t::math_t math2d_t;
+    vec2d_t ones2(math2d_t::ones()), halves2(math2d_t::halves());
+    vec2d_t absv2(-2.5, -0.0);
+    absv2.abs_();
+    REQUIRE((ones2[0] == 1.0 && ones2[1] == 1.0));
+    REQUIRE((halves2[0] == 0.5 && halves2[1] == 0.5));
+    REQUIRE((absv2[0] == 2.5 && !std::signbit(absv2[1])));
+
+    mat2d_t mat2(mat2d_t::identity());
+    REQUIRE((mat2(0, 0) == 1.0 && mat2(0, 1) == 0.0));
+    REQUIRE((mat2(1, 0) == 0.0 && mat2(1, 1) == 1.0));
+#endif
+}
+
 TEST_CASE("Math4f fast trig", "TestMathV4fFastTrig")
 {
     using vec4f_t = math::vec4f_t;
@@ -136,6 +177,43 @@ TEST_CASE("Math4f fast trig", "TestMathV4fFastTrig")
     REQUIRE(math::almost_equal(vcosines[3], 0.0f, 0.001f));
 }
 
+TEST_CASE("Polynomial evaluation", "TestPolynomial")
+{
+    using vec4f_t = math::vec4f_t;
+    using math4f_t = vec4f_t::math_t;
+    using poly4f_t = math::poly_t<float,vec4f_t::packed_t>;
+
+    // 1 + 2x + 3x^2 + ... + 9x^8
+    static constexpr double c[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0 };
+    REQUIRE(math::poly_t<double>::horner(2.0, c) == 4097.0);
+    REQUIRE(math::poly_t<double>::estrin(2.0, c) == 4097.0);
+    REQUIRE(math::poly_t<double>::horner_even(2.0, c) == 757305.0);
+    REQUIRE(math::poly_t<double>::estrin_even(2.0, c) == 757305.0);
+    REQUIRE(math::poly_t<double>::horner_odd(2.0, c) == 1514610.0);
+    REQUIRE(math::poly_t<double>::estrin_odd(2.0, c) == 1514610.0);
+
+    static constexpr float cf[] = { 1.0f, -1.0f, 0.5f, 0.25f, -0.125f };
+    vec4f_t x(-1.0f, 0.5f, 0.0f, 2.0f);
+    vec4f_t h(poly4f_t::horner(x.p, cf)), e(poly4f_t::estrin(x.p, cf));
+    for(int i = 0; i < 4; ++i) {
+        float xi = x[i];
+        float ref = 1.0f - xi + 0.5f*xi*xi + 0.25f*xi*xi*xi - 0.125f*xi*xi*xi*xi;
+        REQUIRE(math::almost_equal(h[i], ref, 1e-5f));
+        REQUIRE(math::almost_equal(e[i], ref, 1e-5f));
+    }
+
+    // the higher accuracy approximations
+    vec4f_t angles(0.1f, 0.4f, 0.7f, 0.785f);
+    vec4f_t tans(math4f_t::fast_tan_1(angles.p));
+    vec4f_t sines(math4f_t::fast_sin_1(angles.p));
+    vec4f_t atans(math4f_t::fast_arctan_1(angles.p));
+    for(int i = 0; i < 4; ++i) {
+        REQUIRE(math::almost_equal(tans[i], std::tan(angles[i]), 1e-6f));
+        REQUIRE(math::almost_equal(sines[i], std::sin(angles[i]), 1e-6f));
+        REQUIRE(math::almost_equal(atans[i], std::atan(angles[i]), 1e-6f));
+    }
+}
+
 TEST_CASE("Vec4f initialization", "TestVec4fInit")
 {
     using vec4f_t = math::vec4f_t;
@@ -3202,6 +3280,1963 @@ TEST_CASE("exprTemplatesFMA")
 }
 
 
+TEST_CASE("TestVeciShifts")
+{
+    using veci_i8x16_t = math::veci_i8x16_t;
+    using veci_ui32x4_t = math::veci_ui32x4_t;
+    using veci_i64x2_t = math::veci_i64x2_t;
+
+    veci_i8x16_t v8{-128, -1, 1, 64, 0x55, -0x56, 7, 0, 1, 2, 3, 4, 5, 6, 7, 8};
+    veci_i8x16_t r8 = math::shl<1>(v8);
+    REQUIRE(r8[0] == 0);
+    REQUIRE(r8[1] == -2);
+    REQUIRE(r8[3] == -128);
+    r8 = math::shr_logical<1>(v8);
+    REQUIRE(r8[0] == 64);
+    REQUIRE(r8[1] == 127);
+    r8 = math::shr_arith(v8, 3);
+    REQUIRE(r8[0] == -16);
+    REQUIRE(r8[1] == -1);
+    REQUIRE(r8[3] == 8);
+    r8 = math::rotl<4>(v8);
+    REQUIRE(r8[4] == 0x55);
+    REQUIRE(r8[2] == 0x10);
+
+    veci_ui32x4_t v32{0x80000001u, 0x12345678u, 1u, 0xFFFFFFFFu};
+    veci_ui32x4_t r32 = math::rotl<16>(v32);
+    REQUIRE(r32[1] == 0x56781234u);
+    r32 = math::rotr(v32, 4);
+    REQUIRE(r32[0] == 0x18000000u);
+    REQUIRE(r32[1] == 0x81234567u);
+    r32 = math::shr_arith<31>(v32);
+    REQUIRE(r32[0] == 0xFFFFFFFFu);
+    REQUIRE(r32[2] == 0u);
+    r32 = math::shl(v32, 32);
+    REQUIRE(r32[3] == 0u);
+
+    veci_i64x2_t v64{-256, 256};
+    veci_i64x2_t r64 = math::shr_arith<4>(v64);
+    REQUIRE(r64[0] == -16);
+    REQUIRE(r64[1] == 16);
+    r64 = math::shr_arith(v64, 100);
+    REQUIRE(r64[0] == -1);
+    REQUIRE(r64[1] == 0);
+
+    // full register shifts
+    r32 = math::bsrli<4>(v32);
+    REQUIRE(r32[0] == 0x12345678u);
+    REQUIRE(r32[3] == 0u);
+    r32 = math::bslli<8>(v32);
+    REQUIRE(r32[0] == 0u);
+    REQUIRE(r32[2] == 0x80000001u);
+    r32 = math::bsrli<16>(v32);
+    REQUIRE(r32[0] == 0u);
+    REQUIRE(r32[3] == 0u);
+    r32 = math::bslli<16>(v32);
+    REQUIRE(r32[0] == 0u);
+    REQUIRE(r32[3] == 0u);
+    r32 = math::alignr<4>(veci_ui32x4_t{5u, 6u, 7u, 8u}, v32);
+    REQUIRE(r32[0] == 0x12345678u);
+    REQUIRE(r32[3] == 5u);
+
+    // per element counts (modulo the element width)
+    r32 = math::rotr(v32, veci_ui32x4_t{1u, 4u, 0u, 33u});
+    REQUIRE(r32[0] == 0xC0000000u);
+    REQUIRE(r32[1] == 0x81234567u);
+    REQUIRE(r32[2] == 1u);
+    REQUIRE(r32[3] == 0xFFFFFFFFu);
+    r32 = math::rotl(v32, veci_ui32x4_t{1u, 8u, 31u, 5u});
+    REQUIRE(r32[0] == 3u);
+    REQUIRE(r32[1] == 0x34567812u);
+    REQUIRE(r32[2] == 0x80000000u);
+    r8 = math::rotl(v8, veci_i8x16_t{1, 0, 9, 2, 4, 7, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+    REQUIRE(r8[0] == 1);
+    REQUIRE(r8[1] == -1);
+    REQUIRE(r8[2] == 2);
+    REQUIRE(r8[3] == 1);
+    REQUIRE(r8[4] == 0x55);
+    REQUIRE(r8[6] == 56);
+    r64 = math::rotr(veci_i64x2_t{1, 3}, veci_i64x2_t{1, 64});
+    REQUIRE(r64[0] == INT64_MIN);
+    REQUIRE(r64[1] == 3);
+}
+
+
+TEST_CASE("TestVeciMul32")
+{
+    using veci_ui32x4_t = math::veci_ui32x4_t;
+    using veci_i32x4_t = math::veci_i32x4_t;
+
+    veci_ui32x4_t a{0xFFFFFFFFu, 0x10000u, 12345u, 0x80000000u};
+    veci_ui32x4_t b{0xFFFFFFFFu, 0x10000u, 1000u, 3u};
+    veci_ui32x4_t lo = math::mul_lo(a, b);
+    REQUIRE(lo[0] == 1u);
+    REQUIRE(lo[1] == 0u);
+    REQUIRE(lo[2] == 12345000u);
+    REQUIRE(lo[3] == 0x80000000u);
+    veci_ui32x4_t hi = math::mul_hi(a, b);
+    REQUIRE(hi[0] == 0xFFFFFFFEu);
+    REQUIRE(hi[1] == 1u);
+    REQUIRE(hi[2] == 0u);
+    REQUIRE(hi[3] == 1u);
+    math::mul_wide(a, b, lo, hi);
+    REQUIRE(lo[2] == 12345000u);
+    REQUIRE(hi[0] == 0xFFFFFFFEu);
+
+    veci_i32x4_t s = math::mul_lo(veci_i32x4_t{-3, 7, -1, 0x10000}, veci_i32x4_t{5, -9, -1, 0x10000});
+    REQUIRE(s[0] == -15);
+    REQUIRE(s[1] == -63);
+    REQUIRE(s[2] == 1);
+    REQUIRE(s[3] == 0);
+
+#if defined(PVECI_INTEL) && defined(AVX2)
+    using veci_ui32x8_t = math::veci_ui32x8_t;
+    veci_ui32x8_t a8{0xFFFFFFFFu, 2u, 3u, 4u, 5u, 6u, 7u, 0x80000000u};
+    veci_ui32x8_t lo8, hi8;
+    math::mul_wide(a8, a8, lo8, hi8);
+    REQUIRE(lo8[0] == 1u);
+    REQUIRE(hi8[0] == 0xFFFFFFFEu);
+    REQUIRE(lo8[6] == 49u);
+    REQUIRE(hi8[7] == 0x40000000u);
+    REQUIRE(math::mul_lo(a8, a8)[5] == 36u);
+    veci_ui32x8_t r8 = math::rotr(a8, veci_ui32x8_t{4u, 1u, 0u, 0u, 0u, 0u, 0u, 31u});
+    REQUIRE(r8[0] == 0xFFFFFFFFu);
+    REQUIRE(r8[1] == 1u);
+    REQUIRE(r8[7] == 1u);
+#endif
+}
+
+
+TEST_CASE("TestVeciCompareTiers")
+{
+    using veci_i64x2_t = math::veci_i64x2_t;
+    using veci_ui64x2_t = math::veci_ui64x2_t;
+    using veci_ui8x16_t = math::veci_ui8x16_t;
+    using veci_ui32x4_t = math::veci_ui32x4_t;
+
+    // upper dwords equal, lower dwords decide (signed/unsigned emulation paths)
+    veci_i64x2_t a(0x0000000080000000LL, -1LL);
+    veci_i64x2_t b(0x000000007FFFFFFFLL, 0LL);
+    REQUIRE(!(a < b));
+    REQUIRE(!(a > b));
+    REQUIRE(!(a == b));
+    REQUIRE(a != b);
+    REQUIRE(a.neq_one(b));
+    veci_i64x2_t m = veci_i64x2_t::min_(a, b);
+    REQUIRE(m[0] == 0x000000007FFFFFFFLL);
+    REQUIRE(m[1] == -1LL);
+    m = veci_i64x2_t::max_(a, b);
+    REQUIRE(m[0] == 0x0000000080000000LL);
+    REQUIRE(m[1] == 0LL);
+    // only the lower dwords differ: the elements are still unequal
+    REQUIRE(veci_i64x2_t(0x100000001LL, 5LL) != veci_i64x2_t(0x100000002LL, 6LL));
+    const veci_i64x2_t n(INT64_MIN + 1, -0x100000000LL);
+    veci_i64x2_t r = n.abs_();
+    REQUIRE(r[0] == INT64_MAX);
+    REQUIRE(r[1] == 0x100000000LL);
+
+    veci_ui64x2_t ua(0xFFFFFFFF00000000ULL, 1ULL);
+    veci_ui64x2_t ub(0x00000000FFFFFFFFULL, 2ULL);
+    REQUIRE(!(ua < ub));
+    REQUIRE(!(ua > ub));
+    REQUIRE(ua > veci_ui64x2_t(0ULL, 0ULL));
+    REQUIRE(ua <= veci_ui64x2_t(0xFFFFFFFF00000000ULL, 1ULL));
+    veci_ui64x2_t um = veci_ui64x2_t::min_(ua, ub);
+    REQUIRE(um[0] == 0x00000000FFFFFFFFULL);
+    REQUIRE(um[1] == 1ULL);
+    um = veci_ui64x2_t::max_(ua, ub);
+    REQUIRE(um[0] == 0xFFFFFFFF00000000ULL);
+    REQUIRE(um[1] == 2ULL);
+
+    veci_ui8x16_t u8a, u8b;
+    for(int i = 0; i < 16; ++i) {
+        u8a[i] = uint8_t(0x80 + i);
+        u8b[i] = uint8_t(0x7F - i);
+    }
+    REQUIRE(u8a > u8b);
+    REQUIRE(u8a >= u8b);
+    REQUIRE(u8b < u8a);
+    REQUIRE(u8b <= u8b);
+    REQUIRE(!(u8b < u8b));
+
+    veci_ui32x4_t u32a{0xFFFFFFFFu, 0x80000000u, 1u, 0u};
+    veci_ui32x4_t u32b{0x7FFFFFFFu, 0x7FFFFFFFu, 0u, 0u};
+    REQUIRE(u32a >= u32b);
+    REQUIRE(!(u32a > u32b));
+    veci_ui32x4_t u32m = veci_ui32x4_t::min_(u32a, u32b);
+    REQUIRE(u32m[0] == 0x7FFFFFFFu);
+    REQUIRE(u32m[2] == 0u);
+
+    REQUIRE(veci_i64x2_t::math_t::isa_tier() == veci_ui8x16_t::math_t::isa_tier());
+#if defined(PVECI_INTEL) && defined(AVX2)
+    // the higher tiers imply the lower ones
+#   if !defined(SSE4) || !defined(SSE4_2) || !defined(SSSE3) || !defined(SSE3) || !defined(SSE2)
+#     error "pconfig.h: AVX2 must imply the SSE tiers"
+#   endif
+    REQUIRE(veci_i64x2_t::math_t::isa_tier() >= math::isa_tier_t::avx2);
+#endif
+}
+
+
+#if defined(AVX2)
+TEST_CASE("TestVeci256")
+{
+    using veci_i8x32_t = math::veci_i8x32_t;
+    using veci_ui16x16_t = math::veci_ui16x16_t;
+    using veci_ui32x8_t = math::veci_ui32x8_t;
+    using veci_i64x4_t = math::veci_i64x4_t;
+
+    veci_i8x32_t v8{-128, 127, -1, 1};
+    v8[31] = 100;
+    veci_i8x32_t r8 = v8;
+    r8.add_sat(veci_i8x32_t{-1, 1, -1, 1});
+    REQUIRE(r8[0] == -128);
+    REQUIRE(r8[1] == 127);
+    REQUIRE(r8[2] == -2);
+    r8 = v8;
+    r8.abs_();
+    REQUIRE(r8[0] == -128);
+    REQUIRE(r8[2] == 1);
+    REQUIRE(r8[31] == 100);
+    REQUIRE((v8 + int8_t(1))[31] == 101);
+
+    veci_ui16x16_t v16{0xFFFF, 0x8000, 1, 0};
+    veci_ui16x16_t w16{0x7FFF, 0x8001, 1, 0};
+    REQUIRE(veci_ui16x16_t::max_(v16, w16)[0] == 0xFFFF);
+    REQUIRE(veci_ui16x16_t::min_(v16, w16)[1] == 0x8000);
+    REQUIRE((v16 >= w16) == false);
+    REQUIRE((v16 != w16) == false);
+    REQUIRE(v16.neq_one(w16));
+
+    veci_ui32x8_t v32{0u, 1u, 2u, 3u};
+    v32[4] = 4u; v32[5] = 5u; v32[6] = 6u; v32[7] = 0xFFFFFFFFu;
+    REQUIRE(veci_ui32x8_t(v32) == v32);
+    REQUIRE((v32 < veci_ui32x8_t(v32)) == false);
+    REQUIRE((~v32)[7] == 0u);
+    // byte shifts work per 128 bit lane
+    veci_ui32x8_t r32 = math::bsrli<4>(v32);
+    REQUIRE(r32[0] == 1u);
+    REQUIRE(r32[3] == 0u);
+    REQUIRE(r32[4] == 5u);
+    REQUIRE(r32[7] == 0u);
+
+    veci_i64x4_t v64{-5, 5};
+    v64[2] = INT64_MIN; v64[3] = INT64_MAX;
+    veci_i64x4_t w64{5, -5};
+    REQUIRE(veci_i64x4_t::min_(v64, w64)[0] == -5);
+    REQUIRE(veci_i64x4_t::min_(v64, w64)[1] == -5);
+    REQUIRE(veci_i64x4_t::max_(v64, w64)[3] == INT64_MAX);
+    REQUIRE(math::shr_arith<1>(v64)[0] == -3);
+    REQUIRE((-v64)[1] == -5);
+}
+#endif // defined(AVX2)
+
+
+// tests for pdivi.h
+
+#include <pdivi.h>
+
+TEST_CASE("TestDivisorI32x4")
+{
+    using veci_ui32x4_t = math::veci_ui32x4_t;
+    using veci_i32x4_t = math::veci_i32x4_t;
+    using veci_ui16x8_t = math::veci_ui16x8_t;
+
+    const uint32_t udivs[] = {1, 2, 3, 7, 8, 10, 641, 65535, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+    for(uint32_t d : udivs) {
+        math::divisor_ui32x4_t div(d);
+        veci_ui32x4_t n{0u, 1u, d, 0xFFFFFFFFu};
+        veci_ui32x4_t q = n / div, r = n % div;
+        for(unsigned i = 0; i < 4; ++i) {
+            REQUIRE(q[i] == n[i] / d);
+            REQUIRE(r[i] == n[i] % d);
+        }
+    }
+
+    const int32_t sdivs[] = {1, -1, 2, -2, 3, -3, 7, -7, 16, -16, 1000, -1000, INT32_MAX, INT32_MIN};
+    const veci_i32x4_t snums[] = {
+        {0, -7, 123456789, INT32_MAX},
+        {-1, -2, -3, -123456789},
+        {INT32_MIN, INT32_MIN + 1, -1000, -999},
+        {-16, -15, -17, -65536}
+    };
+    for(int32_t d : sdivs) {
+        math::divisor_i32x4_t div(d);
+        for(const veci_i32x4_t &n : snums) {
+            veci_i32x4_t q = n / div, r = n % div;
+            for(unsigned i = 0; i < 4; ++i) {
+                // 64 bits for the reference, INT32_MIN / -1 wraps to INT32_MIN (remainder 0)
+                REQUIRE(q[i] == int32_t(uint32_t(int64_t(n[i]) / d)));
+                REQUIRE(r[i] == int32_t(int64_t(n[i]) % d));
+            }
+        }
+    }
+
+    const uint16_t u16divs[] = {1, 3, 4, 7, 10, 255, 0x8000, 0xFFFF};
+    for(uint16_t d : u16divs) {
+        math::divisor_ui16x8_t div(d);
+        veci_ui16x8_t n{0, 1, 2, 3, 1000, 0x7FFF, 0x8000, 0xFFFF};
+        veci_ui16x8_t q = n / div, r = n % div;
+        for(unsigned i = 0; i < 8; ++i) {
+            REQUIRE(q[i] == n[i] / d);
+            REQUIRE(r[i] == n[i] % d);
+        }
+    }
+
+    uint32_t arr[7] = {1, 2, 3, 4, 5, 6, 7};
+    math::divisor_ui32x4_t(3).mod_many(arr, 7);
+    for(unsigned i = 0; i < 7; ++i)
+        REQUIRE(arr[i] == (i + 1) % 3);
+}
+
+
+// tests for pcvt.h
+
+#include <pcvt.h>
+
+TEST_CASE("TestConversions")
+{
+    using math::round_t;
+    using vec4f_t = math::vec4f_t;
+    using veci_i32x4_t = math::veci_i32x4_t;
+    using veci_ui32x4_t = math::veci_ui32x4_t;
+
+    vec4f_t v{2.5f, -2.5f, 1.75f, -1.25f};
+    veci_i32x4_t i = math::cvt_i32<round_t::nearest_even>(v);
+    REQUIRE(i[0] == 2);
+    REQUIRE(i[1] == -2);
+    REQUIRE(i[2] == 2);
+    REQUIRE(i[3] == -1);
+    i = math::cvt_i32<round_t::trunc>(v);
+    REQUIRE(i[1] == -2);
+    REQUIRE(i[3] == -1);
+    i = math::cvt_i32<round_t::floor>(v);
+    REQUIRE(i[0] == 2);
+    REQUIRE(i[1] == -3);
+    REQUIRE(i[3] == -2);
+    i = math::cvt_i32<round_t::ceil>(v);
+    REQUIRE(i[0] == 3);
+    REQUIRE(i[2] == 2);
+    REQUIRE(i[3] == -1);
+
+    vec4f_t big{3e9f, -3e9f, NAN, 2147483520.0f};
+    i = math::cvt_i32_sat<round_t::ceil>(big);
+    REQUIRE(i[0] == INT32_MAX);
+    REQUIRE(i[1] == INT32_MIN);
+    REQUIRE(i[2] == 0);
+    REQUIRE(i[3] == 2147483520);
+
+    veci_ui32x4_t u = math::cvt_u32<round_t::trunc>(vec4f_t{3e9f, 4294967040.0f, 2147483648.0f, 1.5f});
+    REQUIRE(u[0] == 3000000000u);
+    REQUIRE(u[1] == 4294967040u);
+    REQUIRE(u[2] == 2147483648u);
+    REQUIRE(u[3] == 1u);
+    u = math::cvt_u32_sat<round_t::floor>(vec4f_t{-1.5f, 1e20f, NAN, 0.5f});
+    REQUIRE(u[0] == 0u);
+    REQUIRE(u[1] == UINT32_MAX);
+    REQUIRE(u[2] == 0u);
+    REQUIRE(u[3] == 0u);
+
+    vec4f_t f = math::cvt_f32(veci_ui32x4_t{0xFFFFFFFFu, 0x80000001u, 16777217u, 0u});
+    REQUIRE(f[0] == 4294967296.0f);
+    REQUIRE(f[1] == 2147483648.0f);
+    REQUIRE(f[2] == 16777216.0f);
+    REQUIRE(f[3] == 0.0f);
+
+    // arrays with remainders
+    uint16_t s16[11];
+    for(unsigned k = 0; k < 11; ++k) s16[k] = uint16_t(k * 6553 + 5);
+    s16[10] = 0xFFFF;
+    float d[11];
+    math::cvt_f32_norm_many(d, s16, 11);
+    REQUIRE(d[10] == 1.0f);
+    REQUIRE(std::fabs(d[3] - s16[3] / 65535.0f) < 1e-7f);
+    math::cvt_f32_many(d, s16, 11);
+    for(unsigned k = 0; k < 11; ++k)
+        REQUIRE(d[k] == float(s16[k]));
+
+    uint8_t s8[19];
+    for(unsigned k = 0; k < 19; ++k) s8[k] = uint8_t(k * 13);
+    math::cvt_f32_norm_many(d, s8 + 8, 11);
+    REQUIRE(std::fabs(d[10] - 234.0f / 255.0f) < 1e-7f);
+
+    float fs[5] = {-0.5f, 0.5f, 1.5f, 5e9f, -7.5f};
+    int32_t is[5];
+    math::cvt_i32_sat_many<round_t::nearest_even>(is, fs, 5);
+    REQUIRE(is[0] == 0);
+    REQUIRE(is[1] == 0);
+    REQUIRE(is[2] == 2);
+    REQUIRE(is[3] == INT32_MAX);
+    REQUIRE(is[4] == -8);
+
+#if defined(SSE2) || defined(AVX)
+    using veci_i64x2_t = math::veci_i64x2_t;
+    math::vec2d_t dd = math::cvt_f64(veci_i64x2_t(INT64_MIN, 9007199254740993LL));
+    REQUIRE(dd[0] == -9223372036854775808.0);
+    REQUIRE(dd[1] == 9007199254740992.0);
+    veci_i64x2_t i64 = math::cvt_i64_sat<round_t::floor>(math::vec2d_t(-2.5, 1e300));
+    REQUIRE(i64[0] == -3);
+    REQUIRE(i64[1] == INT64_MAX);
+#endif
+}
+
+
+TEST_CASE("TestWidenNarrow")
+{
+    using veci_i8x16_t = math::veci_i8x16_t;
+    using veci_ui8x16_t = math::veci_ui8x16_t;
+    using veci_i16x8_t = math::veci_i16x8_t;
+    using veci_ui16x8_t = math::veci_ui16x8_t;
+    using veci_i32x4_t = math::veci_i32x4_t;
+    using veci_i64x2_t = math::veci_i64x2_t;
+    using veci_ui64x2_t = math::veci_ui64x2_t;
+
+    veci_i8x16_t b;
+    for(int i = 0; i < 16; ++i) b[i] = int8_t(i * 17 - 128);
+    veci_i16x8_t lo = math::widen_lo(b), hi = math::widen_hi(b);
+    for(int i = 0; i < 8; ++i) {
+        REQUIRE(lo[i] == i * 17 - 128);
+        REQUIRE(hi[i] == (i + 8) * 17 - 128);
+    }
+    REQUIRE(math::narrow_trunc(lo, hi) == b);
+
+    veci_ui8x16_t ub;
+    for(int i = 0; i < 16; ++i) ub[i] = uint8_t(255 - i);
+    veci_ui16x8_t ulo = math::widen_lo(ub);
+    REQUIRE(ulo[0] == 255);
+    REQUIRE(ulo[7] == 248);
+
+    // saturation
+    veci_i16x8_t s{-300, -129, -128, 0, 127, 128, 300, -1};
+    veci_i8x16_t n = math::narrow_sat(s, s);
+    REQUIRE(n[0] == -128);
+    REQUIRE(n[1] == -128);
+    REQUIRE(n[4] == 127);
+    REQUIRE(n[6] == 127);
+    REQUIRE(n[15] == -1);
+    veci_ui8x16_t un = math::narrow_usat(s, s);
+    REQUIRE(un[0] == 0);
+    REQUIRE(un[5] == 128);
+    REQUIRE(un[6] == 255);
+    REQUIRE(un[7] == 0);
+    un = math::narrow_sat(veci_ui16x8_t{0, 255, 256, 0xFFFF, 0x8000, 1, 2, 3}, veci_ui16x8_t{});
+    REQUIRE(un[1] == 255);
+    REQUIRE(un[2] == 255);
+    REQUIRE(un[3] == 255);
+    REQUIRE(un[4] == 255);
+    REQUIRE(un[5] == 1);
+
+    veci_i16x8_t t = math::narrow_trunc(veci_i32x4_t{0x12345, -1, 0x18000, -65536}, veci_i32x4_t{});
+    REQUIRE(t[0] == 0x2345);
+    REQUIRE(t[1] == -1);
+    REQUIRE(t[2] == -32768);
+    REQUIRE(t[3] == 0);
+
+    veci_i32x4_t i32 = math::narrow_sat(veci_i64x2_t(INT64_MIN, -2147483649LL), veci_i64x2_t(2147483647LL, -5));
+    REQUIRE(i32[0] == INT32_MIN);
+    REQUIRE(i32[1] == INT32_MIN);
+    REQUIRE(i32[2] == INT32_MAX);
+    REQUIRE(i32[3] == -5);
+    math::veci_ui32x4_t u32 = math::narrow_usat(veci_i64x2_t(-1, 4294967296LL), veci_i64x2_t(4294967295LL, 7));
+    REQUIRE(u32[0] == 0u);
+    REQUIRE(u32[1] == UINT32_MAX);
+    REQUIRE(u32[2] == UINT32_MAX);
+    REQUIRE(u32[3] == 7u);
+    u32 = math::narrow_sat(veci_ui64x2_t(UINT64_MAX, 1), veci_ui64x2_t(0x100000000ULL, 0xFFFFFFFFULL));
+    REQUIRE(u32[0] == UINT32_MAX);
+    REQUIRE(u32[1] == 1u);
+    REQUIRE(u32[2] == UINT32_MAX);
+    REQUIRE(u32[3] == UINT32_MAX);
+
+    // buffers with remainders
+    int16_t w[21];
+    int8_t src[21], dst[21];
+    for(int i = 0; i < 21; ++i) src[i] = int8_t(i * 13 - 100);
+    math::widen_many(w, src, 21);
+    for(int i = 0; i < 21; ++i)
+        REQUIRE(w[i] == src[i]);
+    for(int i = 0; i < 21; ++i) w[i] = int16_t(w[i] * 3);
+    math::narrow_sat_many(dst, w, 21);
+    for(int i = 0; i < 21; ++i)
+        REQUIRE(dst[i] == (w[i] < -128 ? -128 : w[i] > 127 ? 127 : w[i]));
+    uint8_t udst[21];
+    math::narrow_usat_many(udst, w, 21);
+    for(int i = 0; i < 21; ++i)
+        REQUIRE(udst[i] == (w[i] < 0 ? 0 : w[i] > 255 ? 255 : w[i]));
+}
+
+
+#include <pparallel.h>
+
+TEST_CASE("TestParallel")
+{
+    const size_t n = 100003;
+    std::vector<int32_t> src(n);
+    std::vector<float> dst(n), vals(n);
+    for(size_t i = 0; i < n; ++i) {
+        src[i] = int32_t(i) - 50000;
+        vals[i] = 1.0f / float(i + 1);
+    }
+
+    math::thread_pool_t pool1(1), pool4(4), pool7(7, math::affinity_t::compact);
+    REQUIRE(pool4.size() == 4);
+
+    // chunks of 1000 elements, the last one shorter; all conversions done
+    math::parallel_transform(pool4, &dst[0], &src[0], n, [](float * d, const int32_t * s, size_t k) {
+        math::cvt_f32_many(d, s, k); }, 1000);
+    for(size_t i = 0; i < n; ++i)
+        REQUIRE(dst[i] == float(src[i]));
+
+    // every index visited exactly once
+    std::vector<std::atomic<int> > hits(n);
+    for(size_t i = 0; i < n; ++i) hits[i] = 0;
+    math::parallel_for(pool7, n, 333, [&](size_t b, size_t e) {
+        for(size_t i = b; i < e; ++i) ++hits[i]; });
+    size_t bad = 0;
+    for(size_t i = 0; i < n; ++i) bad += hits[i] != 1;
+    REQUIRE(bad == 0);
+
+    // float sums are bitwise identical for any number of threads
+    auto sum = [&](size_t b, size_t e) {
+        float s = 0.0f;
+        for(size_t i = b; i < e; ++i) s += vals[i];
+        return s;
+    };
+    auto add = [](float a, float b) { return a + b; };
+    float s1 = math::parallel_reduce(pool1, n, 1024, 0.0f, sum, add);
+    float s4 = math::parallel_reduce(pool4, n, 1024, 0.0f, sum, add);
+    float s7 = math::parallel_reduce(pool7, n, 1024, 0.0f, sum, add);
+    REQUIRE(s1 == s4);
+    REQUIRE(s1 == s7);
+    REQUIRE(math::almost_equal(s1, 12.0902f, 0.001f));
+
+    // small inputs and nested calls run inline
+    REQUIRE(math::parallel_reduce(pool4, 10, 1024, 1, [](size_t b, size_t e) { return int(e - b); },
+                                  [](int a, int b) { return a + b; }) == 11);
+    std::atomic<int> nested(0);
+    math::parallel_for(pool4, 8, 1, [&](size_t, size_t) {
+        math::parallel_for(pool4, 8, 1, [&](size_t, size_t) { ++nested; }); });
+    REQUIRE(nested.load() == 64);
+
+    // exceptions reach the caller
+    bool thrown = false;
+    try {
+        math::parallel_for(pool4, 100, 1, [](size_t b, size_t) {
+            if(b == 57) throw std::runtime_error("chunk 57"); });
+    } catch(const std::runtime_error &) { thrown = true; }
+    REQUIRE(thrown);
+}
+
+
+#include <palloc.h>
+
+TEST_CASE("TestAlignedAlloc")
+{
+    math::aligned_vector_t<math::vec4f_t> vecs(13);
+    REQUIRE(math::is_aligned(vecs.data(), 64));
+    for(size_t i = 0; i < vecs.size(); ++i)
+        vecs[i] = math::vec4f_t(float(i));
+    vecs.push_back(math::vec4f_t(1.0f));
+    REQUIRE(math::is_aligned(vecs.data(), 64));
+    REQUIRE(vecs[12][0] == 12.0f);
+
+    // the padding up to the next cache line is zeroed and may be read
+    math::aligned_vector_t<float> vals(5, 1.0f);
+    REQUIRE(math::padded_size<float>(5) == 16);
+    REQUIRE(math::padded_size<float>(16) == 16);
+    math::vec4f_t tail;
+    tail.loada(&vals[4]);
+    REQUIRE(tail[0] == 1.0f);
+    REQUIRE(tail[1] == 0.0f);
+    REQUIRE(tail[3] == 0.0f);
+
+    math::arena_t arena(1024);
+    float * a = arena.allocate_array<float>(3);
+    float * b = arena.allocate_array<float>(100);
+    math::mat4f_t * m = arena.allocate_array<math::mat4f_t>(4);
+    void * big = arena.allocate(4000, 256);
+    REQUIRE(math::is_aligned(a, 64));
+    REQUIRE(math::is_aligned(b, 64));
+    REQUIRE(math::is_aligned(m, 64));
+    REQUIRE(math::is_aligned(big, 256));
+    REQUIRE(b - a == 16);
+    REQUIRE(a[3] == 0.0f);
+    REQUIRE(b[99] == 0.0f);
+    size_t cap = arena.capacity();
+    REQUIRE(arena.used() > 4000);
+
+    // reset() reuses the blocks
+    arena.reset();
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.allocate_array<float>(3) == a);
+    arena.allocate(4000, 256);
+    REQUIRE(arena.capacity() == cap);
+}
+
+
+#include <pvfile.h>
+
+TEST_CASE("TestVectorFile")
+{
+    const size_t n = 37;
+    float x[n], y[n], z[n], xyzw[4*n];
+    int32_t ids[n];
+    for(size_t i = 0; i < n; ++i) {
+        x[i] = float(i); y[i] = float(2*i); z[i] = float(3*i);
+        ids[i] = int32_t(1000 + i);
+        for(int c = 0; c < 4; ++c) xyzw[4*i+c] = float(10*i + c);
+    }
+
+    const char * path = "pvfile_test.pvec";
+    {
+        math::vfile_writer_t w;
+        REQUIRE(w.open(path));
+        REQUIRE(w.begin_section("pos", math::vf_type_t::f32, math::vf_layout_t::soa, 3, n));
+        REQUIRE(w.write(x, 10));   // chunk-wise, as produced by a batch kernel
+        REQUIRE(w.write(x + 10, n - 10));
+        REQUIRE(w.write(y, n));
+        REQUIRE(w.write(z, n));
+        REQUIRE(!w.write(z, 1));   // more than announced
+        REQUIRE(w.end_section());
+        REQUIRE(w.begin_section("ids", math::vf_type_t::i32, math::vf_layout_t::aos, 1, n));
+        REQUIRE(!w.write(x, n));   // wrong type
+        REQUIRE(w.write(ids, n));
+        REQUIRE(w.end_section());
+        REQUIRE(w.begin_section("pts", math::vf_type_t::f32, math::vf_layout_t::aos, 4, n));
+        REQUIRE(w.write(xyzw, 4*n));
+        REQUIRE(w.end_section());
+        REQUIRE(w.begin_section("short", math::vf_type_t::f32, math::vf_layout_t::aos, 1, n));
+        REQUIRE(w.write(x, n - 1));
+        REQUIRE(!w.end_section()); // incomplete
+        REQUIRE(w.begin_section("after", math::vf_type_t::f32, math::vf_layout_t::aos, 1, n));
+        REQUIRE(w.write(z, n));    // aligned again after the partial stream
+        REQUIRE(w.end_section());
+        REQUIRE(w.close());
+    }
+
+    math::vfile_t f;
+    REQUIRE(!f.open("does-not-exist.pvec"));
+    REQUIRE(f.open(path));
+    REQUIRE(f.sections() == 4);
+    REQUIRE(f.find("short") == nullptr);
+    const math::vf_section_t * after = f.find("after");
+    REQUIRE(after != nullptr);
+    REQUIRE(after->offset % 64 == 0);
+    REQUIRE(f.stream<float>(*after)[n-1] == z[n-1]);
+
+    const math::vf_section_t * pos = f.find("pos");
+    REQUIRE(pos != nullptr);
+    REQUIRE(pos->count == n);
+    REQUIRE(f.stream<int32_t>(*pos) == nullptr);
+    REQUIRE(f.stream<float>(*pos, 3) == nullptr);
+    const float * zs = f.stream<float>(*pos, 2);
+    REQUIRE(math::is_aligned(zs, 64));
+    REQUIRE(zs[n-1] == z[n-1]);
+
+    math::vview_t<math::vec4f_t> ys = f.view<math::vec4f_t>(*pos, 1);
+    REQUIRE(ys.size() == 10);
+    REQUIRE(ys[2][1] == y[9]);
+    REQUIRE(ys[9][0] == y[36]);
+    REQUIRE(ys[9][1] == 0.0f);    // zero padding
+
+    math::vview_t<math::vec4f_t> pts = f.view<math::vec4f_t>(*f.find("pts"));
+    REQUIRE(pts.size() == n);
+    REQUIRE(pts[17][3] == 173.0f);
+
+    math::vview_t<math::veci_i32x4_t> idv = f.view<math::veci_i32x4_t>(*f.find("ids"));
+    REQUIRE(idv[9][0] == 1036);
+    f.close();
+    REQUIRE(!f.is_open());
+
+    // files with another version are rejected
+    FILE * fp = fopen(path, "r+b");
+    REQUIRE(fp != nullptr);
+    fseek(fp, 4, SEEK_SET);
+    fputc(9, fp);
+    fclose(fp);
+    REQUIRE(!f.open(path));
+
+    // a count that wraps count * element size (and the stream size derived
+    // from it) to zero is rejected
+    {
+        math::vfile_writer_t w;
+        REQUIRE(w.open(path));
+        REQUIRE(w.begin_section("ids", math::vf_type_t::i32, math::vf_layout_t::aos, 1, n));
+        REQUIRE(w.write(ids, n));
+        REQUIRE(w.end_section());
+        REQUIRE(w.close());
+    }
+    REQUIRE(f.open(path));
+    f.close();
+    math::vf_header_t h;
+    math::vf_section_t s;
+    fp = fopen(path, "r+b");
+    REQUIRE(fp != nullptr);
+    REQUIRE(fread(&h, sizeof(h), 1, fp) == 1);
+    fseek(fp, long(h.table_offset), SEEK_SET);
+    REQUIRE(fread(&s, sizeof(s), 1, fp) == 1);
+    s.count = uint64_t(1) << 62;
+    s.stream_bytes = 0;
+    fseek(fp, long(h.table_offset), SEEK_SET);
+    fwrite(&s, sizeof(s), 1, fp);
+    fclose(fp);
+    REQUIRE(!f.open(path));
+    remove(path);
+}
+
+
+#include <ppipeline.h>
+
+TEST_CASE("TestPipeline")
+{
+    const size_t n = 1000;
+    std::vector<float> src(n);
+    for(size_t i = 0; i < n; ++i)
+        src[i] = float(int(i % 17) - 8);
+
+    // scale -> keep positive -> round to int, fused per tile
+    size_t tiles = 0;
+    auto p = math::make_pipeline(
+        math::map_stage<math::vec4f_t>([](math::vec4f_t v) { return v * math::vec4f_t(1.5f, 1.5f, 1.5f, 1.5f); }),
+        math::filter_stage<math::vec4f_t>([](math::vec4f_t v) {
+            return math::cmp_gt(v, math::vec4f_t(0.0f, 0.0f, 0.0f, 0.0f)); }),
+        math::convert_stage<float, int32_t>([](int32_t * d, const float * s, size_t k) {
+            math::cvt_i32_many<math::round_t::nearest_even>(d, s, k); }),
+        math::custom_stage<int32_t, int32_t>([&](const int32_t * in, size_t k, int32_t * out) {
+            ++tiles;
+            for(size_t i = 0; i < k; ++i) out[i] = in[i] + 100;
+            return k; }));
+    REQUIRE(p.tile() == 2048);
+    p.set_tile(100);          // rounded up to 128 elements
+    REQUIRE(p.tile() == 128);
+
+    std::vector<int32_t> dst(n), ref;
+    for(size_t i = 0; i < n; ++i) {
+        float v = src[i] * 1.5f;
+        if(v > 0.0f) ref.push_back(int32_t(std::nearbyint(v)) + 100);
+    }
+    size_t m = p.run(&src[0], n, &dst[0]);
+    REQUIRE(m == ref.size());
+    REQUIRE(tiles == 8);
+    for(size_t i = 0; i < m; ++i)
+        REQUIRE(dst[i] == ref[i]);
+
+    // unpadded short input, integer vectors
+    int32_t isrc[7] = { 1, 2, 3, 4, 5, 6, 7 }, idst[7];
+    auto q = math::make_pipeline(
+        math::map_stage<math::veci_i32x4_t>([](math::veci_i32x4_t v) { return v + v; }));
+    REQUIRE(q.run(isrc, 7, idst) == 7);
+    REQUIRE(idst[6] == 14);
+}
+
+
+#include <pcompress.h>
+
+TEST_CASE("TestCompress")
+{
+    using namespace math;
+
+    vec4f_t v(1.0f, 2.0f, 3.0f, 4.0f);
+    float out[4];
+    for(unsigned bits = 0; bits < 16; ++bits) {
+        size_t k = compress_store(bits, v, out);
+        size_t j = 0;
+        for(unsigned l = 0; l < 4; ++l)
+            if(bits & (1u << l)) REQUIRE(out[j++] == v[l]);
+        REQUIRE(k == j);
+    }
+    vec4f_t mask(cmp_gt(v, vec4f_t(2.5f, 0.0f, 3.5f, 0.0f)));
+    REQUIRE(mask_bits(mask) == 0xA);
+    REQUIRE(compress_store(mask, v, out) == 2);
+    REQUIRE((out[0] == 2.0f && out[1] == 4.0f));
+
+    veci_i64x2_t v64{-5, 7};
+    int64_t out64[2];
+    REQUIRE(compress_store(2u, v64, out64) == 1);
+    REQUIRE(out64[0] == 7);
+
+    // generic fallback
+    veci_i16x8_t v16{1, 2, 3, 4, 5, 6, 7, 8};
+    int16_t out16[8];
+    REQUIRE(compress_store(0x81u, v16, out16) == 2);
+    REQUIRE((out16[0] == 1 && out16[1] == 8));
+
+#if defined(PVECI_INTEL) && defined(AVX2)
+    veci_i32x8_t v8{10, 11, 12, 13, 14, 15, 16, 17};
+    int32_t out8[8];
+    for(unsigned bits = 0; bits < 256; ++bits) {
+        size_t k8 = compress_store(bits, v8, out8), j8 = 0;
+        for(unsigned l = 0; l < 8; ++l)
+            if(bits & (1u << l)) REQUIRE(out8[j8++] == v8[l]);
+        REQUIRE(k8 == j8);
+    }
+#endif
+
+    const size_t n = 1003;
+    std::vector<float> src(n), dst(n);
+    std::vector<int32_t> isrc(n), idst(n);
+    std::vector<uint8_t> keep(n);
+    for(size_t i = 0; i < n; ++i) {
+        src[i] = float((i * 7919) % 100);
+        isrc[i] = int32_t(i);
+        keep[i] = uint8_t((i * 31) % 7 < 2);
+    }
+    size_t k = filter_many<vec4f_t>(&dst[0], &src[0], n, [](const vec4f_t & x) {
+        return cmp_lt(x, vec4f_t(25.0f, 25.0f, 25.0f, 25.0f)); });
+    size_t j = 0;
+    for(size_t i = 0; i < n; ++i)
+        if(src[i] < 25.0f) REQUIRE(dst[j++] == src[i]);
+    REQUIRE(k == j);
+
+    k = compress_many(&idst[0], &isrc[0], &keep[0], n);
+    j = 0;
+    for(size_t i = 0; i < n; ++i)
+        if(keep[i]) REQUIRE(idst[j++] == isrc[i]);
+    REQUIRE(k == j);
+}
+
+
+#include <pexpr.h>
+
+TEST_CASE("TestExpr")
+{
+    using namespace math;
+
+    const size_t n = 37; // full registers and a tail
+    float a[n], b[n], c[n], out[n];
+    for(size_t i = 0; i < n; ++i) {
+        a[i] = float(i) * 0.25f;
+        b[i] = 2.0f - float(i) * 0.125f;
+        c[i] = float(i % 8) * 0.2f;
+        out[i] = -1.0f;
+    }
+    auto A = array_ref((const float *)a, n);
+    auto B = array_ref((const float *)b, n);
+    auto C = array_ref((const float *)c, n);
+
+    array_ref(out, n) = A * B + fast_sin(C) * 0.5f;
+    for(size_t i = 0; i < n; ++i)
+        REQUIRE(std::fabs(out[i] - (a[i] * b[i] + std::sin(c[i]) * 0.5f)) < 1e-5f);
+
+    array_ref(out, n) = max_(abs_(-A + 2.0f), B) / 2.0f - fast_cos(C) * C;
+    for(size_t i = 0; i < n; ++i) {
+        float e = std::max(std::fabs(2.0f - a[i]), b[i]) / 2.0f - std::cos(c[i]) * c[i];
+        REQUIRE(std::fabs(out[i] - e) < 1e-5f);
+    }
+
+    // destination as operand, partial range, user defined operation
+    array_ref(out, n) = 1.0f;
+    array_ref(out, n) += A * 2.0f;
+    typedef ipriv::expr_vec<float>::type expr_vec_t; // vec8f_t with AVX
+    evaluate(out, map(A, [](const expr_vec_t & v) { return v * v; }), 3, 6);
+    for(size_t i = 0; i < n; ++i)
+        REQUIRE(out[i] == (i >= 3 && i < 6 ? a[i] * a[i] : 1.0f + 2.0f * a[i]));
+    REQUIRE(out[n - 1] == 1.0f + 2.0f * a[n - 1]);
+
+#if defined(PVECF_INTEL) && (defined(SSE2) || defined(AVX))
+    double d[5] = { 1.0, 2.0, 3.0, 4.0, 5.0 }, r[5];
+    array_ref(r, 5) = 3.0 * array_ref((const double *)d, 5) + 1.0;
+    for(size_t i = 0; i < 5; ++i)
+        REQUIRE(r[i] == 3.0 * d[i] + 1.0);
+#endif
+}
+
+#include <pinstr.h>
+
+TEST_CASE("TestInstrument")
+{
+    using namespace math;
+
+    instr_reset();
+    vec4f_t::math_t::fast_sin_1(vec4f_t::math_t::ones());
+    vec4f_t::math_t::fast_sin_1(vec4f_t::math_t::ones());
+    {
+        PVEC_PROBE_N("unittest probe", 10);
+    }
+    std::vector<instr_entry_t> e = instr_snapshot();
+#if defined(PVEC_INSTRUMENT)
+    bool found_sin = false, found_probe = false;
+    for(size_t i = 0; i < e.size(); ++i) {
+        if(strcmp(e[i].name, "fast_sin_1() float x 4") == 0) {
+            found_sin = true;
+            REQUIRE(e[i].calls == 2);
+            REQUIRE(e[i].elems == 8);
+        }
+        if(strcmp(e[i].name, "unittest probe") == 0) {
+            found_probe = true;
+            REQUIRE(e[i].calls == 1);
+            REQUIRE(e[i].elems == 10);
+        }
+    }
+    REQUIRE(found_sin);
+    REQUIRE(found_probe);
+
+    // counters of finished threads are kept
+    std::thread t([] { PVEC_PROBE("unittest probe"); });
+    t.join();
+    e = instr_snapshot();
+    for(size_t i = 0; i < e.size(); ++i)
+        if(strcmp(e[i].name, "unittest probe") == 0) REQUIRE(e[i].calls == 2);
+
+    instr_reset();
+    REQUIRE(instr_snapshot().empty());
+#else
+    REQUIRE(e.empty());
+#endif
+}
+
+#include <pfenv.h>
+#include <cfenv>
+
+TEST_CASE("TestFloatEnv")
+{
+    using namespace math;
+
+    // the compiler doesn't know about the environment and may move the
+    // arithmetic across set_fenv(), so it's called through opaque pointers
+    const fp_env_t initial = get_fenv();
+    static volatile float tiny = 1e-38f, scale = 1e-3f, one = 1.0f, three = 3.0f;
+    float (* volatile mul)() = []() { float x = tiny, y = scale; return (vec4f_t(x, x, x, x) * vec4f_t(y, y, y, y))[0]; };
+    float (* volatile div)() = []() { float x = one, y = three; return (vec4f_t(x, x, x, x) / vec4f_t(y, y, y, y))[0]; };
+
+    REQUIRE(mul() != 0.0f); // denormal result
+    {
+        fenv_scope_t fenv(fp_env_t::fast());
+        REQUIRE(get_fenv() == fp_env_t::fast());
+        REQUIRE(mul() == 0.0f);
+    }
+    REQUIRE(get_fenv() == initial);
+    REQUIRE(mul() != 0.0f);
+
+    float up, down;
+    {
+        fp_env_t e = { false, false, round_t::ceil };
+        fenv_scope_t fenv(e);
+        REQUIRE(get_fenv().round == round_t::ceil);
+        up = div();
+    }
+    {
+        fp_env_t e = { false, false, round_t::floor };
+        fenv_scope_t fenv(e);
+        down = div();
+    }
+    REQUIRE(up > down);
+    REQUIRE(get_fenv() == initial);
+
+    // the kernel runs with the environment of the wrapper
+    auto k = with_fenv(fp_env_t::fast(), mul);
+    REQUIRE(k() == 0.0f);
+    REQUIRE(get_fenv() == initial);
+}
+
+TEST_CASE("TestRounding")
+{
+    using vec4f_t = math::vec4f_t;
+    using vec2d_t = math::vec2d_t;
+
+    // beyond the int32_t range (the old SSE2 paths converted to int32_t and back)
+    const vec4f_t big(3e9f, -1e10f, 2147483904.0f, -3e9f);
+    vec4f_t t(big.trunc()), fl(big.floor()), ce(big.ceil()), fr(big.frac());
+    for(unsigned i = 0; i < 4; ++i) {
+        REQUIRE(t[i] == big[i]);
+        REQUIRE(fl[i] == big[i]);
+        REQUIRE(ce[i] == big[i]);
+        REQUIRE(fr[i] == 0.0f);
+    }
+    const vec4f_t near2p23(8388607.5f, -8388607.5f, 4194303.75f, -4194303.75f);
+    fl = near2p23.floor();
+    REQUIRE(fl[0] == 8388607.0f);
+    REQUIRE(fl[1] == -8388608.0f);
+    REQUIRE(fl[2] == 4194303.0f);
+    REQUIRE(fl[3] == -4194304.0f);
+    ce = near2p23.ceil();
+    REQUIRE(ce[0] == 8388608.0f);
+    REQUIRE(ce[1] == -8388607.0f);
+    t = near2p23.trunc();
+    REQUIRE(t[0] == 8388607.0f);
+    REQUIRE(t[1] == -8388607.0f);
+    REQUIRE(t[2] == 4194303.0f);
+    REQUIRE(t[3] == -4194303.0f);
+    fr = near2p23.frac();
+    REQUIRE(fr[2] == 0.75f);
+    REQUIRE(fr[3] == 0.25f);
+
+    // ties: even vs. away from zero
+    const vec4f_t h(0.5f, 1.5f, 2.5f, -2.5f);
+    vec4f_t e(h.round_even()), a(h.round_nearest_away());
+    REQUIRE(e[0] == 0.0f);
+    REQUIRE(e[1] == 2.0f);
+    REQUIRE(e[2] == 2.0f);
+    REQUIRE(e[3] == -2.0f);
+    REQUIRE(a[0] == 1.0f);
+    REQUIRE(a[1] == 2.0f);
+    REQUIRE(a[2] == 3.0f);
+    REQUIRE(a[3] == -3.0f);
+    const vec4f_t h2(0.49999997f, -0.49999997f, 5e9f, -3.7f);
+    e = h2.round_even();
+    a = h2.round_nearest_away();
+    REQUIRE(e[0] == 0.0f);
+    REQUIRE(a[0] == 0.0f);
+    REQUIRE(a[1] == 0.0f);
+    REQUIRE(e[2] == 5e9f);
+    REQUIRE(a[2] == 5e9f);
+    REQUIRE(e[3] == -4.0f);
+    REQUIRE(a[3] == -4.0f);
+
+    // the sign of zero results is kept
+    const vec4f_t nz(-0.4f, -0.0f, 0.3f, -0.7f);
+    t = nz.trunc();
+    e = nz.round_even();
+    ce = nz.ceil();
+    REQUIRE((t[0] == 0.0f && std::signbit(t[0])));
+    REQUIRE((t[1] == 0.0f && std::signbit(t[1])));
+    REQUIRE((t[2] == 0.0f && !std::signbit(t[2])));
+    REQUIRE((e[0] == 0.0f && std::signbit(e[0])));
+    a = nz.round_nearest_away();
+    REQUIRE((a[0] == 0.0f && std::signbit(a[0])));
+    REQUIRE(a[3] == -1.0f);
+    REQUIRE((ce[3] == 0.0f && std::signbit(ce[3])));
+
+    // grid snapping
+    const vec4f_t pos(0.3f, 0.6f, -0.74f, 1.13f);
+    vec4f_t snapped(pos.round_to_multiple(0.25f));
+    REQUIRE(math::almost_equal(snapped[0], 0.25f));
+    REQUIRE(math::almost_equal(snapped[1], 0.5f));
+    REQUIRE(math::almost_equal(snapped[2], -0.75f));
+    REQUIRE(math::almost_equal(snapped[3], 1.25f));
+    snapped = pos.round_to_multiple(vec4f_t(1.0f, 0.5f, 0.5f, 0.1f));
+    REQUIRE(math::almost_equal(snapped[0], 0.0f));
+    REQUIRE(math::almost_equal(snapped[1], 0.5f));
+    REQUIRE(math::almost_equal(snapped[2], -0.5f));
+    REQUIRE(math::almost_equal(snapped[3], 1.1f));
+
+    const vec2d_t d(4503599627370495.5, -1e300);
+    vec2d_t df(d.floor()), dc(d.ceil()), dt(d.trunc()), dr(d.frac());
+    REQUIRE(df[0] == 4503599627370495.0);
+    REQUIRE(dc[0] == 4503599627370496.0);
+    REQUIRE(dt[0] == 4503599627370495.0);
+    REQUIRE(dr[0] == 0.5);
+    REQUIRE(df[1] == -1e300);
+    REQUIRE(dr[1] == 0.0);
+    const vec2d_t dh(2.5, -0.5);
+    vec2d_t de(dh.round_even()), da(dh.round_nearest_away());
+    REQUIRE(de[0] == 2.0);
+    REQUIRE((de[1] == 0.0 && std::signbit(de[1])));
+    REQUIRE(da[0] == 3.0);
+    REQUIRE(da[1] == -1.0);
+    const vec2d_t dz(-0.25, 0.0);
+    REQUIRE(std::signbit(dz.round_nearest_away()[0]));
+    const vec2d_t dg(0.3, -1.74);
+    vec2d_t ds(dg.round_to_multiple(0.25));
+    REQUIRE(math::almost_equal(ds[0], 0.25));
+    REQUIRE(math::almost_equal(ds[1], -1.75));
+
+#if defined(AVX)
+    using vec8f_t = math::vec8f_t;
+    using vec4d_t = math::vec4d_t;
+
+    const vec8f_t h8(0.5f, 1.5f, 2.5f, -2.5f, -0.4f, 3e9f, 8388607.5f, -3.7f);
+    vec8f_t e8(h8.round_even()), a8(h8.round_nearest_away());
+    vec8f_t t8(h8.trunc()), f8(h8.floor()), c8(h8.ceil());
+    const float e8r[8] = {0.0f, 2.0f, 2.0f, -2.0f, -0.0f, 3e9f, 8388608.0f, -4.0f};
+    const float a8r[8] = {1.0f, 2.0f, 3.0f, -3.0f, -0.0f, 3e9f, 8388608.0f, -4.0f};
+    const float t8r[8] = {0.0f, 1.0f, 2.0f, -2.0f, -0.0f, 3e9f, 8388607.0f, -3.0f};
+    const float f8r[8] = {0.0f, 1.0f, 2.0f, -3.0f, -1.0f, 3e9f, 8388607.0f, -4.0f};
+    const float c8r[8] = {1.0f, 2.0f, 3.0f, -2.0f, -0.0f, 3e9f, 8388608.0f, -3.0f};
+    for(unsigned i = 0; i < 8; ++i) {
+        REQUIRE(e8[i] == e8r[i]);
+        REQUIRE(a8[i] == a8r[i]);
+        REQUIRE(t8[i] == t8r[i]);
+        REQUIRE(f8[i] == f8r[i]);
+        REQUIRE(c8[i] == c8r[i]);
+    }
+    REQUIRE(std::signbit(t8[4]));
+    REQUIRE(std::signbit(a8[4]));
+    vec8f_t fr8(h8.frac());
+    REQUIRE(fr8[1] == 0.5f);
+    REQUIRE(math::almost_equal(fr8[4], 0.6f));
+    vec8f_t s8(h8.round_to_multiple(2.0f));
+    REQUIRE(s8[2] == 2.0f);
+    REQUIRE(s8[7] == -4.0f);
+
+    const vec4d_t d4(2.5, -0.5, 4503599627370495.5, -1.25);
+    vec4d_t de4(d4.round_even()), da4(d4.round_nearest_away());
+    vec4d_t df4(d4.floor()), dc4(d4.ceil()), dt4(d4.trunc());
+    REQUIRE(de4[0] == 2.0);
+    REQUIRE((de4[1] == 0.0 && std::signbit(de4[1])));
+    REQUIRE(da4[0] == 3.0);
+    REQUIRE(da4[1] == -1.0);
+    REQUIRE(df4[2] == 4503599627370495.0);
+    REQUIRE(dc4[2] == 4503599627370496.0);
+    REQUIRE(dt4[3] == -1.0);
+    REQUIRE(df4[3] == -2.0);
+    REQUIRE(dc4[3] == -1.0);
+    REQUIRE(d4.frac()[3] == 0.75);
+#endif // AVX
+}
+
+#include <prand.h>
+
+TEST_CASE("TestRandom")
+{
+    using namespace math;
+
+    // Philox4x32-10 known answers (Random123 kat_vectors), lane 0
+    philox4x32_t<> ph(0, 0);
+    uint32_t w[4];
+    for(unsigned i = 0; i < 4; ++i) w[i] = ph.next()[0];
+    REQUIRE((w[0] == 0x6627e8d5u && w[1] == 0xe169c58du && w[2] == 0xbc57ac4cu && w[3] == 0x9b00dbd8u));
+    philox4x32_t<> pk(0x299f31d0a4093822ull, 0x0370734413198a2eull);
+    pk.seek(0x85a308d3243f6a88ull);
+    for(unsigned i = 0; i < 4; ++i) w[i] = pk.next()[0];
+    REQUIRE((w[0] == 0xd16cfe09u && w[1] == 0x94fdccebu && w[2] == 0x5001e420u && w[3] == 0x24126ea1u));
+    // lane k is block k, discard() and seek() agree with next()
+    philox4x32_t<> pa(7, 3), pb(7, 3);
+    uint32_t lane1[4];
+    for(unsigned i = 0; i < 4; ++i) lane1[i] = pa.next()[1];
+    for(unsigned i = 0; i < 9; ++i) pa.next();
+    veci_ui32x4_t p13 = pa.next();
+    pb.seek(1);
+    for(unsigned i = 0; i < 4; ++i)
+        REQUIRE(pb.next()[0] == lane1[i]);
+    pb.seek(0);
+    pb.discard(13);
+    REQUIRE(pb.next() == p13);
+
+    // PCG32: lane 2 of stream 13 is pcg32_srandom(42, 54)
+    pcg32_t<> pcg(42, 13);
+    static const uint32_t pcg_ref[6] = { 0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+    for(unsigned i = 0; i < 6; ++i)
+        REQUIRE(pcg.next()[2] == pcg_ref[i]);
+    pcg32_t<> pc1(1, 2), pc2(1, 2);
+    for(unsigned i = 0; i < 1000; ++i) pc1.next();
+    pc2.discard(1000);
+    REQUIRE(pc1.next() == pc2.next());
+
+    // xoshiro128+ against the scalar algorithm, lanes 2^64 apart
+    xoshiro128p_t<> xo(5);
+    uint64_t sm = 5;
+    uint64_t a = ipriv::splitmix64(sm), b = ipriv::splitmix64(sm);
+    uint32_t s[4] = { uint32_t(a), uint32_t(a >> 32), uint32_t(b), uint32_t(b >> 32) };
+    ipriv::xoshiro128_jump(s, ipriv::xoshiro128_jump64);
+    for(unsigned i = 0; i < 100; ++i)
+        REQUIRE(xo.next()[1] == ipriv::xoshiro128_next(s));
+    xoshiro128p_t<> xs(5, 1), xj(5);
+    xj.jump();
+    REQUIRE(xs.next() == xj.next());
+
+    // distributions: ranges and moments
+    const unsigned n = 4096;
+    double sum = 0.0, sum2 = 0.0;
+    for(unsigned i = 0; i < n; ++i) {
+        vec4f_t u(uniform01(xo));
+        for(unsigned l = 0; l < 4; ++l) {
+            REQUIRE(u[l] >= 0.0f);
+            REQUIRE(u[l] < 1.0f);
+            sum += u[l];
+        }
+    }
+    REQUIRE(std::fabs(sum / (4 * n) - 0.5) < 0.01);
+
+    for(unsigned i = 0; i < 1000; ++i) {
+        veci_ui32x4_t k(uniform_uint(pcg, 10u));
+        veci_i32x4_t j(uniform_int(ph, -3, 3));
+        for(unsigned l = 0; l < 4; ++l) {
+            REQUIRE(k[l] < 10u);
+            REQUIRE((j[l] >= -3 && j[l] <= 3));
+        }
+    }
+
+    std::vector<float> g(3 * n + 5);
+    normal_many(xo, &g[0], g.size());
+    sum = sum2 = 0.0;
+    for(size_t i = 0; i < g.size(); ++i) { sum += g[i]; sum2 += double(g[i]) * g[i]; }
+    REQUIRE(std::fabs(sum / g.size()) < 0.05);
+    REQUIRE(std::fabs(sum2 / g.size() - 1.0) < 0.05);
+    sum = sum2 = 0.0;
+    for(unsigned i = 0; i < n; ++i) {
+        vec4f_t z(normal(pcg, 2.0f, 0.5f));
+        for(unsigned l = 0; l < 4; ++l) { sum += z[l]; sum2 += double(z[l]) * z[l]; }
+    }
+    REQUIRE(std::fabs(sum / (4 * n) - 2.0) < 0.02);
+    REQUIRE(std::fabs(sum2 / (4 * n) - 4.25) < 0.1);
+
+    // directions: unit length, hemispheres above the xy plane
+    double zsum = 0.0, zc = 0.0;
+    for(unsigned i = 0; i < 1000; ++i) {
+        vec4f_t x, y, z;
+        unit_sphere(xo, x, y, z);
+        for(unsigned l = 0; l < 4; ++l) {
+            REQUIRE(std::fabs(x[l] * x[l] + y[l] * y[l] + z[l] * z[l] - 1.0f) < 1e-5f);
+            zsum += z[l];
+        }
+        unit_hemisphere(ph, x, y, z);
+        for(unsigned l = 0; l < 4; ++l) {
+            REQUIRE(z[l] > 0.0f);
+            REQUIRE(std::fabs(x[l] * x[l] + y[l] * y[l] + z[l] * z[l] - 1.0f) < 1e-5f);
+        }
+        cosine_hemisphere(pcg, x, y, z);
+        for(unsigned l = 0; l < 4; ++l) {
+            REQUIRE(z[l] > 0.0f);
+            REQUIRE(std::fabs(x[l] * x[l] + y[l] * y[l] + z[l] * z[l] - 1.0f) < 1e-5f);
+            zc += z[l];
+        }
+    }
+    REQUIRE(std::fabs(zsum / 4000) < 0.05);
+    REQUIRE(std::fabs(zc / 4000 - 2.0 / 3.0) < 0.03); // E[cos] = 2/3
+
+    std::vector<float> f(13);
+    std::vector<uint32_t> r(13);
+    uniform01_many(pcg, &f[0], f.size());
+    next_many(ph, &r[0], r.size());
+    REQUIRE((f[12] >= 0.0f && f[12] < 1.0f));
+
+#if defined(PVECI_INTEL) && defined(AVX2)
+    // 8 lanes: the same streams as the 4 lane generators
+    philox4x32_t<veci_ui32x8_t> ph8(0, 0);
+    REQUIRE(ph8.next()[0] == 0x6627e8d5u);
+    pcg32_t<veci_ui32x8_t> pcg8(42, 6);  // lane 6 of stream 6: sequence 54
+    REQUIRE(pcg8.next()[6] == pcg_ref[0]);
+    xoshiro128p_t<veci_ui32x8_t> xo8(5);
+    xoshiro128p_t<> xo4(5);
+    veci_ui32x8_t v8 = xo8.next();
+    veci_ui32x4_t v4 = xo4.next();
+    REQUIRE((v8[0] == v4[0] && v8[3] == v4[3]));
+    for(unsigned i = 0; i < 100; ++i) {
+        veci_i32x8_t j8(uniform_int(pcg8, 0, 5));
+        for(unsigned l = 0; l < 8; ++l)
+            REQUIRE((j8[l] >= 0 && j8[l] <= 5));
+    }
+#endif
+}
+
+#include <pnoise.h>
+
+TEST_CASE("TestNoise")
+{
+    using namespace math;
+
+    xoshiro128p_t<> g(11);
+    for(unsigned i = 0; i < 2000; ++i) {
+        vec4f_t x(uniform(g, -100.0f, 100.0f)), y(uniform(g, -100.0f, 100.0f));
+        vec4f_t z(uniform(g, -100.0f, 100.0f)), w(uniform(g, -100.0f, 100.0f));
+        vec4f_t n[6] = {
+            perlin(x, y), perlin(x, y, z), perlin(x, y, z, w),
+            simplex(x, y), simplex(x, y, z), simplex(x, y, z, w)
+        };
+        // lanes are independent points
+        vec4f_t x1(x[1], x[1], x[1], x[1]), y1(y[1], y[1], y[1], y[1]);
+        vec4f_t z1(z[1], z[1], z[1], z[1]), w1(w[1], w[1], w[1], w[1]);
+        REQUIRE(perlin(x1, y1, z1)[0] == n[1][1]);
+        REQUIRE(simplex(x1, y1, z1, w1)[3] == n[5][1]);
+        // small steps, small changes (also across the cell borders)
+        vec4f_t d(1e-3f, 1e-3f, 1e-3f, 1e-3f);
+        vec4f_t m[6] = {
+            perlin(x + d, y), perlin(x, y + d, z), perlin(x, y, z, w + d),
+            simplex(x + d, y), simplex(x, y, z + d), simplex(x + d, y, z, w)
+        };
+        for(unsigned k = 0; k < 6; ++k)
+            for(unsigned l = 0; l < 4; ++l) {
+                REQUIRE(std::fabs(n[k][l]) <= 1.0f);
+                REQUIRE(std::fabs(n[k][l] - m[k][l]) < 0.02f);
+            }
+    }
+
+    // Perlin noise is 0 at the lattice points, the seed selects another pattern
+    vec4f_t ix(-3.0f, 0.0f, 7.0f, 100.0f), iy(5.0f, -1.0f, 2.0f, -42.0f);
+    vec4f_t p0(perlin(ix, iy)), p1(perlin(ix, iy, ix, 3)), p2(perlin(ix, iy, iy, ix));
+    REQUIRE((p0[0] == 0.0f && p0[3] == 0.0f && p1[1] == 0.0f && p2[2] == 0.0f));
+    vec4f_t hx(0.3f, 1.7f, -2.2f, 9.9f), hy(0.6f, -4.1f, 3.3f, 0.1f);
+    vec4f_t s0(simplex(hx, hy)), s1(simplex(hx, hy, 1));
+    REQUIRE((s0[0] != s1[0] || s0[1] != s1[1]));
+
+    // one octave is the noise itself, turbulence() in [0,1]
+    vec4f_t f1(fbm(noise_t::simplex, hx, hy, 1)), sx(simplex(hx, hy));
+    REQUIRE((math::almost_equal(f1[0], sx[0]) && math::almost_equal(f1[2], sx[2])));
+    vec4f_t f6(fbm(noise_t::perlin, hx, hy, hx, 6, 2.0f, 0.5f, 5));
+    vec4f_t t6(turbulence(noise_t::simplex, hx, hy, hy, hx, 6));
+    for(unsigned l = 0; l < 4; ++l) {
+        REQUIRE(std::fabs(f6[l]) <= 1.0f);
+        REQUIRE((t6[l] >= 0.0f && t6[l] <= 1.0f));
+    }
+}
+
+#include <pgeom.h>
+
+TEST_CASE("TestRayIntersection")
+{
+    using namespace math;
+
+    // a ray along +x through the unit box and a triangle in the x = 2 plane
+    const vec4f_t o(-1.0f, 0.5f, 0.25f, 1.0f), d(1.0f, 0.0f, 0.0f, 0.0f), id(1.0f, INFINITY, INFINITY, 0.0f);
+    const vec4f_t bmin(0.0f, 0.0f, 0.0f, 1.0f), bmax(1.0f, 1.0f, 1.0f, 1.0f);
+    const vec4f_t v0(2.0f, 0.0f, 0.0f, 1.0f), v1(2.0f, 1.0f, 0.0f, 1.0f), v2(2.0f, 0.0f, 1.0f, 1.0f);
+    float tn = 0.0f, t = 0.0f, u = 0.0f, v = 0.0f;
+    REQUIRE(ray_box(o, id, bmin, bmax, 0.0f, 100.0f, tn));
+    REQUIRE(tn == 1.0f);
+    REQUIRE(!ray_box(o, id, bmin, bmax, 0.0f, 0.5f, tn));
+    REQUIRE(ray_triangle(o, d, v0, v1, v2, 0.0f, 100.0f, t, u, v));
+    REQUIRE((math::almost_equal(t, 3.0f) && math::almost_equal(u, 0.5f) && math::almost_equal(v, 0.25f)));
+    vec4f_t hit(eval_line(o, t, d));
+    REQUIRE(math::almost_equal(hit[0], 2.0f));
+    REQUIRE(!ray_triangle(o, vec4f_t(0.0f, 1.0f, 0.0f, 0.0f), v0, v1, v2, 0.0f, 100.0f, t, u, v)); // parallel
+
+    // packets against the single versions
+    xoshiro128p_t<> g(3);
+    unsigned hits = 0;
+    for(unsigned i = 0; i < 500; ++i) {
+        vec4f_t r[12];
+        for(unsigned k = 0; k < 12; ++k) r[k] = uniform(g, -2.0f, 2.0f);
+        ray_packet_t<vec4f_t> rays;
+        box_packet_t<vec4f_t> boxes;
+        tri_packet_t<vec4f_t> tris;
+        vec4f_t ro[4], rd[4], rid[4], b0[4], b1[4], t0[4], t1[4], t2[4];
+        for(unsigned k = 0; k < 4; ++k) {
+            ro[k] = vec4f_t(r[0][k], r[1][k], r[2][k], 1.0f);
+            rd[k] = vec4f_t(r[3][k], r[4][k], r[5][k], 0.0f);
+            rid[k] = vec4f_t(1.0f / rd[k][0], 1.0f / rd[k][1], 1.0f / rd[k][2], 0.0f);
+            b0[k] = vec4f_t(r[6][k] - 1.0f, r[7][k] - 1.0f, r[8][k] - 1.0f, 1.0f);
+            b1[k] = vec4f_t(r[6][k], r[7][k], r[8][k], 1.0f);
+            t0[k] = vec4f_t(r[9][k], r[10][k], r[11][k], 1.0f);
+            t1[k] = vec4f_t(r[10][k], r[11][k], r[9][k], 1.0f);
+            t2[k] = vec4f_t(r[11][k], r[9][k], -r[10][k], 1.0f);
+            rays.set(k, ro[k], rd[k]);
+            boxes.set(k, b0[k], b1[k]);
+            tris.set(k, t0[k], t1[k], t2[k]);
+        }
+        const vec4f_t zero(0.0f, 0.0f, 0.0f, 0.0f), ten(10.0f, 10.0f, 10.0f, 10.0f);
+        vec4f_t pt, pu, pv, pn;
+        unsigned m0 = mask_bits(ray_box(rays, b0[0], b1[0], zero, ten, pn));
+        for(unsigned k = 0; k < 4; ++k) {
+            bool h = ray_box(ro[k], rid[k], b0[0], b1[0], 0.0f, 10.0f, tn);
+            REQUIRE(h == (((m0 >> k) & 1) != 0));
+            if(h) REQUIRE(math::almost_equal(tn, pn[k]));
+        }
+        unsigned m1 = mask_bits(ray_box(ro[0], rid[0], boxes, 0.0f, 10.0f, pn));
+        for(unsigned k = 0; k < 4; ++k) {
+            bool h = ray_box(ro[0], rid[0], b0[k], b1[k], 0.0f, 10.0f, tn);
+            REQUIRE(h == (((m1 >> k) & 1) != 0));
+            if(h) REQUIRE(math::almost_equal(tn, pn[k]));
+        }
+        unsigned m2 = mask_bits(ray_triangle(rays, t0[1], t1[1], t2[1], zero, ten, pt, pu, pv));
+        for(unsigned k = 0; k < 4; ++k) {
+            bool h = ray_triangle(ro[k], rd[k], t0[1], t1[1], t2[1], 0.0f, 10.0f, t, u, v);
+            // lanes right at an edge may differ in the last bit
+            bool edge = std::fabs(u) < 1e-5f || std::fabs(v) < 1e-5f || std::fabs(u + v - 1.0f) < 1e-5f;
+            if(!edge) REQUIRE(h == (((m2 >> k) & 1) != 0));
+            if(h && !edge) REQUIRE(std::fabs(t - pt[k]) < 1e-4f * (1.0f + std::fabs(t)));
+        }
+        unsigned m3 = mask_bits(ray_triangle(ro[2], rd[2], tris, 0.0f, 10.0f, pt, pu, pv));
+        for(unsigned k = 0; k < 4; ++k) {
+            bool h = ray_triangle(ro[2], rd[2], t0[k], t1[k], t2[k], 0.0f, 10.0f, t, u, v);
+            bool edge = std::fabs(u) < 1e-5f || std::fabs(v) < 1e-5f || std::fabs(u + v - 1.0f) < 1e-5f;
+            if(!edge) REQUIRE(h == (((m3 >> k) & 1) != 0));
+            if(h && !edge) {
+                vec4f_t p(eval_line(ro[2], t, rd[2]));
+                vec4f_t q(t0[k] + (t1[k] - t0[k]) * u + (t2[k] - t0[k]) * v);
+                REQUIRE(std::fabs(p[0] - q[0]) < 1e-3f);
+                REQUIRE(std::fabs(p[2] - q[2]) < 1e-3f);
+            }
+        }
+        hits += m0 != 0;
+        hits += m2 != 0;
+        if(m3) {
+            float tmin_hit;
+            int lane = nearest_hit(ray_triangle(ro[2], rd[2], tris, 0.0f, 10.0f, pt, pu, pv), pt, tmin_hit);
+            REQUIRE(lane >= 0);
+            REQUIRE(((m3 >> lane) & 1) != 0);
+            REQUIRE(tmin_hit == pt[lane]);
+        }
+    }
+    REQUIRE(hits > 50);
+
+#if defined(AVX) && defined(AVX2)
+    // 8 wide packets against the single versions
+    unsigned hits8 = 0;
+    for(unsigned i = 0; i < 200; ++i) {
+        ray_packet_t<vec8f_t> rays;
+        box_packet_t<vec8f_t> boxes;
+        tri_packet_t<vec8f_t> tris;
+        vec4f_t ro[8], rd[8], rid[8], b0[8], b1[8], t0[8], t1[8], t2[8];
+        for(unsigned k = 0; k < 8; ++k) {
+            vec4f_t a(uniform(g, -2.0f, 2.0f)), b(uniform(g, -2.0f, 2.0f)), c(uniform(g, -2.0f, 2.0f));
+            ro[k] = vec4f_t(a[0], a[1], a[2], 1.0f);
+            rd[k] = vec4f_t(a[3], b[0], b[1], 0.0f);
+            rid[k] = vec4f_t(1.0f / rd[k][0], 1.0f / rd[k][1], 1.0f / rd[k][2], 0.0f);
+            b0[k] = vec4f_t(b[2] - 1.0f, b[3] - 1.0f, c[0] - 1.0f, 1.0f);
+            b1[k] = vec4f_t(b[2], b[3], c[0], 1.0f);
+            t0[k] = vec4f_t(c[1], c[2], c[3], 1.0f);
+            t1[k] = vec4f_t(c[2], c[3], c[1], 1.0f);
+            t2[k] = vec4f_t(c[3], c[1], -c[2], 1.0f);
+            rays.set(k, ro[k], rd[k]);
+            boxes.set(k, b0[k], b1[k]);
+            tris.set(k, t0[k], t1[k], t2[k]);
+        }
+        const vec8f_t zero(vec8f_t::math_t::zeroes()), ten(vec8f_t::math_t::set1(10.0f));
+        vec8f_t pt, pu, pv, pn;
+        unsigned m0 = mask_bits(ray_box(rays, b0[0], b1[0], zero, ten, pn));
+        for(unsigned k = 0; k < 8; ++k) {
+            bool h = ray_box(ro[k], rid[k], b0[0], b1[0], 0.0f, 10.0f, tn);
+            REQUIRE(h == (((m0 >> k) & 1) != 0));
+            if(h) REQUIRE(math::almost_equal(tn, pn[k]));
+        }
+        unsigned m1 = mask_bits(ray_box(ro[0], rid[0], boxes, 0.0f, 10.0f, pn));
+        for(unsigned k = 0; k < 8; ++k) {
+            bool h = ray_box(ro[0], rid[0], b0[k], b1[k], 0.0f, 10.0f, tn);
+            REQUIRE(h == (((m1 >> k) & 1) != 0));
+            if(h) REQUIRE(math::almost_equal(tn, pn[k]));
+        }
+        unsigned m2 = mask_bits(ray_triangle(rays, t0[1], t1[1], t2[1], zero, ten, pt, pu, pv));
+        for(unsigned k = 0; k < 8; ++k) {
+            bool h = ray_triangle(ro[k], rd[k], t0[1], t1[1], t2[1], 0.0f, 10.0f, t, u, v);
+            bool edge = std::fabs(u) < 1e-5f || std::fabs(v) < 1e-5f || std::fabs(u + v - 1.0f) < 1e-5f;
+            if(!edge) REQUIRE(h == (((m2 >> k) & 1) != 0));
+            if(h && !edge) REQUIRE(std::fabs(t - pt[k]) < 1e-4f * (1.0f + std::fabs(t)));
+        }
+        unsigned m3 = mask_bits(ray_triangle(ro[2], rd[2], tris, 0.0f, 10.0f, pt, pu, pv));
+        for(unsigned k = 0; k < 8; ++k) {
+            bool h = ray_triangle(ro[2], rd[2], t0[k], t1[k], t2[k], 0.0f, 10.0f, t, u, v);
+            bool edge = std::fabs(u) < 1e-5f || std::fabs(v) < 1e-5f || std::fabs(u + v - 1.0f) < 1e-5f;
+            if(!edge) REQUIRE(h == (((m3 >> k) & 1) != 0));
+        }
+        hits8 += m0 != 0;
+        hits8 += m2 != 0;
+        if(m3) {
+            float tmin_hit;
+            int lane = nearest_hit(ray_triangle(ro[2], rd[2], tris, 0.0f, 10.0f, pt, pu, pv), pt, tmin_hit);
+            REQUIRE(lane >= 0);
+            REQUIRE(((m3 >> lane) & 1) != 0);
+            REQUIRE(tmin_hit == pt[lane]);
+        }
+    }
+    REQUIRE(hits8 > 20);
+#endif
+}
+
+#include <pbvh.h>
+
+TEST_CASE("TestBVH")
+{
+    using namespace math;
+
+    // random triangles in [-4,4]^3
+    const size_t n = 2000;
+    xoshiro128p_t<> g(11);
+    std::vector<vec4f_t> v0(n), v1(n), v2(n), lo(n), hi(n);
+    for(size_t i = 0; i < n; ++i) {
+        vec4f_t c(uniform(g, -4.0f, 4.0f));
+        vec4f_t a(uniform(g, -0.3f, 0.3f)), b(uniform(g, -0.3f, 0.3f)), e(uniform(g, -0.3f, 0.3f));
+        v0[i] = vec4f_t(c[0] + a[0], c[1] + a[1], c[2] + a[2], 1.0f);
+        v1[i] = vec4f_t(c[0] + b[0], c[1] + b[1], c[2] + b[2], 1.0f);
+        v2[i] = vec4f_t(c[0] + e[0], c[1] + e[1], c[2] + e[2], 1.0f);
+    }
+    auto bounds = [&]() {
+        for(size_t i = 0; i < n; ++i) {
+            lo[i] = vec4f_t::min_(vec4f_t::min_(v0[i], v1[i]), v2[i]);
+            hi[i] = vec4f_t::max_(vec4f_t::max_(v0[i], v1[i]), v2[i]);
+        }
+    };
+    bounds();
+
+    bvh_t<> bvh;
+    bvh.build(&lo[0], &hi[0], n);
+    REQUIRE(!bvh.empty());
+    REQUIRE(bvh.prims().size() == n);
+    std::vector<uint32_t> sorted(bvh.prims());
+    std::sort(sorted.begin(), sorted.end());
+    for(size_t i = 0; i < n; ++i)
+        REQUIRE(sorted[i] == i);
+
+    // closest hits, any hits and box queries against brute force, returns
+    // the number of rays that hit
+    auto check = [&]() {
+        unsigned hits = 0;
+        for(unsigned r = 0; r < 300; ++r) {
+            vec4f_t o(uniform(g, -6.0f, 6.0f)), d(uniform(g, -1.0f, 1.0f));
+            o[3] = 1.0f; d[3] = 0.0f;
+            float t, u, v, best = 20.0f;
+            for(size_t i = 0; i < n; ++i)
+                if(ray_triangle(o, d, v0[i], v1[i], v2[i], 0.0f, best, t, u, v)) best = t;
+            float tmax = 20.0f;
+            bool hit = bvh.intersect(o, d, 0.0f, tmax, [&](uint32_t i, float & tm) {
+                float tt, uu, vv;
+                if(!ray_triangle(o, d, v0[i], v1[i], v2[i], 0.0f, tm, tt, uu, vv)) return false;
+                tm = tt;
+                return true;
+            });
+            REQUIRE(hit == (best < 20.0f));
+            REQUIRE(tmax == best);
+            bool occl = bvh.occluded(o, d, 0.0f, 20.0f, [&](uint32_t i, float & tm) {
+                float tt, uu, vv;
+                return ray_triangle(o, d, v0[i], v1[i], v2[i], 0.0f, tm, tt, uu, vv);
+            });
+            REQUIRE(occl == hit);
+            hits += hit;
+
+            vec4f_t qlo(uniform(g, -5.0f, 4.0f)), qhi(qlo + vec4f_t(1.0f, 1.0f, 1.0f, 1.0f));
+            std::vector<uint32_t> found;
+            bvh.overlap(qlo, qhi, [&](uint32_t i) {
+                if(lo[i][0] <= qhi[0] && lo[i][1] <= qhi[1] && lo[i][2] <= qhi[2] &&
+                   hi[i][0] >= qlo[0] && hi[i][1] >= qlo[1] && hi[i][2] >= qlo[2])
+                    found.push_back(i);
+            });
+            size_t count = 0;
+            for(size_t i = 0; i < n; ++i)
+                count += lo[i][0] <= qhi[0] && lo[i][1] <= qhi[1] && lo[i][2] <= qhi[2] &&
+                         hi[i][0] >= qlo[0] && hi[i][1] >= qlo[1] && hi[i][2] >= qlo[2];
+            REQUIRE(found.size() == count);
+        }
+        return hits;
+    };
+    REQUIRE(check() > 30);
+
+    // moved triangles, refit keeps the hierarchy valid
+    for(size_t i = 0; i < n; ++i) {
+        vec4f_t m(uniform(g, -0.5f, 0.5f));
+        m[3] = 0.0f;
+        v0[i] = v0[i] + m; v1[i] = v1[i] + m; v2[i] = v2[i] + m;
+    }
+    bounds();
+    bvh.refit(&lo[0], &hi[0]);
+    REQUIRE(check() > 30);
+    REQUIRE((bvh.bounds_min()[0] >= -5.0f && bvh.bounds_max()[0] <= 5.0f));
+
+#if defined(AVX) && defined(AVX2)
+    // BVH8 finds the same closest hits as BVH4
+    bvh_t<vec8f_t> bvh8;
+    bvh8.build(&lo[0], &hi[0], n);
+    REQUIRE(bvh8.prims().size() == n);
+    for(unsigned r = 0; r < 300; ++r) {
+        vec4f_t o(uniform(g, -6.0f, 6.0f)), d(uniform(g, -1.0f, 1.0f));
+        o[3] = 1.0f; d[3] = 0.0f;
+        auto hit_tri = [&](uint32_t i, float & tm) {
+            float tt, uu, vv;
+            if(!ray_triangle(o, d, v0[i], v1[i], v2[i], 0.0f, tm, tt, uu, vv)) return false;
+            tm = tt;
+            return true;
+        };
+        float t4 = 20.0f, t8 = 20.0f;
+        bool h4 = bvh.intersect(o, d, 0.0f, t4, hit_tri), h8 = bvh8.intersect(o, d, 0.0f, t8, hit_tri);
+        REQUIRE(h4 == h8);
+        REQUIRE(t4 == t8);
+        REQUIRE(bvh8.occluded(o, d, 0.0f, 20.0f, hit_tri) == h4);
+    }
+#endif
+
+    // the parallel build doesn't depend on the number of threads
+    const size_t m = 20000;
+    std::vector<vec4f_t> plo(m), phi(m);
+    for(size_t i = 0; i < m; ++i) {
+        plo[i] = uniform(g, -10.0f, 10.0f);
+        phi[i] = plo[i] + vec4f_t(0.1f, 0.1f, 0.1f, 0.1f);
+    }
+    thread_pool_t one(1), four(4);
+    bvh_t<> b1, b4;
+    b1.build(one, &plo[0], &phi[0], m);
+    b4.build(four, &plo[0], &phi[0], m, 4);
+    REQUIRE(b1.prims() == b4.prims());
+    REQUIRE(b1.nodes().size() == b4.nodes().size());
+    for(size_t i = 0; i < b1.nodes().size(); ++i)
+        for(unsigned c = 0; c < bvh_t<>::W; ++c) {
+            REQUIRE(b1.nodes()[i].child[c] == b4.nodes()[i].child[c]);
+            REQUIRE(b1.nodes()[i].count[c] == b4.nodes()[i].count[c]);
+            REQUIRE(b1.nodes()[i].box.minx[c] == b4.nodes()[i].box.minx[c]);
+        }
+    unsigned leaves = 0;
+    for(size_t i = 0; i < b4.nodes().size(); ++i)
+        for(unsigned c = 0; c < bvh_t<>::W; ++c) leaves += b4.nodes()[i].count[c];
+    REQUIRE(leaves == m);
+}
+
+#include <pcull.h>
+
+TEST_CASE("TestFrustumCulling")
+{
+    using namespace math;
+
+    // OpenGL perspective, 90 degrees, aspect 1, near 1, far 100, camera at
+    // the origin looking along -z
+    const float zn = 1.0f, zf = 100.0f;
+    const float proj[16] = {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, (zf + zn) / (zn - zf), 2.0f * zf * zn / (zn - zf),
+        0.0f, 0.0f, -1.0f, 0.0f
+    };
+    const frustum_t f((mat4f_t(proj)));
+    REQUIRE(f.classify(vec4f_t(0.0f, 0.0f, -10.0f, 1.0f), 1.0f) == cull_t::inside);
+    REQUIRE(f.classify(vec4f_t(0.0f, 0.0f, 10.0f, 1.0f), 1.0f) == cull_t::outside);
+    REQUIRE(f.classify(vec4f_t(10.0f, 0.0f, -10.0f, 1.0f), 1.0f) == cull_t::intersecting);
+    REQUIRE(f.classify(vec4f_t(0.0f, 0.0f, -100.0f, 1.0f), 1.0f) == cull_t::intersecting);
+    REQUIRE(f.classify(vec4f_t(-1.0f, -1.0f, -6.0f, 1.0f), vec4f_t(1.0f, 1.0f, -4.0f, 1.0f)) == cull_t::inside);
+    REQUIRE(f.classify(vec4f_t(20.0f, -1.0f, -6.0f, 1.0f), vec4f_t(22.0f, 1.0f, -4.0f, 1.0f)) == cull_t::outside);
+    // the near plane of a [0,1] depth projection of the same frustum
+    const float proj01[16] = {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, zf / (zn - zf), zf * zn / (zn - zf),
+        0.0f, 0.0f, -1.0f, 0.0f
+    };
+    const frustum_t f01(mat4f_t(proj01), clip_depth_t::zero_one);
+    for(unsigned k = 0; k < 6; ++k)
+        for(unsigned j = 0; j < 4; ++j)
+            REQUIRE(std::fabs(f.plane[k][j] - f01.plane[k][j]) < 1e-4f * (1.0f + std::fabs(f.plane[k][j])));
+
+    // arrays (not a multiple of the vector width) against the single tests
+    const size_t n = 1003;
+    xoshiro128p_t<> g(5);
+    std::vector<float> x(n), y(n), z(n), r(n), x1(n), y1(n), z1(n);
+    for(size_t i = 0; i < n; ++i) {
+        vec4f_t p(uniform(g, -60.0f, 60.0f));
+        x[i] = p[0]; y[i] = p[1]; z[i] = p[2] - 50.0f; r[i] = std::fabs(p[3]) * 0.1f;
+        x1[i] = x[i] + r[i]; y1[i] = y[i] + 0.5f * r[i]; z1[i] = z[i] + 2.0f * r[i];
+    }
+    const sphere_soa_t spheres = { &x[0], &y[0], &z[0], &r[0] };
+    const aabb_soa_t boxes = { &x[0], &y[0], &z[0], &x1[0], &y1[0], &z1[0] };
+
+    std::vector<cull_t> cs(n), cb(n);
+    std::vector<uint32_t> is(n), ib(n), bs((n + 31) / 32), bb((n + 31) / 32);
+    frustum_classify(f, spheres, n, &cs[0]);
+    frustum_classify(f, boxes, n, &cb[0]);
+    size_t ns = frustum_cull(f, spheres, n, &is[0]), nb = frustum_cull(f, boxes, n, &ib[0]);
+    size_t ms = frustum_cull_bits(f, spheres, n, &bs[0]), mb = frustum_cull_bits(f, boxes, n, &bb[0]);
+    size_t ks = 0, kb = 0, count[3] = { 0 };
+    for(size_t i = 0; i < n; ++i) {
+        vec4f_t c(x[i], y[i], z[i], 1.0f), lo(x[i], y[i], z[i], 1.0f), hi(x1[i], y1[i], z1[i], 1.0f);
+        REQUIRE(cs[i] == f.classify(c, r[i]));
+        REQUIRE(cb[i] == f.classify(lo, hi));
+        bool vs = cs[i] != cull_t::outside, vb = cb[i] != cull_t::outside;
+        REQUIRE(vs == (((bs[i / 32] >> (i % 32)) & 1) != 0));
+        REQUIRE(vb == (((bb[i / 32] >> (i % 32)) & 1) != 0));
+        if(vs) {
+            REQUIRE(ks < ns);
+            REQUIRE(is[ks] == i);
+            ++ks;
+        }
+        if(vb) {
+            REQUIRE(kb < nb);
+            REQUIRE(ib[kb] == i);
+            ++kb;
+        }
+        ++count[unsigned(cs[i])];
+    }
+    REQUIRE((ks == ns && kb == nb && ms == ns && mb == nb));
+    REQUIRE((count[0] > 50 && count[1] > 10 && count[2] > 50));
+#if defined(PVECF_INTEL) && defined(AVX) && defined(AVX2)
+    std::vector<uint32_t> i8(n);
+    std::vector<cull_t> c8(n);
+    frustum_classify<vec8f_t>(f, spheres, n, &c8[0]);
+    REQUIRE(frustum_cull<vec8f_t>(f, spheres, n, &i8[0]) == ns);
+    REQUIRE(c8 == cs);
+#endif
+}
+
+#include <ppoints.h>
+
+TEST_CASE("TestPointStats")
+{
+    using namespace math;
+
+    // an elongated cloud along {1,1,0} far from the origin
+    const size_t n = 10003;
+    const float off[3] = { 10000.0f, -5000.0f, 2000.0f };
+    xoshiro128p_t<> g(17);
+    std::vector<vec4f_t> pts(n);
+    std::vector<float> xyz(3 * n), x(n), y(n), z(n);
+    for(size_t i = 0; i < n; ++i) {
+        vec4f_t r(uniform(g, -1.0f, 1.0f));
+        float a = 8.0f * r[0], b = 2.0f * r[1], c = 0.5f * r[2];
+        x[i] = off[0] + 0.70710678f * (a - b);
+        y[i] = off[1] + 0.70710678f * (a + b);
+        z[i] = off[2] + c;
+        pts[i] = vec4f_t(x[i], y[i], z[i], r[3]);
+        xyz[3 * i] = x[i]; xyz[3 * i + 1] = y[i]; xyz[3 * i + 2] = z[i];
+    }
+
+    // reference in double
+    double mean[3] = { 0.0 }, cov[3][3] = { { 0.0 } }, lo[3], hi[3];
+    const float * c3[3] = { &x[0], &y[0], &z[0] };
+    for(unsigned j = 0; j < 3; ++j) {
+        lo[j] = hi[j] = c3[j][0];
+        for(size_t i = 0; i < n; ++i) {
+            mean[j] += c3[j][i];
+            lo[j] = std::min(lo[j], double(c3[j][i]));
+            hi[j] = std::max(hi[j], double(c3[j][i]));
+        }
+        mean[j] /= double(n);
+    }
+    for(unsigned j = 0; j < 3; ++j)
+        for(unsigned k = 0; k < 3; ++k) {
+            for(size_t i = 0; i < n; ++i) cov[j][k] += (c3[j][i] - mean[j]) * (c3[k][i] - mean[k]);
+            cov[j][k] /= double(n);
+        }
+
+    const point_stats_t s[3] = {
+        point_stats(&pts[0], n), point_stats(&xyz[0], n), point_stats(&x[0], &y[0], &z[0], n)
+    };
+    for(unsigned l = 0; l < 3; ++l) {
+        REQUIRE(s[l].count == n);
+        for(unsigned j = 0; j < 3; ++j) {
+            REQUIRE(s[l].bmin[j] == float(lo[j]));
+            REQUIRE(s[l].bmax[j] == float(hi[j]));
+            REQUIRE(std::fabs(s[l].centroid[j] - mean[j]) < 1e-3);
+            for(unsigned k = 0; k < 3; ++k)
+                REQUIRE(std::fabs(s[l].cov[j][k] - cov[j][k]) < 1e-3 * (1.0 + std::fabs(cov[j][k])));
+        }
+    }
+    const point_stats_t e(point_stats(&x[0], &y[0], &z[0], 0));
+    REQUIRE((e.count == 0 && e.bmin[0] > e.bmax[0] && e.centroid[0] == 0.0f));
+
+    // eigen decomposition: A v = lambda v
+    float vals[3];
+    vec4f_t axes[3];
+    sym3_eigen(s[0].cov, vals, axes);
+    REQUIRE((vals[0] >= vals[1] && vals[1] >= vals[2] && vals[2] > 0.0f));
+    for(unsigned k = 0; k < 3; ++k)
+        for(unsigned j = 0; j < 3; ++j) {
+            float av = s[0].cov[j][0] * axes[k][0] + s[0].cov[j][1] * axes[k][1] + s[0].cov[j][2] * axes[k][2];
+            REQUIRE(std::fabs(av - vals[k] * axes[k][j]) < 1e-4f * (1.0f + vals[0]));
+        }
+    REQUIRE(std::fabs(std::fabs(axes[0][0] + axes[0][1]) - 1.41421356f) < 1e-3f);
+    const float diag[3][3] = { { 2.0f, 0.0f, 0.0f }, { 0.0f, 3.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    sym3_eigen(diag, vals, axes);
+    REQUIRE((vals[0] == 3.0f && vals[1] == 2.0f && vals[2] == 1.0f));
+    REQUIRE((std::fabs(axes[0][1]) == 1.0f && std::fabs(axes[1][0]) == 1.0f && axes[2][2] == axes[0][0] * axes[1][1] - axes[0][1] * axes[1][0]));
+
+    // oriented box: contains all points, tighter than the axis aligned one
+    const obb_t b(point_obb(&xyz[0], n));
+    for(size_t i = 0; i < n; ++i)
+        for(unsigned k = 0; k < 3; ++k) {
+            float d = (x[i] - b.center[0]) * b.axis[k][0] + (y[i] - b.center[1]) * b.axis[k][1] + (z[i] - b.center[2]) * b.axis[k][2];
+            REQUIRE(std::fabs(d) <= b.half[k] + 1e-2f);
+        }
+    REQUIRE((b.half[0] < 8.1f && b.half[1] < 2.1f && b.half[2] < 0.6f));
+    REQUIRE(b.half[0] * b.half[1] * b.half[2] < 0.5f * float((hi[0] - lo[0]) * (hi[1] - lo[1]) * (hi[2] - lo[2]) / 8.0));
+    const obb_t b2(point_obb(&pts[0], n));
+    REQUIRE((std::fabs(b2.half[0] - b.half[0]) < 1e-3f && std::fabs(b2.center[2] - b.center[2]) < 1e-3f));
+}
+
+#if defined(PVECF_INTEL)
+#include <pcomplex.h>
+
+TEST_CASE("TestComplex")
+{
+    using namespace math;
+
+    const std::complex<float> a[2] = { std::complex<float>(1.0f, 2.0f), std::complex<float>(-3.0f, 0.5f) };
+    const std::complex<float> b[2] = { std::complex<float>(0.5f, -1.5f), std::complex<float>(2.0f, 4.0f) };
+    complex4f_t za, zb;
+    za.loadu(a); zb.loadu(b);
+    for(unsigned k = 0; k < 2; ++k) {
+        std::complex<float> m = a[k] * b[k], d = a[k] / b[k];
+        REQUIRE((za + zb).get(k) == a[k] + b[k]);
+        REQUIRE((za - zb).get(k) == a[k] - b[k]);
+        REQUIRE(std::abs((za * zb).get(k) - m) < 1e-6f);
+        REQUIRE(std::abs((za / zb).get(k) - d) < 1e-6f);
+        REQUIRE((za * 2.0f).get(k) == a[k] * 2.0f);
+        REQUIRE(conj(za).get(k) == std::conj(a[k]));
+        REQUIRE((-za).get(k) == -a[k]);
+        REQUIRE(std::fabs(norm(za).re(k) - std::norm(a[k])) < 1e-6f);
+        REQUIRE(norm(za).im(k) == 0.0f);
+        REQUIRE(std::fabs(abs(za).re(k) - std::abs(a[k])) < 1e-6f);
+        REQUIRE(abs(za).im(k) == 0.0f);
+        REQUIRE(std::fabs(arg(za).re(k) - std::arg(a[k])) < 2e-6f);
+        REQUIRE(arg(za).im(k) == 0.0f);
+        REQUIRE(std::abs(mul_add(za, zb, za).get(k) - (m + a[k])) < 1e-5f);
+    }
+    REQUIRE((complex4f_t(1.0f, -2.0f).get(1) == std::complex<float>(1.0f, -2.0f)));
+
+#if defined(SSE2) || defined(AVX)
+    const std::complex<double> c(1.5, -2.5), d(-0.25, 4.0);
+    complex2d_t zc(c), zd(d);
+    REQUIRE(std::abs((zc * zd).get(0) - c * d) < 1e-12);
+    REQUIRE(std::abs((zc / zd).get(0) - c / d) < 1e-12);
+    REQUIRE(std::fabs(abs(zc).re(0) - std::abs(c)) < 1e-12);
+    REQUIRE(std::fabs(arg(zd).re(0) - std::arg(d)) < 2e-6);
+#endif
+
+#if defined(AVX)
+    const std::complex<float> a8[4] = { a[0], a[1], std::complex<float>(0.0f, -1.0f), std::complex<float>(-2.0f, -7.0f) };
+    const std::complex<float> b8[4] = { b[0], b[1], std::complex<float>(3.0f, 0.25f), std::complex<float>(-0.5f, 1.0f) };
+    complex8f_t z8a, z8b;
+    z8a.loadu(a8); z8b.loadu(b8);
+    std::complex<float> s8[4];
+    (z8a * z8b).storeu(s8);
+    for(unsigned k = 0; k < 4; ++k) {
+        std::complex<float> m = a8[k] * b8[k];
+        REQUIRE(std::abs(s8[k] - m) < 1e-5f);
+        REQUIRE((z8a + z8b).get(k) == a8[k] + b8[k]);
+        REQUIRE(std::abs((z8a / z8b).get(k) - a8[k] / b8[k]) < 1e-5f);
+        REQUIRE(conj(z8a).get(k) == std::conj(a8[k]));
+        REQUIRE(std::fabs(abs(z8a).re(k) - std::abs(a8[k])) < 1e-5f);
+        REQUIRE(std::fabs(arg(z8a).re(k) - std::arg(a8[k])) < 2e-6f);
+        REQUIRE(std::abs(mul_add(z8a, z8b, z8a).get(k) - (m + a8[k])) < 1e-5f);
+    }
+#endif // AVX
+
+    // array kernels, odd length for the tails
+    const size_t n = 1001;
+    xoshiro128p_t<> g(23);
+    std::vector<std::complex<float> > x(n), y(n), z(n), acc(n), ref(n);
+    std::vector<std::complex<double> > xd(n), yd(n), zd2(n);
+    for(size_t i = 0; i < n; i += 2) {
+        vec4f_t r(uniform(g, -4.0f, 4.0f));
+        for(size_t k = i; k < i + 2 && k < n; ++k) {
+            x[k] = std::complex<float>(r[2 * (k - i)], r[2 * (k - i) + 1]);
+            y[k] = std::complex<float>(r[3 - 2 * (k - i)], -r[2 * (k - i)]);
+            acc[k] = ref[k] = std::complex<float>(float(k), 1.0f);
+            xd[k] = std::complex<double>(x[k]); yd[k] = std::complex<double>(y[k]);
+        }
+    }
+    x[7] = std::complex<float>(0.0f, 0.0f);
+    x[8] = std::complex<float>(-2.0f, 0.0f);
+    cmul_many(&z[0], &x[0], &y[0], n);
+    cmac_many(&acc[0], &x[0], &y[0], n);
+    cmul_many(&zd2[0], &xd[0], &yd[0], n);
+    std::vector<float> nm(n), ab(n), ph(n);
+    std::vector<double> abd(n);
+    norm_many(&nm[0], &x[0], n);
+    abs_many(&ab[0], &x[0], n);
+    arg_many(&ph[0], &x[0], n);
+    abs_many(&abd[0], &xd[0], n);
+    for(size_t i = 0; i < n; ++i) {
+        std::complex<float> m = x[i] * y[i];
+        REQUIRE(std::abs(z[i] - m) < 1e-5f);
+        REQUIRE(std::abs(acc[i] - (ref[i] + m)) < 1e-4f);
+        REQUIRE(std::abs(zd2[i] - xd[i] * yd[i]) < 1e-12);
+        REQUIRE(std::fabs(nm[i] - std::norm(x[i])) < 1e-5f);
+        REQUIRE(std::fabs(ab[i] - std::abs(x[i])) < 1e-5f);
+        REQUIRE(std::fabs(ph[i] - std::arg(x[i])) < 2e-6f);
+        REQUIRE(std::fabs(abd[i] - std::abs(xd[i])) < 1e-12);
+    }
+    REQUIRE((ph[7] == 0.0f && std::fabs(ph[8] - 3.14159265f) < 1e-6f));
+}
+
+#include <pfft.h>
+
+TEST_CASE("TestFFT")
+{
+    using namespace math;
+
+    // naive DFT in double, max error relative to the largest magnitude
+    auto dft = [](const std::vector<std::complex<double> > & x, size_t n, size_t batch, size_t c, double sign) {
+        std::vector<std::complex<double> > y(n);
+        for(size_t k = 0; k < n; ++k)
+            for(size_t j = 0; j < n; ++j)
+                y[k] += x[j * batch + c] * std::polar(1.0, sign * 2.0 * 3.14159265358979323846 * double((j * k) % n) / double(n));
+        return y;
+    };
+    xoshiro128p_t<> g(29);
+    auto random = [&](size_t n) {
+        std::vector<std::complex<float> > x(n);
+        for(size_t i = 0; i < n; i += 2) {
+            vec4f_t r(uniform(g, -1.0f, 1.0f));
+            x[i] = std::complex<float>(r[0], r[1]);
+            if(i + 1 < n) x[i + 1] = std::complex<float>(r[2], r[3]);
+        }
+        return x;
+    };
+
+    for(size_t n = 1; n <= 2048; n *= 2) {
+        std::vector<std::complex<float> > x(random(n)), y(n), z(n);
+        std::vector<std::complex<double> > xd(x.begin(), x.end());
+        fft_plan_t<> plan(n);
+        plan.forward(&x[0], &y[0]);
+        std::vector<std::complex<double> > ref(dft(xd, n, 1, 0, -1.0));
+        double err = 0.0, scale = 1.0;
+        for(size_t k = 0; k < n; ++k) {
+            err = std::max(err, std::abs(std::complex<double>(y[k]) - ref[k]));
+            scale = std::max(scale, std::abs(ref[k]));
+        }
+        REQUIRE(err < 2e-6 * scale * std::log2(double(2 * n)));
+        // inverse, in-place
+        z = y;
+        plan.inverse(&z[0], &z[0]);
+        for(size_t k = 0; k < n; ++k)
+            REQUIRE(std::abs(z[k] / float(n) - x[k]) < 1e-5f);
+    }
+
+    // double precision
+    {
+        const size_t n = 512;
+        std::vector<std::complex<float> > xf(random(n));
+        std::vector<std::complex<double> > x(xf.begin(), xf.end()), y(n);
+        fft_plan_t<double> plan(n);
+        plan.forward(&x[0], &y[0]);
+        std::vector<std::complex<double> > ref(dft(x, n, 1, 0, -1.0));
+        double err = 0.0;
+        for(size_t k = 0; k < n; ++k) err = std::max(err, std::abs(y[k] - ref[k]));
+        REQUIRE(err < 1e-11);
+    }
+
+    // interleaved batches (odd and even) and forward_many
+    for(size_t batch = 3; batch <= 4; ++batch) {
+        const size_t n = 32;
+        std::vector<std::complex<float> > x(random(n * batch)), y(n * batch);
+        std::vector<std::complex<double> > xd(x.begin(), x.end());
+        fft_plan_t<> plan(n, batch);
+        plan.forward(&x[0], &y[0]);
+        for(size_t c = 0; c < batch; ++c) {
+            std::vector<std::complex<double> > ref(dft(xd, n, batch, c, -1.0));
+            for(size_t k = 0; k < n; ++k)
+                REQUIRE(std::abs(std::complex<double>(y[k * batch + c]) - ref[k]) < 1e-4);
+        }
+        fft_plan_t<> single(n);
+        std::vector<std::complex<float> > many(n * batch), one(n);
+        single.forward_many(&x[0], &many[0], batch);
+        for(size_t c = 0; c < batch; ++c) {
+            single.forward(&x[c * n], &one[0]);
+            REQUIRE(std::equal(one.begin(), one.end(), many.begin() + c * n));
+        }
+    }
+
+    // real input
+    for(size_t n = 2; n <= 1024; n *= 2) {
+        std::vector<std::complex<float> > c(random(n / 2 + 1)), y(n / 2 + 1);
+        std::vector<float> x(n), z(n);
+        for(size_t i = 0; i < n; ++i) x[i] = i % 2 ? c[i / 2].imag() : c[i / 2].real();
+        std::vector<std::complex<double> > xd(x.begin(), x.end());
+        fft_real_plan_t<> plan(n);
+        plan.forward(&x[0], &y[0]);
+        std::vector<std::complex<double> > ref(dft(xd, n, 1, 0, -1.0));
+        for(size_t k = 0; k <= n / 2; ++k)
+            REQUIRE(std::abs(std::complex<double>(y[k]) - ref[k]) < 1e-4);
+        plan.inverse(&y[0], &z[0]);
+        for(size_t i = 0; i < n; ++i)
+            REQUIRE(std::fabs(z[i] / float(n) - x[i]) < 1e-5f);
+    }
+
+    // 2D against the row and column DFTs
+    {
+        const size_t rows = 8, cols = 16;
+        std::vector<std::complex<float> > x(random(rows * cols)), y(rows * cols), z(rows * cols);
+        fft2d_plan_t<> plan(rows, cols);
+        plan.forward(&x[0], &y[0]);
+        std::vector<std::complex<double> > t(rows * cols), xd(x.begin(), x.end());
+        for(size_t r = 0; r < rows; ++r) {
+            std::vector<std::complex<double> > xr(xd.begin() + r * cols, xd.begin() + (r + 1) * cols);
+            std::vector<std::complex<double> > row(dft(xr, cols, 1, 0, -1.0));
+            std::copy(row.begin(), row.end(), t.begin() + r * cols);
+        }
+        for(size_t c = 0; c < cols; ++c) {
+            std::vector<std::complex<double> > col(dft(t, rows, cols, c, -1.0));
+            for(size_t r = 0; r < rows; ++r)
+                REQUIRE(std::abs(std::complex<double>(y[r * cols + c]) - col[r]) < 1e-4);
+        }
+        plan.inverse(&y[0], &z[0]);
+        for(size_t i = 0; i < rows * cols; ++i)
+            REQUIRE(std::abs(z[i] / float(rows * cols) - x[i]) < 1e-5f);
+    }
+
+    bool thrown = false;
+    try { fft_plan_t<> bad(12); } catch(const std::invalid_argument &) { thrown = true; }
+    REQUIRE(thrown);
+    thrown = false;
+    try { fft_plan_t<> bad(16, 0); } catch(const std::invalid_argument &) { thrown = true; }
+    REQUIRE(thrown);
+}
+#endif // defined(PVECF_INTEL)
+
 // TODO: test_main() -> main() for Android?
 //#ifdef ANDROID
 #if 0